@@ -0,0 +1,345 @@
+#include <string.h>
+
+#include "glob_opts.h"
+#include "csc_packed.h"
+
+/*
+ * The entries are read and written with memcpy, which compiles to plain
+ * (unaligned) loads and stores, and assume 2-byte short and 4-byte int.
+ */
+
+/* Bytes needed for the first entry of a column, 0 if it does not fit */
+static OSQPInt first_width(OSQPInt d) {
+  if (d >= -128 && d <= 127)     return 1;
+  if (d >= -32768 && d <= 32767) return 2;
+  if ((OSQPInt)(int)d == d)      return 4;
+  return 0;
+}
+
+/* Bytes needed for a gap between rows, 0 if it does not fit */
+static OSQPInt gap_width(OSQPInt g) {
+  if (g <= 255)                        return 1;
+  if (g <= 65535)                      return 2;
+  if ((OSQPInt)(unsigned int)g == g)   return 4;
+  return 0;
+}
+
+static OSQPInt read_first(const unsigned char* d,
+                          OSQPInt              w) {
+  short s;
+  int   i;
+
+  switch (w) {
+  case 1:
+    return (signed char)d[0];
+  case 2:
+    memcpy(&s, d, 2);
+    return s;
+  default:
+    memcpy(&i, d, 4);
+    return i;
+  }
+}
+
+static OSQPInt read_gap(const unsigned char* d,
+                        OSQPInt              w) {
+  unsigned short s;
+  unsigned int   u;
+
+  switch (w) {
+  case 1:
+    return d[0];
+  case 2:
+    memcpy(&s, d, 2);
+    return s;
+  default:
+    memcpy(&u, d, 4);
+    return (OSQPInt)u;
+  }
+}
+
+static void write_first(unsigned char* d,
+                        OSQPInt        w,
+                        OSQPInt        v) {
+  short s = (short)v;
+  int   i = (int)v;
+
+  switch (w) {
+  case 1:
+    d[0] = (unsigned char)(signed char)v;
+    break;
+  case 2:
+    memcpy(d, &s, 2);
+    break;
+  default:
+    memcpy(d, &i, 4);
+  }
+}
+
+static void write_gap(unsigned char* d,
+                      OSQPInt        w,
+                      OSQPInt        v) {
+  unsigned short s = (unsigned short)v;
+  unsigned int   u = (unsigned int)v;
+
+  switch (w) {
+  case 1:
+    d[0] = (unsigned char)v;
+    break;
+  case 2:
+    memcpy(d, &s, 2);
+    break;
+  default:
+    memcpy(d, &u, 4);
+  }
+}
+
+/*
+ * Bytes per entry of column j, 0 if the column is unsorted or its deltas do
+ * not fit. first is the first row of the previous nonempty column.
+ */
+static OSQPInt column_width(const OSQPCscMatrix* A,
+                            OSQPInt              j,
+                            OSQPInt              first) {
+  OSQPInt k, g, wg;
+  OSQPInt w = first_width(A->i[A->p[j]] - first);
+
+  for (k = A->p[j] + 1; k < A->p[j+1] && w; k++) {
+    g = A->i[k] - A->i[k-1] - 1;
+    if (g < 0) return 0;
+    wg = gap_width(g);
+    if (!wg) return 0;
+    w = c_max(w, wg);
+  }
+  return w;
+}
+
+/* y = beta*y */
+static void scale_y(OSQPFloat* y,
+                    OSQPFloat  beta,
+                    OSQPInt    len) {
+  OSQPInt i;
+
+  if (beta == 0) {
+    for (i = 0; i < len; i++) y[i] = 0.0;
+  }
+  else if (beta == -1) {
+    for (i = 0; i < len; i++) y[i] = -y[i];
+  }
+  else if (beta != 1) {
+    for (i = 0; i < len; i++) y[i] *= beta;
+  }
+}
+
+OSQPInt csc_packable(const OSQPCscMatrix* A) {
+  OSQPInt j;
+  OSQPInt first = 0;
+
+  for (j = 0; j < A->n; j++) {
+    if (A->p[j] == A->p[j+1]) continue;
+    if (!column_width(A, j, first)) return 0;
+    first = A->i[A->p[j]];
+  }
+  return 1;
+}
+
+csc_packed* csc_packed_new(const OSQPCscMatrix* A) {
+  OSQPInt j, k, w;
+  OSQPInt first = 0;
+  OSQPInt size  = 0;
+  unsigned char* d;
+
+  csc_packed* Z = c_calloc(1, sizeof(csc_packed));
+  if (!Z) return OSQP_NULL;
+
+  Z->width = c_malloc(c_max(A->n, 1) * sizeof(unsigned char));
+  if (!Z->width) {
+    csc_packed_free(Z);
+    return OSQP_NULL;
+  }
+
+  for (j = 0; j < A->n; j++) {
+    Z->width[j] = 1;
+    if (A->p[j] == A->p[j+1]) continue;
+    w = column_width(A, j, first);
+    Z->width[j] = (unsigned char)w;
+    size += w * (A->p[j+1] - A->p[j]);
+    first = A->i[A->p[j]];
+  }
+
+  Z->size = size;
+  Z->data = c_malloc(c_max(size, 1));
+  if (!Z->data) {
+    csc_packed_free(Z);
+    return OSQP_NULL;
+  }
+
+  d     = Z->data;
+  first = 0;
+  for (j = 0; j < A->n; j++) {
+    if (A->p[j] == A->p[j+1]) continue;
+    w = Z->width[j];
+    k = A->p[j];
+    write_first(d, w, A->i[k] - first);
+    first = A->i[k];
+    d += w;
+    for (k++; k < A->p[j+1]; k++) {
+      write_gap(d, w, A->i[k] - A->i[k-1] - 1);
+      d += w;
+    }
+  }
+
+  return Z;
+}
+
+void csc_packed_free(csc_packed* Z) {
+  if (Z) {
+    c_free(Z->width);
+    c_free(Z->data);
+    c_free(Z);
+  }
+}
+
+/*
+ * Most columns of banded or reordered matrices have 1-byte gaps, which get
+ * their own loop so that the common case decodes with a single load.
+ *
+ * The general form alpha*Ax[k]*x[j] also covers alpha = 1 and alpha = -1 of
+ * the plain products exactly, since multiplying by 1 or -1 is exact.
+ */
+
+void csc_packed_Axpy(const OSQPCscMatrix* A,
+                     const csc_packed*    Z,
+                     const OSQPFloat*     x,
+                           OSQPFloat*     y,
+                           OSQPFloat      alpha,
+                           OSQPFloat      beta) {
+
+  OSQPInt    j, k, end, r, w;
+  OSQPInt    first = 0;
+  OSQPInt*   Ap = A->p;
+  OSQPInt    An = A->n;
+  OSQPFloat* Ax = A->x;
+
+  const unsigned char* d = Z->data;
+
+  scale_y(y, beta, A->m);
+
+  // if A is empty or zero
+  if (Ap[An] == 0 || alpha == 0.0) return;
+
+  for (j = 0; j < An; j++) {
+    k   = Ap[j];
+    end = Ap[j+1];
+    if (k == end) continue;
+
+    w      = Z->width[j];
+    first += read_first(d, w);
+    r      = first;
+    d     += w;
+    y[r]  += alpha*Ax[k] * x[j];
+
+    if (w == 1) {
+      for (k++; k < end; k++, d++) {
+        r    += d[0] + 1;
+        y[r] += alpha*Ax[k] * x[j];
+      }
+    }
+    else {
+      for (k++; k < end; k++) {
+        r    += read_gap(d, w) + 1;
+        d    += w;
+        y[r] += alpha*Ax[k] * x[j];
+      }
+    }
+  }
+}
+
+void csc_packed_Atxpy(const OSQPCscMatrix* A,
+                      const csc_packed*    Z,
+                      const OSQPFloat*     x,
+                            OSQPFloat*     y,
+                            OSQPFloat      alpha,
+                            OSQPFloat      beta) {
+
+  OSQPInt    j, k, end, r, w;
+  OSQPInt    first = 0;
+  OSQPInt*   Ap = A->p;
+  OSQPInt    An = A->n;
+  OSQPFloat* Ax = A->x;
+
+  const unsigned char* d = Z->data;
+
+  scale_y(y, beta, An);
+
+  // if A is empty or alpha = 0
+  if (Ap[An] == 0 || alpha == 0.0) return;
+
+  for (j = 0; j < An; j++) {
+    k   = Ap[j];
+    end = Ap[j+1];
+    if (k == end) continue;
+
+    w      = Z->width[j];
+    first += read_first(d, w);
+    r      = first;
+    d     += w;
+    y[j]  += alpha*Ax[k] * x[r];
+
+    if (w == 1) {
+      for (k++; k < end; k++, d++) {
+        r    += d[0] + 1;
+        y[j] += alpha*Ax[k] * x[r];
+      }
+    }
+    else {
+      for (k++; k < end; k++) {
+        r    += read_gap(d, w) + 1;
+        d    += w;
+        y[j] += alpha*Ax[k] * x[r];
+      }
+    }
+  }
+}
+
+void csc_packed_Axpy_sym_triu(const OSQPCscMatrix* A,
+                              const csc_packed*    Z,
+                              const OSQPFloat*     x,
+                                    OSQPFloat*     y,
+                                    OSQPFloat      alpha,
+                                    OSQPFloat      beta) {
+
+  OSQPInt    j, k, end, r, w;
+  OSQPInt    first = 0;
+  OSQPInt*   Ap = A->p;
+  OSQPInt    An = A->n;
+  OSQPFloat* Ax = A->x;
+
+  const unsigned char* d = Z->data;
+
+  scale_y(y, beta, A->m);
+
+  // if A is empty or zero
+  if (Ap[An] == 0 || alpha == 0.0) return;
+
+  for (j = 0; j < An; j++) {
+    k   = Ap[j];
+    end = Ap[j+1];
+    if (k == end) continue;
+
+    w      = Z->width[j];
+    first += read_first(d, w);
+    r      = first;
+    d     += w;
+
+    for (;;) {
+      y[r] += alpha*Ax[k] * x[j];
+      if (r != j) {
+        y[j] += alpha*Ax[k] * x[r];
+      }
+      if (++k == end) break;
+      r += (w == 1 ? d[0] : read_gap(d, w)) + 1;
+      d += w;
+    }
+  }
+}
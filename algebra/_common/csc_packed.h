@@ -0,0 +1,83 @@
+#ifndef CSC_PACKED_H
+# define CSC_PACKED_H
+
+
+# include "osqp_api_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Row indices of a CSC matrix, delta-encoded in 1, 2 or 4-byte entries.
+ *
+ * Every entry of column j is width[j] bytes wide. The first entry of a column
+ * is the difference between its first row and the first row of the previous
+ * nonempty column (signed), the others are the gaps to the previous row minus
+ * one (unsigned). The columns are stored back to back, so the products find
+ * them by walking the columns in order and need no column offsets.
+ *
+ * The values stay in the CSC matrix, so updates of the values do not touch
+ * the encoding.
+ */
+typedef struct {
+  unsigned char* width; ///< bytes per entry of each column (size n)
+  unsigned char* data;  ///< encoded row indices
+  OSQPInt        size;  ///< number of bytes in data
+} csc_packed;
+
+/**
+ * Whether the row indices of A can be packed: the rows of every column must
+ * be strictly increasing and the deltas must fit in 4 bytes.
+ * @param  A CSC matrix
+ * @return   1 if csc_packed_new() can encode A, 0 otherwise
+ */
+OSQPInt csc_packable(const OSQPCscMatrix* A);
+
+/**
+ * Pack the row indices of A, which must be packable.
+ * @param  A CSC matrix
+ * @return   Packed indices, OSQP_NULL if out of memory
+ */
+csc_packed* csc_packed_new(const OSQPCscMatrix* A);
+
+/**
+ * Free packed indices.
+ * @param  Z Packed indices
+ */
+void csc_packed_free(csc_packed* Z);
+
+/*
+ * The products below give the same results, to the last bit, as csc_Axpy,
+ * csc_Atxpy and csc_Axpy_sym_triu with the row indices of A.
+ */
+
+//y = alpha*A*x + beta*y, with the row indices of A in Z
+void csc_packed_Axpy(const OSQPCscMatrix* A,
+                     const csc_packed*    Z,
+                     const OSQPFloat*     x,
+                           OSQPFloat*     y,
+                           OSQPFloat      alpha,
+                           OSQPFloat      beta);
+
+//y = alpha*A^T*x + beta*y, with the row indices of A in Z
+void csc_packed_Atxpy(const OSQPCscMatrix* A,
+                      const csc_packed*    Z,
+                      const OSQPFloat*     x,
+                            OSQPFloat*     y,
+                            OSQPFloat      alpha,
+                            OSQPFloat      beta);
+
+//y = alpha*A*x + beta*y, where A is symmetric and only triu is stored, with the row indices of A in Z
+void csc_packed_Axpy_sym_triu(const OSQPCscMatrix* A,
+                              const csc_packed*    Z,
+                              const OSQPFloat*     x,
+                                    OSQPFloat*     y,
+                                    OSQPFloat      alpha,
+                                    OSQPFloat      beta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef CSC_PACKED_H */
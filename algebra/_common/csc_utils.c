@@ -114,9 +114,9 @@ OSQPCscMatrix* csc_spalloc(OSQPInt m,
   A->nzmax = nzmax = c_max(nzmax, 0);
   A->nz    = triplet ? 0 : -1;         /* allocate triplet or comp.col */
   A->p     = csc_malloc(triplet ? nzmax : n + 1, sizeof(OSQPInt));
-  A->i     = values ? csc_malloc(nzmax,  sizeof(OSQPInt)) : OSQP_NULL;
+  A->i     = csc_malloc(nzmax,  sizeof(OSQPInt));    /* the pattern is always allocated */
   A->x     = values ? csc_malloc(nzmax,  sizeof(OSQPFloat)) : OSQP_NULL;
-  if (!A->p || (values && !A->i ) || (values && !A->x)){
+  if (!A->p || !A->i || (values && !A->x)){
     csc_spfree(A);
     return OSQP_NULL;
   } else return A;
@@ -25,7 +25,7 @@ OSQPInt csc_is_eq(OSQPCscMatrix* A, OSQPCscMatrix* B, OSQPFloat tol);
  * @param  m       First dimension
  * @param  n       Second dimension
  * @param  nzmax   Maximum number of nonzero elements
- * @param  values  Allocate values (0/1)
+ * @param  values  Allocate values (0/1); the row indices are always allocated
  * @param  triplet Allocate CSC or triplet format matrix (1/0)
  * @return         Matrix pointer
  */
@@ -97,7 +97,7 @@ static void _kkt_colcount_block(OSQPCscMatrix* K,
 
 
 //populate values from M using the K colptr as indicator of
-//next fill location in each row
+//next fill location in each row (only the pattern if K has no values)
 static void _kkt_fill_block(OSQPCscMatrix* K,
                             OSQPCscMatrix* M,
                             OSQPInt*       MtoKKT,
@@ -119,7 +119,7 @@ static void _kkt_fill_block(OSQPCscMatrix* K,
 
             dest       = K->p[col]++;
             K->i[dest] = row;
-            K->x[dest] = M->x[jj];
+            if (K->x) K->x[dest] = M->x[jj];
             if(MtoKKT != OSQP_NULL){MtoKKT[jj] = dest;}
         }
     }
@@ -140,7 +140,7 @@ static void _kkt_fill_diag_zeros(OSQPCscMatrix* K,
         col         = j + offset;
         dest        = K->p[col];
         K->i[dest]  = col;
-        K->x[dest]  = 0.0;  //structural zero
+        if (K->x) K->x[dest] = 0.0;  //structural zero
         K->p[col]++;
         if(rhotoKKT != OSQP_NULL){rhotoKKT[j] = dest;}
     }
@@ -163,7 +163,7 @@ static void _kkt_fill_missing_diag_zeros(OSQPCscMatrix* K,
         {
             dest           = K->p[j + offset];
             K->i[dest]  = j + offset;
-            K->x[dest]  = 0.0;  //structural zero
+            if (K->x) K->x[dest] = 0.0;  //structural zero
             K->p[j]++;;
         }
     }
@@ -346,6 +346,24 @@ OSQPCscMatrix* form_KKT(OSQPCscMatrix* P,
   return KKT;
 }
 
+OSQPCscMatrix* form_KKT_pattern(const OSQPCscMatrix* P,
+                                const OSQPCscMatrix* A) {
+
+  OSQPInt        n = P->n;
+  OSQPInt        m = A->m;
+  OSQPCscMatrix* KKT;
+
+  // Same entries as form_KKT, without the values
+  KKT = csc_spalloc(n + m, n + m,
+                    P->p[n] + n - _count_diagonal_entries((OSQPCscMatrix*)P) + A->p[n] + m,
+                    0, 0);
+  if (!KKT) return OSQP_NULL;
+
+  _kkt_assemble_csc(KKT, OSQP_NULL, OSQP_NULL, OSQP_NULL, (OSQPCscMatrix*)P, (OSQPCscMatrix*)A);
+
+  return KKT;
+}
+
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
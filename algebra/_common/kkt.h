@@ -44,6 +44,17 @@ extern "C" {
                          OSQPInt*       PtoKKT,
                          OSQPInt*       AtoKKT,
                          OSQPInt*       param2toKKT);
+
+/**
+ * Form the pattern of the KKT matrix of form_KKT in CSC format, without the
+ * values, which are not read
+ *
+ * @param  P  data for P in csc format (triu form)
+ * @param  A  data for A in csc format
+ * @return    KKT pattern (upper triangular, no values), OSQP_NULL if out of memory
+ */
+ OSQPCscMatrix* form_KKT_pattern(const OSQPCscMatrix* P,
+                                 const OSQPCscMatrix* A);
 # endif // ifndef OSQP_EMBEDDED_MODE
 
 
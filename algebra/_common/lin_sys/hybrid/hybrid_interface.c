@@ -0,0 +1,555 @@
+#include "glob_opts.h"
+#include "algebra_impl.h"
+#include "algebra_vector.h"
+#include "printing.h"
+#include "reduced_kkt.h"
+
+#include "hybrid_interface.h"
+
+
+/*
+ * Adaptive CG tolerance: a fraction of the ADMM residuals, never increasing
+ * between iterations (same rule as the MKL CG solver)
+ */
+static OSQPFloat cg_compute_tolerance(OSQPInt    admm_iter,
+                                      OSQPFloat  rhs_norm,
+                                      OSQPFloat  scaled_prim_res,
+                                      OSQPFloat  scaled_dual_res,
+                                      OSQPFloat  reduction_factor,
+                                      OSQPFloat* eps_prev) {
+
+  OSQPFloat eps = 1.0;
+
+  if (admm_iter == 1) {
+    // In case rhs = 0.0 we don't want to set eps_prev to 0.0
+    if (rhs_norm < OSQP_CG_TOL_MIN)
+      *eps_prev = 1.0;
+    else
+      *eps_prev = rhs_norm * reduction_factor;
+
+    // Return early since scaled_prim_res and scaled_dual_res are meaningless before the first ADMM iteration
+    return *eps_prev;
+  }
+
+  eps = reduction_factor * c_sqrt(scaled_prim_res * scaled_dual_res);
+  eps = c_max(c_min(eps, (*eps_prev)), OSQP_CG_TOL_MIN);
+  *eps_prev = eps;
+
+  return eps;
+}
+
+
+static void cg_update_precond(hybrid_solver* s) {
+
+  switch(s->precond_type) {
+  /* No preconditioner, just initialize the inverse vector to all 1s */
+  case OSQP_NO_PRECONDITIONER:
+    OSQPVectorf_set_scalar(s->precond_inv, 1.0);
+    break;
+
+  /* Diagonal preconditioner computation */
+  case OSQP_DIAGONAL_PRECONDITIONER:
+    reduced_kkt_diagonal(s->P, s->A, s->rho_vec, s->sigma, s->precond, s->precond_inv);
+    break;
+  }
+}
+
+
+#ifdef OSQP_ENABLE_THREADS
+
+/* Data shared with the factorization thread */
+struct hybrid_fact_job {
+  pthread_mutex_t lock;         ///< protects done and cancel
+  OSQPInt         done;         ///< the thread has finished
+  OSQPInt         cancel;       ///< the solver is being freed, skip the numeric factorization
+  OSQPInt         status;       ///< exitflag of the factorization
+  qdldl_solver*   fact;         ///< factorization built by the thread
+  OSQPMatrix*     P;            ///< copy of P read by the thread
+  OSQPMatrix*     A;            ///< copy of A read by the thread
+  OSQPVectorf*    rho_vec;      ///< copy of rho_vec (OSQP_NULL for scalar rho)
+  OSQPSettings    settings;     ///< copy of the settings
+};
+
+
+static void free_fact_job(struct hybrid_fact_job* job) {
+  if (job->fact)    free_linsys_solver_qdldl(job->fact);
+  if (job->P)       OSQPMatrix_free(job->P);
+  if (job->A)       OSQPMatrix_free(job->A);
+  if (job->rho_vec) OSQPVectorf_free(job->rho_vec);
+  c_free(job);
+}
+
+
+// Factor the KKT matrix from the private copies of the problem data
+static void* factor_thread(void* arg) {
+
+  struct hybrid_fact_job* job  = (struct hybrid_fact_job*)arg;
+  qdldl_solver*           fact = OSQP_NULL;
+  qdldl_symbolic*         sym  = OSQP_NULL;
+  OSQPInt                 status, cancel;
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  // L and the workspace are placed like the buffers of the setup
+  osqp_placement_begin((int)job->settings.huge_pages, (int)job->settings.numa_node,
+                       job->settings.realtime != 0, (int)job->settings.lock_memory);
+#endif
+
+  // Without the analysis the KKT matrix is analysed when it is factored
+  if (qdldl_symbolic_new(&sym, job->P->csc, job->A->csc)) sym = OSQP_NULL;
+
+  // The numeric factorization is the long part; a freed solver does not wait for it
+  pthread_mutex_lock(&job->lock);
+  cancel = job->cancel;
+  pthread_mutex_unlock(&job->lock);
+
+  status = OSQP_LINSYS_SOLVER_INIT_ERROR;
+  if (!cancel)
+    status = init_linsys_solver_qdldl_analysed(&fact, job->P, job->A, job->rho_vec, &job->settings, sym);
+  qdldl_symbolic_free(sym);
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  osqp_placement_end();
+#endif
+
+  pthread_mutex_lock(&job->lock);
+  job->fact   = fact;
+  job->status = status;
+  job->done   = 1;
+  pthread_mutex_unlock(&job->lock);
+
+  return OSQP_NULL;
+}
+
+
+// Start building the factorization; without a thread it is built when needed
+static void start_factorization(hybrid_solver*     s,
+                                const OSQPVectorf* rho_vec) {
+
+  struct hybrid_fact_job* job = c_calloc(1, sizeof(struct hybrid_fact_job));
+
+  if (!job) return;
+
+  // The thread works on copies so the data can be updated while it runs
+  job->settings = s->settings;
+  job->P        = OSQPMatrix_copy_new(s->P);
+  job->A        = OSQPMatrix_copy_new(s->A);
+  if (rho_vec) job->rho_vec = OSQPVectorf_copy_new(rho_vec);
+
+  if (!job->P || !job->A || (rho_vec && !job->rho_vec) ||
+      pthread_mutex_init(&job->lock, OSQP_NULL)) {
+    free_fact_job(job);
+    return;
+  }
+
+  if (pthread_create(&s->thread, OSQP_NULL, &factor_thread, job)) {
+    pthread_mutex_destroy(&job->lock);
+    free_fact_job(job);
+    return;
+  }
+
+  s->job     = job;
+  s->running = 1;
+}
+
+
+static OSQPInt factorization_ready(hybrid_solver* s) {
+
+  OSQPInt done;
+
+  if (!s->running) return 0;
+
+  pthread_mutex_lock(&s->job->lock);
+  done = s->job->done;
+  pthread_mutex_unlock(&s->job->lock);
+
+  return done;
+}
+
+
+// Wait for the thread and take over its factorization
+static OSQPInt join_factorization(hybrid_solver* s) {
+
+  OSQPInt exitflag;
+
+  pthread_join(s->thread, OSQP_NULL);
+  pthread_mutex_destroy(&s->job->lock);
+  s->running = 0;
+
+  exitflag       = s->job->status;
+  s->direct      = s->job->fact;
+  s->job->fact   = OSQP_NULL;
+  free_fact_job(s->job);
+  s->job = OSQP_NULL;
+
+  return exitflag;
+}
+
+
+// Stop the thread before its numeric factorization if it has not reached it,
+// and wait for it
+static void cancel_factorization(hybrid_solver* s) {
+
+  pthread_mutex_lock(&s->job->lock);
+  s->job->cancel = 1;
+  pthread_mutex_unlock(&s->job->lock);
+
+  join_factorization(s);
+}
+
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
+
+// Make the factorization available, waiting for it or building it now
+static OSQPInt factor_kkt(hybrid_solver* s) {
+
+  OSQPInt      exitflag;
+  OSQPSettings settings;
+
+#ifdef OSQP_ENABLE_THREADS
+  if (s->running) {
+    exitflag = join_factorization(s);
+
+    // Point the factorization at the solver data instead of the copies
+    if (s->direct) {
+      s->direct->Pcsc = s->P->csc;
+      s->direct->Acsc = s->A->csc;
+    }
+
+    // rho was updated while the factorization was being built
+    if (!exitflag && s->rho_changed)
+      exitflag = s->direct->update_rho_vec(s->direct, s->rho_is_vec ? s->rho_vec : OSQP_NULL, s->rho_sc);
+  }
+  else
+#endif
+  {
+    settings     = s->settings;
+    settings.rho = s->rho_sc;
+    exitflag = init_linsys_solver_qdldl(&s->direct, s->P, s->A,
+                                        s->rho_is_vec ? s->rho_vec : OSQP_NULL, &settings, 0);
+  }
+  s->rho_changed = 0;
+
+  if (exitflag) {
+    c_eprint("KKT factorization failed, continuing with CG");
+    if (s->direct) free_linsys_solver_qdldl(s->direct);
+    s->direct      = OSQP_NULL;
+    s->fact_failed = 1;
+  }
+
+  return exitflag;
+}
+
+
+// Preconditioned CG on the reduced KKT system, warm started from the last solution
+static OSQPInt solve_cg(hybrid_solver* s,
+                        OSQPVectorf*   b,
+                        OSQPInt        admm_iter) {
+
+  OSQPInt   iter     = 0;
+  OSQPFloat rhs_norm = 0.0;
+  OSQPFloat res_norm = 0.0;
+  OSQPFloat eps      = 1.0;
+  OSQPFloat rd, rd_prev, pKp, alpha;
+
+  //Point our subviews at the OSQP RHS
+  OSQPVectorf_view_update(s->r1, b,    0, s->n);
+  OSQPVectorf_view_update(s->r2, b, s->n, s->m);
+
+  // Compute the RHS for the CG solve and its norm
+  reduced_kkt_compute_rhs(s->A, s->rho_vec, s->r1, s->r2, s->ywork);
+  rhs_norm = OSQPVectorf_norm_inf(s->r1);
+
+  if (admm_iter == 1) {
+    // On the first iteration, set reduction_factor to its default value
+    s->reduction_factor = s->tol_fraction;
+  } else if (s->cg_zero_iters >= s->reduction_interval) {
+    // Tighten the tolerance if CG is consistently never having to actually run
+    s->reduction_factor /= 2;
+    s->cg_zero_iters = 0;
+  }
+
+  eps = cg_compute_tolerance(admm_iter, rhs_norm,
+                             *(s->scaled_prim_res), *(s->scaled_dual_res),
+                             s->reduction_factor, &(s->eps_prev));
+
+  // r = rhs - K*x
+  reduced_kkt_mv_times(s->P, s->A, s->rho_vec, s->sigma, s->x, s->Kp, s->ywork);
+  OSQPVectorf_minus(s->r, s->r1, s->Kp);
+  res_norm = OSQPVectorf_norm_inf(s->r);
+
+  if (res_norm >= eps) {
+    OSQPVectorf_ew_prod(s->d, s->precond_inv, s->r);
+    OSQPVectorf_copy(s->p, s->d);
+    rd = OSQPVectorf_dot_prod(s->r, s->d);
+
+    while (iter < s->max_iter) {
+      reduced_kkt_mv_times(s->P, s->A, s->rho_vec, s->sigma, s->p, s->Kp, s->ywork);
+      pKp = OSQPVectorf_dot_prod(s->p, s->Kp);
+      if (pKp <= 0.0) break;   // the reduced KKT matrix is not positive definite
+
+      alpha = rd / pKp;
+      OSQPVectorf_add_scaled(s->x, 1.0, s->x,  alpha, s->p);
+      OSQPVectorf_add_scaled(s->r, 1.0, s->r, -alpha, s->Kp);
+      iter++;
+
+      res_norm = OSQPVectorf_norm_inf(s->r);
+      if (res_norm < eps) break;
+
+      OSQPVectorf_ew_prod(s->d, s->precond_inv, s->r);
+      rd_prev = rd;
+      rd = OSQPVectorf_dot_prod(s->r, s->d);
+      OSQPVectorf_add_scaled(s->p, 1.0, s->d, rd / rd_prev, s->p);
+    }
+
+    // CG could not reach the tolerance: factor the KKT matrix for the next solve
+    if (res_norm >= eps) s->switch_pending = 1;
+  }
+
+  // Record if no CG iterations were performed
+  if (iter == 0)
+    s->cg_zero_iters++;
+  else
+    s->cg_zero_iters = 0;
+
+  //OSQP wants us to return (x,Ax) in place
+  OSQPVectorf_copy(s->r1, s->x);
+  OSQPMatrix_Axpy(s->A, s->x, s->r2, 1.0, 0.0);
+
+  return 0;
+}
+
+
+// Initialize the hybrid solver
+OSQPInt init_linsys_solver_hybrid(hybrid_solver**     sp,
+                                  const OSQPMatrix*   P,
+                                  const OSQPMatrix*   A,
+                                  const OSQPVectorf*  rho_vec,
+                                  const OSQPSettings* settings,
+                                  OSQPFloat*          scaled_prim_res,
+                                  OSQPFloat*          scaled_dual_res) {
+
+  OSQPInt n = OSQPMatrix_get_n(P);
+  OSQPInt m = OSQPMatrix_get_m(A);
+
+  hybrid_solver* s = c_calloc(1, sizeof(hybrid_solver));
+  *sp = s;
+  if (!s) return OSQP_MEM_ALLOC_ERROR;
+
+  // Link Functions
+  s->name            = &name_hybrid;
+  s->solve           = &solve_linsys_hybrid;
+  s->update_settings = &update_settings_linsys_solver_hybrid;
+  s->warm_start      = &warm_start_linsys_solver_hybrid;
+  s->free            = &free_linsys_solver_hybrid;
+  s->update_matrices = &update_linsys_solver_matrices_hybrid;
+  s->update_rho_vec  = &update_linsys_solver_rho_vec_hybrid;
+
+  // Assign type
+  s->type = OSQP_HYBRID_SOLVER;
+
+  // Operators only provide products
+  s->cg_only = P->op || A->op;
+
+#ifdef OSQP_ENABLE_THREADS
+  // The factorization is built next to the ADMM iterations
+  s->nthreads = s->cg_only ? 1 : 2;
+#else
+  s->nthreads = 1;
+#endif
+
+  //Just hold on to pointers to the problem data
+  s->P     = *(OSQPMatrix**)(&P);
+  s->A     = *(OSQPMatrix**)(&A);
+  s->n     = n;
+  s->m     = m;
+  s->sigma = settings->sigma;
+
+  s->scaled_prim_res = scaled_prim_res;
+  s->scaled_dual_res = scaled_dual_res;
+
+  // Settings read when the factorization is built
+  s->settings = *settings;
+
+  // CG parameters
+  s->precond_type       = settings->cg_precond;
+  s->max_iter           = settings->cg_max_iter;
+  s->reduction_interval = settings->cg_tol_reduction;
+  s->tol_fraction       = settings->cg_tol_fraction;
+  s->reduction_factor   = settings->cg_tol_fraction;
+
+  // CG vectors (x starts from zero)
+  s->x           = OSQPVectorf_calloc(n);
+  s->r           = OSQPVectorf_malloc(n);
+  s->d           = OSQPVectorf_malloc(n);
+  s->p           = OSQPVectorf_malloc(n);
+  s->Kp          = OSQPVectorf_malloc(n);
+  s->precond     = OSQPVectorf_malloc(n);
+  s->precond_inv = OSQPVectorf_malloc(n);
+  s->ywork       = OSQPVectorf_malloc(m);
+  s->rho_vec     = OSQPVectorf_malloc(m);
+
+  //make subviews for the rhs. OSQP passes a different RHS pointer
+  //at every iteration, so they are updated at every solve
+  s->r1 = OSQPVectorf_view(s->x, 0, 0);
+  s->r2 = OSQPVectorf_view(s->x, 0, 0);
+
+  if (!s->x || !s->r || !s->d || !s->p || !s->Kp || !s->precond || !s->precond_inv ||
+      !s->ywork || !s->rho_vec || !s->r1 || !s->r2)
+    return OSQP_MEM_ALLOC_ERROR;
+
+  // Scalar rho is stored in every entry of rho_vec for the reduced KKT products
+  s->rho_is_vec = rho_vec ? 1 : 0;
+  s->rho_sc     = settings->rho;
+  if (rho_vec)
+    OSQPVectorf_copy(s->rho_vec, rho_vec);
+  else
+    OSQPVectorf_set_scalar(s->rho_vec, settings->rho);
+
+  cg_update_precond(s);
+
+#ifdef OSQP_ENABLE_THREADS
+  if (!s->cg_only) start_factorization(s, rho_vec);
+#endif
+
+  return 0;
+}
+
+
+const char* name_hybrid(hybrid_solver* s) {
+  if (s->cg_only) {
+    switch(s->precond_type) {
+    case OSQP_NO_PRECONDITIONER:
+      return "CG on operators (no preconditioner)";
+    case OSQP_DIAGONAL_PRECONDITIONER:
+      return "CG on operators (diagonal preconditioner)";
+    }
+  }
+
+  switch(s->precond_type) {
+  case OSQP_NO_PRECONDITIONER:
+    return "Hybrid - CG (no preconditioner) then QDLDL";
+  case OSQP_DIAGONAL_PRECONDITIONER:
+    return "Hybrid - CG (diagonal preconditioner) then QDLDL";
+  }
+
+  return "Hybrid - CG then QDLDL";
+}
+
+
+OSQPInt solve_linsys_hybrid(hybrid_solver* s,
+                            OSQPVectorf*   b,
+                            OSQPInt        admm_iter) {
+
+  // Switch once the factorization is ready or CG could not keep up. While the
+  // thread is still working, waiting for it costs more than inexact CG steps.
+  if (!s->direct && !s->fact_failed && !s->cg_only) {
+#ifdef OSQP_ENABLE_THREADS
+    if (s->running) s->switch_pending = factorization_ready(s);
+#endif
+    if (s->switch_pending) {
+      factor_kkt(s);
+      s->switch_pending = 0;
+    }
+  }
+
+  if (s->direct) return s->direct->solve(s->direct, b, admm_iter);
+
+  return solve_cg(s, b, admm_iter);
+}
+
+
+void update_settings_linsys_solver_hybrid(hybrid_solver*      s,
+                                          const OSQPSettings* settings) {
+
+  // New preconditioner type requested
+  if (s->precond_type != settings->cg_precond) {
+    s->precond_type = settings->cg_precond;
+    cg_update_precond(s);
+  }
+
+  s->max_iter           = settings->cg_max_iter;
+  s->reduction_interval = settings->cg_tol_reduction;
+  s->tol_fraction       = settings->cg_tol_fraction;
+}
+
+
+void warm_start_linsys_solver_hybrid(hybrid_solver*     s,
+                                     const OSQPVectorf* x) {
+  // The ADMM iterate is a good starting point for the next CG solve
+  OSQPVectorf_copy(s->x, x);
+}
+
+
+OSQPInt update_linsys_solver_matrices_hybrid(hybrid_solver*    s,
+                                             const OSQPMatrix* P,
+                                             const OSQPInt*    Px_new_idx,
+                                             OSQPInt           P_new_n,
+                                             const OSQPMatrix* A,
+                                             const OSQPInt*    Ax_new_idx,
+                                             OSQPInt           A_new_n) {
+  s->P = *(OSQPMatrix**)(&P);
+  s->A = *(OSQPMatrix**)(&A);
+
+  cg_update_precond(s);
+
+#ifdef OSQP_ENABLE_THREADS
+  // The factorization is updated in place, so it has to be finished first
+  if (s->running) factor_kkt(s);
+#endif
+
+  if (s->direct)
+    return s->direct->update_matrices(s->direct, P, Px_new_idx, P_new_n, A, Ax_new_idx, A_new_n);
+
+  // New matrices may factor even if the old ones did not
+  s->fact_failed = 0;
+
+  return 0;
+}
+
+
+OSQPInt update_linsys_solver_rho_vec_hybrid(hybrid_solver*     s,
+                                            const OSQPVectorf* rho_vec,
+                                            OSQPFloat          rho_sc) {
+  s->rho_sc = rho_sc;
+  if (rho_vec)
+    OSQPVectorf_copy(s->rho_vec, rho_vec);
+  else
+    OSQPVectorf_set_scalar(s->rho_vec, rho_sc);
+
+  cg_update_precond(s);
+
+  if (s->direct) return s->direct->update_rho_vec(s->direct, rho_vec, rho_sc);
+
+#ifdef OSQP_ENABLE_THREADS
+  // Applied to the factorization when it is taken over
+  if (s->running) s->rho_changed = 1;
+#endif
+
+  return 0;
+}
+
+
+void free_linsys_solver_hybrid(hybrid_solver* s) {
+
+  if (!s) return;
+
+#ifdef OSQP_ENABLE_THREADS
+  if (s->running) cancel_factorization(s);
+#endif
+
+  if (s->direct) free_linsys_solver_qdldl(s->direct);
+
+  OSQPVectorf_free(s->x);
+  OSQPVectorf_free(s->r);
+  OSQPVectorf_free(s->d);
+  OSQPVectorf_free(s->p);
+  OSQPVectorf_free(s->Kp);
+  OSQPVectorf_free(s->precond);
+  OSQPVectorf_free(s->precond_inv);
+  OSQPVectorf_free(s->ywork);
+  OSQPVectorf_free(s->rho_vec);
+  OSQPVectorf_view_free(s->r1);
+  OSQPVectorf_view_free(s->r2);
+
+  c_free(s);
+}
@@ -0,0 +1,226 @@
+#ifndef HYBRID_INTERFACE_H
+#define HYBRID_INTERFACE_H
+
+
+#include "osqp.h"
+#include "types.h"  //OSQPMatrix and OSQPVector[fi] types
+#include "qdldl_interface.h"
+
+#ifdef OSQP_ENABLE_THREADS
+# include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hybrid solver structure
+ *
+ * The ADMM iterations start with a matrix-free preconditioned CG on the
+ * reduced KKT system. With threads, the QDLDL factorization of the full KKT
+ * matrix is built in the background and used as soon as it is ready. Without
+ * them, it is built once a CG solve cannot reach its tolerance within
+ * cg_max_iter iterations. The factorization is kept from then on.
+ *
+ * Problems given as operators have no KKT matrix to factor and stay with CG.
+ */
+typedef struct hybrid hybrid_solver;
+
+#ifdef OSQP_ENABLE_THREADS
+struct hybrid_fact_job;
+#endif
+
+struct hybrid {
+    enum osqp_linsys_solver_type type;
+
+    /**
+     * @name Functions
+     * @{
+     */
+    const char* (*name)(struct hybrid* s);
+
+    OSQPInt (*solve)(struct hybrid*      self,
+                            OSQPVectorf* b,
+                            OSQPInt      admm_iter);
+
+    void (*update_settings)(struct hybrid*       self,
+                            const  OSQPSettings* settings);
+
+    void (*warm_start)(struct hybrid*      self,
+                       const  OSQPVectorf* x);
+
+    OSQPInt (*adjoint_derivative)(struct hybrid* self);
+
+    void (*free)(struct hybrid* self); ///< Free workspace
+
+    OSQPInt (*solve_block)(struct hybrid*      self,
+                                  OSQPVectorf** b,
+                                  OSQPInt       k,
+                                  OSQPInt       admm_iter);
+
+    OSQPInt (*polish_factor)(struct hybrid*            self,
+                                    const OSQPVectori* active_flags);
+
+    OSQPInt (*update_matrices_rho_vec)(struct hybrid*      self,
+                                       const  OSQPMatrix*  P,
+                                       const  OSQPInt*     Px_new_idx,
+                                              OSQPInt      P_new_n,
+                                       const  OSQPMatrix*  A,
+                                       const  OSQPInt*     Ax_new_idx,
+                                              OSQPInt      A_new_n,
+                                       const  OSQPVectorf* rho_vec,
+                                              OSQPFloat    rho_sc);
+
+    OSQPInt (*update_matrices)(struct hybrid*     self,
+                               const  OSQPMatrix* P,
+                               const  OSQPInt*    Px_new_idx,
+                                      OSQPInt     P_new_n,
+                               const  OSQPMatrix* A,
+                               const  OSQPInt*    Ax_new_idx,
+                                      OSQPInt     A_new_n);   ///< Update solver matrices
+
+    OSQPInt (*update_rho_vec)(struct hybrid*      self,
+                              const  OSQPVectorf* rho_vec,
+                                     OSQPFloat    rho_sc);    ///< Update rho_vec parameter
+
+    OSQPInt nthreads;
+
+    /** @} */
+
+    /**
+     * @name Attributes
+     * @{
+     */
+    OSQPMatrix*   P;              ///< matrix P of the solver (just a pointer)
+    OSQPMatrix*   A;              ///< matrix A of the solver (just a pointer)
+    OSQPVectorf*  rho_vec;        ///< current rho values (scalar rho is stored in every entry)
+    OSQPFloat     rho_sc;         ///< current scalar rho
+    OSQPInt       rho_is_vec;     ///< whether the solver uses a rho vector
+    OSQPFloat     sigma;          ///< scalar parameter
+    OSQPFloat*    scaled_prim_res; ///< primal residual of the solver (just a pointer)
+    OSQPFloat*    scaled_dual_res; ///< dual residual of the solver (just a pointer)
+    OSQPInt       n;              ///< number of QP variables
+    OSQPInt       m;              ///< number of QP constraints
+    OSQPSettings  settings;       ///< settings used to build the factorization (not updated)
+
+    // CG on the reduced KKT system
+    osqp_precond_type precond_type; ///< preconditioner to use
+    OSQPInt       max_iter;       ///< maximum number of CG iterations per solve
+    OSQPInt       reduction_interval; ///< consecutive zero-iteration solves before the tolerance is halved
+    OSQPFloat     tol_fraction;   ///< CG tolerance (fraction of the ADMM residuals)
+    OSQPFloat     reduction_factor; ///< current tolerance reduction factor
+    OSQPFloat     eps_prev;       ///< tolerance of the previous solve
+    OSQPInt       cg_zero_iters;  ///< consecutive solves that needed no CG iterations
+    OSQPVectorf*  x;              ///< CG iterate, kept to warm start the next solve
+    OSQPVectorf*  r;              ///< CG residual
+    OSQPVectorf*  d;              ///< preconditioned residual
+    OSQPVectorf*  p;              ///< CG search direction
+    OSQPVectorf*  Kp;             ///< reduced KKT matrix times p
+    OSQPVectorf*  precond_inv;    ///< inverse of the diagonal preconditioner
+    OSQPVectorf*  precond;        ///< diagonal of the reduced KKT matrix
+    OSQPVectorf*  ywork;          ///< workspace of size m
+    OSQPVectorf*  r1;             ///< view of the upper part of the right-hand side
+    OSQPVectorf*  r2;             ///< view of the lower part of the right-hand side
+
+    // LDL factorization of the full KKT matrix
+    qdldl_solver* direct;         ///< factorization in use, OSQP_NULL while solving with CG
+    OSQPInt       switch_pending; ///< switch on the next solve
+    OSQPInt       fact_failed;    ///< the factorization failed, keep using CG
+    OSQPInt       rho_changed;    ///< rho changed while the factorization was being built
+    OSQPInt       cg_only;        ///< P or A is an operator, never factor
+
+#ifdef OSQP_ENABLE_THREADS
+    // Background factorization
+    pthread_t       thread;       ///< thread running the factorization
+    OSQPInt         running;      ///< a factorization thread has been started and not joined
+    struct hybrid_fact_job* job;  ///< data shared with the thread
+#endif
+
+    /** @} */
+};
+
+
+/**
+ * Initialize the hybrid solver and start the KKT factorization
+ *
+ * @param  s               Pointer to a private structure
+ * @param  P               Objective function matrix (upper triangular form)
+ * @param  A               Constraints matrix
+ * @param  rho_vec         Algorithm parameter (OSQP_NULL for scalar rho)
+ * @param  settings        Solver settings
+ * @param  scaled_prim_res Pointer to the scaled primal residual of the solver
+ * @param  scaled_dual_res Pointer to the scaled dual residual of the solver
+ * @return                 Exitflag for error (0 if no errors)
+ */
+OSQPInt init_linsys_solver_hybrid(hybrid_solver**     sp,
+                                  const OSQPMatrix*   P,
+                                  const OSQPMatrix*   A,
+                                  const OSQPVectorf*  rho_vec,
+                                  const OSQPSettings* settings,
+                                  OSQPFloat*          scaled_prim_res,
+                                  OSQPFloat*          scaled_dual_res);
+
+/**
+ * Get the user-friendly name of the hybrid solver.
+ * @return The user-friendly name
+ */
+const char* name_hybrid(hybrid_solver* s);
+
+/**
+ * Solve linear system and store result in b
+ * @param  s        Linear system solver structure
+ * @param  b        Right-hand side
+ * @return          Exitflag
+ */
+OSQPInt solve_linsys_hybrid(hybrid_solver* s,
+                            OSQPVectorf*   b,
+                            OSQPInt        admm_iter);
+
+void update_settings_linsys_solver_hybrid(hybrid_solver*      s,
+                                          const OSQPSettings* settings);
+
+void warm_start_linsys_solver_hybrid(hybrid_solver*     s,
+                                     const OSQPVectorf* x);
+
+/**
+ * Update linear system solver matrices. Waits for a factorization that is
+ * still being built, since it is updated in place.
+ * @param  s          Linear system solver structure
+ * @param  P          Matrix P
+ * @param  Px_new_idx elements of P to update,
+ * @param  P_new_n    number of elements to update
+ * @param  A          Matrix A
+ * @param  Ax_new_idx elements of A to update,
+ * @param  A_new_n    number of elements to update
+ * @return            Exitflag
+ */
+OSQPInt update_linsys_solver_matrices_hybrid(hybrid_solver*    s,
+                                             const OSQPMatrix* P,
+                                             const OSQPInt*    Px_new_idx,
+                                             OSQPInt           P_new_n,
+                                             const OSQPMatrix* A,
+                                             const OSQPInt*    Ax_new_idx,
+                                             OSQPInt           A_new_n);
+
+/**
+ * Update rho_vec parameter in linear system solver structure
+ * @param  s        Linear system solver structure
+ * @param  rho_vec  new rho_vec value
+ * @return          exitflag
+ */
+OSQPInt update_linsys_solver_rho_vec_hybrid(hybrid_solver*     s,
+                                            const OSQPVectorf* rho_vec,
+                                            OSQPFloat          rho_sc);
+
+/**
+ * Free linear system solver. A factorization that is still being built is
+ * stopped before its numeric phase if it has not started it, and waited for.
+ */
+void free_linsys_solver_hybrid(hybrid_solver* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef HYBRID_INTERFACE_H */
@@ -26,6 +26,13 @@ if(NOT qdldl_POPULATED)
   add_subdirectory(${qdldl_SOURCE_DIR} ${qdldl_BINARY_DIR} EXCLUDE_FROM_ALL)
 endif()
 
+# QDLDL doesn't include the OSQP headers, so prefix its symbols on the command line
+if(OSQP_SYMBOL_PREFIX)
+  foreach(sym QDLDL_etree QDLDL_factor QDLDL_solve QDLDL_Lsolve QDLDL_Ltsolve)
+    target_compile_definitions(qdldlobject PRIVATE "${sym}=${OSQP_SYMBOL_PREFIX}${sym}")
+  endforeach()
+endif()
+
 list(POP_BACK CMAKE_MESSAGE_INDENT)
 
 set_source_files_properties($<TARGET_OBJECTS:qdldlobject> PROPERTIES GENERATED 1)
@@ -40,6 +47,8 @@ file(
 
 set( LIN_SYS_QDLDL_NON_EMBEDDED_SRC_FILES
      ${AMD_SRC_FILES}
+     ${OSQP_ALGEBRA_ROOT}/_common/lin_sys/qdldl/qdldl_supernodal.h
+     ${OSQP_ALGEBRA_ROOT}/_common/lin_sys/qdldl/qdldl_supernodal.c
      )
 
 set( LIN_SYS_QDLDL_EMBEDDED_SRC_FILES
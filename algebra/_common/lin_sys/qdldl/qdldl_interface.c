@@ -7,6 +7,8 @@
 
 #ifndef OSQP_EMBEDDED_MODE
 #include "amd.h"
+#include "csc_math.h"
+#include "qdldl_supernodal.h"
 #endif
 
 #if OSQP_EMBEDDED_MODE != 1
@@ -28,6 +30,29 @@ void warm_start_linsys_solver_qdldl(qdldl_solver*      s,
   return;
 }
 
+#if OSQP_EMBEDDED_MODE != 1
+
+/**
+ * Numeric LDL factorization of the KKT matrix on the pattern of L, with the
+ * supernodal kernels when the solver found supernodes worth using them
+ * @return Number of positive elements of D, -1 if D has a zero element
+ */
+static QDLDL_int LDL_factor_numeric(qdldl_solver*        s,
+                                    const OSQPCscMatrix* KKT) {
+
+#ifndef OSQP_EMBEDDED_MODE
+    if (s->sn)
+        return qdldl_sn_factor(s->sn, KKT, s->L->p, s->L->i, s->L->x, s->D, s->Dinv);
+#endif
+
+    return QDLDL_factor(KKT->n, KKT->p, KKT->i, KKT->x,
+                        s->L->p, s->L->i, s->L->x,
+                        s->D, s->Dinv, s->Lnz,
+                        s->etree, s->bwork, s->iwork, s->fwork);
+}
+
+#endif
+
 #ifndef OSQP_EMBEDDED_MODE
 
 // Free LDL Factorization structure
@@ -45,6 +70,7 @@ void free_linsys_solver_qdldl(qdldl_solver* s) {
         if (s->bp)          c_free(s->bp);
         if (s->sol)         c_free(s->sol);
         if (s->rho_inv_vec) c_free(s->rho_inv_vec);
+        if (s->bk)          c_free(s->bk);
 
         // These are required for matrix updates
         if (s->KKT)       csc_spfree(s->KKT);
@@ -52,7 +78,8 @@ void free_linsys_solver_qdldl(qdldl_solver* s) {
         if (s->AtoKKT)    c_free(s->AtoKKT);
         if (s->rhotoKKT)  c_free(s->rhotoKKT);
 
-        if (s->adj)         c_free(s->adj);
+        if (s->adj)       csc_spfree(s->adj);
+        if (s->adjtoKKT)  c_free(s->adjtoKKT);
 
         // QDLDL workspace
         if (s->D)         c_free(s->D);
@@ -61,6 +88,13 @@ void free_linsys_solver_qdldl(qdldl_solver* s) {
         if (s->iwork)     c_free(s->iwork);
         if (s->bwork)     c_free(s->bwork);
         if (s->fwork)     c_free(s->fwork);
+        if (s->row_work)  c_free(s->row_work);
+
+        // Factorization not in use
+        if (s->pol_Lx)    c_free(s->pol_Lx);
+        if (s->pol_Dinv)  c_free(s->pol_Dinv);
+
+        qdldl_sn_free(s->sn);
         c_free(s);
 
     }
@@ -69,20 +103,34 @@ void free_linsys_solver_qdldl(qdldl_solver* s) {
 
 /**
  * Compute LDL factorization of matrix A
- * @param  A    Matrix to be factorized
- * @param  p    Private workspace
- * @param  nvar Number of QP variables
- * @return      exitstatus (0 is good)
+ * @param  A          Matrix to be factorized
+ * @param  p          Private workspace
+ * @param  nvar       Number of QP variables
+ * @param  supernodal Use the supernodal kernels if the factor has large supernodes
+ * @param  sym        Symbolic analysis of A, OSQP_NULL to compute the elimination tree here
+ * @return            exitstatus (0 is good)
  */
-static OSQPInt LDL_factor(OSQPCscMatrix* A,
-                          qdldl_solver*  p,
-                          OSQPInt        nvar) {
+static OSQPInt LDL_factor(OSQPCscMatrix*        A,
+                          qdldl_solver*         p,
+                          OSQPInt               nvar,
+                          OSQPInt               supernodal,
+                          const qdldl_symbolic* sym) {
 
+    OSQPInt i;
     OSQPInt sum_Lnz;
     OSQPInt factor_status;
 
     // Compute elimination tree
-    sum_Lnz = QDLDL_etree(A->n, A->p, A->i, p->iwork, p->Lnz, p->etree);
+    if (sym) {
+        for (i = 0; i < A->n; i++) {
+            p->etree[i] = sym->etree[i];
+            p->Lnz[i]   = sym->Lnz[i];
+        }
+        sum_Lnz = sym->sum_Lnz;
+    }
+    else {
+        sum_Lnz = QDLDL_etree(A->n, A->p, A->i, p->iwork, p->Lnz, p->etree);
+    }
 
     if (sum_Lnz < 0){
       // Error
@@ -101,11 +149,16 @@ static OSQPInt LDL_factor(OSQPCscMatrix* A,
     p->L->x = (OSQPFloat *)c_malloc(sizeof(OSQPFloat)*sum_Lnz);
     p->L->nzmax = sum_Lnz;
 
+    // The supernodal kernels are optional, so QDLDL is used if they cannot be allocated
+    if (supernodal && qdldl_sn_new(&p->sn, A, p->etree, p->Lnz))
+        p->sn = OSQP_NULL;
+
+    // The supernodal factorization needs the pattern of L beforehand
+    if (p->sn)
+        qdldl_sn_pattern(p->sn, A, p->etree, p->Lnz, p->L->p, p->L->i);
+
     // Factor matrix
-    factor_status = QDLDL_factor(A->n, A->p, A->i, A->x,
-                                 p->L->p, p->L->i, p->L->x,
-                                 p->D, p->Dinv, p->Lnz,
-                                 p->etree, p->bwork, p->iwork, p->fwork);
+    factor_status = LDL_factor_numeric(p, A);
 
     if (factor_status < 0){
       // Error
@@ -122,7 +175,12 @@ static OSQPInt LDL_factor(OSQPCscMatrix* A,
 }
 
 
-static OSQPInt permute_KKT(OSQPCscMatrix** KKT,
+/**
+ * Symmetrically permute the KKT matrix with the permutation stored in p->P
+ * and remap the index vectors PtoKKT, AtoKKT and rhotoKKT (when given).
+ * The unpermuted KKT matrix is freed and replaced by the permuted one.
+ */
+static OSQPInt symperm_KKT(OSQPCscMatrix** KKT,
                            qdldl_solver*   p,
                            OSQPInt         Pnz,
                            OSQPInt         Anz,
@@ -130,31 +188,15 @@ static OSQPInt permute_KKT(OSQPCscMatrix** KKT,
                            OSQPInt*        PtoKKT,
                            OSQPInt*        AtoKKT,
                            OSQPInt*        rhotoKKT) {
-    OSQPFloat* info;
-    OSQPInt    amd_status;
     OSQPInt*   Pinv;
     OSQPInt*   KtoPKPt;
     OSQPInt    i; // Indexing
 
     OSQPCscMatrix* KKT_temp;
 
-    info = (OSQPFloat *)c_malloc(AMD_INFO * sizeof(OSQPFloat));
-
-    // Compute permutation matrix P using AMD
-#ifdef OSQP_USE_LONG
-    amd_status = amd_l_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (OSQPFloat *)OSQP_NULL, info);
-#else
-    amd_status = amd_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (OSQPFloat *)OSQP_NULL, info);
-#endif
-    if (amd_status < 0) {
-        // Free Amd info and return an error
-        c_free(info);
-        return amd_status;
-    }
-
-
     // Inverse of the permutation vector
     Pinv = csc_pinv(p->P, (*KKT)->n);
+    if (!Pinv) return OSQP_MEM_ALLOC_ERROR;
 
     // Permute KKT matrix
     if (!PtoKKT && !AtoKKT && !rhotoKKT){  // No vectors to be stored
@@ -193,20 +235,174 @@ static OSQPInt permute_KKT(OSQPCscMatrix** KKT,
     (*KKT) = KKT_temp;
     // Free Pinv
     c_free(Pinv);
+
+    return 0;
+}
+
+
+static OSQPInt permute_KKT(OSQPCscMatrix** KKT,
+                           qdldl_solver*   p,
+                           OSQPInt         Pnz,
+                           OSQPInt         Anz,
+                           OSQPInt         m,
+                           OSQPInt*        PtoKKT,
+                           OSQPInt*        AtoKKT,
+                           OSQPInt*        rhotoKKT) {
+    OSQPFloat* info;
+    OSQPInt    amd_status;
+
+    info = (OSQPFloat *)c_malloc(AMD_INFO * sizeof(OSQPFloat));
+
+    // Compute permutation matrix P using AMD
+#ifdef OSQP_USE_LONG
+    amd_status = amd_l_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (OSQPFloat *)OSQP_NULL, info);
+#else
+    amd_status = amd_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (OSQPFloat *)OSQP_NULL, info);
+#endif
     // Free Amd info
     c_free(info);
 
+    if (amd_status < 0) {
+        return amd_status;
+    }
+
+    return symperm_KKT(KKT, p, Pnz, Anz, m, PtoKKT, AtoKKT, rhotoKKT);
+}
+
+
+/**
+ * Allocate the numeric factorization workspace
+ * @param  p        Private workspace
+ * @param  n_plus_m Dimension of the KKT matrix
+ * @return          exitstatus (0 is good)
+ */
+static OSQPInt alloc_factor_workspace(qdldl_solver* p,
+                                      OSQPInt       n_plus_m) {
+
+    p->D     = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * n_plus_m);
+    p->etree = (QDLDL_int *)c_malloc(n_plus_m * sizeof(QDLDL_int));
+    p->Lnz   = (QDLDL_int *)c_malloc(n_plus_m * sizeof(QDLDL_int));
+    p->iwork = (QDLDL_int *)c_malloc(sizeof(QDLDL_int)*(3*n_plus_m));
+    p->bwork = (QDLDL_bool *)c_malloc(sizeof(QDLDL_bool)*n_plus_m);
+    p->fwork = (QDLDL_float *)c_malloc(sizeof(QDLDL_float)*n_plus_m);
+
+    if (!p->D || !p->etree || !p->Lnz || !p->iwork || !p->bwork || !p->fwork)
+        return OSQP_MEM_ALLOC_ERROR;
+
     return 0;
 }
 
 
+/**
+ * Release the KKT matrix, its index maps and the numeric factorization
+ * workspace. Only the factor L, Dinv and the permutation are kept, which is
+ * all that is needed to solve with the current factorization.
+ * @param p Private workspace
+ */
+static void release_KKT(qdldl_solver* p) {
+
+    if (p->KKT)      csc_spfree(p->KKT);
+    if (p->PtoKKT)   c_free(p->PtoKKT);
+    if (p->AtoKKT)   c_free(p->AtoKKT);
+    if (p->rhotoKKT) c_free(p->rhotoKKT);
+    if (p->D)        c_free(p->D);
+    if (p->etree)    c_free(p->etree);
+    if (p->Lnz)      c_free(p->Lnz);
+    if (p->iwork)    c_free(p->iwork);
+    if (p->bwork)    c_free(p->bwork);
+    if (p->fwork)    c_free(p->fwork);
+
+    p->KKT      = OSQP_NULL;
+    p->PtoKKT   = OSQP_NULL;
+    p->AtoKKT   = OSQP_NULL;
+    p->rhotoKKT = OSQP_NULL;
+    p->D        = OSQP_NULL;
+    p->etree    = OSQP_NULL;
+    p->Lnz      = OSQP_NULL;
+    p->iwork    = OSQP_NULL;
+    p->bwork    = OSQP_NULL;
+    p->fwork    = OSQP_NULL;
+}
+
+
+/**
+ * Reassemble the permuted KKT matrix and the factorization workspace
+ * released in lean mode. The stored fill-reducing permutation is reused, so
+ * no new ordering is computed and the pattern of L does not change.
+ * @param  p Private workspace
+ * @return   exitstatus (0 is good)
+ */
+static OSQPInt acquire_KKT(qdldl_solver* p) {
+
+    OSQPInt n   = p->n;
+    OSQPInt m   = p->m;
+    OSQPInt Pnz = p->Pcsc->p[n];
+    OSQPInt Anz = p->Acsc->p[n];
+
+    OSQPCscMatrix* KKT_temp;
+
+    // Nothing to do if the KKT matrix is resident
+    if (p->KKT) return 0;
+
+    p->PtoKKT   = c_malloc(Pnz * sizeof(OSQPInt));
+    p->AtoKKT   = c_malloc(Anz * sizeof(OSQPInt));
+    p->rhotoKKT = c_malloc(m * sizeof(OSQPInt));
+
+    if ((Pnz && !p->PtoKKT) || (Anz && !p->AtoKKT) || (m && !p->rhotoKKT) ||
+        alloc_factor_workspace(p, n + m)) {
+        release_KKT(p);
+        return OSQP_MEM_ALLOC_ERROR;
+    }
+
+    KKT_temp = form_KKT(p->Pcsc, p->Acsc,
+                        0, //format = 0 means CSC format
+                        p->sigma, p->rho_inv_vec, p->rho_inv,
+                        p->PtoKKT, p->AtoKKT, p->rhotoKKT);
+
+    if (!KKT_temp || symperm_KKT(&KKT_temp, p, Pnz, Anz, m, p->PtoKKT, p->AtoKKT, p->rhotoKKT)) {
+        if (KKT_temp) csc_spfree(KKT_temp);
+        release_KKT(p);
+        return OSQP_MEM_ALLOC_ERROR;
+    }
+    p->KKT = KKT_temp;
+
+    // Restore the elimination tree and column counts used by QDLDL_factor
+    QDLDL_etree(p->KKT->n, p->KKT->p, p->KKT->i, p->iwork, p->Lnz, p->etree);
+
+    return 0;
+}
+
+
+/**
+ * Estimate the cost of recomputing each row of L: scattering column k of
+ * the KKT matrix plus, for each entry (k,c) of L, the entries of column c
+ * above it that the up-looking factorization updates.
+ * @param p Private workspace (factored)
+ */
+static void LDL_row_work(qdldl_solver* p) {
+
+    OSQPInt c, j;
+    OSQPInt nKKT = p->KKT->n;
+
+    for (c = 0; c < nKKT; c++) {
+        p->row_work[c] = (QDLDL_float)(p->KKT->p[c+1] - p->KKT->p[c] + 1);
+    }
+    for (c = 0; c < nKKT; c++) {
+        for (j = p->L->p[c]; j < p->L->p[c+1]; j++) {
+            p->row_work[p->L->i[j]] += (QDLDL_float)(j - p->L->p[c] + 1);
+        }
+    }
+}
+
+
 // Initialize LDL Factorization structure
-OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
-                                 const OSQPMatrix*   P,
-                                 const OSQPMatrix*   A,
-                                 const OSQPVectorf*  rho_vec,
-                                 const OSQPSettings* settings,
-                                 OSQPInt             polishing) {
+static OSQPInt init_linsys_solver(qdldl_solver**        sp,
+                                  const OSQPMatrix*     P,
+                                  const OSQPMatrix*     A,
+                                  const OSQPVectorf*    rho_vec,
+                                  const OSQPSettings*   settings,
+                                  OSQPInt               polishing,
+                                  const qdldl_symbolic* sym) {
 
     // Define Variables
     OSQPCscMatrix* KKT_temp; // Temporary KKT pointer
@@ -234,6 +430,11 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
     // Polishing flag
     s->polishing = polishing;
 
+    // Lean memory flag
+    s->lean_memory = settings->lean_memory;
+    s->Pcsc = P->csc;
+    s->Acsc = A->csc;
+
     // Link Functions
     s->name            = &name_qdldl;
     s->solve           = &solve_linsys_qdldl;
@@ -243,7 +444,10 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
 
 
 #ifndef OSQP_EMBEDDED_MODE
-    s->free = &free_linsys_solver_qdldl;
+    s->free          = &free_linsys_solver_qdldl;
+    s->solve_block   = &solve_block_linsys_qdldl;
+    s->polish_factor = &polish_factor_linsys_qdldl;
+    s->update_matrices_rho_vec = &update_linsys_solver_matrices_rho_vec_qdldl;
 #endif
 
 #if OSQP_EMBEDDED_MODE != 1
@@ -267,9 +471,8 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
     s->L->nz = -1;
     s->L->p  = (OSQPInt *)c_malloc((n_plus_m+1) * sizeof(QDLDL_int));
 
-    // Diagonal matrix stored as a vector D
+    // Inverse of the diagonal matrix D stored as a vector
     s->Dinv = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * n_plus_m);
-    s->D    = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * n_plus_m);
 
     // Permutation vector P
     s->P    = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n_plus_m);
@@ -285,22 +488,20 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
       s->rho_inv_vec = (OSQPFloat *)c_malloc(sizeof(OSQPFloat) * m);
     // else it is NULL
 
-    // Elimination tree workspace
-    s->etree = (QDLDL_int *)c_malloc(n_plus_m * sizeof(QDLDL_int));
-    s->Lnz   = (QDLDL_int *)c_malloc(n_plus_m * sizeof(QDLDL_int));
-
     // Lx and Li are sparsity dependent, so set them to
     // null initially so we don't try to free them prematurely
     s->L->i = OSQP_NULL;
     s->L->x = OSQP_NULL;
 
-    // Preallocate workspace
-    s->iwork = (QDLDL_int *)c_malloc(sizeof(QDLDL_int)*(3*n_plus_m));
-    s->bwork = (QDLDL_bool *)c_malloc(sizeof(QDLDL_bool)*n_plus_m);
-    s->fwork = (QDLDL_float *)c_malloc(sizeof(QDLDL_float)*n_plus_m);
+    // Preallocate elimination tree and numeric workspace
+    if (alloc_factor_workspace(s, n_plus_m)) {
+        free_linsys_solver_qdldl(s);
+        *sp = OSQP_NULL;
+        return OSQP_MEM_ALLOC_ERROR;
+    }
 
     // Form and permute KKT matrix
-    if (polishing){ // Called from polish()
+    if (polishing && !settings->realtime){ // Called from polish()
 
         KKT_temp = form_KKT(P->csc,A->csc,
                             0, //format = 0 means CSC
@@ -311,7 +512,7 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
         if (KKT_temp)
             permute_KKT(&KKT_temp, s, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL);
     }
-    else { // Called from ADMM algorithm
+    else { // Called from ADMM algorithm, or at setup for polishing in real-time mode
 
         // Allocate vectors of indices
         s->PtoKKT = c_malloc(P->csc->p[n] * sizeof(OSQPInt));
@@ -326,7 +527,8 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
           }
         }
         else {
-          s->rho_inv = 1. / settings->rho;
+          // The polishing system is regularized with -sigma*I in place of -rho_inv*I
+          s->rho_inv = polishing ? sigma : 1. / settings->rho;
         }
 
         KKT_temp = form_KKT(P->csc,A->csc,
@@ -334,8 +536,12 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
                             sigma, s->rho_inv_vec, s->rho_inv,
                             s->PtoKKT, s->AtoKKT,s->rhotoKKT);
 
-        // Permute matrix
-        if (KKT_temp){
+        // Permute matrix, with the ordering of the symbolic analysis if there is one
+        if (KKT_temp && sym){
+            for (i = 0; i < n_plus_m; i++) s->P[i] = sym->P[i];
+            symperm_KKT(&KKT_temp, s, P->csc->p[n], A->csc->p[n], m, s->PtoKKT, s->AtoKKT, s->rhotoKKT);
+        }
+        else if (KKT_temp){
             permute_KKT(&KKT_temp, s, P->csc->p[n], A->csc->p[n], m, s->PtoKKT, s->AtoKKT, s->rhotoKKT);
         }
     }
@@ -349,48 +555,251 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
     }
 
     // Factorize the KKT matrix
-    if (LDL_factor(KKT_temp, s, n) < 0) {
+    if (LDL_factor(KKT_temp, s, n, settings->supernodal && !s->lean_memory, sym) < 0) {
         csc_spfree(KKT_temp);
         free_linsys_solver_qdldl(s);
         *sp = OSQP_NULL;
         return OSQP_NONCVX_ERROR;
     }
 
-    if (polishing){ // If KKT passed, assign it to KKT_temp
+    if (polishing && !settings->realtime){ // If KKT passed, assign it to KKT_temp
         // Polish, no need for KKT_temp
         csc_spfree(KKT_temp);
     }
-    else { // If not embedded option 1 copy pointer to KKT_temp. Do not free it.
+    else { // Keep KKT_temp for refactorizations. Do not free it.
         s->KKT = KKT_temp;
     }
 
+    // Updates of a few entries of the ADMM system only refactor part of L
+    if (!polishing) {
+        s->row_work = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * n_plus_m);
+        if (!s->row_work) {
+            free_linsys_solver_qdldl(s);
+            *sp = OSQP_NULL;
+            return OSQP_MEM_ALLOC_ERROR;
+        }
+        LDL_row_work(s);
+    }
+
+    // Polishing on the ADMM pattern (always in real-time mode) keeps its
+    // factorization next to this one
+    if (!polishing && settings->polishing &&
+        (settings->polish_in_place || settings->realtime) && !s->lean_memory) {
+        s->pol_Lx   = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * s->L->nzmax);
+        s->pol_Dinv = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * n_plus_m);
+        if ((s->L->nzmax && !s->pol_Lx) || !s->pol_Dinv) {
+            free_linsys_solver_qdldl(s);
+            *sp = OSQP_NULL;
+            return OSQP_MEM_ALLOC_ERROR;
+        }
+    }
+
+    // In lean mode only the factors are kept resident; the KKT matrix and the
+    // workspace are reassembled on demand when a refactorization is needed
+    if (s->lean_memory) release_KKT(s);
+
 
     // No error
     return 0;
 }
 
+OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
+                                 const OSQPMatrix*   P,
+                                 const OSQPMatrix*   A,
+                                 const OSQPVectorf*  rho_vec,
+                                 const OSQPSettings* settings,
+                                 OSQPInt             polishing) {
+
+    return init_linsys_solver(sp, P, A, rho_vec, settings, polishing, OSQP_NULL);
+}
+
+OSQPInt init_linsys_solver_qdldl_analysed(qdldl_solver**        sp,
+                                          const OSQPMatrix*     P,
+                                          const OSQPMatrix*     A,
+                                          const OSQPVectorf*    rho_vec,
+                                          const OSQPSettings*   settings,
+                                          const qdldl_symbolic* sym) {
+
+    return init_linsys_solver(sp, P, A, rho_vec, settings, 0, sym);
+}
+
+void qdldl_symbolic_free(qdldl_symbolic* sym) {
+    if (sym) {
+        if (sym->P)     c_free(sym->P);
+        if (sym->etree) c_free(sym->etree);
+        if (sym->Lnz)   c_free(sym->Lnz);
+        c_free(sym);
+    }
+}
+
+OSQPInt qdldl_symbolic_new(qdldl_symbolic**     symp,
+                           const OSQPCscMatrix* P,
+                           const OSQPCscMatrix* A) {
+
+    OSQPInt         n_plus_m = P->n + A->m;
+    OSQPInt         amd_status;
+    OSQPInt*        Pinv  = OSQP_NULL;
+    QDLDL_int*      work  = OSQP_NULL;
+    OSQPCscMatrix*  KKT   = OSQP_NULL;
+    OSQPCscMatrix*  KKTp  = OSQP_NULL;
+    OSQPInt         exitflag = OSQP_MEM_ALLOC_ERROR;
+    qdldl_symbolic* sym   = c_calloc(1, sizeof(qdldl_symbolic));
+
+    *symp = OSQP_NULL;
+    if (!sym) return OSQP_MEM_ALLOC_ERROR;
+
+    sym->n     = n_plus_m;
+    sym->P     = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n_plus_m);
+    sym->etree = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n_plus_m);
+    sym->Lnz   = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n_plus_m);
+    work       = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n_plus_m);
+    KKT        = form_KKT_pattern(P, A);
+    if (!sym->P || !sym->etree || !sym->Lnz || !work || !KKT) goto exit;
+
+    // Same ordering as permute_KKT
+#ifdef OSQP_USE_LONG
+    amd_status = amd_l_order(KKT->n, KKT->p, KKT->i, sym->P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
+#else
+    amd_status = amd_order(KKT->n, KKT->p, KKT->i, sym->P, (OSQPFloat *)OSQP_NULL, (OSQPFloat *)OSQP_NULL);
+#endif
+    if (amd_status < 0) {
+        exitflag = OSQP_LINSYS_SOLVER_INIT_ERROR;
+        goto exit;
+    }
+
+    // The permuted pattern is the one symperm_KKT gives the KKT matrix
+    Pinv = csc_pinv(sym->P, n_plus_m);
+    if (Pinv) KKTp = csc_symperm(KKT, Pinv, OSQP_NULL, 0);
+    if (!KKTp) goto exit;
+
+    sym->sum_Lnz = QDLDL_etree(n_plus_m, KKTp->p, KKTp->i, work, sym->Lnz, sym->etree);
+
+    // The errors are reported when the matrix is factored without the analysis
+    exitflag = sym->sum_Lnz < 0 ? OSQP_LINSYS_SOLVER_INIT_ERROR : 0;
+
+exit:
+    if (Pinv) c_free(Pinv);
+    if (work) c_free(work);
+    csc_spfree(KKT);
+    csc_spfree(KKTp);
+
+    if (exitflag) qdldl_symbolic_free(sym);
+    else          *symp = sym;
+
+    return exitflag;
+}
+
 #endif  // OSQP_EMBEDDED_MODE
 
 const char* name_qdldl(qdldl_solver* s) {
+#ifndef OSQP_EMBEDDED_MODE
+  if (s->sn)
+    return "QDLDL v" STRINGIZE(QDLDL_VERSION_MAJOR) "." STRINGIZE(QDLDL_VERSION_MINOR) "." STRINGIZE(QDLDL_VERSION_PATCH) " (supernodal)";
+#endif
   return "QDLDL v" STRINGIZE(QDLDL_VERSION_MAJOR) "." STRINGIZE(QDLDL_VERSION_MINOR) "." STRINGIZE(QDLDL_VERSION_PATCH);
 }
 
 
-/* solve P'LDL'P x = b for x */
-static void LDLSolve(OSQPFloat*           x,
-                     const OSQPFloat*     b,
-                     const OSQPCscMatrix* L,
-                     const OSQPFloat*     Dinv,
-                     const OSQPInt*       P,
-                     OSQPFloat*           bp) {
+#ifndef OSQP_EMBEDDED_MODE
+
+/*
+ * Sparse right-hand sides are solved by reach when the rows reachable from
+ * their nonzeros in the elimination tree are at most this fraction of the
+ * rows of L. Finding the reach costs a pass over the right-hand side, so past
+ * it the dense solve is faster.
+ */
+#ifndef QDLDL_SPARSE_RHS_MAX_FRACTION
+# define QDLDL_SPARSE_RHS_MAX_FRACTION 0.25
+#endif
+
+/*
+ * Solve LDL' x = b in place, touching only the rows that can be nonzero.
+ *
+ * The parent of column j in the elimination tree is its first row in L, so
+ * the nonzeros of L^{-1} b are the union of the paths from the nonzeros of b
+ * to the roots (the reach). The forward solve and the scaling by D^{-1} only
+ * visit the reach; the backward solve fills the subtrees below it, which are
+ * found by marking every column whose parent is marked. mark is a workspace
+ * of n entries. Returns 0 without touching x if the reach is too large.
+ */
+static OSQPInt LDLSolve_sparse(QDLDL_int          n,
+                               const QDLDL_int*   Lp,
+                               const QDLDL_int*   Li,
+                               const QDLDL_float* Lx,
+                               const QDLDL_float* Dinv,
+                               QDLDL_float*       x,
+                               QDLDL_int*         mark) {
+
+  QDLDL_int   i, j, p;
+  QDLDL_int   nreach = 0;
+  QDLDL_int   limit  = (QDLDL_int)(QDLDL_SPARSE_RHS_MAX_FRACTION * n);
+  QDLDL_float val;
+
+  for (j = 0; j < n; j++) mark[j] = 0;
+
+  for (i = 0; i < n; i++) {
+    if (x[i] == 0.0) continue;
+    for (j = i; j != -1 && !mark[j]; j = Lp[j] < Lp[j+1] ? Li[Lp[j]] : -1) {
+      mark[j] = 1;
+      nreach++;
+    }
+    if (nreach > limit) return 0;
+  }
+
+  // x = L \ b over the reach, in topological (ascending) order
+  for (j = 0; j < n; j++) {
+    if (!mark[j] || x[j] == 0.0) continue;
+    val = x[j];
+    for (p = Lp[j]; p < Lp[j+1]; p++) x[Li[p]] -= Lx[p] * val;
+  }
+
+  for (j = 0; j < n; j++) {
+    if (mark[j]) x[j] *= Dinv[j];
+  }
+
+  // x = L' \ x, from the roots down the subtrees of the reach
+  for (j = n - 1; j >= 0; j--) {
+    if (!mark[j]) {
+      if (Lp[j] == Lp[j+1] || !mark[Li[Lp[j]]]) continue;
+      mark[j] = 1;
+    }
+    val = x[j];
+    for (p = Lp[j]; p < Lp[j+1]; p++) val -= Lx[p] * x[Li[p]];
+    x[j] = val;
+  }
+  return 1;
+}
+
+#endif
+
+/* solve P'LDL'P x = b for x with the factorization of s. With sparse_rhs set,
+ * b is solved by reach if it is sparse enough. */
+static void LDLSolve(OSQPFloat*       x,
+                     const OSQPFloat* b,
+                     qdldl_solver*    s,
+                     OSQPInt          sparse_rhs) {
 
-  OSQPInt j;
-  OSQPInt n = L->n;
+  OSQPInt        j;
+  OSQPCscMatrix* L  = s->L;
+  OSQPInt*       P  = s->P;
+  OSQPFloat*     bp = s->bp;
+  OSQPInt        n  = L->n;
 
   // permute_x(L->n, bp, b, P);
   for (j = 0 ; j < n ; j++) bp[j] = b[P[j]];
 
-  QDLDL_solve(L->n, L->p, L->i, L->x, Dinv, bp);
+#ifndef OSQP_EMBEDDED_MODE
+  // iwork is only used while factoring and is released with the KKT matrix
+  if (!sparse_rhs || !s->iwork ||
+      !LDLSolve_sparse(n, L->p, L->i, L->x, s->Dinv, bp, s->iwork)) {
+    if (s->sn)
+      qdldl_sn_solve(s->sn, L->p, L->i, L->x, s->Dinv, bp);
+    else
+      QDLDL_solve(L->n, L->p, L->i, L->x, s->Dinv, bp);
+  }
+#else
+  QDLDL_solve(L->n, L->p, L->i, L->x, s->Dinv, bp);
+#endif
 
   // permutet_x(L->n, x, bp, P);
   for (j = 0 ; j < n ; j++) x[P[j]] = bp[j];
@@ -408,12 +817,13 @@ OSQPInt solve_linsys_qdldl(qdldl_solver* s,
 
 #ifndef OSQP_EMBEDDED_MODE
   if (s->polishing) {
-    /* stores solution to the KKT system in b */
-    LDLSolve(bv, bv, s->L, s->Dinv, s->P, s->bp);
+    /* stores solution to the KKT system in b; the right-hand sides of the
+     * refinement steps are residuals, often zero in most rows */
+    LDLSolve(bv, bv, s, 1);
   } else {
 #endif
     /* stores solution to the KKT system in s->sol */
-    LDLSolve(s->sol, bv, s->L, s->Dinv, s->P, s->bp);
+    LDLSolve(s->sol, bv, s, 0);
 
     /* copy x_tilde from s->sol */
     for (j = 0 ; j < n ; j++) {
@@ -438,8 +848,307 @@ OSQPInt solve_linsys_qdldl(qdldl_solver* s,
 }
 
 
+#ifndef OSQP_EMBEDDED_MODE
+
+/* Number of right-hand sides solved per pass over L in solve_block_linsys_qdldl */
+#ifndef QDLDL_BLOCK_WIDTH
+# define QDLDL_BLOCK_WIDTH 16
+#endif
+
+/* Solve P'LDL'P X = B for the k columns of B stored interleaved in W, i.e.
+ * W[i*k + j] holds row i of column j. Each entry of L is loaded once and
+ * applied to all the columns. */
+static void LDLSolve_block(OSQPFloat*           W,
+                           OSQPInt              k,
+                           const OSQPCscMatrix* L,
+                           const OSQPFloat*     Dinv) {
+
+  OSQPInt    i, j, p;
+  OSQPInt    n  = L->n;
+  OSQPInt*   Lp = L->p;
+  OSQPInt*   Li = L->i;
+  OSQPFloat* Lx = L->x;
+  OSQPFloat* wi;
+  OSQPFloat* wr;
+  OSQPFloat  l;
+
+  /* Solve L Y = B (L has a unit diagonal) */
+  for (i = 0; i < n; i++) {
+    wi = W + i*k;
+    for (p = Lp[i]; p < Lp[i+1]; p++) {
+      l  = Lx[p];
+      wr = W + Li[p]*k;
+      for (j = 0; j < k; j++) wr[j] -= l * wi[j];
+    }
+  }
+
+  for (i = 0; i < n; i++) {
+    wi = W + i*k;
+    for (j = 0; j < k; j++) wi[j] *= Dinv[i];
+  }
+
+  /* Solve L' X = Dinv Y */
+  for (i = n - 1; i >= 0; i--) {
+    wi = W + i*k;
+    for (p = Lp[i]; p < Lp[i+1]; p++) {
+      l  = Lx[p];
+      wr = W + Li[p]*k;
+      for (j = 0; j < k; j++) wi[j] -= l * wr[j];
+    }
+  }
+}
+
+OSQPInt solve_block_linsys_qdldl(qdldl_solver* s,
+                                 OSQPVectorf** b,
+                                 OSQPInt       k,
+                                 OSQPInt       admm_iter) {
+
+  OSQPInt    i, j, j0, kc, idx;
+  OSQPInt    n = s->n;
+  OSQPInt    n_plus_m = n + s->m;
+  OSQPInt    width = c_min(k, QDLDL_BLOCK_WIDTH);
+  OSQPFloat* W;
+  OSQPFloat* wi;
+  OSQPFloat  rho_inv;
+
+  if (k == 1) return solve_linsys_qdldl(s, b[0], admm_iter);
+
+  /* The workspace only grows, so only the first block solve allocates it */
+  if (width > s->bk_cols) {
+    c_free(s->bk);
+    s->bk = (OSQPFloat *)c_malloc(sizeof(OSQPFloat) * n_plus_m * width);
+    s->bk_cols = s->bk ? width : 0;
+    if (!s->bk) return 1;
+  }
+  W = s->bk;
+
+  for (j0 = 0; j0 < k; j0 += kc) {
+    kc = c_min(width, k - j0);
+
+    /* Permute the right-hand sides into the interleaved workspace */
+    for (i = 0; i < n_plus_m; i++) {
+      idx = s->P[i];
+      wi  = W + i*kc;
+      for (j = 0; j < kc; j++) wi[j] = b[j0 + j]->values[idx];
+    }
+
+    LDLSolve_block(W, kc, s->L, s->Dinv);
+
+    /* Unpermute; as in solve_linsys_qdldl, b keeps x_tilde and z_tilde is
+     * computed from the right-hand side still stored in b */
+    for (i = 0; i < n_plus_m; i++) {
+      idx = s->P[i];
+      wi  = W + i*kc;
+      if (s->polishing || idx < n) {
+        for (j = 0; j < kc; j++) b[j0 + j]->values[idx] = wi[j];
+      }
+      else {
+        rho_inv = s->rho_inv_vec ? s->rho_inv_vec[idx - n] : s->rho_inv;
+        for (j = 0; j < kc; j++) b[j0 + j]->values[idx] += rho_inv * wi[j];
+      }
+    }
+  }
+
+  return 0;
+}
+
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+
 #if OSQP_EMBEDDED_MODE != 1
 
+/*
+ * Partial refactorizations are only used when the affected rows account for
+ * at most this fraction of the work of a full factorization. Each recomputed
+ * row locates its entries in the columns of L with a binary search, so past
+ * it a full factorization is faster.
+ */
+#ifndef QDLDL_PARTIAL_MAX_FRACTION
+# define QDLDL_PARTIAL_MAX_FRACTION 0.5
+#endif
+
+// Column of the entry at position idx of the CSC matrix M
+static QDLDL_int csc_entry_column(const OSQPCscMatrix* M,
+                                  QDLDL_int            idx) {
+
+    QDLDL_int lo = 0;
+    QDLDL_int hi = M->n - 1;
+    QDLDL_int mid;
+
+    // Last column starting at or before idx
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (M->p[mid] <= idx) lo = mid;
+        else                  hi = mid - 1;
+    }
+
+    return lo;
+}
+
+// Mark the path from row k to the root (-1) of the elimination tree and return its work
+static QDLDL_float mark_etree_path(const QDLDL_int*   etree,
+                                   const QDLDL_float* row_work,
+                                   QDLDL_int*         marked,
+                                   QDLDL_int          k) {
+
+    QDLDL_float work = 0.0;
+
+    while (k != -1 && !marked[k]) {
+        marked[k] = 1;
+        work += row_work[k];
+        k = etree[k];
+    }
+
+    return work;
+}
+
+/**
+ * Recompute the rows of L and D marked in iwork[2*n:3*n].
+ *
+ * Row k of L and D[k] depend only on column k of the KKT matrix and on the
+ * rows of L in the subtree of k in the elimination tree, so the marked rows
+ * are recomputed in increasing order with the same operations as
+ * QDLDL_factor. The pattern of L does not change: the entry of row k in
+ * column c is found by a binary search in the sorted row indices of c.
+ *
+ * @return Number of positive elements of D, -1 if D has a zero element
+ */
+static OSQPInt LDL_factor_rows(qdldl_solver* s) {
+
+    QDLDL_int    nKKT     = s->KKT->n;
+    QDLDL_int*   Ap       = s->KKT->p;
+    QDLDL_int*   Ai       = s->KKT->i;
+    QDLDL_float* Ax       = s->KKT->x;
+    QDLDL_int*   Lp       = s->L->p;
+    QDLDL_int*   Li       = s->L->i;
+    QDLDL_float* Lx       = s->L->x;
+    QDLDL_int*   etree    = s->etree;
+    QDLDL_int*   yIdx     = s->iwork;
+    QDLDL_int*   elimBuf  = s->iwork + nKKT;
+    QDLDL_int*   marked   = s->iwork + 2*nKKT;
+    QDLDL_bool*  yMarkers = s->bwork;
+    QDLDL_float* yVals    = s->fwork;
+
+    QDLDL_int   i, j, k, lo, hi, mid, bidx, cidx, nextIdx, nnzY, nnzE;
+    QDLDL_float yVals_cidx;
+    OSQPInt     pos_D_count = 0;
+
+    for (k = 0; k < nKKT; k++) {
+        yMarkers[k] = 0;
+        yVals[k]    = 0.0;
+    }
+
+    for (k = 0; k < nKKT; k++) {
+        if (!marked[k]) continue;
+
+        // Scatter column k and find the nonzero pattern of row k of L
+        s->D[k] = 0.0;
+        nnzY    = 0;
+        for (i = Ap[k]; i < Ap[k+1]; i++) {
+            bidx = Ai[i];
+            if (bidx == k) {
+                s->D[k] = Ax[i];
+                continue;
+            }
+            yVals[bidx] = Ax[i];
+            if (!yMarkers[bidx]) {
+                yMarkers[bidx] = 1;
+                elimBuf[0]     = bidx;
+                nnzE           = 1;
+                nextIdx        = etree[bidx];
+                while (nextIdx != -1 && nextIdx < k && !yMarkers[nextIdx]) {
+                    yMarkers[nextIdx] = 1;
+                    elimBuf[nnzE++]   = nextIdx;
+                    nextIdx           = etree[nextIdx];
+                }
+                while (nnzE) yIdx[nnzY++] = elimBuf[--nnzE];
+            }
+        }
+
+        // Solve for row k in topological order
+        for (i = nnzY - 1; i >= 0; i--) {
+            cidx = yIdx[i];
+
+            lo = Lp[cidx];
+            hi = Lp[cidx+1] - 1;
+            while (lo < hi) {
+                mid = lo + (hi - lo) / 2;
+                if (Li[mid] < k) lo = mid + 1;
+                else             hi = mid;
+            }
+
+            yVals_cidx = yVals[cidx];
+            for (j = Lp[cidx]; j < lo; j++) {
+                yVals[Li[j]] -= Lx[j] * yVals_cidx;
+            }
+            Lx[lo]   = yVals_cidx * s->Dinv[cidx];
+            s->D[k] -= yVals_cidx * Lx[lo];
+
+            yVals[cidx]    = 0.0;
+            yMarkers[cidx] = 0;
+        }
+
+        if (s->D[k] == 0.0) return -1;
+        s->Dinv[k] = 1 / s->D[k];
+    }
+
+    // D only holds the rows recomputed here (acquire_KKT allocates it afresh
+    // in lean mode), while Dinv holds every row, so count the signs of Dinv
+    for (k = 0; k < nKKT; k++) {
+        if (s->Dinv[k] > 0.0) pos_D_count++;
+    }
+
+    return pos_D_count;
+}
+
+/**
+ * Refactor the KKT matrix after some of its entries changed. A changed
+ * entry (i,j), i <= j, lies in column j, so it only affects row j of L and
+ * the rows on the path from j to the root of the elimination tree; only
+ * those are recomputed, unless the indices are not given or the rows make
+ * up too much of the work.
+ *
+ * @return Number of positive elements of D, -1 if D has a zero element
+ */
+static OSQPInt LDL_refactor(qdldl_solver*  s,
+                            const OSQPInt* Px_new_idx,
+                            OSQPInt        P_new_n,
+                            const OSQPInt* Ax_new_idx,
+                            OSQPInt        A_new_n) {
+
+    OSQPInt     i, k;
+    OSQPInt     nKKT       = s->KKT->n;
+    QDLDL_float work       = 0.0;
+    QDLDL_float total_work = 0.0;
+    QDLDL_int*  marked     = s->iwork + 2*nKKT;
+
+    if (s->row_work && (P_new_n <= 0 || Px_new_idx) && (A_new_n <= 0 || Ax_new_idx)) {
+        for (i = 0; i < nKKT; i++) {
+            marked[i]   = 0;
+            total_work += s->row_work[i];
+        }
+
+        // The first row of L an entry changes is the column holding it in the
+        // upper triangular KKT matrix, the larger of its two indices
+        for (i = 0; i < P_new_n; i++)
+            work += mark_etree_path(s->etree, s->row_work, marked,
+                                    csc_entry_column(s->KKT, s->PtoKKT[Px_new_idx[i]]));
+        for (i = 0; i < A_new_n; i++)
+            work += mark_etree_path(s->etree, s->row_work, marked,
+                                    csc_entry_column(s->KKT, s->AtoKKT[Ax_new_idx[i]]));
+
+        if (work <= QDLDL_PARTIAL_MAX_FRACTION * total_work) {
+            s->rows_refactored = 0;
+            for (k = 0; k < nKKT; k++) s->rows_refactored += marked[k];
+            return LDL_factor_rows(s);
+        }
+    }
+
+    s->rows_refactored = nKKT;
+    return LDL_factor_numeric(s, s->KKT);
+}
+
+
 // Update private structure with new P and A
 OSQPInt update_linsys_solver_matrices_qdldl(qdldl_solver*     s,
                                             const OSQPMatrix* P,
@@ -451,15 +1160,23 @@ OSQPInt update_linsys_solver_matrices_qdldl(qdldl_solver*     s,
 
     OSQPInt pos_D_count;
 
+#ifndef OSQP_EMBEDDED_MODE
+    // Reassemble the KKT matrix if it was released
+    if (s->lean_memory && acquire_KKT(s)) return 1;
+#endif
+
     // Update KKT matrix with new P
     update_KKT_P(s->KKT, P->csc, Px_new_idx, P_new_n, s->PtoKKT, s->sigma, 0);
 
     // Update KKT matrix with new A
     update_KKT_A(s->KKT, A->csc, Ax_new_idx, A_new_n, s->AtoKKT);
 
-    pos_D_count = QDLDL_factor(s->KKT->n, s->KKT->p, s->KKT->i, s->KKT->x,
-        s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
-        s->etree, s->bwork, s->iwork, s->fwork);
+    // Only the part of L below the changed entries is recomputed
+    pos_D_count = LDL_refactor(s, Px_new_idx, P_new_n, Ax_new_idx, A_new_n);
+
+#ifndef OSQP_EMBEDDED_MODE
+    if (s->lean_memory) release_KKT(s);
+#endif
 
     //number of positive elements in D should match the
     //dimension of P if P + \sigma I is PD.   Error otherwise.
@@ -473,6 +1190,7 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
 
     OSQPInt i;
     OSQPInt m = s->m;
+    OSQPInt factor_status;
     OSQPFloat* rhov;
 
     // Update internal rho_inv_vec
@@ -486,12 +1204,137 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
       s->rho_inv = 1. / rho_sc;
     }
 
+#ifndef OSQP_EMBEDDED_MODE
+    // Reassemble the KKT matrix if it was released
+    if (s->lean_memory && acquire_KKT(s)) return 1;
+#endif
+
     // Update KKT matrix with new rho_vec
     update_KKT_param2(s->KKT, s->rho_inv_vec, s->rho_inv, s->rhotoKKT, s->m);
 
-    return (QDLDL_factor(s->KKT->n, s->KKT->p, s->KKT->i, s->KKT->x,
-        s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
-        s->etree, s->bwork, s->iwork, s->fwork) < 0);
+    factor_status = LDL_factor_numeric(s, s->KKT);
+
+#ifndef OSQP_EMBEDDED_MODE
+    if (s->lean_memory) release_KKT(s);
+#endif
+
+    return (factor_status < 0);
+}
+
+#endif
+
+#ifndef OSQP_EMBEDDED_MODE
+
+// Update private structure with new P, A and rho_vec
+OSQPInt update_linsys_solver_matrices_rho_vec_qdldl(qdldl_solver*      s,
+                                                    const OSQPMatrix*  P,
+                                                    const OSQPInt*     Px_new_idx,
+                                                    OSQPInt            P_new_n,
+                                                    const OSQPMatrix*  A,
+                                                    const OSQPInt*     Ax_new_idx,
+                                                    OSQPInt            A_new_n,
+                                                    const OSQPVectorf* rho_vec,
+                                                    OSQPFloat          rho_sc) {
+
+    OSQPInt    i;
+    OSQPInt    pos_D_count;
+    OSQPFloat* rhov;
+
+    // Update internal rho_inv_vec
+    if (s->rho_inv_vec) {
+      rhov = rho_vec->values;
+      for (i = 0; i < s->m; i++){
+          s->rho_inv_vec[i] = 1. / rhov[i];
+      }
+    }
+    else {
+      s->rho_inv = 1. / rho_sc;
+    }
+
+    // Reassemble the KKT matrix if it was released
+    if (s->lean_memory && acquire_KKT(s)) return 1;
+
+    update_KKT_P(s->KKT, P->csc, Px_new_idx, P_new_n, s->PtoKKT, s->sigma, 0);
+    update_KKT_A(s->KKT, A->csc, Ax_new_idx, A_new_n, s->AtoKKT);
+    update_KKT_param2(s->KKT, s->rho_inv_vec, s->rho_inv, s->rhotoKKT, s->m);
+
+    // rho_vec changes the diagonal of the constraint rows, so the whole factor is recomputed
+    pos_D_count = LDL_factor_numeric(s, s->KKT);
+
+    if (s->lean_memory) release_KKT(s);
+
+    return (pos_D_count == P->csc->n) ? 0 : 1;
+}
+
+// Swap the factorization in use with the one kept aside
+static void swap_factor(qdldl_solver* s) {
+
+    QDLDL_float* tmp;
+
+    tmp         = s->L->x;
+    s->L->x     = s->pol_Lx;
+    s->pol_Lx   = tmp;
+    tmp         = s->Dinv;
+    s->Dinv     = s->pol_Dinv;
+    s->pol_Dinv = tmp;
+}
+
+
+OSQPInt polish_factor_linsys_qdldl(qdldl_solver*      s,
+                                   const OSQPVectori* active_flags) {
+
+    OSQPInt  j, k;
+    OSQPInt  n = s->n;
+    OSQPInt  m = s->m;
+    OSQPInt  pos_D_count;
+    OSQPInt* flags;
+
+    if (!active_flags) {
+        // Back to the ADMM factorization
+        if (s->polishing) {
+            swap_factor(s);
+            s->polishing = 0;
+        }
+        if (s->lean_memory) {
+            c_free(s->pol_Lx);
+            c_free(s->pol_Dinv);
+            s->pol_Lx   = OSQP_NULL;
+            s->pol_Dinv = OSQP_NULL;
+        }
+        return 0;
+    }
+
+    // Storage for the polishing factorization (kept from setup unless in lean mode)
+    if (!s->pol_Dinv) {
+        s->pol_Lx   = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * s->L->nzmax);
+        s->pol_Dinv = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * (n + m));
+        if ((s->L->nzmax && !s->pol_Lx) || !s->pol_Dinv) return 1;
+    }
+
+    // Reassemble the KKT matrix if it was released
+    if (s->lean_memory && acquire_KKT(s)) return 1;
+
+    // Decouple the inactive rows and regularize the constraint block with -sigma*I
+    flags = active_flags->values;
+    for (j = 0; j < n; j++) {
+        for (k = s->Acsc->p[j]; k < s->Acsc->p[j+1]; k++) {
+            if (!flags[s->Acsc->i[k]]) s->KKT->x[s->AtoKKT[k]] = 0.0;
+        }
+    }
+    update_KKT_param2(s->KKT, OSQP_NULL, s->sigma, s->rhotoKKT, m);
+
+    // Factor into the storage kept aside; the pattern of L is that of the ADMM system
+    swap_factor(s);
+    s->polishing = 1;
+    pos_D_count = LDL_factor_numeric(s, s->KKT);
+
+    // Restore the ADMM values of the KKT matrix
+    update_KKT_A(s->KKT, s->Acsc, OSQP_NULL, s->Acsc->p[n], s->AtoKKT);
+    update_KKT_param2(s->KKT, s->rho_inv_vec, s->rho_inv, s->rhotoKKT, m);
+
+    if (s->lean_memory) release_KKT(s);
+
+    return (pos_D_count == n) ? 0 : 1;
 }
 
 #endif
@@ -663,6 +1506,142 @@ static void _adj_assemble_csc(OSQPCscMatrix*     D,
 
 }
 
+static OSQPInt _adj_nnz(const OSQPMatrix* P_full,
+                        const OSQPMatrix* G,
+                        const OSQPMatrix* A_eq) {
+
+    OSQPInt n = OSQPMatrix_get_m(P_full);
+    OSQPInt n_ineq = OSQPMatrix_get_m(G);
+    OSQPInt n_eq = OSQPMatrix_get_m(A_eq);
+
+    return 2 * (n + n_ineq + n_eq) +                // Diagonal elements (+eps and -eps)
+           OSQPMatrix_get_nz(P_full) +              // Number of elements in P_full
+           2 * OSQPMatrix_get_nz(G) +               // Number of nonzeros in G and G'
+           2 * OSQPMatrix_get_nz(A_eq) +            // Number of nonzeros in A_eq and A_eq'
+           n_ineq;                                  // Number of diagonal elements in slacks
+}
+
+OSQPInt adjoint_derivative_init_qdldl(qdldl_solver**     sp,
+                                      const OSQPMatrix*  P_full,
+                                      const OSQPMatrix*  G,
+                                      const OSQPMatrix*  A_eq,
+                                      const OSQPMatrix*  GDiagLambda,
+                                      const OSQPVectorf* slacks) {
+
+    OSQPInt        dim = 2 * (OSQPMatrix_get_m(P_full) + OSQPMatrix_get_m(G) + OSQPMatrix_get_m(A_eq));
+    OSQPInt        nnz = _adj_nnz(P_full, G, A_eq);
+    OSQPInt        i, sum_Lnz;
+    OSQPCscMatrix* KKT_temp;
+
+    qdldl_solver* s = c_calloc(1, sizeof(qdldl_solver));
+    *sp = s;
+    if (!s) return OSQP_MEM_ALLOC_ERROR;
+
+    s->name = &name_qdldl;
+    s->free = &free_linsys_solver_qdldl;
+    s->type = OSQP_DIRECT_SOLVER;
+    s->nthreads = 1;
+
+    s->adj      = csc_spalloc(dim, dim, nnz, 1, 0);
+    s->adjtoKKT = (OSQPInt *)c_malloc(nnz * sizeof(OSQPInt));
+    s->L        = c_calloc(1, sizeof(OSQPCscMatrix));
+    s->P        = (QDLDL_int *)c_malloc(dim * sizeof(QDLDL_int));
+    s->Dinv     = (QDLDL_float *)c_malloc(dim * sizeof(QDLDL_float));
+    s->bp       = (QDLDL_float *)c_malloc(dim * sizeof(QDLDL_float));
+    s->sol      = (QDLDL_float *)c_malloc(dim * sizeof(QDLDL_float));
+    if (!s->adj || !s->adjtoKKT || !s->L || !s->P || !s->Dinv || !s->bp || !s->sol ||
+        alloc_factor_workspace(s, dim)) {
+        free_linsys_solver_qdldl(s);
+        *sp = OSQP_NULL;
+        return OSQP_MEM_ALLOC_ERROR;
+    }
+    s->L->m = dim;
+    s->L->n = dim;
+    s->L->p = (OSQPInt *)c_malloc((dim + 1) * sizeof(QDLDL_int));
+
+    // Order the assembled system and keep the map of its entries
+    _adj_assemble_csc(s->adj, P_full, G, A_eq, GDiagLambda, slacks);
+    for (i = 0; i < nnz; i++) s->adjtoKKT[i] = i;
+
+    KKT_temp = csc_copy(s->adj);
+    if (!s->L->p || !KKT_temp ||
+        permute_KKT(&KKT_temp, s, 0, nnz, 0, OSQP_NULL, s->adjtoKKT, OSQP_NULL)) {
+        if (KKT_temp) csc_spfree(KKT_temp);
+        free_linsys_solver_qdldl(s);
+        *sp = OSQP_NULL;
+        return OSQP_LINSYS_SOLVER_INIT_ERROR;
+    }
+    s->KKT = KKT_temp;
+
+    // Allocate the factor for the pattern of the permuted system
+    sum_Lnz = QDLDL_etree(dim, s->KKT->p, s->KKT->i, s->iwork, s->Lnz, s->etree);
+    if (sum_Lnz >= 0) {
+        s->L->i = (OSQPInt *)c_malloc(sizeof(OSQPInt) * sum_Lnz);
+        s->L->x = (OSQPFloat *)c_malloc(sizeof(OSQPFloat) * sum_Lnz);
+        s->L->nzmax = sum_Lnz;
+    }
+    if (sum_Lnz < 0 || (sum_Lnz && (!s->L->i || !s->L->x))) {
+        free_linsys_solver_qdldl(s);
+        *sp = OSQP_NULL;
+        return OSQP_LINSYS_SOLVER_INIT_ERROR;
+    }
+
+    return 0;
+}
+
+/* Factor and solve with the structure kept in s; refreshes the values only */
+static OSQPInt _adj_solve_persistent(qdldl_solver*      s,
+                                     const OSQPMatrix*  P_full,
+                                     const OSQPMatrix*  G,
+                                     const OSQPMatrix*  A_eq,
+                                     const OSQPMatrix*  GDiagLambda,
+                                     const OSQPVectorf* slacks,
+                                     const OSQPVectorf* rhs) {
+
+    OSQPCscMatrix* adj = s->adj;
+    OSQPInt        dim = adj->n;
+    OSQPInt        nnz = adj->p[dim];
+    OSQPFloat*     b   = rhs->values;
+    OSQPFloat*     sol = s->sol;
+    OSQPFloat*     res = s->fwork;  // factorization workspace, free after QDLDL_factor
+    OSQPFloat      norm;
+    OSQPInt        i, k;
+
+    _adj_assemble_csc(adj, P_full, G, A_eq, GDiagLambda, slacks);
+    for (i = 0; i < nnz; i++) s->KKT->x[s->adjtoKKT[i]] = adj->x[i];
+
+    // Perturb the factored copy only; adj stays the system to refine against
+    for (i = 0; i < dim; i++) {
+        s->KKT->x[s->adjtoKKT[adj->p[i+1]-1]] += (i < dim / 2) ? 1e-6 : -1e-6;
+    }
+
+    if (QDLDL_factor(dim, s->KKT->p, s->KKT->i, s->KKT->x,
+                     s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
+                     s->etree, s->bwork, s->iwork, s->fwork) < 0) {
+        c_eprint("Error in the LDL factorization of the adjoint system");
+        return 1;
+    }
+
+    // Gradients of a few outputs give right-hand sides that are mostly zero
+    LDLSolve(sol, b, s, 1);
+
+    for (k = 0; k < 200; k++) {
+        for (i = 0; i < dim; i++) res[i] = b[i];
+        csc_Axpy_sym_triu(adj, sol, res, 1, -1);
+
+        norm = 0.0;
+        for (i = 0; i < dim; i++) norm += res[i] * res[i];
+        if (c_sqrt(norm) < 1e-12) break;
+
+        LDLSolve(res, res, s, 1);
+        for (i = 0; i < dim; i++) sol[i] -= res[i];
+    }
+
+    for (i = 0; i < dim; i++) b[i] = sol[i];
+
+    return 0;
+}
+
 OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
                                  const OSQPMatrix*  P_full,
                                  const OSQPMatrix*  G,
@@ -671,6 +1650,8 @@ OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
                                  const OSQPVectorf* slacks,
                                  const OSQPVectorf* rhs) {
 
+    if (s) return _adj_solve_persistent(s, P_full, G, A_eq, GDiagLambda, slacks, rhs);
+
     OSQPInt n = OSQPMatrix_get_m(P_full);
     OSQPInt n_ineq = OSQPMatrix_get_m(G);
     OSQPInt n_eq = OSQPMatrix_get_m(A_eq);
@@ -742,7 +1723,6 @@ OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
     fwork = (QDLDL_float*)malloc(sizeof(QDLDL_float)*An);
 
     P = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(An));
-    Pinv = (QDLDL_int*)malloc(sizeof(QDLDL_int)*(An));
 
     OSQPInt amd_status;
 #ifdef OSQP_USE_LONG
@@ -772,7 +1752,8 @@ OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
 
     //when solving A\b, start with x = b
     for (i = 0 ; i < An ; i++) x_work[i] = rhs->values[P[i]];
-    QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
+    if (!LDLSolve_sparse(Ln, Lp, Li, Lx, Dinv, x_work, iwork))
+        QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
     for (i = 0 ; i < An ; i++) x[P[i]] = x_work[i];
 
     OSQPVectorf *sol = OSQPVectorf_new(x, An);
@@ -785,13 +1766,15 @@ OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
         if (OSQPVectorf_norm_2(residual) < 1e-12) break;
 
         for (i = 0 ; i < An ; i++) x_work[i] = residual->values[P[i]];
-        QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
+        if (!LDLSolve_sparse(Ln, Lp, Li, Lx, Dinv, x_work, iwork))
+            QDLDL_solve(Ln, Lp, Li, Lx, Dinv, x_work);
         for (i = 0 ; i < An ; i++) residual->values[P[i]] = x_work[i];
 
         OSQPVectorf_minus(sol, sol, residual);
     }
 
-    OSQPVectorf_copy(rhs, sol);
+    // rhs may be longer than the system (it is sized for the worst case)
+    for (i = 0 ; i < An ; i++) rhs->values[i] = sol->values[i];
 
     c_free(Lp);
     c_free(Li);
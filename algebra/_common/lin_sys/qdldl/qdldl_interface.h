@@ -38,6 +38,24 @@ struct qdldl {
     OSQPInt (*adjoint_derivative)(struct qdldl* self);
 
     void (*free)(struct qdldl* self); ///< Free workspace (only if desktop)
+
+    OSQPInt (*solve_block)(struct qdldl*       self,
+                                  OSQPVectorf** b,
+                                  OSQPInt       k,
+                                  OSQPInt       admm_iter);
+
+    OSQPInt (*polish_factor)(struct qdldl*       self,
+                             const  OSQPVectori* active_flags);
+
+    OSQPInt (*update_matrices_rho_vec)(struct qdldl*       self,
+                                       const  OSQPMatrix*  P,
+                                       const  OSQPInt*     Px_new_idx,
+                                              OSQPInt      P_new_n,
+                                       const  OSQPMatrix*  A,
+                                       const  OSQPInt*     Ax_new_idx,
+                                              OSQPInt      A_new_n,
+                                       const  OSQPVectorf* rho_vec,
+                                              OSQPFloat    rho_sc);
 #endif
 
     // This used only in non embedded or embedded 2 version
@@ -73,6 +91,12 @@ struct qdldl {
     OSQPFloat      rho_inv;       ///< scalar parameter (used if rho_inv_vec == NULL)
 #ifndef OSQP_EMBEDDED_MODE
     OSQPInt        polishing;     ///< polishing flag
+    OSQPInt        lean_memory;   ///< lean flag; KKT and factorization workspace only exist while refactoring
+    OSQPCscMatrix* Pcsc;          ///< matrix P used to reassemble the KKT matrix (lean mode only)
+    OSQPCscMatrix* Acsc;          ///< matrix A used to reassemble the KKT matrix (lean mode only)
+    OSQPFloat*     bk;            ///< interleaved workspace for block solves (size (n+m)*bk_cols)
+    OSQPInt        bk_cols;       ///< number of right-hand sides bk has room for
+    struct qdldl_sn_* sn;         ///< supernodes of L for the dense kernels (see qdldl_supernodal.h), OSQP_NULL if not used
 #endif
     OSQPInt        n;             ///< number of QP variables
     OSQPInt        m;             ///< number of QP constraints
@@ -91,8 +115,13 @@ struct qdldl {
     QDLDL_int*   iwork;
     QDLDL_bool*  bwork;
     QDLDL_float* fwork;
+    QDLDL_float* row_work;        ///< cost of recomputing each row of L, decides on partial refactorizations
+    QDLDL_int    rows_refactored; ///< rows of L recomputed after the last matrix update (all of them for a full factorization)
+    QDLDL_float* pol_Lx;          ///< values of L of the factorization not in use (see polish_factor)
+    QDLDL_float* pol_Dinv;        ///< Dinv of the factorization not in use (see polish_factor)
 
-    OSQPCscMatrix* adj;
+    OSQPCscMatrix* adj;           ///< unpermuted adjoint system (adjoint solvers only)
+    OSQPInt*       adjtoKKT;      ///< Index of elements from adj to KKT matrix (adjoint solvers only)
 #endif
 
     /** @} */
@@ -100,6 +129,24 @@ struct qdldl {
 
 
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Symbolic analysis of the KKT matrix of the ADMM iterations, which only
+ * depends on the patterns of P and A: the fill-reducing ordering, and the
+ * elimination tree and column counts of the permuted matrix. It does not
+ * read the values of P and A, so it can run while they are scaled.
+ */
+typedef struct qdldl_symbolic_ qdldl_symbolic;
+
+struct qdldl_symbolic_ {
+    QDLDL_int  n;        ///< dimension of the KKT matrix
+    QDLDL_int* P;        ///< fill-reducing permutation (AMD)
+    QDLDL_int* etree;    ///< elimination tree of the permuted KKT matrix
+    QDLDL_int* Lnz;      ///< number of entries of each column of L
+    QDLDL_int  sum_Lnz;  ///< number of entries of L
+};
+#endif
+
 /**
  * Initialize QDLDL Solver
  *
@@ -118,6 +165,46 @@ OSQPInt init_linsys_solver_qdldl(qdldl_solver**      sp,
                                  const OSQPSettings* settings,
                                  OSQPInt             polishing);
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Analyse the pattern of the KKT matrix of the ADMM iterations
+ *
+ * @param  symp  Symbolic analysis, OSQP_NULL on failure
+ * @param  P     Objective function matrix (upper triangular form), only its pattern is read
+ * @param  A     Constraints matrix, only its pattern is read
+ * @return       Exitflag for error (0 if no errors)
+ */
+OSQPInt qdldl_symbolic_new(qdldl_symbolic**     symp,
+                           const OSQPCscMatrix* P,
+                           const OSQPCscMatrix* A);
+
+/**
+ * Free a symbolic analysis
+ * @param  sym  Symbolic analysis
+ */
+void qdldl_symbolic_free(qdldl_symbolic* sym);
+
+/**
+ * Initialize the QDLDL solver of the ADMM iterations as
+ * init_linsys_solver_qdldl does, with the ordering, elimination tree and
+ * column counts of a symbolic analysis of the patterns of P and A
+ *
+ * @param  s         Pointer to a private structure
+ * @param  P         Objective function matrix (upper triangular form)
+ * @param  A         Constraints matrix
+ * @param  rho_vec   Algorithm parameter
+ * @param  settings  Solver settings
+ * @param  sym       Symbolic analysis of P and A (OSQP_NULL to analyse them here)
+ * @return           Exitflag for error (0 if no errors)
+ */
+OSQPInt init_linsys_solver_qdldl_analysed(qdldl_solver**        sp,
+                                          const OSQPMatrix*     P,
+                                          const OSQPMatrix*     A,
+                                          const OSQPVectorf*    rho_vec,
+                                          const OSQPSettings*   settings,
+                                          const qdldl_symbolic* sym);
+#endif
+
 /**
  * Get the user-friendly name of the QDLDL solver.
  * @return The user-friendly name
@@ -134,6 +221,39 @@ OSQPInt solve_linsys_qdldl(qdldl_solver* s,
                            OSQPVectorf*  b,
                            OSQPInt       admm_iter);
 
+#ifndef OSQP_EMBEDDED_MODE
+/**
+ * Solve the linear system for k right-hand sides, streaming L once for each
+ * group of up to QDLDL_BLOCK_WIDTH of them, and store the results in b[0..k-1]
+ * @param  s        Linear system solver structure
+ * @param  b        Right-hand sides
+ * @param  k        Number of right-hand sides
+ * @return          Exitflag
+ */
+OSQPInt solve_block_linsys_qdldl(qdldl_solver* s,
+                                 OSQPVectorf** b,
+                                 OSQPInt       k,
+                                 OSQPInt       admm_iter);
+
+/**
+ * Factor the polishing system on the pattern of the ADMM KKT matrix, or
+ * switch back to the ADMM factorization.
+ *
+ * With active_flags, the A entries of the rows of the inactive constraints
+ * are zeroed, every constraint row gets -sigma on the diagonal and the
+ * result is factored into a second set of values of L and Dinv, with the
+ * ADMM ordering and pattern. The KKT matrix keeps the ADMM values, and solve
+ * returns the solution of the polishing system until the function is called
+ * with OSQP_NULL, which swaps the ADMM factorization back in.
+ *
+ * @param  s             Solver
+ * @param  active_flags  Flags of the constraints (0 if inactive), or OSQP_NULL
+ * @return               Exitflag (0 if no errors)
+ */
+OSQPInt polish_factor_linsys_qdldl(qdldl_solver*      s,
+                                   const OSQPVectori* active_flags);
+#endif
+
 
 void update_settings_linsys_solver_qdldl(qdldl_solver*       s,
                                          const OSQPSettings* settings);
@@ -184,6 +304,55 @@ OSQPInt update_linsys_solver_rho_vec_qdldl(qdldl_solver*      s,
  */
 void free_linsys_solver_qdldl(qdldl_solver* s);
 
+/**
+ * Update the matrices and rho_vec of the linear system solver, and refactor
+ * the KKT matrix once
+ * @param  s          Linear system solver structure
+ * @param  P          Matrix P
+ * @param  Px_new_idx elements of P to update,
+ * @param  P_new_n    number of elements to update
+ * @param  A          Matrix A
+ * @param  Ax_new_idx elements of A to update,
+ * @param  A_new_n    number of elements to update
+ * @param  rho_vec    new rho_vec value
+ * @param  rho_sc     new scalar rho, used without rho_vec
+ * @return            Exitflag
+ */
+OSQPInt update_linsys_solver_matrices_rho_vec_qdldl(qdldl_solver*      s,
+                                                    const OSQPMatrix*  P,
+                                                    const OSQPInt*     Px_new_idx,
+                                                    OSQPInt            P_new_n,
+                                                    const OSQPMatrix*  A,
+                                                    const OSQPInt*     Ax_new_idx,
+                                                    OSQPInt            A_new_n,
+                                                    const OSQPVectorf* rho_vec,
+                                                    OSQPFloat          rho_sc);
+
+/**
+ * Initialize a QDLDL solver of the adjoint system with the structure of the
+ * given matrices. The ordering, the elimination tree and the factor are
+ * allocated once, so that adjoint_derivative_qdldl does not allocate when
+ * the values change but the structure does not.
+ * @param  sp          Pointer to a private structure
+ * @param  P           Full objective function matrix
+ * @param  G           Inequality constraints matrix
+ * @param  A_eq        Equality constraints matrix
+ * @param  GDiagLambda diag(lambda) * G
+ * @param  slacks      Slacks of the inequality constraints
+ * @return             Exitflag for error (0 if no errors)
+ */
+OSQPInt adjoint_derivative_init_qdldl(qdldl_solver**     sp,
+                                      const OSQPMatrix*  P,
+                                      const OSQPMatrix*  G,
+                                      const OSQPMatrix*  A_eq,
+                                      const OSQPMatrix*  GDiagLambda,
+                                      const OSQPVectorf* slacks);
+
+/**
+ * Solve the adjoint system in place of rhs.
+ * @param  s  Solver from adjoint_derivative_init_qdldl, or OSQP_NULL to
+ *            order and factor the system from scratch
+ */
 OSQPInt adjoint_derivative_qdldl(qdldl_solver*      s,
                                  const OSQPMatrix*  P,
                                  const OSQPMatrix*  G,
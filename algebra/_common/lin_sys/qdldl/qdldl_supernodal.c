@@ -0,0 +1,411 @@
+#include "glob_opts.h"
+#include "qdldl_supernodal.h"
+
+/*
+ * The rows of supernode J = f, ..., l-1 are R_J = f, ..., l-1, S, and the
+ * entry in position t of column f+jj is Lx[Lp[f+jj] - jj - 1 + t] for t > jj
+ * (see qdldl_sn). Row R_J[t] for t > 0 is Li[Lp[f] - 1 + t].
+ */
+
+/* Offset of column f+jj of a supernode in Lx, indexed by the position in R_J */
+#define SN_COL(Lp, f, jj) ((Lp)[(f) + (jj)] - (jj) - 1)
+
+
+OSQPInt qdldl_sn_new(qdldl_sn**           snp,
+                     const OSQPCscMatrix* KKT,
+                     const QDLDL_int*     etree,
+                     const QDLDL_int*     Lnz) {
+
+  QDLDL_int   j, J, k, f, w, nsuper;
+  QDLDL_int   n  = KKT->n;
+  QDLDL_int   nz = KKT->p[n];
+  QDLDL_float work      = 0.0;
+  QDLDL_float wide_work = 0.0;
+  QDLDL_float J_work;
+  qdldl_sn*   sn;
+
+  *snp = OSQP_NULL;
+  if (n == 0) return 0;
+
+  /* Column j continues the supernode of j-1 if it is its parent and has the
+   * same rows past it. Eliminating column j takes about Lnz[j]^2 operations,
+   * of which only those in wide supernodes go to the dense kernels. */
+  nsuper = 0;
+  f      = 0;
+  J_work = (QDLDL_float)Lnz[0] * Lnz[0];
+  for (j = 1; j <= n; j++) {
+    if (j < n && etree[j-1] == j && Lnz[j-1] == Lnz[j] + 1) {
+      J_work += (QDLDL_float)Lnz[j] * Lnz[j];
+      continue;
+    }
+    nsuper++;
+    work += J_work;
+    if (j - f >= QDLDL_SN_MIN_WIDTH) wide_work += J_work;
+    if (j < n) {
+      f      = j;
+      J_work = (QDLDL_float)Lnz[j] * Lnz[j];
+    }
+  }
+  if (work == 0.0 || wide_work < QDLDL_SN_MIN_FRACTION * work) return 0;
+
+  sn = (qdldl_sn *)c_calloc(1, sizeof(qdldl_sn));
+  if (!sn) return OSQP_MEM_ALLOC_ERROR;
+  sn->n      = n;
+  sn->nsuper = nsuper;
+
+  sn->super     = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * (nsuper + 1));
+  sn->col_super = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * n);
+  sn->Tp        = (QDLDL_int *)c_calloc(n + 1, sizeof(QDLDL_int));
+  sn->Ti        = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * nz);
+  sn->Tmap      = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * nz);
+  sn->iwork     = (QDLDL_int *)c_malloc(sizeof(QDLDL_int) * 4 * n);
+  sn->work      = (QDLDL_float *)c_malloc(sizeof(QDLDL_float) * 2 * n);
+  if (!sn->super || !sn->col_super || !sn->Tp || (nz && (!sn->Ti || !sn->Tmap)) ||
+      !sn->iwork || !sn->work) {
+    qdldl_sn_free(sn);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  /* Same pass as above, recording the supernodes */
+  J = 0;
+  sn->super[0] = 0;
+  for (j = 0; j < n; j++) {
+    if (j > 0 && !(etree[j-1] == j && Lnz[j-1] == Lnz[j] + 1)) sn->super[++J] = j;
+    sn->col_super[j] = J;
+  }
+  sn->super[nsuper] = n;
+
+  /* Row k of the upper triangular KKT matrix is the lower part of column k */
+  for (k = 0; k < nz; k++) sn->Tp[KKT->i[k] + 1]++;
+  for (j = 0; j < n; j++) sn->Tp[j+1] += sn->Tp[j];
+  for (j = 0; j < n; j++) sn->iwork[j] = sn->Tp[j];
+  for (j = 0; j < n; j++) {
+    for (k = KKT->p[j]; k < KKT->p[j+1]; k++) {
+      w = sn->iwork[KKT->i[k]]++;
+      sn->Ti[w]   = j;
+      sn->Tmap[w] = k;
+    }
+  }
+
+  *snp = sn;
+  return 0;
+}
+
+
+void qdldl_sn_pattern(qdldl_sn*            sn,
+                      const OSQPCscMatrix* KKT,
+                      const QDLDL_int*     etree,
+                      const QDLDL_int*     Lnz,
+                      QDLDL_int*           Lp,
+                      QDLDL_int*           Li) {
+
+  QDLDL_int  i, j, k, r;
+  QDLDL_int  n      = sn->n;
+  QDLDL_int* marker = sn->iwork;
+  QDLDL_int* next   = sn->iwork + n;
+
+  Lp[0] = 0;
+  for (j = 0; j < n; j++) {
+    Lp[j+1]   = Lp[j] + Lnz[j];
+    next[j]   = Lp[j];
+    marker[j] = -1;
+  }
+
+  /* Row k of L is the union of the paths from the entries of column k of the
+   * KKT matrix up the elimination tree, stopping at k; visiting the rows in
+   * increasing order leaves each column of L sorted */
+  for (k = 0; k < n; k++) {
+    marker[k] = k;
+    for (i = KKT->p[k]; i < KKT->p[k+1]; i++) {
+      for (r = KKT->i[i]; marker[r] != k; r = etree[r]) {
+        marker[r]     = k;
+        Li[next[r]++] = k;
+      }
+    }
+  }
+}
+
+
+QDLDL_int qdldl_sn_factor(qdldl_sn*            sn,
+                          const OSQPCscMatrix* KKT,
+                          const QDLDL_int*     Lp,
+                          const QDLDL_int*     Li,
+                          QDLDL_float*         Lx,
+                          QDLDL_float*         D,
+                          QDLDL_float*         Dinv) {
+
+  QDLDL_int    n     = sn->n;
+  QDLDL_int*   map   = sn->iwork;
+  QDLDL_int*   head  = sn->iwork + n;
+  QDLDL_int*   link  = sn->iwork + 2*n;
+  QDLDL_int*   pos   = sn->iwork + 3*n;
+  QDLDL_float* tmp   = sn->work;
+  QDLDL_float* Kx    = KKT->x;
+
+  QDLDL_int   J, K, Knext, f, l, w, h, fK, wK, hK, c, jj, ii, kk, t, q, p1, p2, k;
+  QDLDL_int   rJ, rK, cb, c0, c1, c2, c3;
+  QDLDL_int   pos_D_count = 0;
+  QDLDL_float d0, d1, d2, d3;
+
+  for (J = 0; J < sn->nsuper; J++) head[J] = -1;
+
+  for (J = 0; J < sn->nsuper; J++) {
+    f  = sn->super[J];
+    l  = sn->super[J+1];
+    w  = l - f;
+    h  = Lp[f+1] - Lp[f] + 1;
+    rJ = Lp[f] - 1;
+
+    /* Positions of the rows of J */
+    for (t = 0; t < w; t++) map[f + t] = t;
+    for (t = w; t < h; t++) map[Li[rJ + t]] = t;
+
+    /* Scatter the lower part of the columns of the KKT matrix */
+    for (t = Lp[f]; t < Lp[l]; t++) Lx[t] = 0.0;
+    for (jj = 0; jj < w; jj++) {
+      c    = f + jj;
+      cb   = SN_COL(Lp, f, jj);
+      D[c] = 0.0;
+      for (k = sn->Tp[c]; k < sn->Tp[c+1]; k++) {
+        if (sn->Ti[k] == c) D[c] = Kx[sn->Tmap[k]];
+        else                Lx[cb + map[sn->Ti[k]]] = Kx[sn->Tmap[k]];
+      }
+    }
+
+    /* Updates from the supernodes with rows in J */
+    K       = head[J];
+    head[J] = -1;
+    for (; K != -1; K = Knext) {
+      Knext = link[K];
+      fK    = sn->super[K];
+      wK    = sn->super[K+1] - fK;
+      hK    = Lp[fK+1] - Lp[fK] + 1;
+      rK    = Lp[fK] - 1;
+      p1    = pos[K];
+      for (p2 = p1; p2 < hK && Li[rK + p2] < l; p2++);
+
+      for (q = p1; q < p2 && wK < QDLDL_SN_MIN_WIDTH; q++) {
+        /* Narrow supernodes update one column at a time, as in QDLDL */
+        c  = Li[rK + q];
+        cb = SN_COL(Lp, f, c - f);
+        for (kk = 0; kk < wK; kk++) {
+          c0    = SN_COL(Lp, fK, kk);
+          d0    = D[fK + kk] * Lx[c0 + q];
+          D[c] -= d0 * Lx[c0 + q];
+          for (t = q + 1; t < hK; t++) Lx[cb + map[Li[rK + t]]] -= d0 * Lx[c0 + t];
+        }
+      }
+
+      for (q = p1; q < p2 && wK >= QDLDL_SN_MIN_WIDTH; q++) {
+        /* tmp[q:hK] = L_K[q:hK,:] D_K L_K[q,:]' */
+        for (t = q; t < hK; t++) tmp[t] = 0.0;
+        for (kk = 0; kk + 4 <= wK; kk += 4) {
+          c0 = SN_COL(Lp, fK, kk);
+          c1 = SN_COL(Lp, fK, kk + 1);
+          c2 = SN_COL(Lp, fK, kk + 2);
+          c3 = SN_COL(Lp, fK, kk + 3);
+          d0 = D[fK + kk]     * Lx[c0 + q];
+          d1 = D[fK + kk + 1] * Lx[c1 + q];
+          d2 = D[fK + kk + 2] * Lx[c2 + q];
+          d3 = D[fK + kk + 3] * Lx[c3 + q];
+          for (t = q; t < hK; t++) {
+            tmp[t] += d0 * Lx[c0 + t] + d1 * Lx[c1 + t] + d2 * Lx[c2 + t] + d3 * Lx[c3 + t];
+          }
+        }
+        for (; kk < wK; kk++) {
+          c0 = SN_COL(Lp, fK, kk);
+          d0 = D[fK + kk] * Lx[c0 + q];
+          for (t = q; t < hK; t++) tmp[t] += d0 * Lx[c0 + t];
+        }
+
+        /* Subtract it from the column of J in row q of K */
+        c     = Li[rK + q];
+        cb    = SN_COL(Lp, f, c - f);
+        D[c] -= tmp[q];
+        for (t = q + 1; t < hK; t++) Lx[cb + map[Li[rK + t]]] -= tmp[t];
+      }
+
+      /* Pass K on to the supernode of its next row */
+      pos[K] = p2;
+      if (p2 < hK) {
+        k       = sn->col_super[Li[rK + p2]];
+        link[K] = head[k];
+        head[k] = K;
+      }
+    }
+
+    /* Dense left-looking factorization of the columns of J */
+    for (jj = 0; jj < w; jj++) {
+      c  = f + jj;
+      cb = SN_COL(Lp, f, jj);
+
+      for (ii = 0; ii + 4 <= jj; ii += 4) {
+        c0 = SN_COL(Lp, f, ii);
+        c1 = SN_COL(Lp, f, ii + 1);
+        c2 = SN_COL(Lp, f, ii + 2);
+        c3 = SN_COL(Lp, f, ii + 3);
+        d0 = D[f + ii]     * Lx[c0 + jj];
+        d1 = D[f + ii + 1] * Lx[c1 + jj];
+        d2 = D[f + ii + 2] * Lx[c2 + jj];
+        d3 = D[f + ii + 3] * Lx[c3 + jj];
+        D[c] -= d0 * Lx[c0 + jj] + d1 * Lx[c1 + jj] + d2 * Lx[c2 + jj] + d3 * Lx[c3 + jj];
+        for (t = jj + 1; t < h; t++) {
+          Lx[cb + t] -= d0 * Lx[c0 + t] + d1 * Lx[c1 + t] + d2 * Lx[c2 + t] + d3 * Lx[c3 + t];
+        }
+      }
+      for (; ii < jj; ii++) {
+        c0    = SN_COL(Lp, f, ii);
+        d0    = D[f + ii] * Lx[c0 + jj];
+        D[c] -= d0 * Lx[c0 + jj];
+        for (t = jj + 1; t < h; t++) Lx[cb + t] -= d0 * Lx[c0 + t];
+      }
+
+      if (D[c] == 0.0) return -1;
+      if (D[c] > 0.0) pos_D_count++;
+      Dinv[c] = 1 / D[c];
+      for (t = jj + 1; t < h; t++) Lx[cb + t] *= Dinv[c];
+    }
+
+    /* Pass J on to the supernode of its first row past it */
+    pos[J] = w;
+    if (h > w) {
+      k       = sn->col_super[Li[rJ + w]];
+      link[J] = head[k];
+      head[k] = J;
+    }
+  }
+
+  return pos_D_count;
+}
+
+
+void qdldl_sn_solve(qdldl_sn*          sn,
+                    const QDLDL_int*   Lp,
+                    const QDLDL_int*   Li,
+                    const QDLDL_float* Lx,
+                    const QDLDL_float* Dinv,
+                    QDLDL_float*       x) {
+
+  QDLDL_int    J, f, l, w, h, jj, t, rJ, cb, c0, c1, c2, c3;
+  QDLDL_int    n   = sn->n;
+  QDLDL_float* tmp = sn->work;
+  QDLDL_float* dot = sn->work + n;
+  QDLDL_float  x0, x1, x2, x3, s0, s1, s2, s3;
+
+  /* Solve L y = b */
+  for (J = 0; J < sn->nsuper; J++) {
+    f  = sn->super[J];
+    l  = sn->super[J+1];
+    w  = l - f;
+    h  = Lp[f+1] - Lp[f] + 1;
+    rJ = Lp[f] - 1;
+
+    /* Narrow supernodes are solved one column at a time, as in QDLDL */
+    if (w < QDLDL_SN_MIN_WIDTH) {
+      for (jj = 0; jj < w; jj++) {
+        cb = SN_COL(Lp, f, jj);
+        x0 = x[f + jj];
+        for (t = jj + 1; t < h; t++) x[Li[rJ + t]] -= Lx[cb + t] * x0;
+      }
+      continue;
+    }
+
+    /* Triangular block, then tmp = L[S,J] x[J] and scatter to the rows S */
+    for (jj = 0; jj < w; jj++) {
+      cb = SN_COL(Lp, f, jj);
+      x0 = x[f + jj];
+      for (t = jj + 1; t < w; t++) x[f + t] -= Lx[cb + t] * x0;
+    }
+    if (h == w) continue;
+    for (t = w; t < h; t++) tmp[t] = 0.0;
+    for (jj = 0; jj + 4 <= w; jj += 4) {
+      c0 = SN_COL(Lp, f, jj);
+      c1 = SN_COL(Lp, f, jj + 1);
+      c2 = SN_COL(Lp, f, jj + 2);
+      c3 = SN_COL(Lp, f, jj + 3);
+      x0 = x[f + jj];
+      x1 = x[f + jj + 1];
+      x2 = x[f + jj + 2];
+      x3 = x[f + jj + 3];
+      for (t = w; t < h; t++) {
+        tmp[t] += Lx[c0 + t] * x0 + Lx[c1 + t] * x1 + Lx[c2 + t] * x2 + Lx[c3 + t] * x3;
+      }
+    }
+    for (; jj < w; jj++) {
+      c0 = SN_COL(Lp, f, jj);
+      x0 = x[f + jj];
+      for (t = w; t < h; t++) tmp[t] += Lx[c0 + t] * x0;
+    }
+    for (t = w; t < h; t++) x[Li[rJ + t]] -= tmp[t];
+  }
+
+  for (t = 0; t < n; t++) x[t] *= Dinv[t];
+
+  /* Solve L' x = y */
+  for (J = sn->nsuper - 1; J >= 0; J--) {
+    f  = sn->super[J];
+    l  = sn->super[J+1];
+    w  = l - f;
+    h  = Lp[f+1] - Lp[f] + 1;
+    rJ = Lp[f] - 1;
+
+    if (w < QDLDL_SN_MIN_WIDTH) {
+      for (jj = w - 1; jj >= 0; jj--) {
+        cb = SN_COL(Lp, f, jj);
+        s0 = 0.0;
+        for (t = jj + 1; t < h; t++) s0 += Lx[cb + t] * x[Li[rJ + t]];
+        x[f + jj] -= s0;
+      }
+      continue;
+    }
+
+    /* dot = L[S,J]' x[S] on the gathered rows S, then the triangular block */
+    for (jj = 0; jj < w; jj++) dot[jj] = 0.0;
+    if (h > w) {
+      for (t = w; t < h; t++) tmp[t] = x[Li[rJ + t]];
+      for (jj = 0; jj + 4 <= w; jj += 4) {
+        c0 = SN_COL(Lp, f, jj);
+        c1 = SN_COL(Lp, f, jj + 1);
+        c2 = SN_COL(Lp, f, jj + 2);
+        c3 = SN_COL(Lp, f, jj + 3);
+        s0 = s1 = s2 = s3 = 0.0;
+        for (t = w; t < h; t++) {
+          s0 += Lx[c0 + t] * tmp[t];
+          s1 += Lx[c1 + t] * tmp[t];
+          s2 += Lx[c2 + t] * tmp[t];
+          s3 += Lx[c3 + t] * tmp[t];
+        }
+        dot[jj]     = s0;
+        dot[jj + 1] = s1;
+        dot[jj + 2] = s2;
+        dot[jj + 3] = s3;
+      }
+      for (; jj < w; jj++) {
+        c0 = SN_COL(Lp, f, jj);
+        s0 = 0.0;
+        for (t = w; t < h; t++) s0 += Lx[c0 + t] * tmp[t];
+        dot[jj] = s0;
+      }
+    }
+    for (jj = w - 1; jj >= 0; jj--) {
+      cb = SN_COL(Lp, f, jj);
+      s0 = dot[jj];
+      for (t = jj + 1; t < w; t++) s0 += Lx[cb + t] * x[f + t];
+      x[f + jj] -= s0;
+    }
+  }
+}
+
+
+void qdldl_sn_free(qdldl_sn* sn) {
+  if (sn) {
+    if (sn->super)     c_free(sn->super);
+    if (sn->col_super) c_free(sn->col_super);
+    if (sn->Tp)        c_free(sn->Tp);
+    if (sn->Ti)        c_free(sn->Ti);
+    if (sn->Tmap)      c_free(sn->Tmap);
+    if (sn->iwork)     c_free(sn->iwork);
+    if (sn->work)      c_free(sn->work);
+    c_free(sn);
+  }
+}
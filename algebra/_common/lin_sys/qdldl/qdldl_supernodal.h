@@ -0,0 +1,138 @@
+#ifndef QDLDL_SUPERNODAL_H
+#define QDLDL_SUPERNODAL_H
+
+
+#include "osqp.h"
+#include "types.h"
+#include "qdldl_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Supernodes narrower than this are factored and solved one column at a time
+ * and do not count towards the decision to use the supernodal kernels
+ */
+#ifndef QDLDL_SN_MIN_WIDTH
+# define QDLDL_SN_MIN_WIDTH 4
+#endif
+
+/*
+ * The supernodal kernels are used when the supernodes of at least
+ * QDLDL_SN_MIN_WIDTH columns account for at least this fraction of the work
+ * of the factorization (the sum of the squared column counts of L)
+ */
+#ifndef QDLDL_SN_MIN_FRACTION
+# define QDLDL_SN_MIN_FRACTION 0.5
+#endif
+
+/**
+ * Supernodes of the LDL' factor of a KKT matrix.
+ *
+ * A supernode is a range of consecutive columns f, ..., l-1 of L where each
+ * column is the parent of the previous one in the elimination tree and has
+ * the same rows below the range. Column j then holds rows j+1, ..., l-1
+ * followed by the rows of the range, so the entries of the supernode form a
+ * dense lower trapezoid stored column by column in the CSC arrays of L: the
+ * entry of column f+jj at position t > jj of the rows f, ..., l-1, S is
+ * Lx[Lp[f+jj] + t - jj - 1]. The kernels work on these dense columns and
+ * keep the CSC layout, so the other users of L are not affected.
+ */
+typedef struct qdldl_sn_ qdldl_sn;
+
+struct qdldl_sn_ {
+  QDLDL_int    n;          ///< dimension of the KKT matrix
+  QDLDL_int    nsuper;     ///< number of supernodes
+  QDLDL_int*   super;      ///< first column of each supernode (size nsuper+1)
+  QDLDL_int*   col_super;  ///< supernode of each column (size n)
+  QDLDL_int*   Tp;         ///< column pointers of the strict lower triangle plus diagonal of the KKT matrix (size n+1)
+  QDLDL_int*   Ti;         ///< row indices of that lower triangle (size nnz(KKT))
+  QDLDL_int*   Tmap;       ///< position in the KKT matrix of each entry of the lower triangle (size nnz(KKT))
+  QDLDL_int*   iwork;      ///< row map, update lists and positions of the factorization (size 4n)
+  QDLDL_float* work;       ///< dense workspace of the factorization and the solves (size 2n)
+};
+
+/**
+ * Find the supernodes of the factor of a KKT matrix from its elimination tree
+ * and column counts, and allocate the supernodal structure if they are large
+ * enough for the supernodal kernels to pay off.
+ *
+ * @param  snp    Supernodal structure, or OSQP_NULL if the supernodes are too small
+ * @param  KKT    Permuted KKT matrix (upper triangular)
+ * @param  etree  Elimination tree of KKT
+ * @param  Lnz    Number of entries of each column of L
+ * @return        Exitflag (0 if no errors)
+ */
+OSQPInt qdldl_sn_new(qdldl_sn**           snp,
+                     const OSQPCscMatrix* KKT,
+                     const QDLDL_int*     etree,
+                     const QDLDL_int*     Lnz);
+
+/**
+ * Compute the pattern of L (the same as the one of QDLDL_factor, with sorted
+ * row indices in each column)
+ *
+ * @param  sn     Supernodal structure
+ * @param  KKT    Permuted KKT matrix (upper triangular)
+ * @param  etree  Elimination tree of KKT
+ * @param  Lnz    Number of entries of each column of L
+ * @param  Lp     Column pointers of L (size n+1)
+ * @param  Li     Row indices of L (size sum(Lnz))
+ */
+void qdldl_sn_pattern(qdldl_sn*            sn,
+                      const OSQPCscMatrix* KKT,
+                      const QDLDL_int*     etree,
+                      const QDLDL_int*     Lnz,
+                      QDLDL_int*           Lp,
+                      QDLDL_int*           Li);
+
+/**
+ * Numeric LDL' factorization of the KKT matrix with the supernodal kernels,
+ * on the pattern of L computed by qdldl_sn_pattern
+ *
+ * @param  sn    Supernodal structure
+ * @param  KKT   Permuted KKT matrix (upper triangular)
+ * @param  Lp    Column pointers of L
+ * @param  Li    Row indices of L
+ * @param  Lx    Values of L
+ * @param  D     Diagonal of D
+ * @param  Dinv  Inverse of the diagonal of D
+ * @return       Number of positive elements of D, -1 if D has a zero element
+ */
+QDLDL_int qdldl_sn_factor(qdldl_sn*            sn,
+                          const OSQPCscMatrix* KKT,
+                          const QDLDL_int*     Lp,
+                          const QDLDL_int*     Li,
+                          QDLDL_float*         Lx,
+                          QDLDL_float*         D,
+                          QDLDL_float*         Dinv);
+
+/**
+ * Solve LDL' x = b in place with the supernodal kernels
+ *
+ * @param  sn    Supernodal structure
+ * @param  Lp    Column pointers of L
+ * @param  Li    Row indices of L
+ * @param  Lx    Values of L
+ * @param  Dinv  Inverse of the diagonal of D
+ * @param  x     Right-hand side on entry, solution on exit
+ */
+void qdldl_sn_solve(qdldl_sn*          sn,
+                    const QDLDL_int*   Lp,
+                    const QDLDL_int*   Li,
+                    const QDLDL_float* Lx,
+                    const QDLDL_float* Dinv,
+                    QDLDL_float*       x);
+
+/**
+ * Free the supernodal structure
+ * @param  sn  Supernodal structure
+ */
+void qdldl_sn_free(qdldl_sn* sn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef QDLDL_SUPERNODAL_H */
@@ -0,0 +1,149 @@
+#include "glob_opts.h"
+#include "op_matrix.h"
+
+
+/* Largest absolute value of a diagonal scaling */
+static OSQPFloat max_abs(const OSQPFloat* D,
+                         OSQPInt          len) {
+  OSQPInt   i;
+  OSQPFloat v = 0.0;
+
+  for (i = 0; i < len; i++) v = c_max(v, c_absval(D[i]));
+  return v;
+}
+
+/* y = alpha*c*diag(dout)*f(diag(din)*x) + beta*y */
+static void op_product(const op_matrix* M,
+                       void            (*f)(void* data, const OSQPFloat* x, OSQPFloat* y),
+                       const OSQPFloat* din,
+                       OSQPInt          in_len,
+                       const OSQPFloat* dout,
+                       OSQPInt          out_len,
+                       const OSQPFloat* x,
+                             OSQPFloat* y,
+                             OSQPFloat  alpha,
+                             OSQPFloat  beta) {
+  OSQPInt   i;
+  OSQPFloat sc = alpha * M->c;
+
+  for (i = 0; i < in_len; i++) M->xwork[i] = din[i] * x[i];
+
+  f(M->op.data, M->xwork, M->ywork);
+
+  // y is not read when beta = 0, so it may hold anything
+  if (beta == 0.0) {
+    for (i = 0; i < out_len; i++) y[i] = sc * dout[i] * M->ywork[i];
+  }
+  else {
+    for (i = 0; i < out_len; i++) y[i] = sc * dout[i] * M->ywork[i] + beta * y[i];
+  }
+}
+
+op_matrix* op_matrix_new(const OSQPOperator* op) {
+  OSQPInt i;
+  OSQPInt len = c_max(c_max(op->m, op->n), 1);
+
+  op_matrix* M = c_calloc(1, sizeof(op_matrix));
+  if (!M) return OSQP_NULL;
+
+  M->op    = *op;
+  M->c     = 1.0;
+  M->Dl    = c_malloc(c_max(op->m, 1) * sizeof(OSQPFloat));
+  M->Dr    = c_malloc(c_max(op->n, 1) * sizeof(OSQPFloat));
+  M->xwork = c_malloc(len * sizeof(OSQPFloat));
+  M->ywork = c_malloc(len * sizeof(OSQPFloat));
+  if (!M->Dl || !M->Dr || !M->xwork || !M->ywork) {
+    op_matrix_free(M);
+    return OSQP_NULL;
+  }
+
+  for (i = 0; i < op->m; i++) M->Dl[i] = 1.0;
+  for (i = 0; i < op->n; i++) M->Dr[i] = 1.0;
+
+  return M;
+}
+
+void op_matrix_free(op_matrix* M) {
+  if (M) {
+    c_free(M->Dl);
+    c_free(M->Dr);
+    c_free(M->xwork);
+    c_free(M->ywork);
+    c_free(M);
+  }
+}
+
+void op_matrix_scale(op_matrix* M,
+                     OSQPFloat  sc) {
+  M->c *= sc;
+}
+
+void op_matrix_lmult_diag(op_matrix*       M,
+                          const OSQPFloat* L) {
+  OSQPInt i;
+
+  for (i = 0; i < M->op.m; i++) M->Dl[i] *= L[i];
+}
+
+void op_matrix_rmult_diag(op_matrix*       M,
+                          const OSQPFloat* R) {
+  OSQPInt j;
+
+  for (j = 0; j < M->op.n; j++) M->Dr[j] *= R[j];
+}
+
+void op_matrix_Axpy(const op_matrix* M,
+                    const OSQPFloat* x,
+                          OSQPFloat* y,
+                          OSQPFloat  alpha,
+                          OSQPFloat  beta) {
+  op_product(M, M->op.mult, M->Dr, M->op.n, M->Dl, M->op.m, x, y, alpha, beta);
+}
+
+void op_matrix_Atxpy(const op_matrix* M,
+                     const OSQPFloat* x,
+                           OSQPFloat* y,
+                           OSQPFloat  alpha,
+                           OSQPFloat  beta) {
+  op_product(M, M->op.mult_trans ? M->op.mult_trans : M->op.mult,
+             M->Dl, M->op.m, M->Dr, M->op.n, x, y, alpha, beta);
+}
+
+void op_matrix_col_norm_inf(const op_matrix* M,
+                                  OSQPFloat* E) {
+  OSQPInt   j;
+  OSQPFloat sc = c_absval(M->c) * max_abs(M->Dl, M->op.m);
+
+  for (j = 0; j < M->op.n; j++)
+    E[j] = M->op.col_norm ? sc * c_absval(M->Dr[j]) * M->op.col_norm[j] : 0.0;
+}
+
+void op_matrix_row_norm_inf(const op_matrix* M,
+                                  OSQPFloat* E) {
+  OSQPInt   i;
+  OSQPFloat sc = c_absval(M->c) * max_abs(M->Dr, M->op.n);
+
+  for (i = 0; i < M->op.m; i++)
+    E[i] = M->op.row_norm ? sc * c_absval(M->Dl[i]) * M->op.row_norm[i] : 0.0;
+}
+
+void op_matrix_extract_diag(const op_matrix* M,
+                                  OSQPFloat* d) {
+  OSQPInt j;
+
+  for (j = 0; j < M->op.n; j++)
+    d[j] = M->op.diag ? M->c * M->Dl[j] * M->Dr[j] * M->op.diag[j] : 0.0;
+}
+
+void op_matrix_AtDA_extract_diag(const op_matrix* M,
+                                 const OSQPFloat* D,
+                                       OSQPFloat* d) {
+  OSQPInt   i, j;
+  OSQPFloat w = 0.0;
+
+  for (i = 0; i < M->op.m; i++) w += M->Dl[i] * M->Dl[i] * D[i];
+  if (M->op.m) w *= M->c * M->c / M->op.m;
+
+  for (j = 0; j < M->op.n; j++)
+    d[j] = M->op.diag ? w * M->Dr[j] * M->Dr[j] * M->op.diag[j] : 0.0;
+}
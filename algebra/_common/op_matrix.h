@@ -0,0 +1,95 @@
+#ifndef OP_MATRIX_H
+# define OP_MATRIX_H
+
+
+# include "osqp_api_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Matrix given by the products of a user operator M, scaled as
+ *
+ *   c * diag(Dl) * M * diag(Dr)
+ *
+ * The scalings are applied around the user products, so scaling the matrix
+ * does not call the operator. The norms and diagonals are computed from the
+ * estimates of the operator, and are 0 where the operator has none.
+ */
+typedef struct {
+  OSQPOperator op;    ///< products and estimates given by the user
+  OSQPFloat    c;     ///< scalar factor
+  OSQPFloat*   Dl;    ///< left diagonal (size m)
+  OSQPFloat*   Dr;    ///< right diagonal (size n)
+  OSQPFloat*   xwork; ///< scaled input of the user products (size max(m,n))
+  OSQPFloat*   ywork; ///< output of the user products (size max(m,n))
+} op_matrix;
+
+/**
+ * Wrap an operator, initially unscaled.
+ * @param  op Operator (copied, its data and estimates are not)
+ * @return    Matrix, OSQP_NULL if out of memory
+ */
+op_matrix* op_matrix_new(const OSQPOperator* op);
+
+/**
+ * Free a wrapped operator.
+ * @param  M Matrix
+ */
+void op_matrix_free(op_matrix* M);
+
+// M = sc*M
+void op_matrix_scale(op_matrix* M,
+                     OSQPFloat  sc);
+
+// M = diag(L)*M
+void op_matrix_lmult_diag(op_matrix*       M,
+                          const OSQPFloat* L);
+
+// M = M*diag(R)
+void op_matrix_rmult_diag(op_matrix*       M,
+                          const OSQPFloat* R);
+
+//y = alpha*M*x + beta*y
+void op_matrix_Axpy(const op_matrix* M,
+                    const OSQPFloat* x,
+                          OSQPFloat* y,
+                          OSQPFloat  alpha,
+                          OSQPFloat  beta);
+
+//y = alpha*M'*x + beta*y, with the product of M for symmetric operators
+void op_matrix_Atxpy(const op_matrix* M,
+                     const OSQPFloat* x,
+                           OSQPFloat* y,
+                           OSQPFloat  alpha,
+                           OSQPFloat  beta);
+
+/*
+ * Upper bounds of the norms of the scaled matrix, from the estimates of the
+ * unscaled one (exact while the matrix is unscaled).
+ */
+
+// E = estimate of the inf-norms of the columns of M
+void op_matrix_col_norm_inf(const op_matrix* M,
+                                  OSQPFloat* E);
+
+// E = estimate of the inf-norms of the rows of M
+void op_matrix_row_norm_inf(const op_matrix* M,
+                                  OSQPFloat* E);
+
+// d = diagonal of M
+void op_matrix_extract_diag(const op_matrix* M,
+                                  OSQPFloat* d);
+
+// d = estimate of the diagonal of M'*diag(D)*M, with the mean of D and of
+// the left scaling over the rows (exact when both are constant)
+void op_matrix_AtDA_extract_diag(const op_matrix* M,
+                                 const OSQPFloat* D,
+                                       OSQPFloat* d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef OP_MATRIX_H */
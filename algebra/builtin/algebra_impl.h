@@ -3,6 +3,11 @@
 
 #include "csc_math.h"
 
+#ifndef OSQP_EMBEDDED_MODE
+# include "csc_packed.h"
+# include "op_matrix.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -36,8 +41,12 @@ struct OSQPVectorf_ {
 typedef enum OSQPMatrix_symmetry_type {NONE,TRIU} OSQPMatrix_symmetry_type;
 
 struct OSQPMatrix_ {
-  OSQPCscMatrix*           csc;
+  OSQPCscMatrix*           csc;      ///< entries, OSQP_NULL for matrices given as operators
   OSQPMatrix_symmetry_type symmetry;
+#ifndef OSQP_EMBEDDED_MODE
+  csc_packed*              packed;   ///< packed row indices used by the products, or OSQP_NULL
+  op_matrix*               op;       ///< operator giving the products, or OSQP_NULL
+#endif
 };
 
 #ifdef __cplusplus
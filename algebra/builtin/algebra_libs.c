@@ -2,9 +2,34 @@
 #include "osqp_api_types.h"
 #include "qdldl_interface.h"
 
+#ifndef OSQP_EMBEDDED_MODE
+#include "algebra_impl.h"
+#include "hybrid_interface.h"
+#include "lin_alg.h"
+#endif
+
+#ifdef OSQP_ENABLE_RUNTIME_MKL
+#include "pardiso_interface.h"
+#include "pardiso_runtime.h"
+#endif
+
 OSQPInt osqp_algebra_linsys_supported(void) {
+#ifndef OSQP_EMBEDDED_MODE
+  /* QDLDL (direct solver), alone or behind a CG on the reduced KKT, which
+     also solves the problems given as operators */
+  OSQPInt capabilities = OSQP_CAPABILITY_DIRECT_SOLVER | OSQP_CAPABILITY_HYBRID_SOLVER |
+                         OSQP_CAPABILITY_OPERATORS;
+
+#ifdef OSQP_ENABLE_RUNTIME_MKL
+  /* MKL Pardiso in place of QDLDL, if the MKL runtime library can be loaded */
+  if (!pardiso_runtime_load()) capabilities |= OSQP_CAPABILITY_MKL_PARDISO;
+#endif
+
+  return capabilities;
+#else
   /* Only has QDLDL (direct solver) */
   return OSQP_CAPABILITY_DIRECT_SOLVER;
+#endif
 }
 
 enum osqp_linsys_solver_type osqp_algebra_default_linsys(void) {
@@ -39,6 +64,72 @@ OSQPInt osqp_algebra_device_name(char* name, OSQPInt nameLen) {
 
 #ifndef OSQP_EMBEDDED_MODE
 
+/*
+ * OSQP_AUTO_SOLVER takes the hybrid solver when factoring the KKT matrix is
+ * estimated to cost more than OSQP_AUTO_HYBRID_MIN_FLOPS operations and more
+ * than OSQP_AUTO_HYBRID_MIN_PRODUCTS products with the KKT matrix. The CG
+ * iterations then run while the factorization is built on its thread.
+ */
+#ifndef OSQP_AUTO_HYBRID_MIN_FLOPS
+# define OSQP_AUTO_HYBRID_MIN_FLOPS (1e9)
+#endif
+
+#ifndef OSQP_AUTO_HYBRID_MIN_PRODUCTS
+# define OSQP_AUTO_HYBRID_MIN_PRODUCTS (1e4)
+#endif
+
+static OSQPInt auto_prefers_hybrid(const qdldl_symbolic* sym,
+                                   const OSQPMatrix*     P,
+                                   const OSQPMatrix*     A) {
+
+#ifdef OSQP_ENABLE_THREADS
+  QDLDL_int j;
+  OSQPFloat flops = 0.0;
+  OSQPFloat kkt_nnz;
+
+  // Each column of L updates the columns it has entries in
+  for (j = 0; j < sym->n; j++) flops += (OSQPFloat)sym->Lnz[j] * (sym->Lnz[j] + 3);
+
+  kkt_nnz = OSQPMatrix_get_nz(P) + OSQPMatrix_get_nz(A) + sym->n;
+
+  return flops > OSQP_AUTO_HYBRID_MIN_FLOPS &&
+         flops > OSQP_AUTO_HYBRID_MIN_PRODUCTS * kkt_nnz;
+#else
+  // Without threads the hybrid solver only factors once the CG stalls
+  return 0;
+#endif
+}
+
+// Choose the solver of OSQP_AUTO_SOLVER from the analysis of the KKT pattern
+static OSQPInt init_linsys_solver_auto(LinSysSolver**        s,
+                                       const OSQPMatrix*     P,
+                                       const OSQPMatrix*     A,
+                                       const OSQPVectorf*    rho_vec,
+                                       const OSQPSettings*   settings,
+                                       OSQPFloat*            scaled_prim_res,
+                                       OSQPFloat*            scaled_dual_res,
+                                       const qdldl_symbolic* sym) {
+
+  OSQPInt         exitflag;
+  qdldl_symbolic* own = OSQP_NULL;
+
+  if (!sym) {
+    // The factorization is analysed the same way without the analysis
+    if (qdldl_symbolic_new(&own, P->csc, A->csc))
+      return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, rho_vec, settings, 0);
+    sym = own;
+  }
+
+  if (auto_prefers_hybrid(sym, P, A))
+    exitflag = init_linsys_solver_hybrid((hybrid_solver **)s, P, A, rho_vec, settings,
+                                         scaled_prim_res, scaled_dual_res);
+  else
+    exitflag = init_linsys_solver_qdldl_analysed((qdldl_solver **)s, P, A, rho_vec, settings, sym);
+
+  qdldl_symbolic_free(own);
+  return exitflag;
+}
+
 // Initialize linear system solver structure
 // NB: Only the upper triangular part of P is filled
 OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
@@ -50,13 +141,104 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
                                         OSQPFloat*          scaled_dual_res,
                                         OSQPInt             polishing) {
 
+  /* Operators can only be solved with the CG of the hybrid solver */
+  if (P->op || A->op)
+    return init_linsys_solver_hybrid((hybrid_solver **)s, P, A, rho_vec, settings,
+                                     scaled_prim_res, scaled_dual_res);
+
+#ifdef OSQP_ENABLE_RUNTIME_MKL
+  /* MKL Pardiso replaces QDLDL for the ADMM iterations and polishing */
+  if (settings->linsys_library == OSQP_MKL_PARDISO_LINSYS)
+    return init_linsys_solver_pardiso((pardiso_solver **)s, P, A, rho_vec, settings, polishing);
+#endif
+
   switch (settings->linsys_solver) {
+  case OSQP_HYBRID_SOLVER:
+    /* Polishing solves a single system, so it always factors directly */
+    if (!polishing)
+      return init_linsys_solver_hybrid((hybrid_solver **)s, P, A, rho_vec, settings,
+                                       scaled_prim_res, scaled_dual_res);
+    /* fall through */
+  case OSQP_AUTO_SOLVER:
+    if (!polishing && settings->linsys_solver == OSQP_AUTO_SOLVER)
+      return init_linsys_solver_auto(s, P, A, rho_vec, settings,
+                                     scaled_prim_res, scaled_dual_res, OSQP_NULL);
+    /* fall through */
   default:
   case OSQP_DIRECT_SOLVER:
     return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, rho_vec, settings, polishing);
   }
 }
 
+#ifdef OSQP_ENABLE_THREADS
+
+struct LinSysAnalysis_ {
+  qdldl_symbolic* direct;  ///< symbolic analysis for QDLDL
+};
+
+OSQPInt osqp_algebra_analyse_linsys(LinSysAnalysis**    a,
+                                    const OSQPMatrix*   P,
+                                    const OSQPMatrix*   A,
+                                    const OSQPSettings* settings) {
+
+  OSQPInt exitflag;
+
+  *a = OSQP_NULL;
+
+  /* Only QDLDL factors the KKT matrix at setup */
+  if (P->op || A->op || settings->linsys_solver == OSQP_HYBRID_SOLVER ||
+      settings->linsys_library != OSQP_ALGEBRA_LINSYS) return 0;
+
+  *a = c_calloc(1, sizeof(LinSysAnalysis));
+  if (!*a) return OSQP_MEM_ALLOC_ERROR;
+
+  exitflag = qdldl_symbolic_new(&(*a)->direct, P->csc, A->csc);
+  if (exitflag) {
+    c_free(*a);
+    *a = OSQP_NULL;
+  }
+  return exitflag;
+}
+
+void osqp_algebra_free_linsys_analysis(LinSysAnalysis* a) {
+  if (!a) return;
+  qdldl_symbolic_free(a->direct);
+  c_free(a);
+}
+
+OSQPInt osqp_algebra_init_linsys_solver_analysed(LinSysSolver**        s,
+                                                 const OSQPMatrix*     P,
+                                                 const OSQPMatrix*     A,
+                                                 const OSQPVectorf*    rho_vec,
+                                                 const OSQPSettings*   settings,
+                                                 OSQPFloat*            scaled_prim_res,
+                                                 OSQPFloat*            scaled_dual_res,
+                                                 const LinSysAnalysis* a) {
+
+  if (!a)
+    return osqp_algebra_init_linsys_solver(s, P, A, rho_vec, settings,
+                                           scaled_prim_res, scaled_dual_res, 0);
+
+  if (settings->linsys_solver == OSQP_AUTO_SOLVER)
+    return init_linsys_solver_auto(s, P, A, rho_vec, settings,
+                                   scaled_prim_res, scaled_dual_res, a->direct);
+
+  return init_linsys_solver_qdldl_analysed((qdldl_solver **)s, P, A, rho_vec, settings, a->direct);
+}
+
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
+OSQPInt adjoint_derivative_init_linsys_solver(LinSysSolver**      s,
+                                              const OSQPSettings* settings,
+                                              const OSQPMatrix*   P,
+                                              const OSQPMatrix*   G,
+                                              const OSQPMatrix*   A_eq,
+                                              const OSQPMatrix*   GDiagLambda,
+                                              const OSQPVectorf*  slacks) {
+
+  return adjoint_derivative_init_qdldl((qdldl_solver **)s, P, G, A_eq, GDiagLambda, slacks);
+}
+
 OSQPInt adjoint_derivative_linsys_solver(LinSysSolver**      s,
                                          const OSQPSettings* settings,
                                          const OSQPMatrix*   P,
@@ -66,7 +248,7 @@ OSQPInt adjoint_derivative_linsys_solver(LinSysSolver**      s,
                                          OSQPVectorf*        slacks,
                                          OSQPVectorf*        rhs) {
 
-return adjoint_derivative_qdldl((qdldl_solver **)s, P, G, A_eq, GDiagLambda, slacks, rhs);
+return adjoint_derivative_qdldl((qdldl_solver *)*s, P, G, A_eq, GDiagLambda, slacks, rhs);
 }
 
 #endif
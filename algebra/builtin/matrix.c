@@ -25,7 +25,7 @@ OSQPInt OSQPMatrix_is_eq(const OSQPMatrix* A,
 OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* A,
                                           OSQPInt        is_triu) {
 
-  OSQPMatrix* out = c_malloc(sizeof(OSQPMatrix));
+  OSQPMatrix* out = c_calloc(1, sizeof(OSQPMatrix));
   if(!out) return OSQP_NULL;
 
   if(is_triu) out->symmetry = TRIU;
@@ -42,11 +42,41 @@ OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* A,
   }
 }
 
+//Make a matrix that calls the products of an operator.  Returns OSQP_NULL on failure
+OSQPMatrix* OSQPMatrix_new_from_operator(const OSQPOperator* op,
+                                               OSQPInt       is_triu) {
+
+  OSQPMatrix* out = c_calloc(1, sizeof(OSQPMatrix));
+  if(!out) return OSQP_NULL;
+
+  if(is_triu) out->symmetry = TRIU;
+  else        out->symmetry = NONE;
+
+  out->op = op_matrix_new(op);
+
+  if(!out->op){
+    c_free(out);
+    return OSQP_NULL;
+  }
+  else{
+    return out;
+  }
+}
+
 OSQPCscMatrix* OSQPMatrix_get_csc(const OSQPMatrix* M) {return csc_copy(M->csc);}
 
+// Pack the row indices used by the matrix-vector products
+OSQPInt OSQPMatrix_compress_indices(OSQPMatrix* M) {
+
+  if (M->op || M->packed || !csc_packable(M->csc)) return 0;
+
+  M->packed = csc_packed_new(M->csc);
+  return M->packed ? 0 : 1;
+}
+
 // Make of a copy of a matrix
 OSQPMatrix* OSQPMatrix_copy_new(const OSQPMatrix* A) {
-    OSQPMatrix* out = c_malloc(sizeof(OSQPMatrix));
+    OSQPMatrix* out = c_calloc(1, sizeof(OSQPMatrix));
     if(!out) return OSQP_NULL;
 
     out->symmetry = A->symmetry;
@@ -65,7 +95,7 @@ OSQPMatrix* OSQPMatrix_copy_new(const OSQPMatrix* A) {
 OSQPMatrix* OSQPMatrix_triu_to_symm(const OSQPMatrix* A) {
 
     if (A->symmetry == TRIU) {
-        OSQPMatrix* out = c_malloc(sizeof(OSQPMatrix));
+        OSQPMatrix* out = c_calloc(1, sizeof(OSQPMatrix));
         if(!out) return OSQP_NULL;
 
         out->symmetry = NONE;
@@ -86,7 +116,7 @@ OSQPMatrix* OSQPMatrix_triu_to_symm(const OSQPMatrix* A) {
 OSQPMatrix* OSQPMatrix_vstack(const OSQPMatrix* A,
                               const OSQPMatrix* B) {
     if ((A->symmetry == NONE) && (B->symmetry == NONE)) {
-        OSQPMatrix* out = c_malloc(sizeof(OSQPMatrix));
+        OSQPMatrix* out = c_calloc(1, sizeof(OSQPMatrix));
         if(!out) return OSQP_NULL;
 
         out->symmetry = NONE;
@@ -115,40 +145,76 @@ void OSQPMatrix_update_values(OSQPMatrix*      M,
   csc_update_values(M->csc, Mx_new, Mx_new_idx, M_new_n);
 }
 
-/* Matrix dimensions and data access */
+/* Matrix dimensions and data access (operators have no entries) */
+#ifndef OSQP_EMBEDDED_MODE
+OSQPInt    OSQPMatrix_get_m(const OSQPMatrix* M)  {return M->op ? M->op->op.m : M->csc->m;}
+OSQPInt    OSQPMatrix_get_n(const OSQPMatrix* M)  {return M->op ? M->op->op.n : M->csc->n;}
+OSQPInt    OSQPMatrix_get_nz(const OSQPMatrix* M) {return M->op ? 0 : M->csc->p[M->csc->n];}
+#else
 OSQPInt    OSQPMatrix_get_m(const OSQPMatrix* M)  {return M->csc->m;}
 OSQPInt    OSQPMatrix_get_n(const OSQPMatrix* M)  {return M->csc->n;}
+OSQPInt    OSQPMatrix_get_nz(const OSQPMatrix* M) {return M->csc->p[M->csc->n];}
+#endif
 OSQPFloat* OSQPMatrix_get_x(const OSQPMatrix* M)  {return M->csc->x;}
 OSQPInt*   OSQPMatrix_get_i(const OSQPMatrix* M)  {return M->csc->i;}
 OSQPInt*   OSQPMatrix_get_p(const OSQPMatrix* M)  {return M->csc->p;}
-OSQPInt    OSQPMatrix_get_nz(const OSQPMatrix* M) {return M->csc->p[M->csc->n];}
 
 /* math functions ----------------------------------------------------------*/
 
 //A = sc*A
 void OSQPMatrix_mult_scalar(OSQPMatrix *A,
                             OSQPFloat   sc){
+#ifndef OSQP_EMBEDDED_MODE
+  if(A->op){
+    op_matrix_scale(A->op, sc);
+    return;
+  }
+#endif
   csc_scale(A->csc,sc);
 }
 
 void OSQPMatrix_lmult_diag(OSQPMatrix*        A,
                            const OSQPVectorf* L) {
+#ifndef OSQP_EMBEDDED_MODE
+  if(A->op){
+    op_matrix_lmult_diag(A->op, OSQPVectorf_data(L));
+    return;
+  }
+#endif
   csc_lmult_diag(A->csc, OSQPVectorf_data(L));
 }
 
 void OSQPMatrix_rmult_diag(OSQPMatrix* A,
                            const OSQPVectorf* R) {
+#ifndef OSQP_EMBEDDED_MODE
+  if(A->op){
+    op_matrix_rmult_diag(A->op, R->values);
+    return;
+  }
+#endif
   csc_rmult_diag(A->csc, R->values);
 }
 
 void OSQPMatrix_AtDA_extract_diag(const OSQPMatrix*  A,
                                   const OSQPVectorf* D,
                                         OSQPVectorf* d) {
+#ifndef OSQP_EMBEDDED_MODE
+    if(A->op){
+      op_matrix_AtDA_extract_diag(A->op, OSQPVectorf_data(D), OSQPVectorf_data(d));
+      return;
+    }
+#endif
     csc_AtDA_extract_diag(A->csc, OSQPVectorf_data(D), OSQPVectorf_data(d));
 }
 
 void OSQPMatrix_extract_diag(const OSQPMatrix*  A,
                                    OSQPVectorf* d) {
+#ifndef OSQP_EMBEDDED_MODE
+  if(A->op){
+    op_matrix_extract_diag(A->op, OSQPVectorf_data(d));
+    return;
+  }
+#endif
   csc_extract_diag(A->csc, OSQPVectorf_data(d));
 }
 
@@ -159,6 +225,18 @@ void OSQPMatrix_Axpy(const OSQPMatrix*  A,
                            OSQPFloat    alpha,
                            OSQPFloat    beta) {
 
+#ifndef OSQP_EMBEDDED_MODE
+  if(A->op){
+    op_matrix_Axpy(A->op, x->values, y->values, alpha, beta);
+    return;
+  }
+  if(A->packed){
+    if(A->symmetry == NONE) csc_packed_Axpy(A->csc, A->packed, x->values, y->values, alpha, beta);
+    else                    csc_packed_Axpy_sym_triu(A->csc, A->packed, x->values, y->values, alpha, beta);
+    return;
+  }
+#endif
+
   if(A->symmetry == NONE){
     //full matrix
     csc_Axpy(A->csc, x->values, y->values, alpha, beta);
@@ -175,6 +253,19 @@ void OSQPMatrix_Atxpy(const OSQPMatrix*  A,
                             OSQPFloat    alpha,
                             OSQPFloat    beta) {
 
+#ifndef OSQP_EMBEDDED_MODE
+   if(A->op){
+     if(A->symmetry == NONE) op_matrix_Atxpy(A->op, x->values, y->values, alpha, beta);
+     else                    op_matrix_Axpy(A->op, x->values, y->values, alpha, beta);
+     return;
+   }
+   if(A->packed){
+     if(A->symmetry == NONE) csc_packed_Atxpy(A->csc, A->packed, x->values, y->values, alpha, beta);
+     else                    csc_packed_Axpy_sym_triu(A->csc, A->packed, x->values, y->values, alpha, beta);
+     return;
+   }
+#endif
+
    if(A->symmetry == NONE) csc_Atxpy(A->csc, x->values, y->values, alpha, beta);
    else            csc_Axpy_sym_triu(A->csc, x->values, y->values, alpha, beta);
 }
@@ -193,11 +284,24 @@ void OSQPMatrix_Atxpy(const OSQPMatrix*  A,
 
 void OSQPMatrix_col_norm_inf(const OSQPMatrix*  M,
                                    OSQPVectorf* E) {
+#ifndef OSQP_EMBEDDED_MODE
+   if(M->op){
+     op_matrix_col_norm_inf(M->op, OSQPVectorf_data(E));
+     return;
+   }
+#endif
    csc_col_norm_inf(M->csc, OSQPVectorf_data(E));
 }
 
 void OSQPMatrix_row_norm_inf(const OSQPMatrix*  M,
                                    OSQPVectorf* E) {
+#ifndef OSQP_EMBEDDED_MODE
+   if(M->op){
+     if(M->symmetry == NONE) op_matrix_row_norm_inf(M->op, OSQPVectorf_data(E));
+     else                    op_matrix_col_norm_inf(M->op, OSQPVectorf_data(E));
+     return;
+   }
+#endif
    if(M->symmetry == NONE) csc_row_norm_inf(M->csc, OSQPVectorf_data(E));
    else                    csc_row_norm_inf_sym_triu(M->csc, OSQPVectorf_data(E));
 }
@@ -207,7 +311,11 @@ void OSQPMatrix_row_norm_inf(const OSQPMatrix*  M,
 #ifndef OSQP_EMBEDDED_MODE
 
 void OSQPMatrix_free(OSQPMatrix* M){
-  if (M) csc_spfree(M->csc);
+  if (M) {
+    csc_spfree(M->csc);
+    csc_packed_free(M->packed);
+    op_matrix_free(M->op);
+  }
   c_free(M);
 }
 
@@ -228,7 +336,7 @@ OSQPMatrix* OSQPMatrix_submatrix_byrows(const OSQPMatrix*  A,
 
   if(!M) return OSQP_NULL;
 
-  out = c_malloc(sizeof(OSQPMatrix));
+  out = c_calloc(1, sizeof(OSQPMatrix));
 
   if(!out){
     csc_spfree(M);
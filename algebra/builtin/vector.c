@@ -1,6 +1,9 @@
 #include "osqp.h"
 #include "algebra_vector.h"
 #include "algebra_impl.h"
+#include "printing.h"
+
+#include <assert.h>
 
 /* VECTOR FUNCTIONS ----------------------------------------------------------*/
 
@@ -767,6 +770,283 @@ OSQPInt OSQPVectorf_in_reccone(const OSQPVectorf* y,
 
 
 
+/* VECTOR EXPRESSIONS --------------------------------------------------------*/
+
+void OSQPVectorf_expr_init(OSQPVectorf_expr* e) {
+
+  e->nterms = 0;
+  e->sc     = 1.0;
+  e->s      = OSQP_NULL;
+  e->l      = OSQP_NULL;
+  e->u      = OSQP_NULL;
+}
+
+void OSQPVectorf_expr_add(OSQPVectorf_expr*  e,
+                          OSQPFloat          c,
+                          const OSQPVectorf* a) {
+
+  OSQPVectorf_expr_add_prod(e, c, a, OSQP_NULL);
+}
+
+void OSQPVectorf_expr_add_prod(OSQPVectorf_expr*  e,
+                               OSQPFloat          c,
+                               const OSQPVectorf* a,
+                               const OSQPVectorf* b) {
+
+  // Leaving a term out would give wrong results without any sign of it
+  assert(e->nterms < OSQP_VECTOR_EXPR_TERMS);
+  if (e->nterms == OSQP_VECTOR_EXPR_TERMS) {
+    c_eprint("vector expressions have at most %d terms", OSQP_VECTOR_EXPR_TERMS);
+    return;
+  }
+
+  e->c[e->nterms] = c;
+  e->a[e->nterms] = a;
+  e->b[e->nterms] = b;
+  e->nterms++;
+}
+
+void OSQPVectorf_expr_mult_scalar(OSQPVectorf_expr* e,
+                                  OSQPFloat         sc) {
+
+  e->sc *= sc;
+}
+
+void OSQPVectorf_expr_ew_prod(OSQPVectorf_expr*  e,
+                              const OSQPVectorf* s) {
+
+  e->s = s;
+}
+
+void OSQPVectorf_expr_bound_vec(OSQPVectorf_expr*  e,
+                                const OSQPVectorf* l,
+                                const OSQPVectorf* u) {
+
+  e->l = l;
+  e->u = u;
+}
+
+/* Raw arrays of an expression */
+typedef struct {
+  OSQPInt          nterms;
+  OSQPFloat        c[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPFloat* a[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPFloat* b[OSQP_VECTOR_EXPR_TERMS];
+  OSQPFloat        sc;
+  const OSQPFloat* s;
+  const OSQPFloat* l;
+  const OSQPFloat* u;
+} expr_values;
+
+/* Shapes of the expressions built by the solver, evaluated by dedicated loops */
+enum expr_shape {
+  EXPR_GENERAL = 0,
+  EXPR_PROD,            /* c0*(a0.*b0) */
+  EXPR_SUM2,            /* c0*a0 + c1*a1 */
+  EXPR_SUM_PROD,        /* c0*a0 + c1*(a1.*b1) */
+  EXPR_SUM3,            /* c0*a0 + c1*a1 + c2*a2 */
+  EXPR_SUM3_SCALAR,     /* sc*(c0*a0 + c1*a1 + c2*a2) */
+  EXPR_SUM3_EW,         /* s.*(c0*a0 + c1*a1 + c2*a2) */
+  EXPR_SUM3_BOUND,      /* min(max(c0*a0 + c1*a1 + c2*a2, l), u) */
+  EXPR_SUM2_PROD_BOUND  /* min(max(c0*a0 + c1*a1 + c2*(a2.*b2), l), u) */
+};
+
+static OSQPInt expr_values_init(expr_values*            v,
+                                const OSQPVectorf_expr* e) {
+
+  OSQPInt k;
+  OSQPInt nprod   = 0;
+  OSQPInt lastp   = 0;
+  OSQPInt scaled  = (e->sc != 1.0);
+  OSQPInt bounded = (e->l != OSQP_NULL);
+  OSQPInt plain;
+
+  v->nterms = e->nterms;
+  for (k = e->nterms; k < OSQP_VECTOR_EXPR_TERMS; k++) {
+    v->c[k] = 0.0;
+    v->a[k] = OSQP_NULL;
+    v->b[k] = OSQP_NULL;
+  }
+  for (k = 0; k < e->nterms; k++) {
+    v->c[k] = e->c[k];
+    v->a[k] = e->a[k]->values;
+    v->b[k] = e->b[k] ? e->b[k]->values : OSQP_NULL;
+    if (e->b[k]) {
+      nprod++;
+      lastp = (k == e->nterms - 1);
+    }
+  }
+  v->sc = e->sc;
+  v->s  = e->s ? e->s->values : OSQP_NULL;
+  v->l  = e->l ? e->l->values : OSQP_NULL;
+  v->u  = e->u ? e->u->values : OSQP_NULL;
+
+  // Only the last term can be a product in the dedicated loops
+  if (nprod > 1 || (nprod == 1 && !lastp)) return EXPR_GENERAL;
+
+  plain = !scaled && !v->s && !bounded;
+  switch (4 * e->nterms + nprod) {
+  case 4 * 1 + 1:
+    return plain ? EXPR_PROD : EXPR_GENERAL;
+  case 4 * 2:
+    return plain ? EXPR_SUM2 : EXPR_GENERAL;
+  case 4 * 2 + 1:
+    return plain ? EXPR_SUM_PROD : EXPR_GENERAL;
+  case 4 * 3:
+    if (plain)                           return EXPR_SUM3;
+    if (scaled && !v->s && !bounded)     return EXPR_SUM3_SCALAR;
+    if (!scaled && v->s && !bounded)     return EXPR_SUM3_EW;
+    if (!scaled && !v->s && bounded)     return EXPR_SUM3_BOUND;
+    return EXPR_GENERAL;
+  case 4 * 3 + 1:
+    return (!scaled && !v->s && bounded) ? EXPR_SUM2_PROD_BOUND : EXPR_GENERAL;
+  default:
+    return EXPR_GENERAL;
+  }
+}
+
+/* Value of any expression at element i */
+static OSQPFloat expr_value(const expr_values* v,
+                            OSQPInt            i) {
+
+  OSQPInt   k;
+  OSQPFloat val = 0.0;
+
+  for (k = 0; k < v->nterms; k++) {
+    if (v->b[k]) val += v->c[k] * (v->a[k][i] * v->b[k][i]);
+    else         val += v->c[k] * v->a[k][i];
+  }
+  if (v->sc != 1.0) val *= v->sc;
+  if (v->s)         val *= v->s[i];
+  if (v->l)         val  = c_min(c_max(val, v->l[i]), v->u[i]);
+
+  return val;
+}
+
+void OSQPVectorf_eval(OSQPVectorf*            x,
+                      const OSQPVectorf_expr* e) {
+
+  OSQPInt     i;
+  OSQPInt     length = x->length;
+  OSQPFloat*  xv     = x->values;
+  expr_values v;
+
+  const OSQPFloat *a0, *a1, *a2, *b;
+  OSQPFloat        c0, c1, c2;
+
+  OSQPInt shape = expr_values_init(&v, e);
+
+  a0 = v.a[0]; a1 = v.a[1]; a2 = v.a[2];
+  c0 = v.c[0]; c1 = v.c[1]; c2 = v.c[2];
+  b  = v.nterms > 0 ? v.b[v.nterms - 1] : OSQP_NULL;
+
+  switch (shape) {
+  case EXPR_PROD:
+    for (i = 0; i < length; i++) xv[i] = c0 * (a0[i] * b[i]);
+    break;
+  case EXPR_SUM2:
+    for (i = 0; i < length; i++) xv[i] = c0 * a0[i] + c1 * a1[i];
+    break;
+  case EXPR_SUM_PROD:
+    for (i = 0; i < length; i++) xv[i] = c0 * a0[i] + c1 * (a1[i] * b[i]);
+    break;
+  case EXPR_SUM3:
+    for (i = 0; i < length; i++) xv[i] = c0 * a0[i] + c1 * a1[i] + c2 * a2[i];
+    break;
+  case EXPR_SUM3_SCALAR:
+    for (i = 0; i < length; i++) {
+      xv[i] = (c0 * a0[i] + c1 * a1[i] + c2 * a2[i]) * v.sc;
+    }
+    break;
+  case EXPR_SUM3_EW:
+    for (i = 0; i < length; i++) {
+      xv[i] = (c0 * a0[i] + c1 * a1[i] + c2 * a2[i]) * v.s[i];
+    }
+    break;
+  case EXPR_SUM3_BOUND:
+    for (i = 0; i < length; i++) {
+      xv[i] = c_min(c_max(c0 * a0[i] + c1 * a1[i] + c2 * a2[i], v.l[i]), v.u[i]);
+    }
+    break;
+  case EXPR_SUM2_PROD_BOUND:
+    for (i = 0; i < length; i++) {
+      xv[i] = c_min(c_max(c0 * a0[i] + c1 * a1[i] + c2 * (a2[i] * b[i]),
+                          v.l[i]), v.u[i]);
+    }
+    break;
+  default:
+    for (i = 0; i < length; i++) xv[i] = expr_value(&v, i);
+  }
+}
+
+OSQPFloat OSQPVectorf_eval_norm_inf(OSQPVectorf*            x,
+                                    const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      S,
+                                    OSQPFloat*              snorm) {
+
+  OSQPInt     i;
+  OSQPInt     length = x ? x->length : e->a[0]->length;
+  OSQPFloat*  xv     = x ? x->values : OSQP_NULL;
+  OSQPFloat*  Sv     = S ? S->values : OSQP_NULL;
+  OSQPFloat   val, absval;
+  OSQPFloat   normval  = 0.0;
+  OSQPFloat   snormval = 0.0;
+  expr_values v;
+
+  const OSQPFloat *a0, *a1, *a2;
+  OSQPFloat        c0, c1, c2;
+
+  OSQPInt shape = expr_values_init(&v, e);
+
+  a0 = v.a[0]; a1 = v.a[1]; a2 = v.a[2];
+  c0 = v.c[0]; c1 = v.c[1]; c2 = v.c[2];
+
+  for (i = 0; i < length; i++) {
+    switch (shape) {
+    case EXPR_SUM2:
+      val = c0 * a0[i] + c1 * a1[i];
+      break;
+    case EXPR_SUM3:
+      val = c0 * a0[i] + c1 * a1[i] + c2 * a2[i];
+      break;
+    default:
+      val = expr_value(&v, i);
+    }
+    if (xv) xv[i] = val;
+
+    absval = c_absval(val);
+    if (absval > normval) normval = absval;
+    if (Sv) {
+      absval = c_absval(Sv[i] * val);
+      if (absval > snormval) snormval = absval;
+    }
+  }
+
+  if (S) *snorm = snormval;
+  return normval;
+}
+
+OSQPFloat OSQPVectorf_expr_dot_prod(const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      w) {
+
+  OSQPInt     i;
+  OSQPInt     length  = w->length;
+  OSQPFloat*  wv      = w->values;
+  OSQPFloat   dotprod = 0.0;
+  expr_values v;
+
+  if (expr_values_init(&v, e) == EXPR_SUM2) {
+    for (i = 0; i < length; i++) {
+      dotprod += wv[i] * (v.c[0] * v.a[0][i] + v.c[1] * v.a[1][i]);
+    }
+  }
+  else {
+    for (i = 0; i < length; i++) dotprod += wv[i] * expr_value(&v, i);
+  }
+  return dotprod;
+}
+
+
 #if OSQP_EMBEDDED_MODE != 1
 
 OSQPFloat OSQPVectorf_norm_1(const OSQPVectorf* a) {
@@ -20,6 +20,7 @@
 
 #include <cusparse.h>
 #include "algebra_types.h"
+#include "algebra_vector.h"
 
 
 /*******************************************************************************
@@ -115,6 +116,27 @@ void cuda_vec_add_scaled3(OSQPFloat*       d_x,
                           OSQPFloat        scc,
                           OSQPInt          n);
 
+/**
+ * Device arrays of an OSQPVectorf_expr, passed by value to the kernel
+ */
+typedef struct {
+  OSQPInt          nterms;
+  OSQPFloat        c[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPFloat* a[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPFloat* b[OSQP_VECTOR_EXPR_TERMS];
+  OSQPFloat        sc;
+  const OSQPFloat* s;
+  const OSQPFloat* l;
+  const OSQPFloat* u;
+} cuda_vec_expr;
+
+/**
+ * d_x[i] = e[i] for i in [0,n-1], in a single kernel
+ */
+void cuda_vec_eval(OSQPFloat*    d_x,
+                   cuda_vec_expr e,
+                   OSQPInt       n);
+
 /**
  * h_res = |d_x|_inf
  */
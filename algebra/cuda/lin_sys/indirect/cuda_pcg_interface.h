@@ -52,6 +52,24 @@ typedef struct cudapcg_solver_ {
 
   void (*free)(struct cudapcg_solver_* self);
 
+  OSQPInt (*solve_block)(struct cudapcg_solver_* self,
+                         OSQPVectorf**           b,
+                         OSQPInt                 k,
+                         OSQPInt                 admm_iter);
+
+  OSQPInt (*polish_factor)(struct cudapcg_solver_* self,
+                           const OSQPVectori*      active_flags);
+
+  OSQPInt (*update_matrices_rho_vec)(struct cudapcg_solver_* self,
+                                     const  OSQPMatrix*      P,
+                                     const  OSQPInt*         Px_new_idx,
+                                            OSQPInt          P_new_n,
+                                     const  OSQPMatrix*      A,
+                                     const  OSQPInt*         Ax_new_idx,
+                                            OSQPInt          A_new_n,
+                                     const  OSQPVectorf*     rho_vec,
+                                            OSQPFloat        rho_sc);
+
   OSQPInt (*update_matrices)(struct cudapcg_solver_* self,
                              const  OSQPMatrix*      P,
                              const  OSQPInt*         Px_new_idx,
@@ -56,6 +56,13 @@ OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* M,
   return out;
 }
 
+/* The CSR products of cuSPARSE keep their own index format */
+OSQPInt OSQPMatrix_compress_indices(OSQPMatrix* mat) { return 0; }
+
+/* Operators are not supported by this algebra */
+OSQPMatrix* OSQPMatrix_new_from_operator(const OSQPOperator* op,
+                                               OSQPInt       is_triu) { return OSQP_NULL; }
+
 void OSQPMatrix_update_values(OSQPMatrix*      mat,
                               const OSQPFloat* Mx_new,
                               const OSQPInt*   Mx_new_idx,
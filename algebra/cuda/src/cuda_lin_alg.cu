@@ -114,6 +114,26 @@ __global__ void vec_ew_prod_kernel(OSQPFloat*       c,
   }
 }
 
+__global__ void vec_eval_kernel(OSQPFloat*    x,
+                                cuda_vec_expr e,
+                                OSQPInt       n) {
+
+  OSQPInt idx = threadIdx.x + blockDim.x * blockIdx.x;
+  OSQPInt grid_size = blockDim.x * gridDim.x;
+
+  for(OSQPInt i = idx; i < n; i += grid_size) {
+    OSQPFloat val = 0.0;
+    for (OSQPInt k = 0; k < e.nterms; k++) {
+      if (e.b[k]) val += e.c[k] * (e.a[k][i] * e.b[k][i]);
+      else        val += e.c[k] * e.a[k][i];
+    }
+    if (e.sc != 1.0) val *= e.sc;
+    if (e.s)         val *= e.s[i];
+    if (e.l)         val  = c_min(c_max(val, e.l[i]), e.u[i]);
+    x[i] = val;
+  }
+}
+
 __global__ void vec_eq_kernel(const OSQPFloat* a,
                               const OSQPFloat* b,
                                     OSQPFloat  tol,
@@ -630,6 +650,15 @@ void cuda_vec_add_scaled3(OSQPFloat*       d_x,
   checkCudaErrors(cublasTaxpy(CUDA_handle->cublasHandle, n, &scc, d_c, 1, d_x, 1));
 }
 
+void cuda_vec_eval(OSQPFloat*    d_x,
+                   cuda_vec_expr e,
+                   OSQPInt       n) {
+
+  OSQPInt number_of_blocks = (n / THREADS_PER_BLOCK) + 1;
+
+  vec_eval_kernel<<<number_of_blocks, THREADS_PER_BLOCK>>>(d_x, e, n);
+}
+
 void cuda_vec_norm_inf(const OSQPFloat* d_x,
                              OSQPInt    n,
                              OSQPFloat* h_res) {
@@ -17,10 +17,13 @@
 
 #include "algebra_types.h"
 #include "algebra_vector.h"
+#include "printing.h"
 
 #include "cuda_lin_alg.h"
 #include "cuda_malloc.h"
 
+#include <assert.h>
+
 
 /*******************************************************************************
  *                           API Functions                                     *
@@ -386,6 +389,128 @@ OSQPInt OSQPVectorf_in_reccone(const OSQPVectorf* y,
   return res;
 }
 
+/* VECTOR EXPRESSIONS --------------------------------------------------------*/
+
+void OSQPVectorf_expr_init(OSQPVectorf_expr* e) {
+
+  e->nterms = 0;
+  e->sc     = 1.0;
+  e->s      = OSQP_NULL;
+  e->l      = OSQP_NULL;
+  e->u      = OSQP_NULL;
+}
+
+void OSQPVectorf_expr_add(OSQPVectorf_expr*  e,
+                          OSQPFloat          c,
+                          const OSQPVectorf* a) {
+
+  OSQPVectorf_expr_add_prod(e, c, a, OSQP_NULL);
+}
+
+void OSQPVectorf_expr_add_prod(OSQPVectorf_expr*  e,
+                               OSQPFloat          c,
+                               const OSQPVectorf* a,
+                               const OSQPVectorf* b) {
+
+  // Leaving a term out would give wrong results without any sign of it
+  assert(e->nterms < OSQP_VECTOR_EXPR_TERMS);
+  if (e->nterms == OSQP_VECTOR_EXPR_TERMS) {
+    c_eprint("vector expressions have at most %d terms", OSQP_VECTOR_EXPR_TERMS);
+    return;
+  }
+
+  e->c[e->nterms] = c;
+  e->a[e->nterms] = a;
+  e->b[e->nterms] = b;
+  e->nterms++;
+}
+
+void OSQPVectorf_expr_mult_scalar(OSQPVectorf_expr* e,
+                                  OSQPFloat         sc) {
+
+  e->sc *= sc;
+}
+
+void OSQPVectorf_expr_ew_prod(OSQPVectorf_expr*  e,
+                              const OSQPVectorf* s) {
+
+  e->s = s;
+}
+
+void OSQPVectorf_expr_bound_vec(OSQPVectorf_expr*  e,
+                                const OSQPVectorf* l,
+                                const OSQPVectorf* u) {
+
+  e->l = l;
+  e->u = u;
+}
+
+/* Device arrays of an expression */
+static cuda_vec_expr expr_device(const OSQPVectorf_expr* e) {
+
+  OSQPInt       k;
+  cuda_vec_expr d;
+
+  d.nterms = e->nterms;
+  for (k = 0; k < OSQP_VECTOR_EXPR_TERMS; k++) {
+    d.c[k] = k < e->nterms ? e->c[k] : 0.0;
+    d.a[k] = k < e->nterms ? e->a[k]->d_val : OSQP_NULL;
+    d.b[k] = k < e->nterms && e->b[k] ? e->b[k]->d_val : OSQP_NULL;
+  }
+  d.sc = e->sc;
+  d.s  = e->s ? e->s->d_val : OSQP_NULL;
+  d.l  = e->l ? e->l->d_val : OSQP_NULL;
+  d.u  = e->u ? e->u->d_val : OSQP_NULL;
+
+  return d;
+}
+
+void OSQPVectorf_eval(OSQPVectorf*            x,
+                      const OSQPVectorf_expr* e) {
+
+  if (x->length) cuda_vec_eval(x->d_val, expr_device(e), x->length);
+}
+
+OSQPFloat OSQPVectorf_eval_norm_inf(OSQPVectorf*            x,
+                                    const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      S,
+                                    OSQPFloat*              snorm) {
+
+  OSQPInt    n = x ? x->length : e->a[0]->length;
+  OSQPFloat  normval = 0.0;
+  OSQPFloat* d_val;
+
+  if (S) *snorm = 0.0;
+  if (!n) return normval;
+
+  /* The norms are reduced from the evaluated expression */
+  if (x) d_val = x->d_val;
+  else   cuda_malloc((void **) &d_val, n * sizeof(OSQPFloat));
+
+  cuda_vec_eval(d_val, expr_device(e), n);
+  cuda_vec_norm_inf(d_val, n, &normval);
+  if (S) cuda_vec_scaled_norm_inf(S->d_val, d_val, n, snorm);
+
+  if (!x) cuda_free((void **) &d_val);
+  return normval;
+}
+
+OSQPFloat OSQPVectorf_expr_dot_prod(const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      w) {
+
+  OSQPFloat  dotprod = 0.0;
+  OSQPFloat* d_val;
+
+  if (!w->length) return dotprod;
+
+  cuda_malloc((void **) &d_val, w->length * sizeof(OSQPFloat));
+  cuda_vec_eval(d_val, expr_device(e), w->length);
+  cuda_vec_prod(d_val, w->d_val, w->length, &dotprod);
+  cuda_free((void **) &d_val);
+
+  return dotprod;
+}
+
 void OSQPVectorf_ew_reciprocal(OSQPVectorf*       b,
                                const OSQPVectorf* a) {
 
@@ -6,8 +6,12 @@
 #include "kkt.h"
 #endif
 
+#ifdef OSQP_ALGEBRA_BUILTIN
+#include "pardiso_runtime.h"  /* MKL loaded at runtime by the builtin algebra */
+#else
 #include "mkl_service.h"
 #include "mkl_pardiso.h"
+#endif
 
 // Solver Phases
 #define PARDISO_SYMBOLIC  (11)
@@ -116,13 +120,13 @@ OSQPInt init_linsys_solver_pardiso(pardiso_solver**    sp,
   // else it is NULL
 
   // Form KKT matrix
-  if (polishing){ // Called from polish()
+  if (polishing && !settings->realtime){ // Called from polish()
     s->KKT = form_KKT(P->csc,A->csc,
                       1,  //format = 1 means CSR
                       sigma, s->rho_inv_vec, sigma,
                       OSQP_NULL, OSQP_NULL, OSQP_NULL);
   }
-  else { // Called from ADMM algorithm
+  else { // Called from ADMM algorithm, or at setup for polishing in real-time mode
 
     // Allocate vectors of indices
     s->PtoKKT   = c_malloc(P->csc->p[n] * sizeof(OSQPInt));
@@ -137,7 +141,8 @@ OSQPInt init_linsys_solver_pardiso(pardiso_solver**    sp,
         }
     }
     else {
-      s->rho_inv = 1. / settings->rho;
+      // The polishing system is regularized with -sigma*I in place of -rho_inv*I
+      s->rho_inv = polishing ? sigma : 1. / settings->rho;
     }
 
     s->KKT = form_KKT(P->csc,A->csc,
@@ -35,6 +35,24 @@ struct pardiso {
 
     void (*free)(struct pardiso* self);
 
+    OSQPInt (*solve_block)(struct pardiso* self,
+                           OSQPVectorf**   b,
+                           OSQPInt         k,
+                           OSQPInt         admm_iter);
+
+    OSQPInt (*polish_factor)(struct pardiso*    self,
+                             const OSQPVectori* active_flags);
+
+    OSQPInt (*update_matrices_rho_vec)(struct pardiso*    self,
+                                       const OSQPMatrix*  P,
+                                       const OSQPInt*     Px_new_idx,
+                                       OSQPInt            P_new_n,
+                                       const OSQPMatrix*  A,
+                                       const OSQPInt*     Ax_new_idx,
+                                       OSQPInt            A_new_n,
+                                       const OSQPVectorf* rho_vec,
+                                       OSQPFloat          rho_sc);
+
     OSQPInt (*update_matrices)(struct pardiso*   self,
                                const OSQPMatrix* P,
                                const OSQPInt*    Px_new_idx,
@@ -0,0 +1,101 @@
+/*
+ * Loads MKL Pardiso at runtime with dlopen (Linux and macOS).
+ *
+ * The MKL single dynamic library selects its integer interface per call
+ * name: pardiso takes 32-bit integers and pardiso_64 takes 64-bit ones, so
+ * the library needs no interface-layer setup before the first call.
+ */
+
+#include "pardiso_runtime.h"
+
+#include <dlfcn.h>
+
+#ifdef OSQP_ENABLE_THREADS
+# include <pthread.h>
+
+static pthread_mutex_t load_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+typedef void (*pardiso_fn)(void**, const OSQPInt*, const OSQPInt*, const OSQPInt*,
+                           const OSQPInt*, const OSQPInt*, const void*,
+                           const OSQPInt*, const OSQPInt*, OSQPInt*,
+                           const OSQPInt*, OSQPInt*, const OSQPInt*,
+                           void*, void*, OSQPInt*);
+
+typedef int (*max_threads_fn)(void);
+
+static const char* mkl_rt_names[] = {
+#ifdef __APPLE__
+  "libmkl_rt.dylib",
+  "libmkl_rt.2.dylib",
+  "libmkl_rt.1.dylib"
+#else
+  "libmkl_rt.so",
+  "libmkl_rt.so.2",
+  "libmkl_rt.so.1"
+#endif
+};
+
+#ifdef OSQP_USE_LONG
+# define PARDISO_SYMBOL "pardiso_64"
+#else
+# define PARDISO_SYMBOL "pardiso"
+#endif
+
+static int            load_state = 0;  // 0: not tried, 1: loaded, -1: not available
+static pardiso_fn     pardiso_ptr;
+static max_threads_fn max_threads_ptr;
+
+
+OSQPInt pardiso_runtime_load(void) {
+  void*  lib = NULL;
+  size_t i;
+
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_lock(&load_lock);
+#endif
+  if (load_state == 0) {
+    load_state = -1;
+
+    for (i = 0; i < sizeof(mkl_rt_names) / sizeof(mkl_rt_names[0]) && !lib; i++)
+      lib = dlopen(mkl_rt_names[i], RTLD_NOW | RTLD_LOCAL);
+
+    // The library stays loaded for the life of the process
+    if (lib) {
+      pardiso_ptr     = (pardiso_fn) dlsym(lib, PARDISO_SYMBOL);
+      max_threads_ptr = (max_threads_fn) dlsym(lib, "MKL_Get_Max_Threads");
+      if (pardiso_ptr) load_state = 1;
+      else             dlclose(lib);
+    }
+  }
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_unlock(&load_lock);
+#endif
+
+  return load_state == 1 ? 0 : 1;
+}
+
+void pardiso_runtime(void**           pt,
+                     const OSQPInt*   maxfct,
+                     const OSQPInt*   mnum,
+                     const OSQPInt*   mtype,
+                     const OSQPInt*   phase,
+                     const OSQPInt*   n,
+                     const void*      a,
+                     const OSQPInt*   ia,
+                     const OSQPInt*   ja,
+                     OSQPInt*         perm,
+                     const OSQPInt*   nrhs,
+                     OSQPInt*         iparm,
+                     const OSQPInt*   msglvl,
+                     void*            b,
+                     void*            x,
+                     OSQPInt*         error) {
+  // The solver is only set up once the library is loaded
+  pardiso_ptr(pt, maxfct, mnum, mtype, phase, n, a, ia, ja, perm, nrhs,
+              iparm, msglvl, b, x, error);
+}
+
+int pardiso_runtime_max_threads(void) {
+  return max_threads_ptr ? max_threads_ptr() : 1;
+}
@@ -0,0 +1,59 @@
+#ifndef PARDISO_RUNTIME_H
+#define PARDISO_RUNTIME_H
+
+/*
+ * MKL Pardiso for the builtin algebra, loaded from the MKL single dynamic
+ * library (libmkl_rt) the first time it is needed.
+ *
+ * This header stands in for mkl_service.h and mkl_pardiso.h when the Pardiso
+ * interface is built into the builtin algebra (OSQP_ENABLE_RUNTIME_MKL), so
+ * the library needs MKL neither to build nor to run without it.
+ */
+
+#include "osqp_api_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Load MKL Pardiso, once per process
+ * @return  0 if MKL Pardiso can be used, 1 otherwise
+ */
+OSQPInt pardiso_runtime_load(void);
+
+/**
+ * Call pardiso (or pardiso_64 with 64-bit integers) from the loaded library;
+ * the arguments are those of the MKL function
+ */
+void pardiso_runtime(void**           pt,
+                     const OSQPInt*   maxfct,
+                     const OSQPInt*   mnum,
+                     const OSQPInt*   mtype,
+                     const OSQPInt*   phase,
+                     const OSQPInt*   n,
+                     const void*      a,
+                     const OSQPInt*   ia,
+                     const OSQPInt*   ja,
+                     OSQPInt*         perm,
+                     const OSQPInt*   nrhs,
+                     OSQPInt*         iparm,
+                     const OSQPInt*   msglvl,
+                     void*            b,
+                     void*            x,
+                     OSQPInt*         error);
+
+/**
+ * Maximum number of threads of the loaded library
+ * @return  Number of threads, 1 if the library does not say
+ */
+int pardiso_runtime_max_threads(void);
+
+#define PARDISO             pardiso_runtime
+#define mkl_get_max_threads pardiso_runtime_max_threads
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef PARDISO_RUNTIME_H */
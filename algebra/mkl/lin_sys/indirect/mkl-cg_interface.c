@@ -119,6 +119,9 @@ OSQPInt init_linsys_mklcg(mklcg_solver**     sp,
   s->solve           = &solve_linsys_mklcg;
   s->warm_start      = &warm_start_linys_mklcg;
   s->free            = &free_linsys_mklcg;
+  s->solve_block     = OSQP_NULL;
+  s->polish_factor   = OSQP_NULL;
+  s->update_matrices_rho_vec = OSQP_NULL;
   s->update_matrices = &update_matrices_linsys_mklcg;
   s->update_rho_vec  = &update_rho_linsys_mklcg;
   s->update_settings = &update_settings_linsys_solver_mklcg;
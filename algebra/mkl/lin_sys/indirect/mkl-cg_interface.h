@@ -21,6 +21,9 @@ typedef struct mklcg_solver_ {
   void    (*warm_start)(struct mklcg_solver_* self, const OSQPVectorf* x);
   OSQPInt (*adjoint_derivative)(struct mklcg_solver_* self);
   void    (*free)(struct mklcg_solver_* self);
+  OSQPInt (*solve_block)(struct mklcg_solver_* self, OSQPVectorf** b, OSQPInt k, OSQPInt admm_iter);
+  OSQPInt (*polish_factor)(struct mklcg_solver_* self, const OSQPVectori* active_flags);
+  OSQPInt (*update_matrices_rho_vec)(struct mklcg_solver_* self, const OSQPMatrix* P, const OSQPInt* Px_new_idx, OSQPInt P_new_n, const OSQPMatrix* A, const OSQPInt* Ax_new_idx, OSQPInt A_new_n, const OSQPVectorf* rho_vec, OSQPFloat rho_sc);
   OSQPInt (*update_matrices)(struct mklcg_solver_* self,
                              const  OSQPMatrix*    P,
                              const  OSQPInt*       Px_new_idx,
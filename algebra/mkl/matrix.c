@@ -168,6 +168,13 @@ OSQPCscMatrix* OSQPMatrix_get_csc(const OSQPMatrix* M) {
   return B;
 }
 
+/* The sparse BLAS products of MKL keep their own index format */
+OSQPInt OSQPMatrix_compress_indices(OSQPMatrix* M) { return 0; }
+
+/* Operators are not supported by this algebra */
+OSQPMatrix* OSQPMatrix_new_from_operator(const OSQPOperator* op,
+                                               OSQPInt       is_triu) { return OSQP_NULL; }
+
 
 /* math functions ----------------------------------------------------------*/
 
@@ -3,9 +3,12 @@
 #include "algebra_impl.h"
 #include "stdio.h"
 #include "time.h"
+#include "printing.h"
 
 #include "blas_helpers.h"
 
+#include <assert.h>
+
 /* VECTOR FUNCTIONS ----------------------------------------------------------*/
 
 OSQPInt OSQPVectorf_is_eq(const OSQPVectorf* A,
@@ -602,6 +605,131 @@ OSQPInt OSQPVectorf_in_reccone(const OSQPVectorf* y,
 //   }
 // }
 
+/* VECTOR EXPRESSIONS --------------------------------------------------------*/
+
+void OSQPVectorf_expr_init(OSQPVectorf_expr* e) {
+
+  e->nterms = 0;
+  e->sc     = 1.0;
+  e->s      = OSQP_NULL;
+  e->l      = OSQP_NULL;
+  e->u      = OSQP_NULL;
+}
+
+void OSQPVectorf_expr_add(OSQPVectorf_expr*  e,
+                          OSQPFloat          c,
+                          const OSQPVectorf* a) {
+
+  OSQPVectorf_expr_add_prod(e, c, a, OSQP_NULL);
+}
+
+void OSQPVectorf_expr_add_prod(OSQPVectorf_expr*  e,
+                               OSQPFloat          c,
+                               const OSQPVectorf* a,
+                               const OSQPVectorf* b) {
+
+  // Leaving a term out would give wrong results without any sign of it
+  assert(e->nterms < OSQP_VECTOR_EXPR_TERMS);
+  if (e->nterms == OSQP_VECTOR_EXPR_TERMS) {
+    c_eprint("vector expressions have at most %d terms", OSQP_VECTOR_EXPR_TERMS);
+    return;
+  }
+
+  e->c[e->nterms] = c;
+  e->a[e->nterms] = a;
+  e->b[e->nterms] = b;
+  e->nterms++;
+}
+
+void OSQPVectorf_expr_mult_scalar(OSQPVectorf_expr* e,
+                                  OSQPFloat         sc) {
+
+  e->sc *= sc;
+}
+
+void OSQPVectorf_expr_ew_prod(OSQPVectorf_expr*  e,
+                              const OSQPVectorf* s) {
+
+  e->s = s;
+}
+
+void OSQPVectorf_expr_bound_vec(OSQPVectorf_expr*  e,
+                                const OSQPVectorf* l,
+                                const OSQPVectorf* u) {
+
+  e->l = l;
+  e->u = u;
+}
+
+/* Value of the expression at element i */
+static OSQPFloat expr_value(const OSQPVectorf_expr* e,
+                            OSQPInt                 i) {
+
+  OSQPInt   k;
+  OSQPFloat val = 0.0;
+
+  for (k = 0; k < e->nterms; k++) {
+    if (e->b[k]) val += e->c[k] * (e->a[k]->values[i] * e->b[k]->values[i]);
+    else         val += e->c[k] * e->a[k]->values[i];
+  }
+  if (e->sc != 1.0) val *= e->sc;
+  if (e->s)         val *= e->s->values[i];
+  if (e->l)         val  = c_min(c_max(val, e->l->values[i]), e->u->values[i]);
+
+  return val;
+}
+
+void OSQPVectorf_eval(OSQPVectorf*            x,
+                      const OSQPVectorf_expr* e) {
+
+  OSQPInt    i;
+  OSQPInt    length = x->length;
+  OSQPFloat* xv     = x->values;
+
+  for (i = 0; i < length; i++) xv[i] = expr_value(e, i);
+}
+
+OSQPFloat OSQPVectorf_eval_norm_inf(OSQPVectorf*            x,
+                                    const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      S,
+                                    OSQPFloat*              snorm) {
+
+  OSQPInt    i;
+  OSQPInt    length   = x ? x->length : e->a[0]->length;
+  OSQPFloat* xv       = x ? x->values : OSQP_NULL;
+  OSQPFloat* Sv       = S ? S->values : OSQP_NULL;
+  OSQPFloat  val, absval;
+  OSQPFloat  normval  = 0.0;
+  OSQPFloat  snormval = 0.0;
+
+  for (i = 0; i < length; i++) {
+    val = expr_value(e, i);
+    if (xv) xv[i] = val;
+
+    absval = c_absval(val);
+    if (absval > normval) normval = absval;
+    if (Sv) {
+      absval = c_absval(Sv[i] * val);
+      if (absval > snormval) snormval = absval;
+    }
+  }
+
+  if (S) *snorm = snormval;
+  return normval;
+}
+
+OSQPFloat OSQPVectorf_expr_dot_prod(const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      w) {
+
+  OSQPInt    i;
+  OSQPInt    length  = w->length;
+  OSQPFloat* wv      = w->values;
+  OSQPFloat  dotprod = 0.0;
+
+  for (i = 0; i < length; i++) dotprod += wv[i] * expr_value(e, i);
+  return dotprod;
+}
+
 OSQPFloat OSQPVectorf_norm_1(const OSQPVectorf* a) {
 
   OSQPFloat val = 0.0;
@@ -0,0 +1,123 @@
+/*
+ * Solve time with the termination checks on the solver thread and on a
+ * helper thread (async_termination).
+ *
+ * Solves a random QP with check_termination = 1, where the checks cost about
+ * as much as the iterations they follow, and with the default interval, and
+ * reports the time per iteration of each. Both solves run the same iterations
+ * and return the same iterate, so the difference is the time of the checks
+ * the helper thread takes off the iterations, less the copies of the
+ * iterates. The solves are cold started and timed without the setup; rho is
+ * adapted at a fixed interval, whose checks stay on the solver thread.
+ *
+ * The helper thread only overlaps the iterations on a machine with a core to
+ * spare; on a single core the numbers show the cost of the copies and the
+ * synchronization.
+ *
+ * Usage: bench_async_check [--n=N] [--m=M] [--col_nnz=K] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static double time_solve(bench_problem* prob,
+                         OSQPSettings*  settings,
+                         OSQPInt        repeats,
+                         double*        samples,
+                         OSQPInt*       iter) {
+
+  OSQPInt     r;
+  double      t;
+  OSQPSolver* solver = NULL;
+
+  if (osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                 prob->m, prob->n, settings)) {
+    printf("Setup failed\n");
+    exit(1);
+  }
+
+  for (r = 0; r < repeats; r++) {
+    osqp_cold_start(solver);
+    t = bench_time();
+    osqp_solve(solver);
+    samples[r] = (bench_time() - t) / solver->info->iter;
+  }
+  *iter = solver->info->iter;
+
+  osqp_cleanup(solver);
+  return bench_percentile(samples, repeats, 50);
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n       = 20000;
+  OSQPInt        m       = 10000;
+  OSQPFloat      col_nnz = 4.0;
+  OSQPInt        repeats = 5;
+  OSQPInt        intervals[2];
+  OSQPInt        i, k;
+  OSQPInt        iter_sync, iter_async;
+  double         t_sync, t_async;
+  double*        samples;
+  bench_problem* prob;
+  OSQPSettings*  settings;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, 20, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  samples  = malloc(repeats * sizeof(double));
+  if (!prob || !settings || !samples) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose               = 0;
+  settings->polishing             = 0;
+  settings->eps_abs               = 1e-7;
+  settings->eps_rel               = 1e-7;
+  settings->adaptive_rho_interval = 100;
+  intervals[0] = 1;
+  intervals[1] = settings->check_termination;
+
+  printf("n = %lld, m = %lld\n\n", (long long)n, (long long)m);
+  printf("%-18s %10s %18s %18s %10s\n", "check_termination", "iter",
+         "sync [us/iter]", "async [us/iter]", "speedup");
+
+  for (k = 0; k < 2; k++) {
+    settings->check_termination = intervals[k];
+
+    settings->async_termination = 0;
+    t_sync = time_solve(prob, settings, repeats, samples, &iter_sync);
+
+    settings->async_termination = 1;
+    t_async = time_solve(prob, settings, repeats, samples, &iter_async);
+
+    if (iter_sync != iter_async) {
+      printf("Different iterations: %lld and %lld\n",
+             (long long)iter_sync, (long long)iter_async);
+      return 1;
+    }
+    printf("%-18lld %10lld %18.2f %18.2f %10.2f\n",
+           (long long)intervals[k], (long long)iter_sync,
+           1e6 * t_sync, 1e6 * t_async, t_sync / t_async);
+  }
+
+  bench_free_problem(prob);
+  free(settings);
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Size and speed of the compressed row indices of the built-in algebra.
+ *
+ * Generates a random QP and times the matrix-vector products of every ADMM
+ * iteration (A x, A' y and the symmetric P x from its upper triangle) with
+ * the plain CSC row indices and with the delta-encoded ones of
+ * compress_indices, and reports the bytes read per nonzero for the row
+ * indices and for indices plus values. The products are expected to give
+ * identical results, which is checked.
+ *
+ * The products are called directly, so the benchmark includes the private
+ * headers of the built-in algebra.
+ *
+ * Usage: bench_compressed_index [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                               [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+#include "csc_math.h"
+#include "csc_packed.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_PRODUCTS 3
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 1000000;
+  OSQPInt        m         = 1500000;
+  OSQPFloat      col_nnz   = 4;
+  OSQPInt        bandwidth = 50;
+  OSQPInt        repeats   = 20;
+  OSQPInt        i, c, r, len, nnz;
+  double         t, t_plain, t_packed, bytes;
+  double*        s_plain;
+  double*        s_packed;
+  bench_problem* prob;
+  csc_packed*    ZA;
+  csc_packed*    ZP;
+  OSQPFloat*     x;
+  OSQPFloat*     y;
+  OSQPFloat*     out_plain;
+  OSQPFloat*     out_packed;
+  int            same = 1;
+
+  const char* names[N_PRODUCTS] = {"A x", "A' y", "P x"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob       = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  s_plain    = malloc(repeats * sizeof(double));
+  s_packed   = malloc(repeats * sizeof(double));
+  x          = malloc(n * sizeof(OSQPFloat));
+  y          = malloc(m * sizeof(OSQPFloat));
+  out_plain  = malloc((n > m ? n : m) * sizeof(OSQPFloat));
+  out_packed = malloc((n > m ? n : m) * sizeof(OSQPFloat));
+  if (!prob || !s_plain || !s_packed || !x || !y || !out_plain || !out_packed) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++) x[i] = 1.0 + 1e-6 * i;
+  for (i = 0; i < m; i++) y[i] = 1.0 - 1e-7 * i;
+
+  if (!csc_packable(prob->A) || !csc_packable(prob->P)) {
+    printf("The row indices of the problem cannot be packed\n");
+    return 1;
+  }
+  ZA = csc_packed_new(prob->A);
+  ZP = csc_packed_new(prob->P);
+  if (!ZA || !ZP) {
+    printf("Out of memory packing the indices\n");
+    return 1;
+  }
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld\n\n",
+         (long long)n, (long long)m, (long long)prob->P->p[n], (long long)prob->A->p[n]);
+
+  /* Bytes read per nonzero; the packed products also read the column widths */
+  printf("%-8s %18s %18s %18s %18s\n", "matrix", "plain idx [B/nz]", "packed idx [B/nz]",
+         "plain total [B/nz]", "packed total [B/nz]");
+  for (c = 0; c < 2; c++) {
+    nnz   = c == 0 ? prob->A->p[n] : prob->P->p[n];
+    bytes = (double)(c == 0 ? ZA->size : ZP->size) + n;
+    printf("%-8s %18.3f %18.3f %18.3f %18.3f\n", c == 0 ? "A" : "P triu",
+           (double)sizeof(OSQPInt), bytes / nnz,
+           (double)(sizeof(OSQPInt) + sizeof(OSQPFloat)), bytes / nnz + sizeof(OSQPFloat));
+  }
+
+  printf("\n%-8s %16s %16s %10s\n", "product", "plain [us]", "packed [us]", "speedup");
+  for (c = 0; c < N_PRODUCTS; c++) {
+    len = c == 0 ? m : n;
+
+    for (r = 0; r < repeats; r++) {
+      t = bench_time();
+      if (c == 0)      csc_Axpy(prob->A, x, out_plain, 1.0, 0.0);
+      else if (c == 1) csc_Atxpy(prob->A, y, out_plain, 1.0, 0.0);
+      else             csc_Axpy_sym_triu(prob->P, x, out_plain, 1.0, 0.0);
+      s_plain[r] = bench_time() - t;
+
+      t = bench_time();
+      if (c == 0)      csc_packed_Axpy(prob->A, ZA, x, out_packed, 1.0, 0.0);
+      else if (c == 1) csc_packed_Atxpy(prob->A, ZA, y, out_packed, 1.0, 0.0);
+      else             csc_packed_Axpy_sym_triu(prob->P, ZP, x, out_packed, 1.0, 0.0);
+      s_packed[r] = bench_time() - t;
+    }
+    if (memcmp(out_plain, out_packed, len * sizeof(OSQPFloat))) same = 0;
+
+    t_plain  = bench_percentile(s_plain, repeats, 50);
+    t_packed = bench_percentile(s_packed, repeats, 50);
+    printf("%-8s %16.1f %16.1f %10.2f\n", names[c], 1e6 * t_plain, 1e6 * t_packed,
+           t_plain / t_packed);
+  }
+  printf("\nresults %s\n", same ? "identical" : "DIFFER");
+
+  csc_packed_free(ZA);
+  csc_packed_free(ZP);
+  bench_free_problem(prob);
+  free(s_plain);
+  free(s_packed);
+  free(x);
+  free(y);
+  free(out_plain);
+  free(out_packed);
+  return same ? 0 : 1;
+}
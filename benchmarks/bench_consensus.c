@@ -0,0 +1,121 @@
+/*
+ * Setup and solve times of a consensus solve over row blocks against a
+ * single solver.
+ *
+ * Sets up a random QP once with osqp_setup and then with osqp_consensus_setup
+ * for each number of blocks, and times the setup (which factors the KKT
+ * matrices) and one solve from zero. The setup of the blocks and their local
+ * solves run on one thread per block when the library has threads, so the
+ * times depend on the number of cores. The distance of the consensus solution
+ * to the one of the single solver shows the accuracy of the consensus.
+ *
+ * Usage: bench_consensus [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                        [--max_blocks=K]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n          = 5000;
+  OSQPInt        m          = 7500;
+  OSQPFloat      col_nnz    = 4;
+  OSQPInt        bandwidth  = 10;
+  OSQPInt        max_blocks = 8;
+  OSQPInt        i, K, exitflag;
+  double         t, t_setup, t_solve, diff;
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPConsensus* cons;
+  OSQPSettings*  settings;
+  OSQPFloat*     x;
+  OSQPFloat*     y;
+  OSQPInfo       info;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--max_blocks", &max_blocks)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (max_blocks < 1) max_blocks = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  x        = malloc(n * sizeof(OSQPFloat));
+  y        = malloc(m * sizeof(OSQPFloat));
+  if (!prob || !settings || !x || !y) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose   = 0;
+  settings->polishing = 0;
+  settings->eps_abs   = 1e-5;
+  settings->eps_rel   = 1e-5;
+
+  t = bench_time();
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        prob->m, prob->n, settings);
+  t_setup = bench_time() - t;
+  if (exitflag) {
+    printf("Setup failed: %s\n", osqp_error_message(exitflag));
+    return 1;
+  }
+  t = bench_time();
+  osqp_solve(solver);
+  t_solve = bench_time() - t;
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld\n\n",
+         (long long)n, (long long)m, (long long)prob->P->nzmax, (long long)prob->A->nzmax);
+  printf("%-12s %14s %14s %8s %12s %16s\n", "solver", "setup [ms]", "solve [ms]",
+         "iter", "status", "max |x - x_1|");
+  printf("%-12s %14.3f %14.3f %8lld %12s %16s\n", "osqp_solve", 1e3 * t_setup,
+         1e3 * t_solve, (long long)solver->info->iter, solver->info->status, "-");
+
+  for (K = 1; K <= max_blocks; K *= 2) {
+    cons = NULL;
+
+    t = bench_time();
+    exitflag = osqp_consensus_setup(&cons, prob->P, prob->q, prob->A, prob->l, prob->u,
+                                    prob->m, prob->n, K, NULL, settings);
+    t_setup = bench_time() - t;
+    if (exitflag) {
+      printf("Consensus setup failed: %s\n", osqp_error_message(exitflag));
+      return 1;
+    }
+
+    t = bench_time();
+    exitflag = osqp_consensus_solve(cons, x, y, &info);
+    t_solve = bench_time() - t;
+    if (exitflag) {
+      printf("Consensus solve failed: %s\n", osqp_error_message(exitflag));
+      return 1;
+    }
+
+    diff = 0;
+    for (i = 0; i < n; i++) diff = fmax(diff, fabs(x[i] - solver->solution->x[i]));
+
+    printf("K = %-8lld %14.3f %14.3f %8lld %12s %16.3g\n", (long long)K, 1e3 * t_setup,
+           1e3 * t_solve, (long long)info.iter, info.status, diff);
+
+    osqp_consensus_cleanup(cons);
+  }
+
+  osqp_cleanup(solver);
+  bench_free_problem(prob);
+  free(settings);
+  free(x);
+  free(y);
+  return 0;
+}
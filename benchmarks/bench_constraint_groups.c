@@ -0,0 +1,146 @@
+/*
+ * Effect of grouping the constraints by type on the iteration cost.
+ *
+ * Generates a random QP and turns a fraction of its constraints into
+ * equalities (l = u = 0, which keeps the problem feasible) and another
+ * fraction into loose constraints (both bounds infinite), interleaved at
+ * random. Then times a fixed number of ADMM iterations with the constraints
+ * in the user ordering and with group_constraints, where the operations with
+ * the vector of rho values become scalings of three segments and the loose
+ * constraints skip the projection. The termination criteria are not checked,
+ * so the iterations only do the ADMM steps.
+ *
+ * Usage: bench_constraint_groups [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                                [--eq=FRACTION] [--loose=FRACTION]
+ *                                [--iter=K] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_CASES 2
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n          = 50000;
+  OSQPInt        m          = 500000;
+  OSQPFloat      col_nnz    = 2;
+  OSQPInt        bandwidth  = 5;
+  OSQPFloat      eq_frac    = 0.5;
+  OSQPFloat      loose_frac = 0.1;
+  OSQPInt        iter       = 200;
+  OSQPInt        repeats    = 5;
+  OSQPInt        i, c, r;
+  OSQPInt        exitflag;
+  OSQPInt        n_eq = 0, n_loose = 0;
+  unsigned int   state = 7;
+  double         t, draw, diff;
+  double*        s_solve[N_CASES];
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     x[N_CASES];
+
+  const char* names[N_CASES] = {"interleaved", "grouped"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_float(argv[i], "--eq", &eq_frac) &&
+        !bench_arg_float(argv[i], "--loose", &loose_frac) &&
+        !bench_arg_int(argv[i], "--iter", &iter) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  if (!prob || !settings) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (c = 0; c < N_CASES; c++) {
+    s_solve[c] = malloc(repeats * sizeof(double));
+    x[c]       = malloc(n * sizeof(OSQPFloat));
+    if (!s_solve[c] || !x[c]) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+  }
+
+  /* Interleave equalities and loose constraints among the inequalities */
+  for (i = 0; i < m; i++) {
+    state = state * 1103515245u + 12345u;
+    draw  = (double)(state >> 8) / (double)(1u << 24);
+    if (draw < eq_frac) {
+      prob->l[i] = 0;
+      prob->u[i] = 0;
+      n_eq++;
+    }
+    else if (draw < eq_frac + loose_frac) {
+      prob->l[i] = -OSQP_INFTY;
+      prob->u[i] =  OSQP_INFTY;
+      n_loose++;
+    }
+  }
+
+  /* Run a fixed number of iterations */
+  osqp_set_default_settings(settings);
+  settings->verbose           = 0;
+  settings->polishing         = 0;
+  settings->adaptive_rho      = 0;
+  settings->check_termination = 0;
+  settings->max_iter          = iter;
+
+  for (c = 0; c < N_CASES; c++) {
+    settings->group_constraints = c;
+
+    exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                          prob->m, prob->n, settings);
+    if (exitflag) {
+      printf("Setup of the %s problem failed: %s\n", names[c], osqp_error_message(exitflag));
+      return 1;
+    }
+
+    for (r = 0; r < repeats; r++) {
+      t = bench_time();
+      osqp_solve(solver);
+      s_solve[c][r] = bench_time() - t;
+    }
+
+    memcpy(x[c], solver->solution->x, n * sizeof(OSQPFloat));
+    osqp_cleanup(solver);
+    solver = NULL;
+  }
+
+  diff = 0;
+  for (i = 0; i < n; i++) diff = fmax(diff, fabs(x[0][i] - x[1][i]));
+
+  printf("n = %lld, m = %lld (%lld equalities, %lld loose), nnz(P) = %lld, nnz(A) = %lld\n\n",
+         (long long)n, (long long)m, (long long)n_eq, (long long)n_loose,
+         (long long)prob->P->p[n], (long long)prob->A->p[n]);
+  printf("%-16s %14s %16s\n", "constraints", "solve [ms]", "per iter [us]");
+  for (c = 0; c < N_CASES; c++) {
+    t = bench_percentile(s_solve[c], repeats, 50);
+    printf("%-16s %14.3f %16.3f\n", names[c], 1e3 * t, 1e6 * t / iter);
+  }
+  printf("\nmax |x_interleaved - x_grouped| = %.3g\n", diff);
+
+  bench_free_problem(prob);
+  free(settings);
+  for (c = 0; c < N_CASES; c++) {
+    free(s_solve[c]);
+    free(x[c]);
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Setup and solve times with the equality constraints eliminated at setup.
+ *
+ * Generates a random QP and turns a fraction of its constraints into
+ * equalities l = u = A x0 for a small random x0 (x0 satisfies the other
+ * constraints too, so the problem stays feasible). Then solves it as it is
+ * and with eliminate_equalities, where the KKT system loses two rows per
+ * eliminated equality and the equalities hold by construction. The distance
+ * between the primal solutions shows the accuracy of the substitution (the
+ * duals can differ, since a random A gives dependent equalities). With
+ * --verbose=1 the setup header reports how many equalities were eliminated;
+ * a problem whose reduction would be too dense is solved as it is.
+ *
+ * Usage: bench_eliminate [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                        [--eq=FRACTION] [--repeats=R] [--verbose=V]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_CASES 2
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 20000;
+  OSQPInt        m         = 30000;
+  OSQPFloat      col_nnz   = 2;
+  OSQPInt        bandwidth = 5;
+  OSQPFloat      eq_frac   = 0.3;
+  OSQPInt        repeats   = 5;
+  OSQPInt        verbose   = 0;
+  OSQPInt        i, j, k, c, r;
+  OSQPInt        exitflag;
+  OSQPInt        n_eq  = 0;
+  OSQPInt        iter[N_CASES];
+  unsigned int   state = 7;
+  double         t, draw, diff;
+  double         t_setup[N_CASES];
+  double         obj[N_CASES];
+  double*        s_solve[N_CASES];
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     x0;
+  OSQPFloat*     Ax0;
+  OSQPFloat*     x[N_CASES];
+
+  const char* names[N_CASES] = {"as is", "eliminated"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_float(argv[i], "--eq", &eq_frac) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats) &&
+        !bench_arg_int(argv[i], "--verbose", &verbose)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  x0       = malloc(n * sizeof(OSQPFloat));
+  Ax0      = calloc(m, sizeof(OSQPFloat));
+  if (!prob || !settings || !x0 || !Ax0) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (c = 0; c < N_CASES; c++) {
+    s_solve[c] = malloc(repeats * sizeof(double));
+    x[c]       = malloc(n * sizeof(OSQPFloat));
+    if (!s_solve[c] || !x[c]) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+  }
+
+  /* Equalities through a point inside the other constraints */
+  for (j = 0; j < n; j++) {
+    state = state * 1103515245u + 12345u;
+    x0[j] = 0.2 * ((double)(state >> 8) / (double)(1u << 24) - 0.5);
+    for (k = prob->A->p[j]; k < prob->A->p[j+1]; k++) Ax0[prob->A->i[k]] += prob->A->x[k] * x0[j];
+  }
+  for (i = 0; i < m; i++) {
+    state = state * 1103515245u + 12345u;
+    draw  = (double)(state >> 8) / (double)(1u << 24);
+    if (draw < eq_frac) {
+      prob->l[i] = Ax0[i];
+      prob->u[i] = Ax0[i];
+      n_eq++;
+    }
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose   = verbose;
+  settings->polishing = 0;
+  settings->eps_abs   = 1e-5;
+  settings->eps_rel   = 1e-5;
+
+  for (c = 0; c < N_CASES; c++) {
+    settings->eliminate_equalities = c;
+
+    t = bench_time();
+    exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                          prob->m, prob->n, settings);
+    t_setup[c] = bench_time() - t;
+    if (exitflag) {
+      printf("Setup of the %s problem failed: %s\n", names[c], osqp_error_message(exitflag));
+      return 1;
+    }
+
+    /* Every solve starts from zero */
+    settings->warm_starting = 0;
+    osqp_update_settings(solver, settings);
+    for (r = 0; r < repeats; r++) {
+      t = bench_time();
+      osqp_solve(solver);
+      s_solve[c][r] = bench_time() - t;
+    }
+    settings->warm_starting = 1;
+
+    iter[c] = solver->info->iter;
+    obj[c]  = solver->info->obj_val;
+    memcpy(x[c], solver->solution->x, n * sizeof(OSQPFloat));
+    osqp_cleanup(solver);
+    solver = NULL;
+  }
+
+  diff = 0;
+  for (i = 0; i < n; i++) diff = fmax(diff, fabs(x[0][i] - x[1][i]));
+
+  printf("n = %lld, m = %lld (%lld equalities), nnz(P) = %lld, nnz(A) = %lld\n\n",
+         (long long)n, (long long)m, (long long)n_eq,
+         (long long)prob->P->p[n], (long long)prob->A->p[n]);
+  printf("%-12s %14s %14s %8s %16s\n", "equalities", "setup [ms]", "solve [ms]",
+         "iter", "objective");
+  for (c = 0; c < N_CASES; c++) {
+    t = bench_percentile(s_solve[c], repeats, 50);
+    printf("%-12s %14.3f %14.3f %8lld %16.8g\n", names[c], 1e3 * t_setup[c], 1e3 * t,
+           (long long)iter[c], obj[c]);
+  }
+  printf("\nmax |x_as_is - x_eliminated| = %.3g\n", diff);
+
+  bench_free_problem(prob);
+  free(settings);
+  free(x0);
+  free(Ax0);
+  for (c = 0; c < N_CASES; c++) {
+    free(s_solve[c]);
+    free(x[c]);
+  }
+  return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Setup latency and time to solution of the hybrid linear solver.
+ *
+ * Sets up and solves a random QP with the direct solver and with the hybrid
+ * solver, which starts with CG on the reduced KKT system and switches to the
+ * QDLDL factorization once it is available. Reports the setup time, the
+ * solve time and their sum (time to solution) as medians over the repeats.
+ * Cleanup waits for a factorization thread still running; the cleanup column
+ * shows that wait.
+ *
+ * Usage: bench_hybrid_linsys [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                            [--adaptive_rho=0|1] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_SOLVERS 2
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n            = 3000;
+  OSQPInt        m            = 2000;
+  OSQPFloat      col_nnz      = 10;
+  OSQPInt        bandwidth    = 0;
+  OSQPInt        adaptive_rho = 0;
+  OSQPInt        repeats      = 3;
+  OSQPInt        i, k, r;
+  OSQPInt        exitflag;
+  OSQPInt        iters[N_SOLVERS];
+  char           status[N_SOLVERS][32];
+  double         t, diff;
+  double*        s_setup[N_SOLVERS];
+  double*        s_solve[N_SOLVERS];
+  double*        s_total[N_SOLVERS];
+  double*        s_cleanup[N_SOLVERS];
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     x[N_SOLVERS];
+
+  const enum osqp_linsys_solver_type types[N_SOLVERS] = {OSQP_DIRECT_SOLVER, OSQP_HYBRID_SOLVER};
+  const char* names[N_SOLVERS] = {"direct", "hybrid"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--adaptive_rho", &adaptive_rho) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  if (!prob || !settings) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (k = 0; k < N_SOLVERS; k++) {
+    s_setup[k]   = malloc(repeats * sizeof(double));
+    s_solve[k]   = malloc(repeats * sizeof(double));
+    s_total[k]   = malloc(repeats * sizeof(double));
+    s_cleanup[k] = malloc(repeats * sizeof(double));
+    x[k]         = malloc(n * sizeof(OSQPFloat));
+    if (!s_setup[k] || !s_solve[k] || !s_total[k] || !s_cleanup[k] || !x[k]) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose      = 0;
+  settings->adaptive_rho = adaptive_rho;
+
+  for (k = 0; k < N_SOLVERS; k++) {
+    settings->linsys_solver = types[k];
+
+    for (r = 0; r < repeats; r++) {
+      t = bench_time();
+      exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                            prob->m, prob->n, settings);
+      s_setup[k][r] = bench_time() - t;
+      if (exitflag) {
+        printf("Setup with the %s solver failed: %s\n", names[k], osqp_error_message(exitflag));
+        return 1;
+      }
+
+      t = bench_time();
+      osqp_solve(solver);
+      s_solve[k][r] = bench_time() - t;
+      s_total[k][r] = s_setup[k][r] + s_solve[k][r];
+
+      iters[k] = solver->info->iter;
+      strcpy(status[k], solver->info->status);
+      memcpy(x[k], solver->solution->x, n * sizeof(OSQPFloat));
+
+      t = bench_time();
+      osqp_cleanup(solver);
+      s_cleanup[k][r] = bench_time() - t;
+      solver = NULL;
+    }
+  }
+
+  diff = 0;
+  for (i = 0; i < n; i++) diff = fmax(diff, fabs(x[0][i] - x[1][i]));
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, adaptive_rho = %lld\n\n",
+         (long long)n, (long long)m, (long long)prob->P->nzmax, (long long)prob->A->nzmax,
+         (long long)adaptive_rho);
+  printf("%-8s %14s %14s %14s %14s %8s  %s\n", "solver", "setup [ms]", "solve [ms]",
+         "total [ms]", "cleanup [ms]", "iter", "status");
+  for (k = 0; k < N_SOLVERS; k++) {
+    printf("%-8s %14.3f %14.3f %14.3f %14.3f %8lld  %s\n", names[k],
+           1e3 * bench_percentile(s_setup[k], repeats, 50),
+           1e3 * bench_percentile(s_solve[k], repeats, 50),
+           1e3 * bench_percentile(s_total[k], repeats, 50),
+           1e3 * bench_percentile(s_cleanup[k], repeats, 50),
+           (long long)iters[k], status[k]);
+  }
+  printf("\nmax |x_direct - x_hybrid| = %.3g\n", diff);
+
+  bench_free_problem(prob);
+  free(settings);
+  for (k = 0; k < N_SOLVERS; k++) {
+    free(s_setup[k]);
+    free(s_solve[k]);
+    free(s_total[k]);
+    free(s_cleanup[k]);
+    free(x[k]);
+  }
+  return 0;
+}
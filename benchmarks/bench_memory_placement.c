@@ -0,0 +1,142 @@
+/*
+ * Effect of huge-page and NUMA placement on the ADMM iteration time.
+ *
+ * Sets up the same large random QP with each placement policy and times a
+ * fixed number of iterations (no termination checks, no rho adaptation), so
+ * that only memory placement differs between the runs.
+ *
+ * Usage: bench_memory_placement [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                               [--iters=K] [--repeats=R] [--numa_node=NODE]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  const char* name;
+  OSQPInt     huge_pages;
+  OSQPInt     numa_node;
+} placement_config;
+
+static int run_config(const bench_problem*    prob,
+                      const placement_config* cfg,
+                      OSQPInt                 iters,
+                      OSQPInt                 repeats) {
+
+  OSQPInt       exitflag, r;
+  OSQPSolver*   solver = NULL;
+  OSQPSettings* settings;
+  double        t_setup, t;
+  double*       samples;
+
+  settings = malloc(sizeof(OSQPSettings));
+  samples  = malloc(repeats * sizeof(double));
+  if (!settings || !samples) {
+    free(settings);
+    free(samples);
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose           = 0;
+  settings->polishing         = 0;
+  settings->warm_starting     = 0;
+  settings->adaptive_rho      = 0;
+  settings->check_termination = 0;
+  settings->max_iter          = iters;
+  settings->huge_pages        = cfg->huge_pages;
+  settings->numa_node         = cfg->numa_node;
+
+  t_setup  = bench_time();
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        prob->m, prob->n, settings);
+  t_setup  = bench_time() - t_setup;
+
+  if (exitflag) {
+    printf("%-22s setup failed: %s\n", cfg->name, osqp_error_message(exitflag));
+    free(settings);
+    free(samples);
+    return 1;
+  }
+
+  // One untimed solve to fault in any remaining pages
+  osqp_solve(solver);
+
+  for (r = 0; r < repeats; r++) {
+    t = bench_time();
+    osqp_solve(solver);
+    samples[r] = (bench_time() - t) / (double)iters;
+  }
+
+  printf("%-22s %10.2f %14.3f %14.3f %14.3f\n", cfg->name, 1e3 * t_setup,
+         1e6 * bench_percentile(samples, repeats, 0),
+         1e6 * bench_percentile(samples, repeats, 50),
+         1e6 * bench_percentile(samples, repeats, 95));
+
+  osqp_cleanup(solver);
+  free(settings);
+  free(samples);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 50000;
+  OSQPInt        m         = 75000;
+  OSQPFloat      col_nnz   = 4;
+  OSQPInt        bandwidth = 10;
+  OSQPInt        iters     = 200;
+  OSQPInt        repeats   = 10;
+  OSQPInt        numa_node = 0;
+  OSQPInt        i, num_configs;
+  int            failed = 0;
+  bench_problem* prob;
+
+  placement_config configs[4];
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--iters", &iters) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats) &&
+        !bench_arg_int(argv[i], "--numa_node", &numa_node)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (iters < 1)   iters = 1;
+  if (repeats < 1) repeats = 1;
+
+  configs[0].name = "default";          configs[0].huge_pages = 0; configs[0].numa_node = -1;
+  configs[1].name = "huge pages";       configs[1].huge_pages = 1; configs[1].numa_node = -1;
+  configs[2].name = "numa node";        configs[2].huge_pages = 0; configs[2].numa_node = numa_node;
+  configs[3].name = "huge pages + numa"; configs[3].huge_pages = 1; configs[3].numa_node = numa_node;
+  num_configs = numa_node >= 0 ? 4 : 2;
+
+  prob = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  if (!prob) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+#ifndef OSQP_ENABLE_MEMORY_PLACEMENT
+  printf("Note: OSQP was built without OSQP_ENABLE_MEMORY_PLACEMENT, all policies behave as the default\n");
+#endif
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, %lld iterations x %lld repeats\n\n",
+         (long long)n, (long long)m, (long long)prob->P->nzmax, (long long)prob->A->nzmax,
+         (long long)iters, (long long)repeats);
+  printf("%-22s %10s %14s %14s %14s\n", "placement", "setup [ms]",
+         "min [us/iter]", "p50 [us/iter]", "p95 [us/iter]");
+
+  for (i = 0; i < num_configs; i++) {
+    failed |= run_config(prob, &configs[i], iters, repeats);
+  }
+
+  bench_free_problem(prob);
+  return failed;
+}
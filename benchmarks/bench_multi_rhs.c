@@ -0,0 +1,139 @@
+/*
+ * Throughput of osqp_solve_multi against one osqp_solve per scenario.
+ *
+ * Sets up a random QP once and solves k scenarios that differ in q, first
+ * one at a time (osqp_update_data_vec + osqp_solve) and then as one block.
+ * Both runs use the same settings and start every scenario from zero, so
+ * they take the same iterations and only the cost per iteration differs.
+ *
+ * Usage: bench_multi_rhs [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                        [--k=K] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 5000;
+  OSQPInt        m         = 7500;
+  OSQPFloat      col_nnz   = 4;
+  OSQPInt        bandwidth = 10;
+  OSQPInt        k         = 32;
+  OSQPInt        repeats   = 3;
+  OSQPInt        i, j, r, iters;
+  OSQPInt        exitflag;
+  unsigned int   state = 7;
+  double         t, t_single, t_multi, diff;
+  double*        s_single;
+  double*        s_multi;
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     q;
+  OSQPFloat*     x_single;
+  OSQPFloat*     x_multi;
+  OSQPFloat*     y_multi;
+  OSQPInfo*      info;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--k", &k) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (k < 1)       k = 1;
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  q        = malloc(n * k * sizeof(OSQPFloat));
+  x_single = malloc(n * k * sizeof(OSQPFloat));
+  x_multi  = malloc(n * k * sizeof(OSQPFloat));
+  y_multi  = malloc(m * k * sizeof(OSQPFloat));
+  info     = malloc(k * sizeof(OSQPInfo));
+  s_single = malloc(repeats * sizeof(double));
+  s_multi  = malloc(repeats * sizeof(double));
+  if (!prob || !settings || !q || !x_single || !x_multi || !y_multi || !info ||
+      !s_single || !s_multi) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+  // Scenarios: the nominal q with independent relative perturbations
+  for (j = 0; j < k; j++) {
+    for (i = 0; i < n; i++) {
+      state = state * 1103515245u + 12345u;
+      q[j*n + i] = prob->q[i] * (0.5 + (double)(state >> 8) / (double)(1u << 24));
+    }
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose       = 0;
+  settings->polishing     = 0;
+  settings->warm_starting = 0;
+  settings->adaptive_rho  = 0;
+
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        prob->m, prob->n, settings);
+  if (exitflag) {
+    printf("Setup failed: %s\n", osqp_error_message(exitflag));
+    return 1;
+  }
+
+  iters = 0;
+  for (r = 0; r < repeats; r++) {
+    t = bench_time();
+    for (j = 0; j < k; j++) {
+      osqp_update_data_vec(solver, q + j*n, NULL, NULL);
+      osqp_solve(solver);
+      memcpy(x_single + j*n, solver->solution->x, n * sizeof(OSQPFloat));
+      if (r == 0) iters += solver->info->iter;
+    }
+    s_single[r] = bench_time() - t;
+
+    t = bench_time();
+    exitflag = osqp_solve_multi(solver, k, q, NULL, NULL, x_multi, y_multi, info);
+    s_multi[r] = bench_time() - t;
+    if (exitflag) {
+      printf("Block solve failed: %s\n", osqp_error_message(exitflag));
+      return 1;
+    }
+  }
+
+  diff = 0;
+  for (i = 0; i < n * k; i++) diff = fmax(diff, fabs(x_single[i] - x_multi[i]));
+
+  t_single = bench_percentile(s_single, repeats, 50);
+  t_multi  = bench_percentile(s_multi, repeats, 50);
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, k = %lld, %lld ADMM iterations in total\n\n",
+         (long long)n, (long long)m, (long long)prob->P->nzmax, (long long)prob->A->nzmax,
+         (long long)k, (long long)iters);
+  printf("%-16s %14s %18s\n", "mode", "p50 [ms]", "[ms/scenario]");
+  printf("%-16s %14.3f %18.3f\n", "k x osqp_solve", 1e3 * t_single, 1e3 * t_single / k);
+  printf("%-16s %14.3f %18.3f\n", "osqp_solve_multi", 1e3 * t_multi, 1e3 * t_multi / k);
+  printf("\nspeedup %.2f, max |x_single - x_multi| = %.3g\n", t_single / t_multi, diff);
+
+  osqp_cleanup(solver);
+  bench_free_problem(prob);
+  free(settings);
+  free(q);
+  free(x_single);
+  free(x_multi);
+  free(y_multi);
+  free(info);
+  free(s_single);
+  free(s_multi);
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Bandwidth of the products of a constraint matrix streamed from a
+ * memory-mapped file.
+ *
+ * Writes a random A to a file, maps it with osqp_operator_map_file and times
+ * A*x and A'*y. The bandwidth is the size of the column pointers, row indices
+ * and values divided by the time of a product. Warm runs find the file in the
+ * page cache; before each cold run the file is evicted from the page cache
+ * (where posix_fadvise is available), so the product reads it from the disk.
+ * The bandwidth of the same loops on the matrix in memory is the reference.
+ *
+ * Usage: bench_out_of_core [--n=N] [--m=M] [--col_nnz=C] [--chunk_mb=S]
+ *                          [--repeats=R] [--file=PATH]
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE
+#endif
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef void (*product_fn)(void* data, const OSQPFloat* x, OSQPFloat* y);
+
+static void csc_mult(void* data, const OSQPFloat* x, OSQPFloat* y) {
+  const OSQPCscMatrix* A = (const OSQPCscMatrix*)data;
+  OSQPInt i, j, k;
+
+  for (i = 0; i < A->m; i++) y[i] = 0.0;
+  for (j = 0; j < A->n; j++)
+    for (k = A->p[j]; k < A->p[j+1]; k++) y[A->i[k]] += A->x[k] * x[j];
+}
+
+static void csc_mult_trans(void* data, const OSQPFloat* x, OSQPFloat* y) {
+  const OSQPCscMatrix* A = (const OSQPCscMatrix*)data;
+  OSQPInt   j, k;
+  OSQPFloat yj;
+
+  for (j = 0; j < A->n; j++) {
+    yj = 0.0;
+    for (k = A->p[j]; k < A->p[j+1]; k++) yj += A->x[k] * x[A->i[k]];
+    y[j] = yj;
+  }
+}
+
+/* Evict the file from the page cache, returns 0 if not supported */
+static int evict_file(const char* filename) {
+#ifdef POSIX_FADV_DONTNEED
+  int fd = open(filename, O_RDONLY);
+  int ok;
+
+  if (fd < 0) return 0;
+  ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+  close(fd);
+  return ok;
+#else
+  (void)filename;
+  return 0;
+#endif
+}
+
+static void run_product(const char*      name,
+                        product_fn       f,
+                        void*            data,
+                        const char*      evict,
+                        const OSQPFloat* x,
+                        OSQPFloat*       y,
+                        double           bytes,
+                        double*          samples,
+                        OSQPInt          repeats) {
+  OSQPInt r;
+  double  t;
+
+  // One untimed product to fault in the pages and the vectors
+  if (!evict) f(data, x, y);
+
+  for (r = 0; r < repeats; r++) {
+    if (evict && !evict_file(evict)) {
+      printf("%-22s page cache eviction not supported\n", name);
+      return;
+    }
+    t = bench_time();
+    f(data, x, y);
+    samples[r] = bench_time() - t;
+  }
+
+  // The fastest run has the highest bandwidth
+  printf("%-22s %12.3f %14.2f %14.2f %14.2f\n", name,
+         1e3 * bench_percentile(samples, repeats, 50),
+         1e-9 * bytes / bench_percentile(samples, repeats, 95),
+         1e-9 * bytes / bench_percentile(samples, repeats, 50),
+         1e-9 * bytes / bench_percentile(samples, repeats, 0));
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n        = 200000;
+  OSQPInt        m        = 300000;
+  OSQPFloat      col_nnz  = 50;
+  OSQPInt        chunk_mb = 64;
+  OSQPInt        repeats  = 10;
+  OSQPInt        i, len, exitflag;
+  const char*    filename = "bench_out_of_core.csc";
+  bench_problem* prob;
+  OSQPOperator   op;
+  OSQPFloat     *x, *y;
+  double*        samples;
+  double         bytes;
+
+  for (i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--file=", 7) == 0) {
+      filename = argv[i] + 7;
+    }
+    else if (!bench_arg_int(argv[i], "--n", &n) &&
+             !bench_arg_int(argv[i], "--m", &m) &&
+             !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+             !bench_arg_int(argv[i], "--chunk_mb", &chunk_mb) &&
+             !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_OUT_OF_CORE)) {
+    printf("OSQP was built without OSQP_ENABLE_OUT_OF_CORE\n");
+    return 1;
+  }
+
+  len     = n > m ? n : m;
+  prob    = bench_random_qp(n, m, col_nnz, 0, 1);
+  x       = malloc(len * sizeof(OSQPFloat));
+  y       = malloc(len * sizeof(OSQPFloat));
+  samples = malloc(repeats * sizeof(double));
+  if (!prob || !x || !y || !samples) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (i = 0; i < len; i++) x[i] = 1.0 / (1 + i % 7);
+
+  exitflag = osqp_csc_write_file(prob->A, filename);
+  if (!exitflag) exitflag = osqp_operator_map_file(&op, filename, chunk_mb * 1024 * 1024);
+  if (exitflag) {
+    printf("Could not write and map %s: %s\n", filename, osqp_error_message(exitflag));
+    return 1;
+  }
+
+  bytes = (double)(n + 1) * sizeof(OSQPInt) +
+          (double)prob->A->p[n] * (sizeof(OSQPInt) + sizeof(OSQPFloat));
+
+  printf("n = %lld, m = %lld, nnz(A) = %lld, %.1f MB streamed per product, %lld MB chunks, %lld repeats\n\n",
+         (long long)n, (long long)m, (long long)prob->A->p[n], 1e-6 * bytes,
+         (long long)chunk_mb, (long long)repeats);
+  printf("%-22s %12s %14s %14s %14s\n", "product", "p50 [ms]",
+         "p95 [GB/s]", "p50 [GB/s]", "max [GB/s]");
+
+  run_product("A*x   in memory",  csc_mult,       prob->A, NULL,     x, y, bytes, samples, repeats);
+  run_product("A'*y  in memory",  csc_mult_trans, prob->A, NULL,     x, y, bytes, samples, repeats);
+  run_product("A*x   mapped warm", op.mult,       op.data, NULL,     x, y, bytes, samples, repeats);
+  run_product("A'*y  mapped warm", op.mult_trans, op.data, NULL,     x, y, bytes, samples, repeats);
+  run_product("A*x   mapped cold", op.mult,       op.data, filename, x, y, bytes, samples, repeats);
+  run_product("A'*y  mapped cold", op.mult_trans, op.data, filename, x, y, bytes, samples, repeats);
+
+  osqp_operator_unmap_file(&op);
+  remove(filename);
+
+  bench_free_problem(prob);
+  free(x);
+  free(y);
+  free(samples);
+  return 0;
+}
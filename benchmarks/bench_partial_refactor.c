@@ -0,0 +1,130 @@
+/*
+ * Cost of osqp_update_data_mat when only a few entries of A change.
+ *
+ * Sets up a random QP without scaling, so the update indices reach the
+ * linear system solver, and times updates of k random entries of A against
+ * an update of all entries, which always refactors the whole KKT matrix.
+ * The partial refactorization only recomputes the rows of L on the
+ * elimination tree paths of the changed entries, so its cost depends on
+ * where they land in the fill-reducing ordering.
+ *
+ * Usage: bench_partial_refactor [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                               [--k=K] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 5000;
+  OSQPInt        m         = 7500;
+  OSQPFloat      col_nnz   = 4;
+  OSQPInt        bandwidth = 10;
+  OSQPInt        k         = 4;
+  OSQPInt        repeats   = 20;
+  OSQPInt        i, r, nnzA;
+  OSQPInt        exitflag;
+  unsigned int   state = 7;
+  double         t, t_full, t_partial;
+  double*        s_full;
+  double*        s_partial;
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     Ax_new;
+  OSQPFloat*     Ax_vals;
+  OSQPInt*       Ax_new_idx;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--k", &k) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  if (!prob) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  nnzA = prob->A->p[n];
+  if (k < 1)    k = 1;
+  if (k > nnzA) k = nnzA;
+
+  settings   = malloc(sizeof(OSQPSettings));
+  Ax_new     = malloc(nnzA * sizeof(OSQPFloat));
+  Ax_vals    = malloc(k * sizeof(OSQPFloat));
+  Ax_new_idx = malloc(k * sizeof(OSQPInt));
+  s_full     = malloc(repeats * sizeof(double));
+  s_partial  = malloc(repeats * sizeof(double));
+  if (!settings || !Ax_new || !Ax_vals || !Ax_new_idx || !s_full || !s_partial) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose = 0;
+  settings->scaling = 0;
+
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        prob->m, prob->n, settings);
+  if (exitflag) {
+    printf("Setup failed: %s\n", osqp_error_message(exitflag));
+    return 1;
+  }
+
+  for (i = 0; i < nnzA; i++) Ax_new[i] = prob->A->x[i];
+
+  for (r = 0; r < repeats; r++) {
+    // Perturb all entries and update them at once
+    for (i = 0; i < nnzA; i++) Ax_new[i] *= (r % 2) ? 0.9 : 1.0 / 0.9;
+    t = bench_time();
+    exitflag = osqp_update_data_mat(solver, NULL, NULL, 0, Ax_new, NULL, nnzA);
+    s_full[r] = bench_time() - t;
+
+    // Perturb k random entries
+    for (i = 0; i < k; i++) {
+      state = state * 1103515245u + 12345u;
+      Ax_new_idx[i] = (OSQPInt)((state >> 8) % (unsigned int)nnzA);
+      Ax_vals[i]    = Ax_new[Ax_new_idx[i]] * ((r % 2) ? 1.1 : 0.8);
+    }
+    t = bench_time();
+    exitflag |= osqp_update_data_mat(solver, NULL, NULL, 0, Ax_vals, Ax_new_idx, k);
+    s_partial[r] = bench_time() - t;
+
+    if (exitflag) {
+      printf("Update failed\n");
+      return 1;
+    }
+  }
+
+  t_full    = bench_percentile(s_full, repeats, 50);
+  t_partial = bench_percentile(s_partial, repeats, 50);
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, k = %lld\n\n",
+         (long long)n, (long long)m, (long long)prob->P->nzmax, (long long)nnzA, (long long)k);
+  printf("%-20s %14s\n", "update", "p50 [ms]");
+  printf("%-20s %14.3f\n", "all entries of A", 1e3 * t_full);
+  printf("%-20s %14.3f\n", "k entries of A", 1e3 * t_partial);
+  printf("\nspeedup %.2f\n", t_full / t_partial);
+
+  osqp_cleanup(solver);
+  bench_free_problem(prob);
+  free(settings);
+  free(Ax_new);
+  free(Ax_vals);
+  free(Ax_new_idx);
+  free(s_full);
+  free(s_partial);
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Polishing time with a reduced KKT system against polishing in place.
+ *
+ * Generates a random QP, solves it once without polishing and then repeats
+ * the same solve with each polishing mode: the default, which extracts the
+ * active rows of A and orders and factors a new reduced KKT system, and
+ * polish_in_place, which refactors the ADMM KKT matrix with the inactive rows
+ * decoupled. The polishing time is read from info->polish_time, so the
+ * library must be built with profiling. The distance between the polished
+ * solutions shows that both modes solve the same system.
+ *
+ * Usage: bench_polish [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                     [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_CASES 2
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 20000;
+  OSQPInt        m         = 30000;
+  OSQPFloat      col_nnz   = 2;
+  OSQPInt        bandwidth = 5;
+  OSQPInt        repeats   = 5;
+  OSQPInt        i, c, r;
+  OSQPInt        exitflag;
+  OSQPInt        status[N_CASES];
+  double         t, diff;
+  double         t_setup[N_CASES];
+  double*        s_polish[N_CASES];
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     x[N_CASES];
+
+  const char* names[N_CASES] = {"reduced", "in place"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  if (!prob || !settings) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (c = 0; c < N_CASES; c++) {
+    s_polish[c] = malloc(repeats * sizeof(double));
+    x[c]        = malloc(n * sizeof(OSQPFloat));
+    if (!s_polish[c] || !x[c]) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose       = 0;
+  settings->polishing     = 1;
+  settings->warm_starting = 0;
+  settings->eps_abs       = 1e-5;
+  settings->eps_rel       = 1e-5;
+
+  for (c = 0; c < N_CASES; c++) {
+    settings->polish_in_place = c;
+
+    t = bench_time();
+    exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                          prob->m, prob->n, settings);
+    t_setup[c] = bench_time() - t;
+    if (exitflag) {
+      printf("Setup with %s polishing failed: %s\n", names[c], osqp_error_message(exitflag));
+      return 1;
+    }
+
+    /* Every solve starts from zero and ends with the same polish */
+    for (r = 0; r < repeats; r++) {
+      osqp_solve(solver);
+      s_polish[c][r] = solver->info->polish_time;
+    }
+
+    status[c] = solver->info->status_polish;
+    memcpy(x[c], solver->solution->x, n * sizeof(OSQPFloat));
+    osqp_cleanup(solver);
+    solver = NULL;
+  }
+
+  diff = 0;
+  for (i = 0; i < n; i++) diff = fmax(diff, fabs(x[0][i] - x[1][i]));
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld\n\n",
+         (long long)n, (long long)m, (long long)prob->P->p[n], (long long)prob->A->p[n]);
+  printf("%-12s %14s %14s %14s\n", "polishing", "setup [ms]", "polish [ms]", "status");
+  for (c = 0; c < N_CASES; c++) {
+    t = bench_percentile(s_polish[c], repeats, 50);
+    printf("%-12s %14.3f %14.3f %14lld\n", names[c], 1e3 * t_setup[c], 1e3 * t,
+           (long long)status[c]);
+  }
+  printf("\nmax |x_reduced - x_in_place| = %.3g\n", diff);
+
+  bench_free_problem(prob);
+  free(settings);
+  for (c = 0; c < N_CASES; c++) {
+    free(s_polish[c]);
+    free(x[c]);
+  }
+  return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Effect of the internal ordering of the variables and constraints on the
+ * iteration cost.
+ *
+ * Generates a banded random QP, whose natural ordering keeps the nonzeros of
+ * P and A close to the diagonal, and shuffles its variables and constraints
+ * as user orderings often are. Then times a fixed number of ADMM iterations
+ * on the banded problem, on the shuffled problem, and on the shuffled problem
+ * with the reverse Cuthill-McKee reordering of the solver. The termination
+ * criteria are checked at every iteration but can not be met, so every
+ * iteration also computes the residuals with P x, A x and A' y. The direct
+ * solver applies its own fill-reducing ordering to the KKT matrix, so only
+ * the matrix-vector products and the vector operations see the ordering; the
+ * indirect solver (not available in the builtin algebra) is dominated by
+ * them.
+ *
+ * The cache misses themselves are best counted by running the benchmark
+ * under a profiler, e.g. perf stat -e cache-misses,LLC-load-misses.
+ *
+ * Usage: bench_reorder [--n=N] [--m=M] [--col_nnz=C] [--bandwidth=B]
+ *                      [--indirect=0|1] [--iter=K] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_CASES 3
+
+/* Random permutation and its inverse */
+static void random_perm(OSQPInt       n,
+                        OSQPInt*      perm,
+                        OSQPInt*      pinv,
+                        unsigned int* state) {
+  OSQPInt i, j, t;
+
+  for (i = 0; i < n; i++) perm[i] = i;
+  for (i = n - 1; i > 0; i--) {
+    *state = *state * 1103515245u + 12345u;
+    j = (OSQPInt)((*state >> 8) % (unsigned int)(i + 1));
+    t = perm[i]; perm[i] = perm[j]; perm[j] = t;
+  }
+  for (i = 0; i < n; i++) pinv[perm[i]] = i;
+}
+
+/* Entry (i, j) of M moves to (rinv[i], cinv[j]), mirrored above the diagonal with upper */
+static OSQPCscMatrix* permute(const OSQPCscMatrix* M,
+                              const OSQPInt*       rinv,
+                              const OSQPInt*       cinv,
+                              int                  upper) {
+  OSQPInt i, j, k, t, q;
+  OSQPInt nnz = M->p[M->n];
+
+  OSQPCscMatrix* C   = malloc(sizeof(OSQPCscMatrix));
+  OSQPInt*       Ci  = malloc(nnz * sizeof(OSQPInt));
+  OSQPInt*       Cp  = calloc(M->n + 1, sizeof(OSQPInt));
+  OSQPFloat*     Cx  = malloc(nnz * sizeof(OSQPFloat));
+  OSQPInt*       ri  = malloc(nnz * sizeof(OSQPInt));
+  OSQPInt*       rj  = malloc(nnz * sizeof(OSQPInt));
+  OSQPFloat*     rx  = malloc(nnz * sizeof(OSQPFloat));
+  OSQPInt*       cnt = calloc((M->m > M->n ? M->m : M->n) + 1, sizeof(OSQPInt));
+
+  if (!C || !Ci || !Cp || !Cx || !ri || !rj || !rx || !cnt) return NULL;
+
+  /* Sort the entries by row, then stably by column, so the rows of each column are sorted */
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      i = rinv[M->i[k]];
+      q = cinv[j];
+      cnt[(upper && i > q ? q : i) + 1]++;
+    }
+  }
+  for (i = 0; i < M->m; i++) cnt[i+1] += cnt[i];
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      i = rinv[M->i[k]];
+      q = cinv[j];
+      if (upper && i > q) { t = i; i = q; q = t; }
+      t = cnt[i]++;
+      ri[t] = i;
+      rj[t] = q;
+      rx[t] = M->x[k];
+    }
+  }
+  for (t = 0; t < nnz; t++) Cp[rj[t]+1]++;
+  for (j = 0; j < M->n; j++) Cp[j+1] += Cp[j];
+  memcpy(cnt, Cp, M->n * sizeof(OSQPInt));
+  for (t = 0; t < nnz; t++) {
+    k = cnt[rj[t]]++;
+    Ci[k] = ri[t];
+    Cx[k] = rx[t];
+  }
+
+  csc_set_data(C, M->m, M->n, nnz, Cx, Ci, Cp);
+  free(ri);
+  free(rj);
+  free(rx);
+  free(cnt);
+  return C;
+}
+
+static void free_csc(OSQPCscMatrix* M) {
+  free(M->x);
+  free(M->i);
+  free(M->p);
+  free(M);
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n         = 200000;
+  OSQPInt        m         = 300000;
+  OSQPFloat      col_nnz   = 3;
+  OSQPInt        bandwidth = 5;
+  OSQPInt        indirect  = 0;
+  OSQPInt        iter      = 50;
+  OSQPInt        repeats   = 3;
+  OSQPInt        i, c, r;
+  OSQPInt        exitflag;
+  OSQPInt        iters[N_CASES];
+  unsigned int   state = 11;
+  double         t, diff;
+  double*        s_setup[N_CASES];
+  double*        s_solve[N_CASES];
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPInt*       xperm;
+  OSQPInt*       xinv;
+  OSQPInt*       yperm;
+  OSQPInt*       yinv;
+  OSQPCscMatrix* Ps;
+  OSQPCscMatrix* As;
+  OSQPFloat*     qs;
+  OSQPFloat*     ls;
+  OSQPFloat*     us;
+  OSQPFloat*     x[N_CASES];
+
+  const char* names[N_CASES] = {"banded", "shuffled", "shuffled + rcm"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--bandwidth", &bandwidth) &&
+        !bench_arg_int(argv[i], "--indirect", &indirect) &&
+        !bench_arg_int(argv[i], "--iter", &iter) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  prob     = bench_random_qp(n, m, col_nnz, bandwidth, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  xperm    = malloc(n * sizeof(OSQPInt));
+  xinv     = malloc(n * sizeof(OSQPInt));
+  yperm    = malloc(m * sizeof(OSQPInt));
+  yinv     = malloc(m * sizeof(OSQPInt));
+  qs       = malloc(n * sizeof(OSQPFloat));
+  ls       = malloc(m * sizeof(OSQPFloat));
+  us       = malloc(m * sizeof(OSQPFloat));
+  if (!prob || !settings || !xperm || !xinv || !yperm || !yinv || !qs || !ls || !us) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (c = 0; c < N_CASES; c++) {
+    s_setup[c] = malloc(repeats * sizeof(double));
+    s_solve[c] = malloc(repeats * sizeof(double));
+    x[c]       = malloc(n * sizeof(OSQPFloat));
+    if (!s_setup[c] || !s_solve[c] || !x[c]) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+  }
+
+  /* Shuffled copy of the problem */
+  random_perm(n, xperm, xinv, &state);
+  random_perm(m, yperm, yinv, &state);
+  Ps = permute(prob->P, xinv, xinv, 1);
+  As = permute(prob->A, yinv, xinv, 0);
+  if (!Ps || !As) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++) qs[i] = prob->q[xperm[i]];
+  for (i = 0; i < m; i++) {
+    ls[i] = prob->l[yperm[i]];
+    us[i] = prob->u[yperm[i]];
+  }
+
+  /* Run a fixed number of iterations */
+  osqp_set_default_settings(settings);
+  settings->verbose           = 0;
+  settings->polishing         = 0;
+  settings->adaptive_rho      = 0;
+  settings->check_termination = 1;
+  settings->eps_abs           = 1e-14;
+  settings->eps_rel           = 0;
+  settings->max_iter          = iter;
+  settings->linsys_solver     = indirect ? OSQP_INDIRECT_SOLVER : OSQP_DIRECT_SOLVER;
+
+  for (c = 0; c < N_CASES; c++) {
+    settings->reorder = (c == 2) ? OSQP_RCM_REORDER : OSQP_NO_REORDER;
+
+    for (r = 0; r < repeats; r++) {
+      t = bench_time();
+      if (c == 0) {
+        exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                              prob->m, prob->n, settings);
+      }
+      else {
+        exitflag = osqp_setup(&solver, Ps, qs, As, ls, us, m, n, settings);
+      }
+      s_setup[c][r] = bench_time() - t;
+      if (exitflag) {
+        printf("Setup of the %s problem failed: %s\n", names[c], osqp_error_message(exitflag));
+        return 1;
+      }
+
+      t = bench_time();
+      osqp_solve(solver);
+      s_solve[c][r] = bench_time() - t;
+
+      iters[c] = solver->info->iter;
+      memcpy(x[c], solver->solution->x, n * sizeof(OSQPFloat));
+      osqp_cleanup(solver);
+      solver = NULL;
+    }
+  }
+
+  /* Bring the solutions of the shuffled problem back to the banded ordering */
+  diff = 0;
+  for (i = 0; i < n; i++) {
+    diff = fmax(diff, fabs(x[0][xperm[i]] - x[1][i]));
+    diff = fmax(diff, fabs(x[0][xperm[i]] - x[2][i]));
+  }
+
+  printf("n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, solver = %s\n\n",
+         (long long)n, (long long)m, (long long)prob->P->p[n], (long long)prob->A->p[n],
+         indirect ? "indirect" : "direct");
+  printf("%-16s %14s %14s %16s %8s\n", "ordering", "setup [ms]", "solve [ms]",
+         "per iter [us]", "iter");
+  for (c = 0; c < N_CASES; c++) {
+    t = bench_percentile(s_solve[c], repeats, 50);
+    printf("%-16s %14.3f %14.3f %16.3f %8lld\n", names[c],
+           1e3 * bench_percentile(s_setup[c], repeats, 50), 1e3 * t,
+           1e6 * t / iters[c], (long long)iters[c]);
+  }
+  printf("\nmax |x_banded - x| = %.3g\n", diff);
+
+  bench_free_problem(prob);
+  free_csc(Ps);
+  free_csc(As);
+  free(settings);
+  free(xperm);
+  free(xinv);
+  free(yperm);
+  free(yinv);
+  free(qs);
+  free(ls);
+  free(us);
+  for (c = 0; c < N_CASES; c++) {
+    free(s_setup[c]);
+    free(s_solve[c]);
+    free(x[c]);
+  }
+  return 0;
+}
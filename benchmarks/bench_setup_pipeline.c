@@ -0,0 +1,106 @@
+/*
+ * Setup time with the stages that only read the sparsity patterns on helper
+ * threads (setup_threads).
+ *
+ * Sets up random QPs of growing size with setup_threads = 1, ..., T and
+ * reports the median time of osqp_setup and its ratio to the sequential
+ * setup. With more than one thread the ordering, elimination tree and column
+ * counts of the KKT matrix, and the compressed row indices, are computed
+ * while the data is scaled; the numeric factorization waits for both.
+ *
+ * The stages only overlap on a machine with cores to spare; on a single core
+ * the numbers show the cost of the threads and of the separate analysis.
+ *
+ * Usage: bench_setup_pipeline [--n=N] [--col_nnz=K] [--threads=T] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static double time_setup(bench_problem* prob,
+                         OSQPSettings*  settings,
+                         OSQPInt        repeats,
+                         double*        samples) {
+
+  OSQPInt     r;
+  double      t;
+  OSQPSolver* solver;
+
+  for (r = 0; r < repeats; r++) {
+    solver = NULL;
+    t = bench_time();
+    if (osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                   prob->m, prob->n, settings)) {
+      printf("Setup failed\n");
+      exit(1);
+    }
+    samples[r] = bench_time() - t;
+    osqp_cleanup(solver);
+  }
+
+  return bench_percentile(samples, repeats, 50);
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        n       = 100000;
+  OSQPFloat      col_nnz = 4.0;
+  OSQPInt        threads = 4;
+  OSQPInt        repeats = 5;
+  OSQPInt        i, k, t;
+  double         t_seq, t_par;
+  double*        samples;
+  bench_problem* prob;
+  OSQPSettings*  settings;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--threads", &threads) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+  if (threads < 1) threads = 1;
+
+  settings = malloc(sizeof(OSQPSettings));
+  samples  = malloc(repeats * sizeof(double));
+  if (!settings || !samples) {
+    printf("Out of memory\n");
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose          = 0;
+  settings->compress_indices = 1;
+
+  printf("%-10s %-10s %-8s %14s %10s\n", "n", "m", "threads", "setup [ms]", "speedup");
+
+  for (k = n / 4; k <= n; k *= 2) {
+    prob = bench_random_qp(k, k / 2, col_nnz, 20, 1);
+    if (!prob) {
+      printf("Out of memory generating the problem\n");
+      return 1;
+    }
+
+    t_seq = 0;
+    for (t = 1; t <= threads; t++) {
+      settings->setup_threads = t;
+      t_par = time_setup(prob, settings, repeats, samples);
+      if (t == 1) t_seq = t_par;
+      printf("%-10lld %-10lld %-8lld %14.2f %10.2f\n", (long long)k, (long long)(k / 2),
+             (long long)t, 1e3 * t_par, t_seq / t_par);
+    }
+
+    bench_free_problem(prob);
+  }
+
+  free(settings);
+  free(samples);
+  return 0;
+}
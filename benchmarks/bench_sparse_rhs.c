@@ -0,0 +1,136 @@
+/*
+ * Adjoint derivative time with a gradient of one output against a dense one.
+ *
+ * Generates a QP made of independent groups of variables, each with a dense
+ * block of P, an equality sum(x_g) = 1 and bounds on the variables, so the
+ * adjoint system splits into one block per group. After solving it once in
+ * real-time mode (realtime = 2, which keeps the adjoint solver from setup), it
+ * times osqp_adjoint_derivative_compute with dx = e_i for a few outputs i and
+ * with a dense dx. The one-hot right-hand sides are solved by reach, touching
+ * only the rows of one group; the dense ones sweep the whole factor. Both
+ * include the numeric factorization of the adjoint system, which is the same.
+ *
+ * Usage: bench_sparse_rhs [--groups=G] [--group_size=S] [--repeats=R]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+
+  OSQPInt        ng      = 2000;
+  OSQPInt        gs      = 8;
+  OSQPInt        repeats = 20;
+  OSQPInt        i, j, k, r;
+  OSQPInt        n, m;
+  OSQPInt        exitflag;
+  double         t, t_sparse, t_dense;
+  double*        samples;
+  bench_problem* prob;
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     dx;
+  OSQPFloat*     dy;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--groups", &ng) &&
+        !bench_arg_int(argv[i], "--group_size", &gs) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  n        = ng * gs;
+  m        = ng + n;
+  prob     = bench_problem_new(n, m, ng * gs * (gs + 1) / 2, 2 * n);
+  settings = malloc(sizeof(OSQPSettings));
+  samples  = malloc(repeats * sizeof(double));
+  dx       = malloc(n * sizeof(OSQPFloat));
+  dy       = calloc(m, sizeof(OSQPFloat));
+  if (!prob || !settings || !samples || !dx || !dy) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+
+  k = 0;
+  for (j = 0; j < n; j++) {
+    prob->P->p[j] = k;
+    for (i = j - j % gs; i <= j; i++) {
+      prob->P->i[k]   = i;
+      prob->P->x[k++] = (i == j) ? 4.0 : 0.5;
+    }
+    prob->A->p[j]         = 2 * j;
+    prob->A->i[2 * j]     = j / gs;
+    prob->A->x[2 * j]     = 1.0;
+    prob->A->i[2 * j + 1] = ng + j;
+    prob->A->x[2 * j + 1] = 1.0;
+    prob->q[j]            = -1.0 + 0.5 * (j % gs) / gs + 0.01 * (j % 7);
+  }
+  prob->P->p[n]  = k;
+  prob->P->nzmax = k;
+  prob->A->p[n]  = 2 * n;
+  prob->A->nzmax = 2 * n;
+  for (i = 0; i < ng; i++) {
+    prob->l[i] = 1.0;
+    prob->u[i] = 1.0;
+  }
+  for (i = ng; i < m; i++) {
+    prob->l[i] = 0.0;
+    prob->u[i] = 0.6;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose  = 0;
+  settings->realtime = 2;
+
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        m, n, settings);
+  if (exitflag) {
+    printf("Setup failed: %s\n", osqp_error_message(exitflag));
+    return 1;
+  }
+  osqp_solve(solver);
+
+  // Gradients of single outputs spread over the groups
+  for (r = 0; r < repeats; r++) {
+    for (j = 0; j < n; j++) dx[j] = 0.0;
+    dx[(r * 7919) % n] = 1.0;
+
+    t = bench_time();
+    exitflag = osqp_adjoint_derivative_compute(solver, dx, dy, dy);
+    samples[r] = bench_time() - t;
+    if (exitflag) {
+      printf("Derivative failed: %s\n", osqp_error_message(exitflag));
+      return 1;
+    }
+  }
+  t_sparse = bench_percentile(samples, repeats, 50);
+
+  for (j = 0; j < n; j++) dx[j] = 1.0 + 0.1 * (j % 3);
+  for (r = 0; r < repeats; r++) {
+    t = bench_time();
+    osqp_adjoint_derivative_compute(solver, dx, dy, dy);
+    samples[r] = bench_time() - t;
+  }
+  t_dense = bench_percentile(samples, repeats, 50);
+
+  printf("n = %lld, m = %lld, groups of %lld variables, status %s\n\n",
+         (long long)n, (long long)m, (long long)gs, solver->info->status);
+  printf("%-12s %16s\n", "gradient", "derivative [ms]");
+  printf("%-12s %16.3f\n", "one output", 1e3 * t_sparse);
+  printf("%-12s %16.3f\n", "dense", 1e3 * t_dense);
+  printf("\nspeedup = %.2f\n", t_dense / t_sparse);
+
+  osqp_cleanup(solver);
+  bench_free_problem(prob);
+  free(settings);
+  free(samples);
+  free(dx);
+  free(dy);
+  return 0;
+}
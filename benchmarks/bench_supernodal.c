@@ -0,0 +1,278 @@
+/*
+ * Factorization and solve times of the supernodal LDL kernels against QDLDL.
+ *
+ * Builds one problem of each class and sets it up twice with the direct
+ * solver, with supernodal = 0 (QDLDL one column at a time) and supernodal = 1
+ * (dense kernels on the supernodes of the factor):
+ *
+ *  - mpc:    MPC with dense dynamics x_{k+1} = Ad x_k + Bd u_k over a long
+ *            horizon, with bounds on all variables
+ *  - dense:  dense P (as in a portfolio with a full covariance), box
+ *            constraints and a budget row
+ *  - sparse: random sparse QP (bench_random_qp) without a band, so the factor
+ *            fills in
+ *
+ * For each class it reports the setup time, the median time of a rho update
+ * (a full numeric refactorization) and the median time per iteration of a
+ * solve with a fixed number of iterations (one KKT solve each). With
+ * --verbose=1 the setup header shows whether the supernodes were large
+ * enough for the dense kernels; otherwise both runs use QDLDL.
+ *
+ * Usage: bench_supernodal [--nx=NX] [--nu=NU] [--horizon=N] [--dense_n=N]
+ *                         [--n=N] [--m=M] [--col_nnz=C] [--iter=K]
+ *                         [--repeats=R] [--verbose=V]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_CLASSES 3
+
+static double bench_noise(unsigned int* state) {
+  *state = *state * 1103515245u + 12345u;
+  return 2.0 * (double)(*state >> 8) / (double)(1u << 24) - 1.0;
+}
+
+/*
+ * Variables z = (x_0, ..., x_N, u_0, ..., u_{N-1}), constraints x_0 = x_init,
+ * x_{k+1} = Ad x_k + Bd u_k and bounds on all variables.
+ */
+static bench_problem* mpc_problem(OSQPInt nx,
+                                  OSQPInt nu,
+                                  OSQPInt N) {
+  OSQPInt        j, k, r, s, nnz;
+  OSQPInt        n     = (N + 1) * nx + N * nu;
+  OSQPInt        neq   = (N + 1) * nx;
+  unsigned int   state = 11;
+  OSQPFloat*     Ad    = malloc(nx * nx * sizeof(OSQPFloat));
+  OSQPFloat*     Bd    = malloc(nx * nu * sizeof(OSQPFloat));
+  bench_problem* prob  = bench_problem_new(n, neq + n, n, (N + 1) * nx * (nx + 2) + N * nu * (nx + 1));
+
+  if (!Ad || !Bd || !prob) {
+    free(Ad);
+    free(Bd);
+    bench_free_problem(prob);
+    return NULL;
+  }
+
+  // Stable dynamics with every state coupled to every other one
+  for (r = 0; r < nx; r++) {
+    for (s = 0; s < nx; s++) Ad[r * nx + s] = (r == s ? 0.9 : 0.0) + 0.1 * bench_noise(&state) / nx;
+    for (s = 0; s < nu; s++) Bd[r * nu + s] = 0.1 * bench_noise(&state);
+  }
+
+  for (j = 0; j < n; j++) {
+    prob->P->p[j] = j;
+    prob->P->i[j] = j;
+    prob->P->x[j] = j < neq ? 1.0 : 0.1;
+    prob->q[j]    = j < neq ? 0.5 * bench_noise(&state) : 0.0;
+  }
+  prob->P->p[n]  = n;
+  prob->P->nzmax = n;
+
+  nnz = 0;
+  for (k = 0; k <= N; k++) {
+    for (s = 0; s < nx; s++) {
+      prob->A->i[nnz]   = k * nx + s;
+      prob->A->x[nnz++] = -1;
+      for (r = 0; r < nx && k < N; r++) {
+        prob->A->i[nnz]   = (k + 1) * nx + r;
+        prob->A->x[nnz++] = Ad[r * nx + s];
+      }
+      prob->A->i[nnz]   = neq + k * nx + s;
+      prob->A->x[nnz++] = 1;
+      prob->A->p[k * nx + s + 1] = nnz;
+    }
+  }
+  for (k = 0; k < N; k++) {
+    for (s = 0; s < nu; s++) {
+      j = neq + k * nu + s;
+      for (r = 0; r < nx; r++) {
+        prob->A->i[nnz]   = (k + 1) * nx + r;
+        prob->A->x[nnz++] = Bd[r * nu + s];
+      }
+      prob->A->i[nnz]   = neq + j;
+      prob->A->x[nnz++] = 1;
+      prob->A->p[j + 1] = nnz;
+    }
+  }
+  prob->A->nzmax = nnz;
+
+  for (s = 0; s < neq; s++) {
+    prob->l[s] = s < nx ? bench_noise(&state) : 0.0;
+    prob->u[s] = prob->l[s];
+  }
+  for (j = 0; j < n; j++) {
+    prob->l[neq + j] = -2.0;
+    prob->u[neq + j] = 2.0;
+  }
+
+  free(Ad);
+  free(Bd);
+  return prob;
+}
+
+/* Dense diagonally dominant P, box constraints and sum(x) <= 1 */
+static bench_problem* dense_problem(OSQPInt n) {
+  OSQPInt        i, j, nnz;
+  unsigned int   state = 13;
+  bench_problem* prob  = bench_problem_new(n, n + 1, n * (n + 1) / 2, 2 * n);
+
+  if (!prob) return NULL;
+
+  nnz = 0;
+  for (j = 0; j < n; j++) {
+    prob->P->p[j] = nnz;
+    for (i = 0; i <= j; i++) {
+      prob->P->i[nnz]   = i;
+      prob->P->x[nnz++] = i == j ? 0.5 * n + 1.0 : 0.5 * bench_noise(&state);
+    }
+    prob->q[j] = bench_noise(&state);
+  }
+  prob->P->p[n]  = nnz;
+  prob->P->nzmax = nnz;
+
+  for (j = 0; j < n; j++) {
+    prob->A->p[j]         = 2 * j;
+    prob->A->i[2 * j]     = j;
+    prob->A->x[2 * j]     = 1.0;
+    prob->A->i[2 * j + 1] = n;
+    prob->A->x[2 * j + 1] = 1.0;
+    prob->l[j]            = 0.0;
+    prob->u[j]            = 0.2;
+  }
+  prob->A->p[n]  = 2 * n;
+  prob->A->nzmax = 2 * n;
+  prob->l[n]     = -OSQP_INFTY;
+  prob->u[n]     = 1.0;
+
+  return prob;
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        nx        = 24;
+  OSQPInt        nu        = 12;
+  OSQPInt        horizon   = 100;
+  OSQPInt        dense_n   = 600;
+  OSQPInt        n         = 3000;
+  OSQPInt        m         = 3000;
+  OSQPFloat      col_nnz   = 2;
+  OSQPInt        iter      = 50;
+  OSQPInt        repeats   = 5;
+  OSQPInt        verbose   = 0;
+  OSQPInt        i, c, k, r;
+  OSQPInt        exitflag;
+  double         t, diff;
+  double         t_setup[2], t_factor[2], t_iter[2];
+  double*        samples;
+  bench_problem* probs[N_CLASSES];
+  OSQPSolver*    solver = NULL;
+  OSQPSettings*  settings;
+  OSQPFloat*     x[2];
+
+  const char* names[N_CLASSES] = {"mpc", "dense", "sparse"};
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--nx", &nx) &&
+        !bench_arg_int(argv[i], "--nu", &nu) &&
+        !bench_arg_int(argv[i], "--horizon", &horizon) &&
+        !bench_arg_int(argv[i], "--dense_n", &dense_n) &&
+        !bench_arg_int(argv[i], "--n", &n) &&
+        !bench_arg_int(argv[i], "--m", &m) &&
+        !bench_arg_float(argv[i], "--col_nnz", &col_nnz) &&
+        !bench_arg_int(argv[i], "--iter", &iter) &&
+        !bench_arg_int(argv[i], "--repeats", &repeats) &&
+        !bench_arg_int(argv[i], "--verbose", &verbose)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (repeats < 1) repeats = 1;
+
+  probs[0] = mpc_problem(nx, nu, horizon);
+  probs[1] = dense_problem(dense_n);
+  probs[2] = bench_random_qp(n, m, col_nnz, 0, 1);
+  settings = malloc(sizeof(OSQPSettings));
+  samples  = malloc(repeats * sizeof(double));
+  if (!probs[0] || !probs[1] || !probs[2] || !settings || !samples) {
+    printf("Out of memory generating the problems\n");
+    return 1;
+  }
+
+  // A fixed number of iterations, so both runs do the same number of solves
+  osqp_set_default_settings(settings);
+  settings->verbose           = verbose;
+  settings->polishing         = 0;
+  settings->warm_starting     = 0;
+  settings->adaptive_rho      = 0;
+  settings->check_termination = 0;
+  settings->max_iter          = iter;
+  settings->linsys_solver     = OSQP_DIRECT_SOLVER;
+
+  printf("%-8s %8s %8s %14s %14s %14s %10s %10s %10s %10s\n", "class", "n", "m",
+         "kernels", "setup [ms]", "factor [ms]", "iter [us]", "x diff", "x factor", "x iter");
+
+  for (c = 0; c < N_CLASSES; c++) {
+    for (k = 0; k < 2; k++) {
+      x[k] = malloc(probs[c]->n * sizeof(OSQPFloat));
+      if (!x[k]) {
+        printf("Out of memory generating the problems\n");
+        return 1;
+      }
+
+      settings->supernodal = k;
+
+      t = bench_time();
+      exitflag = osqp_setup(&solver, probs[c]->P, probs[c]->q, probs[c]->A, probs[c]->l,
+                            probs[c]->u, probs[c]->m, probs[c]->n, settings);
+      t_setup[k] = bench_time() - t;
+      if (exitflag) {
+        printf("Setup of the %s problem failed: %s\n", names[c], osqp_error_message(exitflag));
+        return 1;
+      }
+
+      // Every rho update refactors the whole KKT matrix
+      for (r = 0; r < repeats; r++) {
+        t = bench_time();
+        osqp_update_rho(solver, r % 2 ? 0.1 : 0.2);
+        samples[r] = bench_time() - t;
+      }
+      t_factor[k] = bench_percentile(samples, repeats, 50);
+
+      for (r = 0; r < repeats; r++) {
+        t = bench_time();
+        osqp_solve(solver);
+        samples[r] = (bench_time() - t) / solver->info->iter;
+      }
+      t_iter[k] = bench_percentile(samples, repeats, 50);
+
+      memcpy(x[k], solver->solution->x, probs[c]->n * sizeof(OSQPFloat));
+      osqp_cleanup(solver);
+      solver = NULL;
+    }
+
+    diff = 0;
+    for (i = 0; i < probs[c]->n; i++) diff = fmax(diff, fabs(x[0][i] - x[1][i]));
+
+    for (k = 0; k < 2; k++) {
+      printf("%-8s %8lld %8lld %14s %14.3f %14.3f %10.2f", names[c], (long long)probs[c]->n,
+             (long long)probs[c]->m, k ? "supernodal" : "qdldl", 1e3 * t_setup[k],
+             1e3 * t_factor[k], 1e6 * t_iter[k]);
+      if (k) printf(" %10.2g %10.2f %10.2f\n", diff, t_factor[0] / t_factor[1], t_iter[0] / t_iter[1]);
+      else   printf("\n");
+    }
+    free(x[0]);
+    free(x[1]);
+  }
+
+  for (c = 0; c < N_CLASSES; c++) bench_free_problem(probs[c]);
+  free(settings);
+  free(samples);
+  return 0;
+}
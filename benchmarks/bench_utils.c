@@ -0,0 +1,241 @@
+#include "bench_utils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+
+#define c_max_int(a, b) (((a) > (b)) ? (a) : (b))
+#define c_min_int(a, b) (((a) < (b)) ? (a) : (b))
+
+/* xorshift32, so problems are identical across platforms */
+static unsigned int bench_rand(unsigned int* state) {
+  unsigned int x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static OSQPFloat bench_uniform(unsigned int* state) {
+  return (OSQPFloat)(bench_rand(state) & 0xFFFFFF) / (OSQPFloat)0x1000000;
+}
+
+static int bench_cmp_int(const void* a,
+                         const void* b) {
+  OSQPInt ia = *(const OSQPInt*)a;
+  OSQPInt ib = *(const OSQPInt*)b;
+  return (ia > ib) - (ia < ib);
+}
+
+/* Draw about col_nnz distinct sorted row indices in [lo, hi), at most maxnum */
+static OSQPInt bench_draw_rows(OSQPInt*      idx,
+                               OSQPInt       lo,
+                               OSQPInt       hi,
+                               OSQPFloat     col_nnz,
+                               OSQPInt       maxnum,
+                               unsigned int* state) {
+  OSQPInt i, k, num;
+
+  if (hi <= lo || maxnum <= 0) return 0;
+
+  // Randomized rounding keeps the expected count for fractional col_nnz
+  num = (OSQPInt)col_nnz;
+  if (bench_uniform(state) < col_nnz - num) num++;
+  if (num > hi - lo) num = hi - lo;
+  if (num > maxnum)  num = maxnum;
+
+  for (i = 0; i < num; i++) idx[i] = lo + (OSQPInt)(bench_rand(state) % (unsigned int)(hi - lo));
+  qsort(idx, num, sizeof(OSQPInt), bench_cmp_int);
+
+  // Drop duplicates
+  for (i = 0, k = 0; i < num; i++) {
+    if (k == 0 || idx[i] != idx[k - 1]) idx[k++] = idx[i];
+  }
+  return k;
+}
+
+static OSQPCscMatrix* bench_csc_alloc(OSQPInt m,
+                                      OSQPInt n,
+                                      OSQPInt nzmax) {
+  OSQPCscMatrix* M = malloc(sizeof(OSQPCscMatrix));
+  OSQPFloat*     x = malloc((nzmax > 0 ? nzmax : 1) * sizeof(OSQPFloat));
+  OSQPInt*       i = malloc((nzmax > 0 ? nzmax : 1) * sizeof(OSQPInt));
+  OSQPInt*       p = calloc(n + 1, sizeof(OSQPInt));
+
+  if (!M || !x || !i || !p) {
+    free(M); free(x); free(i); free(p);
+    return NULL;
+  }
+  csc_set_data(M, m, n, nzmax, x, i, p);
+  return M;
+}
+
+static void bench_csc_free(OSQPCscMatrix* M) {
+  if (!M) return;
+  free(M->x);
+  free(M->i);
+  free(M->p);
+  free(M);
+}
+
+bench_problem* bench_random_qp(OSQPInt      n,
+                               OSQPInt      m,
+                               OSQPFloat    col_nnz,
+                               OSQPInt      bandwidth,
+                               unsigned int seed) {
+
+  OSQPInt       i, j, k, c, nnz, P_nnz, A_nnz;
+  OSQPFloat*    diag;
+  unsigned int  state = seed ? seed : 1;
+  bench_problem* prob;
+
+  // Upper bounds on the number of nonzeros
+  P_nnz = (OSQPInt)((col_nnz + 1) * n) + n;
+  A_nnz = (OSQPInt)((col_nnz + 1) * n);
+
+  prob = bench_problem_new(n, m, P_nnz, A_nnz);
+  diag = calloc(n, sizeof(OSQPFloat));
+  if (!prob || !diag) {
+    free(diag);
+    bench_free_problem(prob);
+    return NULL;
+  }
+
+  // P: random strictly upper part plus a dominant diagonal
+  nnz = 0;
+  for (j = 0; j < n; j++) {
+    c = bandwidth > 0 ? c_max_int(0, j - bandwidth) : 0;
+    k = bench_draw_rows(prob->P->i + nnz, c, j, col_nnz, P_nnz - nnz - (n - j), &state);
+    for (i = nnz; i < nnz + k; i++) {
+      prob->P->x[i] = 2 * bench_uniform(&state) - 1;
+      diag[prob->P->i[i]] += prob->P->x[i] < 0 ? -prob->P->x[i] : prob->P->x[i];
+      diag[j]             += prob->P->x[i] < 0 ? -prob->P->x[i] : prob->P->x[i];
+    }
+    nnz += k;
+    prob->P->i[nnz] = j;
+    prob->P->x[nnz] = 0; // filled in below
+    nnz++;
+    prob->P->p[j + 1] = nnz;
+  }
+  for (j = 0; j < n; j++) prob->P->x[prob->P->p[j + 1] - 1] = diag[j] + 1;
+  prob->P->nzmax = nnz;
+
+  // A: random sparse columns
+  nnz = 0;
+  for (j = 0; j < n; j++) {
+    c = (OSQPInt)((double)j * m / n);
+    if (bandwidth > 0) {
+      k = bench_draw_rows(prob->A->i + nnz, c_max_int(0, c - bandwidth),
+                          c_min_int(m, c + bandwidth + 1), col_nnz, A_nnz - nnz, &state);
+    } else {
+      k = bench_draw_rows(prob->A->i + nnz, 0, m, col_nnz, A_nnz - nnz, &state);
+    }
+    for (i = nnz; i < nnz + k; i++) prob->A->x[i] = 2 * bench_uniform(&state) - 1;
+    nnz += k;
+    prob->A->p[j + 1] = nnz;
+  }
+  prob->A->nzmax = nnz;
+
+  // Bounds around zero keep the problem feasible
+  for (j = 0; j < n; j++) prob->q[j] = 2 * bench_uniform(&state) - 1;
+  for (i = 0; i < m; i++) {
+    prob->l[i] = -1 - bench_uniform(&state);
+    prob->u[i] =  1 + bench_uniform(&state);
+  }
+
+  free(diag);
+  return prob;
+}
+
+bench_problem* bench_problem_new(OSQPInt n,
+                                 OSQPInt m,
+                                 OSQPInt P_nnz,
+                                 OSQPInt A_nnz) {
+  bench_problem* prob = calloc(1, sizeof(bench_problem));
+
+  if (!prob) return NULL;
+  prob->n = n;
+  prob->m = m;
+
+  prob->P = bench_csc_alloc(n, n, P_nnz);
+  prob->A = bench_csc_alloc(m, n, A_nnz);
+  prob->q = malloc((n > 0 ? n : 1) * sizeof(OSQPFloat));
+  prob->l = malloc((m > 0 ? m : 1) * sizeof(OSQPFloat));
+  prob->u = malloc((m > 0 ? m : 1) * sizeof(OSQPFloat));
+  if (!prob->P || !prob->A || !prob->q || !prob->l || !prob->u) {
+    bench_free_problem(prob);
+    return NULL;
+  }
+  return prob;
+}
+
+void bench_free_problem(bench_problem* prob) {
+  if (!prob) return;
+  bench_csc_free(prob->P);
+  bench_csc_free(prob->A);
+  free(prob->q);
+  free(prob->l);
+  free(prob->u);
+  free(prob);
+}
+
+double bench_time(void) {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+static int bench_cmp_double(const void* a,
+                            const void* b) {
+  double da = *(const double*)a;
+  double db = *(const double*)b;
+  return (da > db) - (da < db);
+}
+
+double bench_percentile(double* samples,
+                        OSQPInt num,
+                        double  pct) {
+  OSQPInt rank;
+
+  if (num <= 0) return 0.0;
+  qsort(samples, num, sizeof(double), bench_cmp_double);
+
+  rank = (OSQPInt)(pct / 100.0 * num + 0.999999);
+  if (rank < 1)   rank = 1;
+  if (rank > num) rank = num;
+  return samples[rank - 1];
+}
+
+int bench_arg_int(const char* arg,
+                  const char* name,
+                  OSQPInt*    value) {
+  size_t len = strlen(name);
+
+  if (strncmp(arg, name, len) || arg[len] != '=') return 0;
+  *value = (OSQPInt)atol(arg + len + 1);
+  return 1;
+}
+
+int bench_arg_float(const char* arg,
+                    const char* name,
+                    OSQPFloat*  value) {
+  size_t len = strlen(name);
+
+  if (strncmp(arg, name, len) || arg[len] != '=') return 0;
+  *value = (OSQPFloat)atof(arg + len + 1);
+  return 1;
+}
@@ -0,0 +1,93 @@
+#ifndef BENCH_UTILS_H_
+#define BENCH_UTILS_H_
+
+/*
+ * Helpers shared by the OSQP benchmark programs.
+ */
+
+#include "osqp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Randomly generated QP in the form expected by osqp_setup */
+typedef struct {
+  OSQPInt        n;
+  OSQPInt        m;
+  OSQPCscMatrix* P; ///< upper triangular, diagonally dominant (hence positive definite)
+  OSQPCscMatrix* A;
+  OSQPFloat*     q;
+  OSQPFloat*     l;
+  OSQPFloat*     u;
+} bench_problem;
+
+/**
+ * Generate a random feasible QP.
+ * @param  n          Number of variables
+ * @param  m          Number of constraints
+ * @param  col_nnz    Average number of nonzeros per column of A and of the strict upper part of P
+ * @param  bandwidth  Maximum distance of a nonzero from the (scaled) diagonal, or 0 for none;
+ *                    a small bandwidth keeps the fill-in of the KKT factor low
+ * @param  seed       Seed of the pseudo-random generator (same seed, same problem)
+ * @return            Problem, or NULL if out of memory
+ */
+bench_problem* bench_random_qp(OSQPInt      n,
+                               OSQPInt      m,
+                               OSQPFloat    col_nnz,
+                               OSQPInt      bandwidth,
+                               unsigned int seed);
+
+/**
+ * Allocate a problem with empty matrices, for benchmarks that build their own.
+ * The column pointers are zeroed; the indices, values and vectors are not set.
+ * @param  n      Number of variables
+ * @param  m      Number of constraints
+ * @param  P_nnz  Capacity of P
+ * @param  A_nnz  Capacity of A
+ * @return        Problem, or NULL if out of memory
+ */
+bench_problem* bench_problem_new(OSQPInt n,
+                                 OSQPInt m,
+                                 OSQPInt P_nnz,
+                                 OSQPInt A_nnz);
+
+/**
+ * Free a problem generated by bench_random_qp or bench_problem_new.
+ * @param  prob  Problem
+ */
+void bench_free_problem(bench_problem* prob);
+
+/**
+ * Monotonic wall-clock time.
+ * @return  Time in seconds since an arbitrary origin
+ */
+double bench_time(void);
+
+/**
+ * Percentile of a set of samples (the samples are sorted in place).
+ * @param  samples  Samples
+ * @param  num      Number of samples
+ * @param  pct      Percentile in [0, 100]
+ * @return          Nearest-rank percentile
+ */
+double bench_percentile(double* samples,
+                        OSQPInt num,
+                        double  pct);
+
+/**
+ * Parse "--name=value" style integer and floating point options.
+ * @return  1 if argv[i] matched name and value was set, 0 otherwise
+ */
+int bench_arg_int(const char* arg,
+                  const char* name,
+                  OSQPInt*    value);
+int bench_arg_float(const char* arg,
+                    const char* name,
+                    OSQPFloat*  value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef BENCH_UTILS_H_ */
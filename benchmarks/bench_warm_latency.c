@@ -0,0 +1,572 @@
+/*
+ * Latency distribution of warm-started re-solves in closed loop.
+ *
+ * Drives two closed-loop sequences through the update, warm start and solve
+ * cycle and reports the percentiles of the update and solve latencies
+ * separately:
+ *
+ *  - mpc:       tracking MPC of a chain of masses coupled by springs. Every
+ *               step updates the initial state (l = u on the first rows) and
+ *               the reference (q), warm starts the primal variables with the
+ *               solution shifted by one step, solves and applies the first
+ *               input to the plant with a small disturbance. The reference
+ *               is a square wave, so the setpoint changes now and then.
+ *  - portfolio: rolling rebalancing of a factor-model portfolio. Every step
+ *               updates the expected returns (q), which follow a random
+ *               walk, and re-solves from the previous solution.
+ *
+ * The first solve after setup is cold and left out of the statistics. Solves
+ * slower than a multiple of the median are reported as outliers and
+ * attributed to a rho update, which refactors the KKT matrix with the direct
+ * solver, to polishing, or to a longer run of iterations.
+ *
+ * Usage: bench_warm_latency [--steps=K] [--masses=M] [--horizon=N]
+ *                           [--assets=A] [--factors=F] [--polish=0|1]
+ *                           [--rho_interval=I] [--outlier=FACTOR]
+ */
+
+#include "osqp.h"
+#include "bench_utils.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_WORST 5
+
+/* Closed-loop scenario: update runs before and advance after every solve */
+typedef struct {
+  const char*    name;
+  bench_problem* prob;
+  void*          ctx;
+  OSQPInt        (*update)(void* ctx, OSQPSolver* solver, OSQPInt step);
+  void           (*advance)(void* ctx, const OSQPSolver* solver);
+} bench_scenario;
+
+static double bench_noise(unsigned int* state) {
+  *state = *state * 1103515245u + 12345u;
+  return 2.0 * (double)(*state >> 8) / (double)(1u << 24) - 1.0;
+}
+
+
+/*
+ * MPC tracking
+ *
+ * Variables z = (x_0, ..., x_N, u_0, ..., u_{N-1}), constraints
+ * x_0 = x_init, x_{k+1} = Ad x_k + Bd u_k and bounds on all variables.
+ */
+
+typedef struct {
+  OSQPInt        masses;
+  OSQPInt        horizon;
+  OSQPInt        nx;
+  OSQPInt        nu;
+  OSQPFloat*     Ad;     ///< nx x nx, row major
+  OSQPFloat*     Bd;     ///< nx x nu, row major
+  OSQPFloat*     xs;     ///< plant state
+  OSQPFloat*     xs_new;
+  OSQPFloat*     z_warm;
+  bench_problem* prob;
+  unsigned int   state;
+} mpc_ctx;
+
+#define MPC_DT       0.1
+#define MPC_SPRING   1.0
+#define MPC_Q_POS    10.0
+#define MPC_Q_VEL    0.1
+#define MPC_R        0.1
+#define MPC_PERIOD   200
+
+static OSQPFloat mpc_reference(OSQPInt mass,
+                               OSQPInt step) {
+  // Square wave with a different phase for every mass
+  return ((step + 37 * mass) / (MPC_PERIOD / 2)) % 2 ? 0.5 : -0.5;
+}
+
+static bench_problem* mpc_problem(mpc_ctx* c) {
+  OSQPInt        i, j, k, r, s, nnz;
+  OSQPInt        nm  = c->masses;
+  OSQPInt        N   = c->horizon;
+  OSQPInt        nx  = 2 * nm;
+  OSQPInt        nu  = nm;
+  OSQPInt        n   = (N + 1) * nx + N * nu;
+  OSQPInt        neq = (N + 1) * nx;
+  bench_problem* prob;
+
+  c->nx     = nx;
+  c->nu     = nu;
+  c->Ad     = calloc(nx * nx, sizeof(OSQPFloat));
+  c->Bd     = calloc(nx * nu, sizeof(OSQPFloat));
+  c->xs     = calloc(nx, sizeof(OSQPFloat));
+  c->xs_new = calloc(nx, sizeof(OSQPFloat));
+  c->z_warm = calloc(n, sizeof(OSQPFloat));
+  prob      = bench_problem_new(n, neq + n, n, (N + 1) * nx * (nx + 2) + N * nu * (nx + 1));
+  if (!c->Ad || !c->Bd || !c->xs || !c->xs_new || !c->z_warm || !prob) {
+    bench_free_problem(prob);
+    return NULL;
+  }
+
+  // Positions first, then velocities; every mass is pulled by its neighbors
+  for (i = 0; i < nm; i++) {
+    c->Ad[i * nx + i]                  = 1;
+    c->Ad[i * nx + nm + i]             = MPC_DT;
+    c->Ad[(nm + i) * nx + nm + i]      = 1;
+    c->Ad[(nm + i) * nx + i]           = -2 * MPC_SPRING * MPC_DT;
+    if (i > 0)      c->Ad[(nm + i) * nx + i - 1] = MPC_SPRING * MPC_DT;
+    if (i < nm - 1) c->Ad[(nm + i) * nx + i + 1] = MPC_SPRING * MPC_DT;
+    c->Bd[(nm + i) * nu + i]           = MPC_DT;
+  }
+
+  // P: diagonal tracking and input weights
+  for (j = 0; j < n; j++) {
+    prob->P->p[j] = j;
+    prob->P->i[j] = j;
+    if (j < neq) prob->P->x[j] = j % nx < nm ? MPC_Q_POS : MPC_Q_VEL;
+    else         prob->P->x[j] = MPC_R;
+  }
+  prob->P->p[n]  = n;
+  prob->P->nzmax = n;
+
+  // A: state columns, then input columns, then the bound rows
+  nnz = 0;
+  for (k = 0; k <= N; k++) {
+    for (s = 0; s < nx; s++) {
+      prob->A->i[nnz]   = k * nx + s;
+      prob->A->x[nnz++] = -1;
+      for (r = 0; r < nx && k < N; r++) {
+        if (c->Ad[r * nx + s] == 0) continue;
+        prob->A->i[nnz]   = (k + 1) * nx + r;
+        prob->A->x[nnz++] = c->Ad[r * nx + s];
+      }
+      prob->A->i[nnz]   = neq + k * nx + s;
+      prob->A->x[nnz++] = 1;
+      prob->A->p[k * nx + s + 1] = nnz;
+    }
+  }
+  for (k = 0; k < N; k++) {
+    for (s = 0; s < nu; s++) {
+      j = neq + k * nu + s;
+      for (r = 0; r < nx; r++) {
+        if (c->Bd[r * nu + s] == 0) continue;
+        prob->A->i[nnz]   = (k + 1) * nx + r;
+        prob->A->x[nnz++] = c->Bd[r * nu + s];
+      }
+      prob->A->i[nnz]   = neq + j;
+      prob->A->x[nnz++] = 1;
+      prob->A->p[j + 1] = nnz;
+    }
+  }
+  prob->A->nzmax = nnz;
+
+  // Dynamics, initial state at rest and bounds on positions, velocities and inputs
+  for (i = 0; i < neq; i++) {
+    prob->l[i] = 0;
+    prob->u[i] = 0;
+  }
+  for (j = 0; j < n; j++) {
+    if (j >= neq)         prob->u[neq + j] = 1.0;
+    else if (j % nx < nm) prob->u[neq + j] = 2.0;
+    else                  prob->u[neq + j] = 1.5;
+    prob->l[neq + j] = -prob->u[neq + j];
+  }
+  for (k = 0; k <= N; k++) {
+    for (s = 0; s < nx; s++) prob->q[k * nx + s] = s < nm ? -MPC_Q_POS * mpc_reference(s, k) : 0;
+  }
+  for (j = neq; j < n; j++) prob->q[j] = 0;
+
+  c->prob = prob;
+  return prob;
+}
+
+static OSQPInt mpc_update(void*       ctx,
+                          OSQPSolver* solver,
+                          OSQPInt     step) {
+  mpc_ctx*   c   = ctx;
+  OSQPInt    k, s;
+  OSQPInt    nx  = c->nx;
+  OSQPInt    nu  = c->nu;
+  OSQPInt    N   = c->horizon;
+  OSQPInt    neq = (N + 1) * nx;
+  OSQPInt    exitflag;
+  OSQPFloat* z   = solver->solution->x;
+
+  for (s = 0; s < nx; s++) {
+    c->prob->l[s] = -c->xs[s];
+    c->prob->u[s] = -c->xs[s];
+  }
+  for (k = 0; k <= N; k++) {
+    for (s = 0; s < c->masses; s++) c->prob->q[k * nx + s] = -MPC_Q_POS * mpc_reference(s, step + k);
+  }
+
+  exitflag = osqp_update_data_vec(solver, c->prob->q, c->prob->l, c->prob->u);
+  if (exitflag) return exitflag;
+
+  // Shift the previous trajectory by one step and repeat its last state and input
+  memcpy(c->z_warm, z + nx, N * nx * sizeof(OSQPFloat));
+  memcpy(c->z_warm + N * nx, z + N * nx, nx * sizeof(OSQPFloat));
+  memcpy(c->z_warm + neq, z + neq + nu, (N - 1) * nu * sizeof(OSQPFloat));
+  memcpy(c->z_warm + neq + (N - 1) * nu, z + neq + (N - 1) * nu, nu * sizeof(OSQPFloat));
+
+  return osqp_warm_start(solver, c->z_warm, OSQP_NULL);
+}
+
+static void mpc_advance(void*             ctx,
+                        const OSQPSolver* solver) {
+  mpc_ctx*         c   = ctx;
+  OSQPInt          r, s;
+  OSQPInt          nx  = c->nx;
+  OSQPInt          nu  = c->nu;
+  const OSQPFloat* u0  = solver->solution->x + (c->horizon + 1) * nx;
+
+  for (r = 0; r < nx; r++) {
+    c->xs_new[r] = r >= c->masses ? 1e-3 * bench_noise(&c->state) : 0;
+    for (s = 0; s < nx; s++) c->xs_new[r] += c->Ad[r * nx + s] * c->xs[s];
+    for (s = 0; s < nu; s++) c->xs_new[r] += c->Bd[r * nu + s] * u0[s];
+  }
+  memcpy(c->xs, c->xs_new, nx * sizeof(OSQPFloat));
+}
+
+static void mpc_free(mpc_ctx* c) {
+  free(c->Ad);
+  free(c->Bd);
+  free(c->xs);
+  free(c->xs_new);
+  free(c->z_warm);
+}
+
+
+/*
+ * Portfolio rebalancing
+ *
+ * Variables z = (x, y) with the asset weights x and the factor exposures
+ * y = F' x, minimizing x' D x + y' y - mu' x / gamma subject to a budget and
+ * bounds on the weights.
+ */
+
+typedef struct {
+  OSQPInt        assets;
+  OSQPInt        factors;
+  OSQPFloat*     mu;
+  bench_problem* prob;
+  unsigned int   state;
+} portfolio_ctx;
+
+#define PORTFOLIO_GAMMA   1.0
+#define PORTFOLIO_DENSITY 0.5
+#define PORTFOLIO_MAX_W   0.05
+#define PORTFOLIO_DRIFT   0.05
+
+static bench_problem* portfolio_problem(portfolio_ctx* c) {
+  OSQPInt        i, j, nnz;
+  OSQPInt        na = c->assets;
+  OSQPInt        nf = c->factors;
+  OSQPInt        n  = na + nf;
+  OSQPInt        m  = nf + 1 + na;
+  bench_problem* prob;
+
+  c->mu = malloc(na * sizeof(OSQPFloat));
+  prob  = bench_problem_new(n, m, n, na * (nf + 2) + nf);
+  if (!c->mu || !prob) {
+    bench_free_problem(prob);
+    return NULL;
+  }
+
+  // P: idiosyncratic risk of the assets and unit factor covariance
+  for (j = 0; j < n; j++) {
+    prob->P->p[j] = j;
+    prob->P->i[j] = j;
+    prob->P->x[j] = j < na ? 2 * (0.05 + 0.05 * (1 + bench_noise(&c->state))) : 2;
+  }
+  prob->P->p[n]  = n;
+  prob->P->nzmax = n;
+
+  // A: factor loadings, budget and weight bounds of the assets, then -I for y
+  nnz = 0;
+  for (j = 0; j < na; j++) {
+    for (i = 0; i < nf; i++) {
+      if (0.5 * (1 + bench_noise(&c->state)) >= PORTFOLIO_DENSITY) continue;
+      prob->A->i[nnz]   = i;
+      prob->A->x[nnz++] = bench_noise(&c->state) / sqrt((double)nf);
+    }
+    prob->A->i[nnz]   = nf;
+    prob->A->x[nnz++] = 1;
+    prob->A->i[nnz]   = nf + 1 + j;
+    prob->A->x[nnz++] = 1;
+    prob->A->p[j + 1] = nnz;
+  }
+  for (i = 0; i < nf; i++) {
+    prob->A->i[nnz]        = i;
+    prob->A->x[nnz++]      = -1;
+    prob->A->p[na + i + 1] = nnz;
+  }
+  prob->A->nzmax = nnz;
+
+  for (i = 0; i < nf; i++) {
+    prob->l[i] = 0;
+    prob->u[i] = 0;
+  }
+  prob->l[nf] = 1;
+  prob->u[nf] = 1;
+  for (j = 0; j < na; j++) {
+    prob->l[nf + 1 + j] = 0;
+    prob->u[nf + 1 + j] = PORTFOLIO_MAX_W;
+  }
+
+  for (j = 0; j < na; j++) {
+    c->mu[j]   = 0.1 * bench_noise(&c->state);
+    prob->q[j] = -c->mu[j] / PORTFOLIO_GAMMA;
+  }
+  for (j = na; j < n; j++) prob->q[j] = 0;
+
+  c->prob = prob;
+  return prob;
+}
+
+static OSQPInt portfolio_update(void*       ctx,
+                                OSQPSolver* solver,
+                                OSQPInt     step) {
+  portfolio_ctx* c = ctx;
+  OSQPInt        j;
+
+  (void)step;
+  for (j = 0; j < c->assets; j++) {
+    c->mu[j]         += PORTFOLIO_DRIFT * 0.1 * bench_noise(&c->state);
+    c->prob->q[j]     = -c->mu[j] / PORTFOLIO_GAMMA;
+  }
+
+  // The solver starts from the previous solution
+  return osqp_update_data_vec(solver, c->prob->q, OSQP_NULL, OSQP_NULL);
+}
+
+static void portfolio_advance(void*             ctx,
+                              const OSQPSolver* solver) {
+  (void)ctx;
+  (void)solver;
+}
+
+
+/*
+ * Driver
+ */
+
+typedef struct {
+  OSQPInt   steps;
+  OSQPInt   polish;
+  OSQPInt   rho_interval;
+  OSQPFloat outlier;
+} bench_options;
+
+static void print_latency(const char* phase,
+                          double*     samples,
+                          double*     sorted,
+                          OSQPInt     num) {
+  memcpy(sorted, samples, num * sizeof(double));
+  printf("%-8s %12.1f %12.1f %12.1f %12.1f\n", phase,
+         1e6 * bench_percentile(sorted, num, 50), 1e6 * bench_percentile(sorted, num, 90),
+         1e6 * bench_percentile(sorted, num, 99), 1e6 * bench_percentile(sorted, num, 100));
+}
+
+static OSQPInt run_scenario(const bench_scenario* sc,
+                            const bench_options*  opt) {
+  OSQPInt       i, k, w, taken, exitflag;
+  OSQPInt       steps    = opt->steps;
+  OSQPInt       unsolved = 0;
+  OSQPInt       n_rho = 0, n_polish = 0;
+  OSQPInt       n_out[4] = {0, 0, 0, 0};
+  OSQPInt       worst[N_WORST];
+  double        t, t_med, it_med;
+  double*       t_update = malloc(steps * sizeof(double));
+  double*       t_solve  = malloc(steps * sizeof(double));
+  double*       t_total  = malloc(steps * sizeof(double));
+  double*       sorted   = malloc(steps * sizeof(double));
+  double*       t_polish = malloc(steps * sizeof(double));
+  OSQPInt*      iter     = malloc(steps * sizeof(OSQPInt));
+  OSQPInt*      rho_upd  = malloc(steps * sizeof(OSQPInt));
+  OSQPInt*      cause    = malloc(steps * sizeof(OSQPInt));
+  OSQPSolver*   solver   = NULL;
+  OSQPSettings* settings = malloc(sizeof(OSQPSettings));
+  bench_problem* prob    = sc->prob;
+
+  const char* causes[4] = {"rho update", "polishing", "iterations", "other"};
+
+  if (!t_update || !t_solve || !t_total || !sorted || !t_polish || !iter || !rho_upd ||
+      !cause || !settings) {
+    printf("Out of memory allocating the samples\n");
+    return 1;
+  }
+
+  osqp_set_default_settings(settings);
+  settings->verbose   = 0;
+  settings->polishing = opt->polish;
+  if (opt->rho_interval >= 0) settings->adaptive_rho_interval = opt->rho_interval;
+
+  exitflag = osqp_setup(&solver, prob->P, prob->q, prob->A, prob->l, prob->u,
+                        prob->m, prob->n, settings);
+  if (exitflag) {
+    printf("Setup of the %s problem failed: %s\n", sc->name, osqp_error_message(exitflag));
+    return 1;
+  }
+
+  // Cold solve, not part of the statistics
+  osqp_solve(solver);
+  sc->advance(sc->ctx, solver);
+
+  for (k = 0; k < steps; k++) {
+    t        = bench_time();
+    exitflag = sc->update(sc->ctx, solver, k + 1);
+    t_update[k] = bench_time() - t;
+    if (exitflag) {
+      printf("Update of the %s problem failed: %s\n", sc->name, osqp_error_message(exitflag));
+      return 1;
+    }
+
+    t = bench_time();
+    osqp_solve(solver);
+    t_solve[k] = bench_time() - t;
+
+    t_total[k]  = t_update[k] + t_solve[k];
+    t_polish[k] = opt->polish ? solver->info->polish_time : 0;
+    iter[k]     = solver->info->iter;
+    rho_upd[k]  = solver->info->rho_updates;
+    if (rho_upd[k] > 0) n_rho++;
+    if (solver->info->status_polish != 0) n_polish++;
+    if (solver->info->status_val != OSQP_SOLVED &&
+        solver->info->status_val != OSQP_SOLVED_INACCURATE) unsolved++;
+
+    sc->advance(sc->ctx, solver);
+  }
+
+  printf("%s: n = %lld, m = %lld, nnz(P) = %lld, nnz(A) = %lld, %lld warm-started steps\n\n",
+         sc->name, (long long)prob->n, (long long)prob->m, (long long)prob->P->p[prob->n],
+         (long long)prob->A->p[prob->n], (long long)steps);
+  printf("%-8s %12s %12s %12s %12s\n", "phase", "p50 [us]", "p90 [us]", "p99 [us]", "max [us]");
+  print_latency("update", t_update, sorted, steps);
+  print_latency("solve",  t_solve,  sorted, steps);
+  print_latency("total",  t_total,  sorted, steps);
+
+  for (k = 0; k < steps; k++) sorted[k] = (double)iter[k];
+  it_med = bench_percentile(sorted, steps, 50);
+  printf("\niterations: p50 %.0f, p99 %.0f, max %.0f\n", it_med,
+         bench_percentile(sorted, steps, 99), bench_percentile(sorted, steps, 100));
+  printf("steps with rho updates: %lld, polished: %lld, not solved: %lld\n",
+         (long long)n_rho, (long long)n_polish, (long long)unsolved);
+
+  // Outliers: rho updates refactor the KKT matrix, then polishing if it took at
+  // least half of the excess over the median, then long runs of iterations
+  memcpy(sorted, t_solve, steps * sizeof(double));
+  t_med = bench_percentile(sorted, steps, 50);
+  for (k = 0; k < steps; k++) {
+    cause[k] = -1;
+    if (t_solve[k] <= opt->outlier * t_med) continue;
+    if (rho_upd[k] > 0)                                cause[k] = 0;
+    else if (t_polish[k] >= 0.5 * (t_solve[k] - t_med)) cause[k] = 1;
+    else if (iter[k] > 2 * it_med)                     cause[k] = 2;
+    else                                               cause[k] = 3;
+    n_out[cause[k]]++;
+  }
+  printf("\nsolve outliers (> %.1f x p50): %lld\n", opt->outlier,
+         (long long)(n_out[0] + n_out[1] + n_out[2] + n_out[3]));
+  for (i = 0; i < 4; i++) {
+    if (n_out[i]) printf("  %-12s %8lld\n", causes[i], (long long)n_out[i]);
+  }
+
+  // Slowest solves
+  printf("\n%-8s %12s %8s %12s %14s  %s\n", "step", "solve [us]", "iter", "rho updates",
+         "polish [us]", "cause");
+  for (i = 0; i < N_WORST && i < steps; i++) {
+    worst[i] = -1;
+    for (k = 0; k < steps; k++) {
+      for (taken = 0, w = 0; w < i; w++) taken |= worst[w] == k;
+      if (!taken && (worst[i] < 0 || t_solve[k] > t_solve[worst[i]])) worst[i] = k;
+    }
+    k = worst[i];
+    printf("%-8lld %12.1f %8lld %12lld %14.1f  %s\n", (long long)(k + 1), 1e6 * t_solve[k],
+           (long long)iter[k], (long long)rho_upd[k], 1e6 * t_polish[k],
+           cause[k] >= 0 ? causes[cause[k]] : "-");
+  }
+  printf("\n");
+
+  osqp_cleanup(solver);
+  free(settings);
+  free(t_update);
+  free(t_solve);
+  free(t_total);
+  free(sorted);
+  free(t_polish);
+  free(iter);
+  free(rho_upd);
+  free(cause);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+
+  OSQPInt        i;
+  OSQPInt        status = 0;
+  bench_options  opt;
+  bench_scenario sc;
+  mpc_ctx        mpc;
+  portfolio_ctx  pf;
+
+  opt.steps        = 5000;
+  opt.polish       = 1;
+  opt.rho_interval = -1;
+  opt.outlier      = 3;
+
+  memset(&mpc, 0, sizeof(mpc));
+  memset(&pf,  0, sizeof(pf));
+  mpc.masses  = 6;
+  mpc.horizon = 20;
+  mpc.state   = 7;
+  pf.assets   = 1000;
+  pf.factors  = 20;
+  pf.state    = 11;
+
+  for (i = 1; i < argc; i++) {
+    if (!bench_arg_int(argv[i], "--steps", &opt.steps) &&
+        !bench_arg_int(argv[i], "--masses", &mpc.masses) &&
+        !bench_arg_int(argv[i], "--horizon", &mpc.horizon) &&
+        !bench_arg_int(argv[i], "--assets", &pf.assets) &&
+        !bench_arg_int(argv[i], "--factors", &pf.factors) &&
+        !bench_arg_int(argv[i], "--polish", &opt.polish) &&
+        !bench_arg_int(argv[i], "--rho_interval", &opt.rho_interval) &&
+        !bench_arg_float(argv[i], "--outlier", &opt.outlier)) {
+      printf("Unknown argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (opt.steps < 1)    opt.steps   = 1;
+  if (mpc.masses < 1)   mpc.masses  = 1;
+  if (mpc.horizon < 2)  mpc.horizon = 2;
+  if (pf.assets < 1)    pf.assets   = 1;
+  if (pf.factors < 1)   pf.factors  = 1;
+
+  sc.name    = "mpc";
+  sc.prob    = mpc_problem(&mpc);
+  sc.ctx     = &mpc;
+  sc.update  = mpc_update;
+  sc.advance = mpc_advance;
+  if (!sc.prob) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  status |= run_scenario(&sc, &opt);
+  bench_free_problem(sc.prob);
+  mpc_free(&mpc);
+
+  sc.name    = "portfolio";
+  sc.prob    = portfolio_problem(&pf);
+  sc.ctx     = &pf;
+  sc.update  = portfolio_update;
+  sc.advance = portfolio_advance;
+  if (!sc.prob) {
+    printf("Out of memory generating the problem\n");
+    return 1;
+  }
+  status |= run_scenario(&sc, &opt);
+  bench_free_problem(sc.prob);
+  free(pf.mu);
+
+  return (int)status;
+}
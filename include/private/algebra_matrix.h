@@ -34,9 +34,20 @@ OSQPInt OSQPMatrix_is_eq(const OSQPMatrix* A,
 OSQPMatrix* OSQPMatrix_new_from_csc(const OSQPCscMatrix* A,
                                           OSQPInt        is_triu);
 
+//Make a matrix that calls the products of an operator, which must stay valid
+//while the matrix is used.  Returns OSQP_NULL on failure or if the algebra
+//does not support operators
+OSQPMatrix* OSQPMatrix_new_from_operator(const OSQPOperator* op,
+                                               OSQPInt       is_triu);
+
 /* Return a copy of the matrix in CSC format */
 OSQPCscMatrix* OSQPMatrix_get_csc(const OSQPMatrix* M);
 
+/* Switch the matrix-vector products to compressed row indices where the
+   algebra supports them (otherwise the matrix is left as it is).
+   Returns 1 if out of memory, 0 otherwise */
+OSQPInt OSQPMatrix_compress_indices(OSQPMatrix* M);
+
 /* Return a copy of a matrix as output (Uses MALLOC) */
 OSQPMatrix* OSQPMatrix_copy_new(const OSQPMatrix* A);
 
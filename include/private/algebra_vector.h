@@ -234,6 +234,78 @@ OSQPInt OSQPVectorf_in_reccone(const OSQPVectorf* y,
                                OSQPFloat          infval,
                                OSQPFloat          tol);
 
+
+/* VECTOR EXPRESSIONS --------------------------------------------------------*/
+
+/* Maximum number of terms in a vector expression */
+# define OSQP_VECTOR_EXPR_TERMS (4)
+
+/* Lazy elementwise expression
+ *
+ *   e[i] = min(max(sc * s[i] * sum_k c[k] * (a[k][i] * b[k][i]), l[i]), u[i])
+ *
+ * with the terms summed in the order they are added. Factors and bounds
+ * that are not set are left out. The expression only holds pointers to
+ * its vectors; it is evaluated in a single pass over them by
+ * OSQPVectorf_eval and the reductions below.
+ */
+typedef struct {
+  OSQPInt            nterms;
+  OSQPFloat          c[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPVectorf* a[OSQP_VECTOR_EXPR_TERMS];
+  const OSQPVectorf* b[OSQP_VECTOR_EXPR_TERMS];
+  OSQPFloat          sc;
+  const OSQPVectorf* s;
+  const OSQPVectorf* l;
+  const OSQPVectorf* u;
+} OSQPVectorf_expr;
+
+/* Empty expression e = 0 */
+void OSQPVectorf_expr_init(OSQPVectorf_expr* e);
+
+/* Add the term c*a to e. Adding more than OSQP_VECTOR_EXPR_TERMS terms
+ * fails an assertion, or prints an error and leaves the term out when
+ * assertions are disabled.
+ */
+void OSQPVectorf_expr_add(OSQPVectorf_expr*  e,
+                          OSQPFloat          c,
+                          const OSQPVectorf* a);
+
+/* Add the term c*(a.*b) to e, with the same limit as OSQPVectorf_expr_add */
+void OSQPVectorf_expr_add_prod(OSQPVectorf_expr*  e,
+                               OSQPFloat          c,
+                               const OSQPVectorf* a,
+                               const OSQPVectorf* b);
+
+/* Scale the sum of the terms of e by sc */
+void OSQPVectorf_expr_mult_scalar(OSQPVectorf_expr* e,
+                                  OSQPFloat         sc);
+
+/* Scale the sum of the terms of e elementwise by s */
+void OSQPVectorf_expr_ew_prod(OSQPVectorf_expr*  e,
+                              const OSQPVectorf* s);
+
+/* Bound e elementwise to [l, u] */
+void OSQPVectorf_expr_bound_vec(OSQPVectorf_expr*  e,
+                                const OSQPVectorf* l,
+                                const OSQPVectorf* u);
+
+/* x = e. x can be one of the vectors of e */
+void OSQPVectorf_eval(OSQPVectorf*            x,
+                      const OSQPVectorf_expr* e);
+
+/* x = e and return ||e||_inf. If S is not null, also set
+ * snorm = ||S.*e||_inf. x can be null to only compute the norms.
+ */
+OSQPFloat OSQPVectorf_eval_norm_inf(OSQPVectorf*            x,
+                                    const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      S,
+                                    OSQPFloat*              snorm);
+
+/* Inner product w'e */
+OSQPFloat OSQPVectorf_expr_dot_prod(const OSQPVectorf_expr* e,
+                                    const OSQPVectorf*      w);
+
 # if OSQP_EMBEDDED_MODE != 1
 
 /* Vector elementwise reciprocal b = 1./a (needed for scaling)*/
@@ -0,0 +1,127 @@
+/* Termination checks of the ADMM iterations run on a helper thread */
+#ifndef ASYNC_CHECK_H
+#define ASYNC_CHECK_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Snapshot of the iterates of one check point. The check runs update_info,
+ * check_termination_conditions and check_stall on solver, a copy of the
+ * solver whose workspace reads the snapshot and the temporaries of the helper
+ * thread instead of the vectors of the ADMM iterations, and whose information
+ * is written to info.
+ */
+typedef struct {
+  OSQPSolver    solver;    ///< copy of the solver with the workspace and information below
+  OSQPWorkspace work;      ///< copy of the workspace pointing to the snapshot
+  OSQPInfo      info;      ///< information computed by the check
+  OSQPVectorf*  x;         ///< snapshot of x (size n)
+  OSQPVectorf*  z;         ///< snapshot of z (size m)
+  OSQPVectorf*  y;         ///< snapshot of y (size m)
+  OSQPVectorf*  delta_x;   ///< snapshot of delta_x (size n)
+  OSQPVectorf*  delta_y;   ///< snapshot of delta_y (size m)
+  OSQPInt       iter;      ///< iteration of the snapshot
+  OSQPInt       exitflag;  ///< 1 if a termination criterion is met at the snapshot
+} async_check_slot;
+
+/**
+ * Double-buffered termination checks. At a check point the iterates are
+ * copied to the free slot and handed to the helper thread, and the ADMM
+ * iterations go on. The result is collected one iteration later; if the
+ * check terminates the solve, the iterate of the snapshot and its information
+ * replace the current ones, so the solve returns the iterate it checked.
+ */
+struct OSQPAsyncCheck_ {
+  async_check_slot slot[2];
+  OSQPInt          next;         ///< slot of the next snapshot
+  OSQPInt          posted;       ///< slot handed to the helper thread, -1 if none
+  OSQPInt          done;         ///< the helper thread finished the posted slot
+  OSQPInt          quit;         ///< the helper thread has to return
+  OSQPInt          compute_obj;  ///< compute the objective in the checks
+
+  /**
+   * @name Temporaries of the checks, shared by the slots since the helper
+   * thread checks one at a time
+   * @{
+   */
+  OSQPVectorf*     x_prev;       ///< dual residual (size n)
+  OSQPVectorf*     z_prev;       ///< primal residual (size m)
+  OSQPVectorf*     Ax;           ///< A * x of the last check (size m)
+  OSQPVectorf*     Px;           ///< P * x of the last check (size n)
+  OSQPVectorf*     Aty;          ///< A' * y of the last check (size n)
+  OSQPVectorf*     Atdelta_y;    ///< size n
+  OSQPVectorf*     Pdelta_x;     ///< size n
+  OSQPVectorf*     Adelta_x;     ///< size m
+  /** @} */
+
+#ifdef OSQP_ENABLE_PROFILING
+  OSQPTimer*       timer;        ///< timer of the checks, the one of the solver is not shared
+#endif
+
+  pthread_t        thread;       ///< helper thread
+  pthread_mutex_t  lock;         ///< protects next to quit
+  pthread_cond_t   cond;         ///< signals a posted slot, a finished check or quit
+};
+
+/**
+ * Allocate the buffers and start the helper thread
+ * @param  acp  Asynchronous checks, OSQP_NULL on failure
+ * @param  n    Number of variables
+ * @param  m    Number of constraints
+ * @return      Exitflag (0 if no errors)
+ */
+OSQPInt async_check_new(OSQPAsyncCheck** acp,
+                        OSQPInt          n,
+                        OSQPInt          m);
+
+/**
+ * Copy the iterates of the current iteration to the free slot. The slot is
+ * free while the helper thread checks the other one.
+ * @param  ac      Asynchronous checks
+ * @param  solver  Solver
+ * @param  iter    Current iteration
+ */
+void async_check_snapshot(OSQPAsyncCheck* ac,
+                          OSQPSolver*     solver,
+                          OSQPInt         iter);
+
+/**
+ * Hand the slot of the last snapshot to the helper thread
+ * @param  ac           Asynchronous checks
+ * @param  solver       Solver
+ * @param  compute_obj  Compute the objective value in the check
+ */
+void async_check_post(OSQPAsyncCheck* ac,
+                      OSQPSolver*     solver,
+                      OSQPInt         compute_obj);
+
+/**
+ * Wait for the posted check. Its progress of the residuals is copied to the
+ * workspace of the solver and, if it terminates the solve, so are its
+ * iterate, residuals and information.
+ * @param  ac      Asynchronous checks
+ * @param  solver  Solver to update, or OSQP_NULL to only wait for the check
+ * @return         1 if the check terminates the solve
+ */
+OSQPInt async_check_collect(OSQPAsyncCheck* ac,
+                            OSQPSolver*     solver);
+
+/**
+ * Stop the helper thread and free the buffers
+ * @param  ac  Asynchronous checks
+ */
+void async_check_free(OSQPAsyncCheck* ac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef ASYNC_CHECK_H */
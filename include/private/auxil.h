@@ -54,6 +54,13 @@ void swap_vectors(OSQPVectorf** a,
                   OSQPVectorf** b);
 
 
+/**
+ * Compute the right-hand side of the KKT system in xz_tilde
+ * @param solver    Solver
+ */
+void compute_rhs(OSQPSolver* solver);
+
+
 /**
  * Update x_tilde and z_tilde variable (first ADMM step)
  * @param solver    Solver
@@ -146,12 +153,53 @@ void update_status(OSQPInfo* info,
  * @param  approximate Boolean
  * @return             Residuals check
  */
-OSQPInt check_termination(OSQPSolver* solver,
-                          OSQPInt     approximate);
+OSQPInt check_termination_conditions(OSQPSolver* solver,
+                                     OSQPInt     approximate);
 
 
 # ifndef OSQP_EMBEDDED_MODE
 
+/**
+ * Track the residuals at a termination check that did not terminate: keep
+ * the best iterate (with best_iterate) and count the checks that decrease
+ * the residual ratio max(prim_res / eps_prim, dual_res / eps_dual) by less
+ * than OSQP_STALL_DECREASE. After stall_checks of them the status is set to
+ * OSQP_STALLED.
+ *
+ * @param  solver  Solver, with the information of the current iterate
+ * @param  iter    Current iteration
+ * @return         1 if the solve has stalled
+ */
+OSQPInt check_stall(OSQPSolver* solver,
+                    OSQPInt     iter);
+
+/**
+ * Bring back the best iterate kept by check_stall if it has smaller
+ * residuals than the current one, and update the information with it.
+ *
+ * @param  solver       Solver, with the information of the current iterate
+ * @param  compute_obj  Compute the objective value
+ */
+void restore_best_iterate(OSQPSolver* solver,
+                          OSQPInt     compute_obj);
+
+/**
+ * Decide whether a rho update is worth its refactorization
+ * (adaptive_rho_cost_model).
+ *
+ * The residuals are extrapolated from their trend since the previous
+ * adaptation to estimate the iterations left, of which the update to rho_new
+ * is expected to save a share that grows with the mismatch of the current rho.
+ * The update pays when these iterations take longer than the last measured
+ * rho update. Without profiling, or before any measurement, it always pays.
+ *
+ * @param  solver   Solver, with the information of the current iterate
+ * @param  rho_new  New value of rho
+ * @return          1 if rho should be updated
+ */
+OSQPInt rho_update_pays(OSQPSolver* solver,
+                        OSQPFloat   rho_new);
+
 /**
  * Validate problem data
  * @param  P  Problem data (quadratic cost term, csc format)
@@ -171,6 +219,25 @@ OSQPInt validate_data(const OSQPCscMatrix* P,
                             OSQPInt        m,
                             OSQPInt        n);
 
+/**
+ * Validate problem data given as operators
+ * @param  P  Problem data (quadratic cost term, operator)
+ * @param  q  Problem data (linear cost term)
+ * @param  A  Problem data (constraint matrix, operator)
+ * @param  l  Problem data (constraint lower bound)
+ * @param  u  Problem data (constraint upper bound)
+ * @param  m  Problem data (number of constraints)
+ * @param  n  Problem data (number of variables)
+ * @return    Exitflag to check
+ */
+OSQPInt validate_operators(const OSQPOperator* P,
+                           const OSQPFloat*    q,
+                           const OSQPOperator* A,
+                           const OSQPFloat*    l,
+                           const OSQPFloat*    u,
+                                 OSQPInt       m,
+                                 OSQPInt       n);
+
 # endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
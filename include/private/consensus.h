@@ -0,0 +1,131 @@
+/* Consensus ADMM over blocks of constraint rows, one local solver per block */
+#ifndef CONSENSUS_H
+#define CONSENSUS_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef OSQP_ENABLE_THREADS
+# include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Minimum number of consensus iterations between two changes of rho */
+#define CONSENSUS_RHO_INTERVAL (10)
+
+/* Ratio of the residuals above which rho is changed */
+#define CONSENSUS_RHO_RATIO (10.)
+
+/* Work of one block, run on its own thread */
+typedef struct {
+  OSQPConsensus*       cons;
+  OSQPInt              k;         ///< block index
+  OSQPInt              task;      ///< CONSENSUS_TASK_*
+  OSQPInt              exitflag;
+  OSQPInt              threaded;  ///< running on its own thread
+  const OSQPCscMatrix* A;         ///< whole constraint matrix (setup only)
+  const OSQPFloat*     l;         ///< whole lower bound (setup only)
+  const OSQPFloat*     u;         ///< whole upper bound (setup only)
+} OSQPConsensusJob;
+
+/**
+ * The rows of A are split into K contiguous blocks. Block k solves
+ *
+ *   minimize   (1/K)(1/2 x'Px + q'x) + (rho/2)||x - z + w_k||^2
+ *   subject to l_k <= A_k x <= u_k
+ *
+ * with its own solver (and KKT factorization), then z is the average of the
+ * x_k + w_k and the scaled duals w_k are updated with x_k - z. At the
+ * solution x_k = z for every block, and the duals of the blocks are the
+ * duals of the whole problem.
+ */
+struct OSQPConsensus_ {
+  OSQPInt        n;
+  OSQPInt        m;
+  OSQPInt        K;
+  OSQPInt*       row_start;  ///< first row of each block, and m (size K+1)
+  OSQPSolver**   blocks;     ///< local solvers (size K)
+  OSQPSettings*  settings;   ///< settings of the consensus iterations
+
+  OSQPCscMatrix* P;          ///< copy of P for the objective
+  OSQPFloat*     q;          ///< copy of q
+  OSQPCscMatrix* Pk;         ///< local cost P/K + rho*I, with the whole diagonal
+  OSQPInt*       Pk_diag;    ///< positions of the diagonal in Pk->x (size n)
+  OSQPFloat*     Pk_diag_x;  ///< new diagonal values for the local solvers (size n)
+  OSQPFloat*     P_diag;     ///< diagonal of P/K (size n)
+
+  OSQPFloat      rho;        ///< consensus penalty
+  OSQPFloat*     z;          ///< consensus iterate (size n)
+  OSQPFloat*     z_prev;     ///< previous consensus iterate (size n)
+  OSQPFloat*     xk;         ///< local iterates (n x K column-major)
+  OSQPFloat*     wk;         ///< scaled duals of the consensus constraints (n x K)
+  OSQPFloat*     qk;         ///< local linear costs (n x K)
+  OSQPInt*       status;     ///< status of the last local solve of each block (size K)
+
+  OSQPConsensusJob* jobs;    ///< work of each block (size K)
+# ifdef OSQP_ENABLE_THREADS
+  pthread_t*     threads;    ///< threads of the blocks 1..K-1 (size K)
+# endif
+
+  OSQPFloat      setup_time;
+# ifdef OSQP_ENABLE_PROFILING
+  OSQPTimer*     timer;
+# endif
+};
+
+/**
+ * Split the rows and set up the local solvers, in parallel when the library
+ * is built with threads.
+ * @param  P          Quadratic cost (upper triangular), already validated
+ * @param  q          Linear cost
+ * @param  A          Constraint matrix
+ * @param  l          Lower bound
+ * @param  u          Upper bound
+ * @param  m          Number of constraints
+ * @param  n          Number of variables
+ * @param  K          Number of blocks
+ * @param  row_start  First row of each block and m (size K+1), or OSQP_NULL for blocks of equal size
+ * @param  settings   Settings, already validated
+ * @param  consp      Consensus solver
+ * @return            Exitflag (0 if no errors)
+ */
+OSQPInt consensus_setup(OSQPConsensus**      consp,
+                        const OSQPCscMatrix* P,
+                        const OSQPFloat*     q,
+                        const OSQPCscMatrix* A,
+                        const OSQPFloat*     l,
+                        const OSQPFloat*     u,
+                        OSQPInt              m,
+                        OSQPInt              n,
+                        OSQPInt              K,
+                        const OSQPInt*       row_start,
+                        const OSQPSettings*  settings);
+
+/**
+ * Run the consensus iterations from the current z and w_k.
+ * @param  cons  Consensus solver
+ * @param  x     Primal solution (size n)
+ * @param  y     Dual solution (size m)
+ * @param  info  Solver information, or OSQP_NULL
+ * @return       Exitflag (0 if no errors)
+ */
+OSQPInt consensus_solve(OSQPConsensus* cons,
+                        OSQPFloat*     x,
+                        OSQPFloat*     y,
+                        OSQPInfo*      info);
+
+/**
+ * Free a consensus solver and its local solvers.
+ * @param  cons  Consensus solver
+ */
+void consensus_free(OSQPConsensus* cons);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef CONSENSUS_H */
@@ -9,6 +9,20 @@
 extern "C" {
 #endif
 
+/**
+ * Allocate the fixed-structure adjoint system used in real-time mode, so that
+ * adjoint_derivative_compute does not allocate
+ * @param  solver Solver
+ * @return        Exitflag (0 if no errors)
+ */
+OSQPInt adjoint_derivative_alloc_system(OSQPSolver* solver);
+
+/**
+ * Free the fixed-structure adjoint system (if allocated)
+ * @param  derivative_data Derivative data
+ */
+void adjoint_derivative_free_system(OSQPDerivativeData* derivative_data);
+
 OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
                                    OSQPCscMatrix* dP,
                                    OSQPCscMatrix* dA);
@@ -0,0 +1,113 @@
+/* Elimination of the equality constraints by substitution of variables */
+#ifndef ELIMINATE_H
+#define ELIMINATE_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Smallest pivot relative to the largest entry of its equality */
+#define ELIMINATE_PIVOT_TOL (0.1)
+
+/* Entries created by the elimination below this fraction of their operands are dropped */
+#define ELIMINATE_DROP_TOL (1e-12)
+
+/* Largest residual of a dependent equality, relative to the right-hand sides */
+#define ELIMINATE_FEAS_TOL (1e-9)
+
+/* Largest ratio of nnz(Pr) + nnz(Ar) to nnz(P) + nnz(A) */
+#define ELIMINATE_MAX_FILL (2)
+
+/**
+ * Eliminate the equality constraints (rows with l == u) of the problem.
+ *
+ * The equality rows are brought to reduced row echelon form by a sparse
+ * Gauss-Jordan elimination with Markowitz pivoting: each independent row
+ * solves for one pivot variable in terms of the others, so x = T x_r + t with
+ * x_r the remaining variables. Pr = T'PT (upper triangular) and Ar = A_I T,
+ * with A_I the inequality rows of A; the reduced q, l and u are in
+ * elim->q_r, elim->l_r and elim->u_r.
+ *
+ * No elimination is done (and *elimp is OSQP_NULL) when there are no
+ * equalities, when they are inconsistent, when they fix every variable, or
+ * when the reduced problem would be denser than ELIMINATE_MAX_FILL times the
+ * original one.
+ *
+ * @param  elimp  Elimination structure, or OSQP_NULL if none is done
+ * @param  P      Quadratic cost matrix (upper triangular)
+ * @param  q      Linear cost
+ * @param  A      Constraint matrix
+ * @param  l      Lower bounds
+ * @param  u      Upper bounds
+ * @param  m      Number of constraints
+ * @param  n      Number of variables
+ * @param  Pr     Reduced P (allocated when *elimp is set)
+ * @param  Ar     Reduced A (allocated when *elimp is set)
+ * @return        Exitflag (0 if no errors)
+ */
+OSQPInt eliminate_new(OSQPEliminate**      elimp,
+                      const OSQPCscMatrix* P,
+                      const OSQPFloat*     q,
+                      const OSQPCscMatrix* A,
+                      const OSQPFloat*     l,
+                      const OSQPFloat*     u,
+                      OSQPInt              m,
+                      OSQPInt              n,
+                      OSQPCscMatrix**      Pr,
+                      OSQPCscMatrix**      Ar);
+
+/**
+ * Bring an update of the user vectors to the reduced problem. A change of
+ * the bounds moves t, so new bounds give all three reduced vectors. Each
+ * pointer that has to be updated is replaced by a pointer into the structure.
+ * @param  e  Elimination structure
+ * @param  q  New q (size n), or OSQP_NULL
+ * @param  l  New l (size m), or OSQP_NULL
+ * @param  u  New u (size m), or OSQP_NULL
+ * @return    Exitflag (0 if no errors), OSQP_DATA_VALIDATION_ERROR if an
+ *            eliminated row stops being an equality
+ */
+OSQPInt eliminate_data_vec(OSQPEliminate*    e,
+                           const OSQPFloat** q,
+                           const OSQPFloat** l,
+                           const OSQPFloat** u);
+
+/**
+ * Restrict user iterates to the reduced problem. Each non-null pointer is
+ * replaced by a pointer into e->fwork, valid until the next call.
+ * @param  e  Elimination structure
+ * @param  x  Primal iterate (size n), or OSQP_NULL
+ * @param  y  Dual iterate (size m), or OSQP_NULL
+ */
+void eliminate_iterates(OSQPEliminate*    e,
+                        const OSQPFloat** x,
+                        const OSQPFloat** y);
+
+/**
+ * Expand the solution and the certificates of the reduced problem, stored at
+ * the start of the solution arrays, to the user problem, in place. The duals
+ * of the equalities solve the stationarity condition of the user problem.
+ * The objective already includes obj_const (see compute_obj_val).
+ * @param  e         Elimination structure
+ * @param  solution  Solution of the reduced problem
+ * @param  info      Solver information
+ */
+void eliminate_solution(OSQPEliminate*  e,
+                        OSQPSolution*   solution,
+                        const OSQPInfo* info);
+
+/**
+ * Free the elimination structure
+ * @param  e  Elimination structure
+ */
+void eliminate_free(OSQPEliminate* e);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef ELIMINATE_H */
@@ -19,6 +19,14 @@ extern "C" {
 #  ifdef OSQP_CUSTOM_MEMORY
 /* Use user-provided memory management functions */
 #    include OSQP_CUSTOM_MEMORY
+#  elif defined(OSQP_ENABLE_MEMORY_PLACEMENT)
+/* Use standard library functions, placing large setup buffers on huge pages/NUMA nodes */
+#   include <stdlib.h>
+#   include "memory_placement.h"
+#   define c_malloc  osqp_placed_malloc
+#   define c_calloc  osqp_placed_calloc
+#   define c_free    osqp_placed_free
+#   define c_realloc osqp_placed_realloc
 #  else
 /* If no custom memory allocator defined, use standard library functions.  */
 #   include <stdlib.h>
@@ -58,9 +66,11 @@ extern "C" {
 #  ifndef OSQP_USE_FLOAT // Doubles
 #   define c_sqrt sqrt
 #   define c_fmod fmod
+#   define c_log log
 #  else          // Floats
 #   define c_sqrt sqrtf
 #   define c_fmod fmodf
+#   define c_log logf
 #  endif /* ifndef OSQP_USE_FLOAT */
 
 # endif // end OSQP_EMBEDDED_MODE
@@ -5,6 +5,8 @@
  * Interface for interrupting the OSQP solver.
  */
 
+#include "osqp_configure.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
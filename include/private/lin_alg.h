@@ -53,8 +53,51 @@ OSQPInt osqp_algebra_init_linsys_solver(LinSysSolver**      s,
                                         OSQPInt             polishing);
 
 
+#ifdef OSQP_ENABLE_THREADS
+/* Analysis of the pattern of the KKT matrix, computed while the values are scaled */
+typedef struct LinSysAnalysis_ LinSysAnalysis;
+
+/**
+ * Analyse the patterns of P and A for the linear system solver of the ADMM
+ * iterations. The values of P and A are not read and may change meanwhile.
+ * @param   a         Analysis, OSQP_NULL if the solver does not use one
+ * @param   P         Objective function matrix
+ * @param   A         Constraint matrix
+ * @param   settings  Solver settings
+ * @return            Exitflag for error (0 if no errors)
+ */
+OSQPInt osqp_algebra_analyse_linsys(LinSysAnalysis**    a,
+                                    const OSQPMatrix*   P,
+                                    const OSQPMatrix*   A,
+                                    const OSQPSettings* settings);
+
+/* Free an analysis of the KKT matrix */
+void osqp_algebra_free_linsys_analysis(LinSysAnalysis* a);
+
+/* osqp_algebra_init_linsys_solver for the ADMM iterations, with the analysis of the patterns (or OSQP_NULL) */
+OSQPInt osqp_algebra_init_linsys_solver_analysed(LinSysSolver**        s,
+                                                 const OSQPMatrix*     P,
+                                                 const OSQPMatrix*     A,
+                                                 const OSQPVectorf*    rho_vec,
+                                                 const OSQPSettings*   settings,
+                                                 OSQPFloat*            scaled_prim_res,
+                                                 OSQPFloat*            scaled_dual_res,
+                                                 const LinSysAnalysis* a);
+#endif
+
+
 #ifdef OSQP_ALGEBRA_BUILTIN
 #ifndef OSQP_EMBEDDED_MODE
+/* Solver of the adjoint system that keeps its structure across calls */
+OSQPInt adjoint_derivative_init_linsys_solver(LinSysSolver**      s,
+                                              const OSQPSettings* settings,
+                                              const OSQPMatrix*   P,
+                                              const OSQPMatrix*   G,
+                                              const OSQPMatrix*   A_eq,
+                                              const OSQPMatrix*   GDiagLambda,
+                                              const OSQPVectorf*  slacks);
+
+/* Solve the adjoint system in place of rhs; *s may be OSQP_NULL */
 OSQPInt adjoint_derivative_linsys_solver(LinSysSolver**      s,
                                          const OSQPSettings* settings,
                                          const OSQPMatrix*   P,
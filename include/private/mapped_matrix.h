@@ -0,0 +1,59 @@
+/* Constraint matrix streamed from a memory-mapped CSC file */
+#ifndef MAPPED_MATRIX_H
+#define MAPPED_MATRIX_H
+
+
+#include "osqp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * File layout, in the byte order of the machine that wrote it. Every array
+ * starts on an 8-byte boundary (the padding bytes are zero).
+ *
+ *   char    magic[8]    "OSQPCSC" followed by a zero byte
+ *   int32   int_size    sizeof(OSQPInt)
+ *   int32   float_size  sizeof(OSQPFloat)
+ *   int64   m, n, nnz   dimensions and number of nonzeros
+ *   OSQPInt p[n+1]      column pointers
+ *   OSQPInt i[nnz]      row indices
+ *   OSQPFloat x[nnz]    values
+ */
+
+/* Default number of bytes of row indices and values read per chunk */
+#define MAPPED_CSC_CHUNK_SIZE (64 * 1024 * 1024)
+
+/**
+ * Write a CSC matrix in the layout above.
+ * @param  M         Matrix
+ * @param  filename  File to write
+ * @return           Exitflag (0 if no errors)
+ */
+OSQPInt mapped_csc_write(const OSQPCscMatrix* M,
+                         const char*          filename);
+
+/**
+ * Map a CSC file as an operator. The whole file is read once to validate the
+ * indices and compute the norm and A'A diagonal estimates of the operator.
+ * @param  op          Operator to fill
+ * @param  filename    File written by mapped_csc_write
+ * @param  chunk_size  Bytes of row indices and values read per chunk (0 for the default)
+ * @return             Exitflag (0 if no errors)
+ */
+OSQPInt mapped_csc_open(OSQPOperator* op,
+                        const char*   filename,
+                        OSQPInt       chunk_size);
+
+/**
+ * Unmap an operator filled by mapped_csc_open and free its estimates.
+ * @param  op  Operator
+ */
+void mapped_csc_close(OSQPOperator* op);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef MAPPED_MATRIX_H */
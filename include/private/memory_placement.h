@@ -0,0 +1,91 @@
+#ifndef MEMORY_PLACEMENT_H_
+#define MEMORY_PLACEMENT_H_
+
+/*
+ * Huge-page and NUMA-aware placement of large solver buffers.
+ *
+ * When the library is built with OSQP_ENABLE_MEMORY_PLACEMENT, c_malloc,
+ * c_calloc, c_realloc and c_free are routed through these functions.
+ * Allocations made while a placement policy is active (i.e. during
+ * osqp_setup) that are at least OSQP_PLACEMENT_MIN_SIZE get pages of their
+ * own, bound according to the policy and zero-filled by the calling thread;
+ * those of at least OSQP_PLACEMENT_HUGE_PAGE_SIZE can also be backed by huge
+ * pages. Every other allocation is forwarded to the standard library.
+ *
+ * The policy can also pre-fault every allocation made while it is active,
+ * whatever its size, and lock it in RAM with mlock, so that later accesses
+ * from a real-time loop never take a page fault. Locked allocations always
+ * get pages of their own (at least one page each), which are unlocked when
+ * the allocation is freed.
+ */
+
+#include <stddef.h>
+
+#include "osqp_configure.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Allocations smaller than this are never placed */
+#define OSQP_PLACEMENT_MIN_SIZE (64 * 1024)
+
+/* Allocations smaller than this are never backed by huge pages; larger ones
+ * are aligned to (and rounded up to a multiple of) this size */
+#define OSQP_PLACEMENT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * Set the placement policy of the calling thread
+ * @param  huge_pages  Boolean; back large allocations with transparent huge pages
+ * @param  numa_node   NUMA node to bind large allocations to, or -1 for first-touch
+ * @param  prefault    Boolean; touch every allocation so its pages are faulted in
+ * @param  lock        Boolean; also lock every allocation in RAM
+ */
+void osqp_placement_begin(int huge_pages,
+                          int numa_node,
+                          int prefault,
+                          int lock);
+
+/**
+ * Reset the placement policy of the calling thread
+ * @return  Nonzero if some allocation could not be locked since the last begin
+ */
+int osqp_placement_end(void);
+
+/**
+ * Allocate memory according to the placement policy of the calling thread
+ * @param  size  Number of bytes
+ * @return       Pointer to the memory, to be released with osqp_placed_free()
+ */
+void* osqp_placed_malloc(size_t size);
+
+/**
+ * Allocate zeroed memory according to the placement policy of the calling thread
+ * @param  num   Number of elements
+ * @param  size  Size of each element
+ * @return       Pointer to the memory, to be released with osqp_placed_free()
+ */
+void* osqp_placed_calloc(size_t num,
+                         size_t size);
+
+/**
+ * Resize memory from the functions above or from the standard library; a
+ * placed buffer is moved to memory placed by the policy of the calling thread
+ * @param  ptr   Memory to resize, or NULL
+ * @param  size  New number of bytes
+ * @return       Pointer to the memory, to be released with osqp_placed_free()
+ */
+void* osqp_placed_realloc(void*  ptr,
+                          size_t size);
+
+/**
+ * Release memory from the functions above or from the standard library
+ * @param  ptr  Memory to release, or NULL
+ */
+void osqp_placed_free(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef MEMORY_PLACEMENT_H_ */
@@ -0,0 +1,44 @@
+/* Block ADMM for several right-hand sides sharing one KKT factorization */
+#ifndef MULTI_RHS_H
+#define MULTI_RHS_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Solve k problems that share P, A and the KKT factorization of the solver
+ * but have their own q, l and u. The iterates of all the problems advance
+ * together, so every linear system solve handles all the unconverged problems
+ * at once. Problems are dropped from the block as soon as they terminate.
+ *
+ * The iterates, data and solution of the solver are left untouched.
+ *
+ * @param  solver OSQP solver
+ * @param  k      Number of problems
+ * @param  q      Linear costs (n x k column-major), or OSQP_NULL to use the solver's q
+ * @param  l      Lower bounds (m x k column-major), or OSQP_NULL to use the solver's l
+ * @param  u      Upper bounds (m x k column-major), or OSQP_NULL to use the solver's u
+ * @param  x      Primal solutions (n x k column-major)
+ * @param  y      Dual solutions (m x k column-major)
+ * @param  info   Solver information of each problem (size k), or OSQP_NULL
+ * @return        Exitflag (0 if no errors)
+ */
+OSQPInt multi_rhs_solve(OSQPSolver*      solver,
+                        OSQPInt          k,
+                        const OSQPFloat* q,
+                        const OSQPFloat* l,
+                        const OSQPFloat* u,
+                        OSQPFloat*       x,
+                        OSQPFloat*       y,
+                        OSQPInfo*        info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef MULTI_RHS_H */
@@ -19,6 +19,30 @@ extern "C" {
  */
 OSQPInt polish(OSQPSolver* solver);
 
+/**
+ * Allocate the vectors of the polishing structure work->pol
+ * @param  work Workspace
+ * @return      Exitflag (0 if no errors)
+ */
+OSQPInt polish_alloc(OSQPWorkspace* work);
+
+/**
+ * Preallocate the reduced KKT system and the workspace of polishing, so that
+ * polish() does not allocate (real-time mode). With polish_in_place and a
+ * linear system solver that supports it, the ADMM solver is used instead of
+ * a reduced KKT system; otherwise nothing is done outside real-time mode.
+ * @param  solver OSQP solver
+ * @return        Exitflag (0 if no errors)
+ */
+OSQPInt polish_alloc_system(OSQPSolver* solver);
+
+/**
+ * Free the vectors of the polishing structure work->pol, and its reduced
+ * system if it was preallocated
+ * @param  work Workspace
+ */
+void polish_free(OSQPWorkspace* work);
+
 #ifdef __cplusplus
 }
 #endif
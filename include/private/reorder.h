@@ -0,0 +1,108 @@
+/* Internal ordering of the variables and constraints */
+#ifndef REORDER_H
+#define REORDER_H
+
+
+#include "osqp.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compute the internal ordering of the variables and constraints and permute
+ * P and A into it.
+ *
+ * With settings->reorder = OSQP_RCM_REORDER, the ordering is a reverse
+ * Cuthill-McKee ordering of the graph of the KKT matrix, whose nodes are the
+ * variables and the constraints. Nearby variables and constraints then have
+ * nearby indices, which narrows the band of P and A and keeps the vector
+ * entries touched by a column of P or A close in memory.
+ *
+ * With settings->group_constraints and settings->rho_is_vec, the constraints
+ * are then stably grouped into equalities, inequalities and loose
+ * constraints, so that rho is constant on each of the three segments.
+ *
+ * The rows of each column of Pr and Ar are sorted, and Pr is upper triangular.
+ *
+ * @param  P        Quadratic cost matrix (upper triangular)
+ * @param  A        Constraint matrix
+ * @param  l        Lower bounds
+ * @param  u        Upper bounds
+ * @param  settings Solver settings
+ * @param  Pr       Permuted P (allocated)
+ * @param  Ar       Permuted A (allocated)
+ * @return          Ordering structure, OSQP_NULL if out of memory
+ */
+OSQPReorder* reorder_new(const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         const OSQPFloat*     l,
+                         const OSQPFloat*     u,
+                         const OSQPSettings*  settings,
+                         OSQPCscMatrix**      Pr,
+                         OSQPCscMatrix**      Ar);
+
+/**
+ * Check that the constraint types still follow the grouping of reorder_new,
+ * i.e. that the scaled bounds gave every constraint the type of its segment.
+ * @param  r           Ordering structure
+ * @param  constr_type Constraint types, as set by set_rho_vec
+ * @return             1 if the segments are valid, 0 otherwise
+ */
+OSQPInt reorder_check_segments(OSQPReorder*       r,
+                               const OSQPVectori* constr_type);
+
+/**
+ * Free the ordering structure
+ * @param  r Ordering structure
+ */
+void reorder_free(OSQPReorder* r);
+
+/**
+ * Bring vectors of user data into the internal order. Each non-null pointer
+ * is replaced by a pointer into r->fwork, which stays valid until the next
+ * call of a reorder function.
+ * @param  r Ordering structure
+ * @param  q Vector of size n (q or x), or OSQP_NULL
+ * @param  l Vector of size m (l or y), or OSQP_NULL
+ * @param  u Vector of size m, or OSQP_NULL
+ */
+void reorder_data_vec(OSQPReorder*      r,
+                      const OSQPFloat** q,
+                      const OSQPFloat** l,
+                      const OSQPFloat** u);
+
+/**
+ * Bring an update of the values of P and A into the internal order. Index
+ * vectors are translated to the internal positions; values given without
+ * indices are scattered to their internal positions.
+ * @param  r      Ordering structure
+ * @param  Px     New values of P, or OSQP_NULL
+ * @param  Px_idx Indices of the new values of P, or OSQP_NULL
+ * @param  P_n    Number of new values of P
+ * @param  Ax     New values of A, or OSQP_NULL
+ * @param  Ax_idx Indices of the new values of A, or OSQP_NULL
+ * @param  A_n    Number of new values of A
+ */
+void reorder_data_mat(OSQPReorder*      r,
+                      const OSQPFloat** Px,
+                      const OSQPInt**   Px_idx,
+                      OSQPInt           P_n,
+                      const OSQPFloat** Ax,
+                      const OSQPInt**   Ax_idx,
+                      OSQPInt           A_n);
+
+/**
+ * Bring the solution and the certificates back into the user order, in place
+ * @param  r        Ordering structure
+ * @param  solution Solution in the internal order
+ */
+void reorder_solution(OSQPReorder*  r,
+                      OSQPSolution* solution);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef REORDER_H */
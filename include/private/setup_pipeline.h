@@ -0,0 +1,81 @@
+/* Stages of the setup that only read the patterns of P and A, run on helper threads */
+#ifndef SETUP_PIPELINE_H
+#define SETUP_PIPELINE_H
+
+
+#include "osqp.h"
+#include "types.h"
+#include "lin_alg.h"
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Stages of the setup that depend only on the sparsity patterns of P and A.
+ * The values of P and A are scaled on the calling thread while they run.
+ */
+enum setup_stage {
+  SETUP_STAGE_ANALYSE_KKT = 0,  ///< ordering, elimination tree and column counts of the KKT matrix
+  SETUP_STAGE_COMPRESS_P,       ///< compressed row indices of P
+  SETUP_STAGE_COMPRESS_A,       ///< compressed row indices of A
+  SETUP_STAGES
+};
+
+/**
+ * Pipeline of the setup. The stages are taken in order by the helper threads
+ * and, once it has scaled the data, by the calling thread, which then waits
+ * for the stages still running before it factors the KKT matrix. The helper
+ * threads place their allocations with the placement policy of the settings.
+ */
+struct OSQPSetupPipeline_ {
+  OSQPMatrix*     P;                     ///< P of the workspace; the stages only read its pattern
+  OSQPMatrix*     A;                     ///< A of the workspace; the stages only read its pattern
+  OSQPSettings    settings;              ///< copy of the settings of the setup
+  OSQPInt         run[SETUP_STAGES];     ///< the stage is part of this setup
+  OSQPInt         status[SETUP_STAGES];  ///< exitflag of each stage
+  OSQPInt         next;                  ///< next stage to take
+  OSQPInt         finished;              ///< the helper threads are joined
+  OSQPInt         unlocked;              ///< some allocation of a helper thread could not be locked in RAM
+  LinSysAnalysis* analysis;              ///< analysis of the KKT matrix, OSQP_NULL if none
+
+  OSQPInt         nthreads;              ///< number of helper threads started
+  pthread_t*      threads;               ///< helper threads
+  pthread_mutex_t lock;                  ///< protects next and unlocked
+};
+
+/**
+ * Start the helper threads on the stages needed by a setup, setup_threads - 1
+ * of them at most. The threads that cannot be started leave their stages to
+ * setup_pipeline_finish.
+ * @param  plp       Pipeline, OSQP_NULL on failure
+ * @param  work      Workspace with the data of the problem
+ * @param  settings  Settings of the setup
+ * @return           Exitflag (0 if no errors)
+ */
+OSQPInt setup_pipeline_start(OSQPSetupPipeline**  plp,
+                             OSQPWorkspace*       work,
+                             const OSQPSettings*  settings);
+
+/**
+ * Run the stages no helper thread has taken and wait for the others
+ * @param  pl        Pipeline
+ * @param  analysis  Analysis of the KKT matrix, owned by the pipeline (OSQP_NULL if none)
+ * @return           Exitflag (0 if no errors)
+ */
+OSQPInt setup_pipeline_finish(OSQPSetupPipeline* pl,
+                              LinSysAnalysis**   analysis);
+
+/**
+ * Wait for the helper threads if needed and free the pipeline
+ * @param  pl  Pipeline
+ */
+void setup_pipeline_free(OSQPSetupPipeline* pl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ifndef SETUP_PIPELINE_H */
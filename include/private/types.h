@@ -26,6 +26,16 @@ typedef struct linsys_solver LinSysSolver;
  */
 typedef struct OSQPTimer_ OSQPTimer;
 
+/**
+ * Termination checks run on a helper thread (see async_check.h)
+ */
+typedef struct OSQPAsyncCheck_ OSQPAsyncCheck;
+
+/**
+ * Stages of the setup run on helper threads (see setup_pipeline.h)
+ */
+typedef struct OSQPSetupPipeline_ OSQPSetupPipeline;
+
 /**
  * Problem scaling matrices stored as vectors
  */
@@ -57,7 +67,112 @@ typedef struct {
   OSQPFloat    obj_val;       ///< objective value at polished solution
   OSQPFloat    prim_res;      ///< primal residual at polished solution
   OSQPFloat    dual_res;      ///< dual residual at polished solution
+
+  /**
+   * @name Reduced KKT system kept from setup (real-time mode or polish_in_place)
+   * Ared then keeps all the rows of A, with the inactive ones zeroed, so the
+   * system has a fixed pattern and is refactored in place. With in_place,
+   * plsh is the ADMM solver, which zeroes the rows in its own KKT matrix, and
+   * there is no Ared.
+   * @{
+   */
+  OSQPInt       in_place;     ///< plsh is the ADMM solver (see polish_factor)
+  LinSysSolver* plsh;         ///< linear system solver of the reduced KKT system
+  OSQPVectorf*  row_mask;     ///< 1 for active and 0 for inactive rows of A
+  OSQPVectorf*  rhs_red;      ///< reduced right-hand side (size n+m)
+  OSQPVectorf*  sol;          ///< polished solution (size n+m)
+  OSQPVectorf*  sol_x;        ///< view into the x part of sol
+  OSQPVectorf*  sol_y;        ///< view into the y part of sol
+  OSQPVectorf*  ref;          ///< iterative refinement right-hand side (size n+m)
+  OSQPVectorf*  ref_x;        ///< view into the x part of ref
+  OSQPVectorf*  ref_y;        ///< view into the y part of ref
+  OSQPInt*      iwork;        ///< raw workspace (size m)
+  OSQPFloat*    fwork;        ///< raw workspace (size 2n+4m)
+  /** @} */
 } OSQPPolish;
+
+/**
+ * Internal ordering of the variables and constraints
+ *
+ * The solver works on P(xperm, xperm), A(yperm, xperm), q(xperm), l(yperm)
+ * and u(yperm); the user data and the solution are translated at the API.
+ */
+typedef struct {
+  OSQPInt    n;      ///< number of variables
+  OSQPInt    m;      ///< number of constraints
+  OSQPInt    nnzP;   ///< number of nonzeros in P
+  OSQPInt    nnzA;   ///< number of nonzeros in A
+  OSQPInt*   xperm;  ///< user index of each internal variable (size n)
+  OSQPInt*   yperm;  ///< user index of each internal constraint (size m)
+  OSQPInt*   Pmap;   ///< internal position of each user entry of P (size nnzP)
+  OSQPInt*   Amap;   ///< internal position of each user entry of A (size nnzA)
+  OSQPInt*   iwork;  ///< translated update indices (size max(nnzP + nnzA, m))
+  OSQPFloat* fwork;  ///< permuted data (size max(n + 2m, nnzP + nnzA))
+
+  /**
+   * @name Constraint segments (group_constraints)
+   * With grouped set, the constraints are ordered as [equalities, inequalities,
+   * loose constraints], and segmented says whether the current constraint
+   * types still follow that layout.
+   * @{
+   */
+  OSQPInt      grouped;    ///< constraints are grouped by type
+  OSQPInt      segmented;  ///< rho_vec operations run per segment
+  OSQPInt      n_eq;       ///< number of equality constraints
+  OSQPInt      n_ineq;     ///< number of inequality constraints
+  OSQPVectorf* view[4];    ///< views used by the segment kernels
+  /** @} */
+} OSQPReorder;
+
+/**
+ * Elimination of the equality constraints
+ *
+ * Each independent equality solves for one pivot variable, so that
+ * x = T x_r + t with x_r the remaining variables. The solver works on
+ *
+ *   minimize   1/2 x_r'(T'PT)x_r + (T'(Pt + q))'x_r
+ *   subject to l_I - A_I t <= A_I T x_r <= u_I - A_I t
+ *
+ * with I the inequality rows; the user data and the solution are translated
+ * at the API.
+ */
+typedef struct {
+  OSQPInt        n;          ///< number of user variables
+  OSQPInt        m;          ///< number of user constraints
+  OSQPInt        n_r;        ///< number of remaining variables
+  OSQPInt        m_r;        ///< number of inequality constraints
+  OSQPInt        n_eq;       ///< number of equality constraints
+  OSQPInt*       free_var;   ///< user index of each remaining variable (size n_r)
+  OSQPInt*       ineq_row;   ///< user index of each inequality (size m_r)
+  OSQPInt*       eq_row;     ///< user index of each equality (size n_eq)
+  OSQPInt*       pivot;      ///< variable solved for by each equality, -1 if dependent (size n_eq)
+
+  /**
+   * @name Elimination steps
+   * Step k subtracts op_val[k] times equality op_src[k] from equality
+   * op_row[k], or scales it by op_val[k] when op_src[k] == op_row[k].
+   * @{
+   */
+  OSQPInt        n_ops;
+  OSQPInt*       op_row;
+  OSQPInt*       op_src;
+  OSQPFloat*     op_val;
+  /** @} */
+
+  OSQPCscMatrix* T;          ///< substitution matrix (size n x n_r)
+  OSQPCscMatrix* Tt;         ///< transpose of T
+  OSQPCscMatrix* P;          ///< copy of P (upper triangular)
+  OSQPCscMatrix* A_ineq;     ///< inequality rows of A
+  OSQPFloat*     q;          ///< user q (size n)
+  OSQPFloat*     l;          ///< user l (size m)
+  OSQPFloat*     u;          ///< user u (size m)
+  OSQPFloat*     t;          ///< particular solution of the equalities (size n)
+  OSQPFloat      obj_const;  ///< objective at x_r = 0
+  OSQPFloat*     q_r;        ///< reduced q (size n_r)
+  OSQPFloat*     l_r;        ///< reduced l (size m_r)
+  OSQPFloat*     u_r;        ///< reduced u (size m_r)
+  OSQPFloat*     fwork;      ///< workspace (size 2n + m)
+} OSQPEliminate;
 # endif // ifndef OSQP_EMBEDDED_MODE
 
 
@@ -87,7 +202,25 @@ typedef struct {
     OSQPVectorf *ryl;  ///< for internal use, size m
     OSQPVectorf *ryu;  ///< for internal use, size m
     OSQPVectorf *rhs;  ///< rhs of linear system to solve for derivatives; length 2*(n + n_ineq_l + n_ineq_u + n_eq)
-                       ///< conservatively allocated with length 2(n + 2m) in `osqp_setup`
+                       ///< conservatively allocated with length 2(n + 2m) in `osqp_setup`,
+                       ///< or 2(n + 3m) in real-time mode
+
+    // Adjoint system with a fixed structure kept from setup (real-time mode only).
+    // Every constraint has a lower, an upper and an equality slot; the rows of
+    // slots that do not apply are zeroed so that they decouple from the system.
+    LinSysSolver *adj_solver;  ///< solver of the adjoint system
+    OSQPMatrix   *P_full;      ///< full P, unscaled
+    OSQPMatrix   *G;           ///< [-A; A] with the rows of absent bounds zeroed, unscaled (size 2m x n)
+    OSQPMatrix   *A_eq;        ///< A with the rows of inequalities zeroed, unscaled
+    OSQPMatrix   *GDiagLambda; ///< diag(lambda) * G
+    OSQPVectorf  *slacks;      ///< slacks of the rows of G, size 2m
+    OSQPVectorf  *lambda;      ///< dual variables of the rows of G, size 2m
+    OSQPVectorf  *G_scale;     ///< row scaling and mask of G, size 2m
+    OSQPVectorf  *eq_scale;    ///< row scaling and mask of A_eq, size m
+    OSQPVectorf  *x;           ///< primal solution, size n
+    OSQPInt      *ctype;       ///< slots used by each constraint, size m
+    OSQPInt      *iwork;       ///< column cursors, size n
+    OSQPFloat    *fwork;       ///< matrix values, size max(nnz(P_full), nnz(G))
 } OSQPDerivativeData;
 
 /**
@@ -104,6 +237,48 @@ struct OSQPWorkspace_ {
 # ifndef OSQP_EMBEDDED_MODE
   /// Polish structure
   OSQPPolish* pol;
+
+  /// Internal ordering (OSQP_NULL if the user ordering is kept)
+  OSQPReorder* reorder;
+
+  /// Eliminated equality constraints (OSQP_NULL if none)
+  OSQPEliminate* elim;
+
+  /// P and A were given as operators, their entries are not known
+  OSQPInt matrix_free;
+
+  /**
+   * @name Progress of the residuals over the termination checks of a solve
+   * @{
+   */
+  OSQPFloat    stall_ref;   ///< residual ratio of the last check that made progress
+  OSQPInt      stall_count; ///< termination checks since then
+  OSQPVectorf* best_x;      ///< iterate with the smallest residual ratio (best_iterate only)
+  OSQPVectorf* best_z;
+  OSQPVectorf* best_y;
+  OSQPFloat    best_ratio;  ///< residual ratio of the best iterate
+  OSQPInt      best_iter;   ///< iteration of the best iterate
+
+  /** @} */
+
+  /**
+   * @name Cost of the rho updates (adaptive_rho_cost_model only)
+   * @{
+   */
+  OSQPFloat rho_refactor_time;  ///< time of the last rho update of a solve, 0 until one is measured
+  OSQPFloat rho_refactor_total; ///< time of the rho updates of this solve
+  OSQPFloat rho_trend_ratio;    ///< residual ratio at the previous adaptation of rho
+  OSQPInt   rho_trend_iter;     ///< iteration of the previous adaptation of rho, 0 if none
+
+  /** @} */
+
+#  ifdef OSQP_ENABLE_THREADS
+  /// Termination checks on a helper thread (async_termination only)
+  OSQPAsyncCheck* async;
+
+  /// Stages of the setup on helper threads, only during setup (setup_threads > 1)
+  OSQPSetupPipeline* pipeline;
+#  endif
 # endif // ifndef OSQP_EMBEDDED_MODE
 
   /**
@@ -241,6 +416,41 @@ struct linsys_solver {
   OSQPInt (*adjoint_derivative)(LinSysSolver* self);
 
   void (*free)(LinSysSolver* self);         ///< free linear system solver (only in desktop version)
+
+  /**
+   * Solve the ADMM KKT system for k right-hand sides at once (optional).
+   * Each b[j] is overwritten as by solve. Solvers that set this to OSQP_NULL
+   * are called once per right-hand side instead.
+   */
+  OSQPInt (*solve_block)(LinSysSolver* self,
+                         OSQPVectorf** b,
+                         OSQPInt       k,
+                         OSQPInt       admm_iter);
+
+  /**
+   * Factor the polishing system on the pattern of the ADMM KKT matrix
+   * (optional). With active_flags, the rows of the inactive constraints
+   * (flag 0) are decoupled and solve returns the solution of the polishing
+   * system until this is called again with OSQP_NULL. The ADMM factorization
+   * is kept. Solvers that set this to OSQP_NULL polish with a reduced system.
+   */
+  OSQPInt (*polish_factor)(LinSysSolver*      self,
+                           const OSQPVectori* active_flags);
+
+  /**
+   * Update P, A and rho_vec with a single factorization (optional). Solvers
+   * that set this to OSQP_NULL are updated by update_matrices and then
+   * update_rho_vec.
+   */
+  OSQPInt (*update_matrices_rho_vec)(LinSysSolver*      self,
+                                     const OSQPMatrix*  P,
+                                     const OSQPInt*     Px_new_idx,
+                                     OSQPInt            P_new_n,
+                                     const OSQPMatrix*  A,
+                                     const OSQPInt*     Ax_new_idx,
+                                     OSQPInt            A_new_n,
+                                     const OSQPVectorf* rho_vec,
+                                     OSQPFloat          rho_sc);
 # endif // ifndef OSQP_EMBEDDED_MODE
 
 # if OSQP_EMBEDDED_MODE != 1
@@ -0,0 +1,131 @@
+#ifndef OSQP_HPP
+#define OSQP_HPP
+
+/*
+ * Templated C++ interface to OSQP.
+ *
+ * A library built with OSQP_BUILD_CXX_API provides osqp::Solver<Float, Int>
+ * for its own OSQPFloat and for the fixed-width integer of the size of its
+ * OSQPInt. Libraries built with different precisions and different
+ * OSQP_SYMBOL_PREFIX values can be linked into the same program, e.g. to use
+ * osqp::Solver<float, std::int32_t> and osqp::Solver<double, std::int64_t>
+ * side by side. This header does not include the C headers for that reason.
+ */
+
+#include <cstdint>
+#include <memory>
+
+namespace osqp {
+
+/**
+ * Matrix in compressed-column form referencing caller-owned arrays
+ * (see OSQPCscMatrix).
+ */
+template <typename Float, typename Int>
+struct CscMatrix {
+  Int          m; ///< number of rows
+  Int          n; ///< number of columns
+  const Int*   p; ///< column pointers (size n+1)
+  const Int*   i; ///< row indices (size p[n])
+  const Float* x; ///< numerical values (size p[n])
+};
+
+/**
+ * Solver settings (see OSQPSettings for the meaning of each field).
+ * Settings not listed here keep their default values.
+ */
+template <typename Float, typename Int>
+struct Settings {
+  Int   verbose;
+  Int   warm_starting;
+  Int   scaling;
+  Int   polishing;
+  Float rho;
+  Int   rho_is_vec;
+  Float sigma;
+  Float alpha;
+  Int   adaptive_rho;
+  Int   max_iter;
+  Float eps_abs;
+  Float eps_rel;
+  Float eps_prim_inf;
+  Float eps_dual_inf;
+  Int   scaled_termination;
+  Int   check_termination;
+  Float time_limit;
+  Float delta;
+  Int   polish_refine_iter;
+};
+
+/**
+ * OSQP solver for one precision. All functions returning Int return the
+ * exit flag of the corresponding C function (0 on success).
+ */
+template <typename Float, typename Int>
+class Solver {
+public:
+  typedef osqp::CscMatrix<Float, Int> CscMatrix;
+  typedef osqp::Settings<Float, Int>  Settings;
+
+  /**
+   * Default settings, as set by osqp_set_default_settings.
+   */
+  static Settings default_settings();
+
+  Solver();
+  ~Solver();
+
+  Solver(Solver&& other) noexcept;
+  Solver& operator=(Solver&& other) noexcept;
+
+  Solver(const Solver&) = delete;
+  Solver& operator=(const Solver&) = delete;
+
+  /**
+   * Set up the solver (see osqp_setup); any previous problem is released.
+   * @param  P         Quadratic cost (upper triangular part)
+   * @param  q         Linear cost (size n)
+   * @param  A         Constraint matrix
+   * @param  l         Lower bounds (size m)
+   * @param  u         Upper bounds (size m)
+   * @param  settings  Solver settings
+   */
+  Int setup(const CscMatrix& P,
+            const Float*     q,
+            const CscMatrix& A,
+            const Float*     l,
+            const Float*     u,
+            const Settings&  settings);
+
+  Int  solve();
+  Int  update_data_vec(const Float* q_new,
+                       const Float* l_new,
+                       const Float* u_new);
+  Int  update_settings(const Settings& settings);
+  Int  update_rho(Float rho_new);
+  Int  warm_start(const Float* x,
+                  const Float* y);
+  void cold_start();
+
+  /* Problem dimensions, or 0 before setup */
+  Int n() const;
+  Int m() const;
+
+  /* Solution and information of the last solve (see OSQPSolution and OSQPInfo) */
+  const Float* x() const;
+  const Float* y() const;
+  const char*  status() const;
+  Int          status_val() const;
+  Int          iter() const;
+  Float        obj_val() const;
+  Float        prim_res() const;
+  Float        dual_res() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace osqp
+
+#endif /* ifndef OSQP_HPP */
@@ -18,7 +18,11 @@ enum osqp_capabilities_type {
     OSQP_CAPABILITY_INDIRECT_SOLVER = 0x02,    /**<< An indirect linear solver is present in the algebra. */
     OSQP_CAPABILITY_CODEGEN         = 0x04,    /**<< Code generation is present. */
     OSQP_CAPABILITY_UPDATE_MATRICES = 0x08,    /**<< The problem matrices can be updated. */
-    OSQP_CAPABILITY_DERIVATIVES     = 0x10     /**<< Solution derivatives w.r.t P/q/A/l/u are available. */
+    OSQP_CAPABILITY_DERIVATIVES     = 0x10,    /**<< Solution derivatives w.r.t P/q/A/l/u are available. */
+    OSQP_CAPABILITY_HYBRID_SOLVER   = 0x20,    /**<< A hybrid (CG, then direct) linear solver is present in the algebra. */
+    OSQP_CAPABILITY_OPERATORS       = 0x40,    /**<< P and A can be given as operators (osqp_setup_operators). */
+    OSQP_CAPABILITY_OUT_OF_CORE     = 0x80,    /**<< Matrices can be streamed from memory-mapped files (osqp_operator_map_file). */
+    OSQP_CAPABILITY_MKL_PARDISO     = 0x100    /**<< MKL Pardiso can be loaded at runtime as the direct solver (linsys_library). */
 };
 
 
@@ -36,7 +40,8 @@ enum osqp_status_type {
     OSQP_TIME_LIMIT_REACHED,
     OSQP_NON_CVX,               /* problem non-convex */
     OSQP_SIGINT,                /* interrupted by user */
-    OSQP_UNSOLVED               /* Unsolved; only setup function has been called */
+    OSQP_UNSOLVED,              /* Unsolved; only setup function has been called */
+    OSQP_STALLED                /* residuals stopped decreasing (see stall_checks) */
 };
 extern const char * OSQP_STATUS_MESSAGE[];
 
@@ -58,8 +63,18 @@ enum osqp_linsys_solver_type {
     OSQP_UNKNOWN_SOLVER = 0,    /* Start from 0 for unknown solver because we index an array*/
     OSQP_DIRECT_SOLVER,
     OSQP_INDIRECT_SOLVER,
+    OSQP_HYBRID_SOLVER,         /* CG until the direct factorization is available */
+    OSQP_AUTO_SOLVER,           /* Chosen by the algebra for each problem at setup */
 };
 
+/**********************************
+* Linear system solver libraries *
+**********************************/
+typedef enum {
+    OSQP_ALGEBRA_LINSYS = 0,         /* Solvers of the algebra backend */
+    OSQP_MKL_PARDISO_LINSYS,         /* MKL Pardiso loaded at runtime as the direct solver (builtin algebra) */
+} osqp_linsys_library_type;
+
 /*********************************
 * Preconditioners for CG method *
 *********************************/
@@ -68,6 +83,14 @@ typedef enum {
     OSQP_DIAGONAL_PRECONDITIONER,    /* Diagonal (Jacobi) preconditioner */
 } osqp_precond_type;
 
+/*****************************************
+* Orderings of variables and constraints *
+*****************************************/
+typedef enum {
+    OSQP_NO_REORDER = 0,             /* Keep the order of the user data */
+    OSQP_RCM_REORDER,                /* Reverse Cuthill-McKee on the graph of P and A */
+} osqp_reorder_type;
+
 /******************
 * Solver Errors  *
 ******************/
@@ -151,6 +174,32 @@ extern const char * OSQP_ERROR_MESSAGE[];
 
 #  define OSQP_DELTA                (1E-6)
 #  define OSQP_POLISH_REFINE_ITER   (3)
+#  define OSQP_POLISH_IN_PLACE      (0)
+
+# define OSQP_LEAN_MEMORY           (0)
+# define OSQP_HUGE_PAGES            (0)
+# define OSQP_NUMA_NODE             (-1)
+
+# define OSQP_REALTIME              (0)
+# define OSQP_LOCK_MEMORY           (0)
+
+# define OSQP_REORDER               (OSQP_NO_REORDER)
+# define OSQP_GROUP_CONSTRAINTS     (0)
+# define OSQP_COMPRESS_INDICES      (0)
+# define OSQP_ELIMINATE_EQUALITIES  (0)
+
+# define OSQP_STALL_CHECKS          (0)
+# define OSQP_BEST_ITERATE          (0)
+
+# define OSQP_SUPERNODAL            (0)
+
+# define OSQP_ASYNC_TERMINATION     (0)
+
+# define OSQP_SETUP_THREADS         (1)
+
+# define OSQP_ADAPTIVE_RHO_COST_MODEL (0)
+
+# define OSQP_LINSYS_LIBRARY        (OSQP_ALGEBRA_LINSYS)
 
 
 /*********************************
@@ -187,5 +236,7 @@ extern const char * OSQP_ERROR_MESSAGE[];
 # define OSQP_CG_TOL_MIN    (1E-7)
 # define OSQP_CG_POLISH_TOL (1e-5)
 
+# define OSQP_STALL_DECREASE (0.9) ///< residual decrease that counts as progress in stall_checks
+
 
 #endif /* ifndef OSQP_API_CONSTANTS_H */
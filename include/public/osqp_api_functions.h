@@ -90,6 +90,85 @@ OSQP_API OSQPInt osqp_setup(OSQPSolver**         solverp,
                             OSQPInt              n,
                             const OSQPSettings*  settings);
 
+/**
+ * Initialize OSQP solver for a problem whose P and A are given as operators.
+ *
+ * The solver only uses the products of P and A, so the linear systems are
+ * solved by a preconditioned CG on the reduced KKT system whatever
+ * linsys_solver is set to. The scaling equilibrates the norm estimates of the
+ * operators and is applied to them as diagonal scalings around the products;
+ * without estimates, the corresponding rows and columns are not scaled.
+ *
+ * Polishing, reorder, group_constraints, the matrix updates, the derivatives
+ * and code generation need the entries of P and A and are not available.
+ * The operators and their data must stay valid until the solver is cleaned up.
+ * Requires an algebra with OSQP_CAPABILITY_OPERATORS.
+ *
+ * @param  solverp   Solver pointer
+ * @param  P         Problem data (quadratic cost term, n x n operator)
+ * @param  q         Problem data (linear cost term)
+ * @param  A         Problem data (constraint matrix, m x n operator)
+ * @param  l         Problem data (constraint lower bound)
+ * @param  u         Problem data (constraint upper bound)
+ * @param  m         Problem data (number of constraints)
+ * @param  n         Problem data (number of variables)
+ * @param  settings  Solver settings
+ * @return           Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_setup_operators(OSQPSolver**        solverp,
+                                      const OSQPOperator* P,
+                                      const OSQPFloat*    q,
+                                      const OSQPOperator* A,
+                                      const OSQPFloat*    l,
+                                      const OSQPFloat*    u,
+                                      OSQPInt             m,
+                                      OSQPInt             n,
+                                      const OSQPSettings* settings);
+
+/**
+ * Write a CSC matrix to a file that osqp_operator_map_file can stream from.
+ *
+ * The file starts with a 40-byte header (the 8 bytes "OSQPCSC\0", the sizes
+ * of OSQPInt and OSQPFloat as 32-bit integers, then m, n and nnz as 64-bit
+ * integers), followed by the arrays p, i and x of the matrix, each padded to
+ * a multiple of 8 bytes, all in the byte order of the machine. Matrices too
+ * large to build in memory can be written in this layout directly.
+ * Requires OSQP_CAPABILITY_OUT_OF_CORE.
+ *
+ * @param  M         Matrix
+ * @param  filename  File to write
+ * @return           Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_csc_write_file(const OSQPCscMatrix* M,
+                                     const char*          filename);
+
+/**
+ * Memory-map a matrix file as an operator for osqp_setup_operators.
+ *
+ * The products stream over the file in chunks: the next chunk is read ahead
+ * while the current one is used, and the finished ones are released, so the
+ * matrix does not have to fit in memory. The file is read once here to check
+ * it and to compute the norm and A'A diagonal estimates of the operator, which
+ * are the only parts of the matrix kept in memory. Meant for the constraint
+ * matrix A, since the products of P have to be symmetric.
+ * Requires OSQP_CAPABILITY_OUT_OF_CORE.
+ *
+ * @param  op          Operator to fill
+ * @param  filename    File written by osqp_csc_write_file
+ * @param  chunk_size  Bytes of row indices and values per chunk (0 for 64 MiB)
+ * @return             Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_operator_map_file(OSQPOperator* op,
+                                        const char*   filename,
+                                        OSQPInt       chunk_size);
+
+/**
+ * Unmap an operator filled by osqp_operator_map_file, once the solvers using
+ * it are cleaned up.
+ * @param  op  Operator
+ */
+OSQP_API void osqp_operator_unmap_file(OSQPOperator* op);
+
 # endif /* ifndef OSQP_EMBEDDED_MODE */
 
 /**
@@ -113,6 +192,106 @@ OSQP_API OSQPInt osqp_solve(OSQPSolver* solver);
 
 # ifndef OSQP_EMBEDDED_MODE
 
+/**
+ * Solve k quadratic programs that share P and A with the solver but have
+ * their own q, l and u
+ *
+ * The k problems are solved together by a block ADMM: every iteration solves
+ * the KKT system of all the unconverged problems with one pass over the
+ * factorization, and each problem leaves the block as soon as it terminates.
+ * The factorization, rho and the other settings of the solver are used for
+ * all the problems, except that adaptive rho and polishing are not performed.
+ * The iterates start from the solver's iterates if warm starting is enabled,
+ * and from zero otherwise.
+ *
+ * The data, iterates, information and solution of the solver are not
+ * modified. Infeasibility certificates are not returned.
+ *
+ * @param  solver Solver
+ * @param  k      Number of problems
+ * @param  q      Linear costs (n x k, column-major), or NULL to use the solver's q for all
+ * @param  l      Lower bounds (m x k, column-major), or NULL to use the solver's l for all
+ * @param  u      Upper bounds (m x k, column-major), or NULL to use the solver's u for all
+ * @param  x      Primal solutions (n x k, column-major)
+ * @param  y      Dual solutions (m x k, column-major)
+ * @param  info   Information of each solve (size k), or NULL
+ * @return        Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_solve_multi(OSQPSolver*      solver,
+                                  OSQPInt          k,
+                                  const OSQPFloat* q,
+                                  const OSQPFloat* l,
+                                  const OSQPFloat* u,
+                                  OSQPFloat*       x,
+                                  OSQPFloat*       y,
+                                  OSQPInfo*        info);
+
+/**
+ * Initialize a consensus solver for problems whose constraints split into
+ * blocks of rows, e.g. stochastic programs or network flows
+ *
+ * The rows of A are split into K contiguous blocks, each with its own solver
+ * and KKT factorization of the variables and the rows of the block only. The
+ * blocks agree on x through a consensus ADMM: every iteration solves the
+ * blocks in parallel (one thread each when the library is built with
+ * OSQP_ENABLE_THREADS) and averages their solutions. The consensus penalty
+ * starts at settings->rho and is balanced with the residuals when
+ * settings->adaptive_rho is set; max_iter, eps_abs, eps_rel and time_limit
+ * apply to the consensus iterations. Polishing is not performed.
+ *
+ * The consensus solver is allocated in \a consp; call
+ * osqp_consensus_cleanup() on it even when the setup fails.
+ *
+ * @param  consp      Pointer to the consensus solver
+ * @param  P          Problem data (upper triangular part of quadratic cost term, csc format)
+ * @param  q          Problem data (linear cost term)
+ * @param  A          Problem data (constraint matrix, csc format)
+ * @param  l          Problem data (constraint lower bound)
+ * @param  u          Problem data (constraint upper bound)
+ * @param  m          Problem data (number of constraints)
+ * @param  n          Problem data (number of variables)
+ * @param  K          Number of blocks
+ * @param  row_start  First row of each block, followed by m (size K+1), or NULL for blocks of equal size
+ * @param  settings   Solver settings
+ * @return            Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_consensus_setup(OSQPConsensus**      consp,
+                                      const OSQPCscMatrix* P,
+                                      const OSQPFloat*     q,
+                                      const OSQPCscMatrix* A,
+                                      const OSQPFloat*     l,
+                                      const OSQPFloat*     u,
+                                      OSQPInt              m,
+                                      OSQPInt              n,
+                                      OSQPInt              K,
+                                      const OSQPInt*       row_start,
+                                      const OSQPSettings*  settings);
+
+/**
+ * Solve the problem of a consensus solver
+ *
+ * A new solve starts from the consensus iterate and the local solutions of
+ * the previous one. If the rows of a block are infeasible on their own, the
+ * problem is reported primal infeasible and x and y are set to NaN.
+ *
+ * @param  cons  Consensus solver
+ * @param  x     Primal solution (size n)
+ * @param  y     Dual solution (size m)
+ * @param  info  Solver information, or NULL
+ * @return       Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_consensus_solve(OSQPConsensus* cons,
+                                      OSQPFloat*     x,
+                                      OSQPFloat*     y,
+                                      OSQPInfo*      info);
+
+/**
+ * Cleanup a consensus solver and the solvers of its blocks
+ * @param  cons  Consensus solver
+ * @return       Exitflag for errors (0 if no errors)
+ */
+OSQP_API OSQPInt osqp_consensus_cleanup(OSQPConsensus* cons);
+
 /**
  * Cleanup workspace by deallocating memory
  *
@@ -179,6 +358,11 @@ OSQP_API OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
  * If Px_new_idx (Ax_new_idx) is OSQP_NULL, Px_new (Ax_new) is assumed
  * to be as long as P->x (A->x) and the whole P->x (A->x) is replaced.
  *
+ * With the direct solver and scaling disabled, only the part of the KKT
+ * factorization that depends on the updated elements is recomputed, so
+ * updating a few elements is cheaper than updating all of them. With
+ * scaling, the scaled matrices change as a whole and are fully refactored.
+ *
  * @param  solver     Solver
  * @param  Px_new     Vector of new elements in P->x (upper triangular), NULL if none
  * @param  Px_new_idx Index mapping new elements to positions in P->x
@@ -199,6 +383,43 @@ OSQP_API OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
                                       const OSQPInt*   Ax_new_idx,
                                       OSQPInt          A_new_n);
 
+/**
+ * Update the problem data vectors and elements of matrices P (upper
+ * triangular) and A in a single step.
+ *
+ * The arguments are those of osqp_update_data_vec and osqp_update_data_mat.
+ * Calling the two one after the other scales the data and refactors the KKT
+ * matrix twice when the constraint types change. Here all elements are
+ * replaced first, the data is rescaled once, the constraint types are
+ * recomputed once and the KKT matrix is refactored at most once. Nothing is
+ * changed if the new bounds are not consistent.
+ *
+ * @param  solver     Solver
+ * @param  q_new      New linear cost, NULL if none
+ * @param  l_new      New lower bound, NULL if none
+ * @param  u_new      New upper bound, NULL if none
+ * @param  Px_new     Vector of new elements in P->x (upper triangular), NULL if none
+ * @param  Px_new_idx Index mapping new elements to positions in P->x
+ * @param  P_new_n    Number of new elements to be changed
+ * @param  Ax_new     Vector of new elements in A->x, NULL if none
+ * @param  Ax_new_idx Index mapping new elements to positions in A->x
+ * @param  A_new_n    Number of new elements to be changed
+ * @return            output flag:  0: OK
+ *                                  1: P_new_n > nnzP
+ *                                  2: A_new_n > nnzA
+ *                                 <0: error in the update
+ */
+OSQP_API OSQPInt osqp_update_data(OSQPSolver*      solver,
+                                  const OSQPFloat* q_new,
+                                  const OSQPFloat* l_new,
+                                  const OSQPFloat* u_new,
+                                  const OSQPFloat* Px_new,
+                                  const OSQPInt*   Px_new_idx,
+                                  OSQPInt          P_new_n,
+                                  const OSQPFloat* Ax_new,
+                                  const OSQPInt*   Ax_new_idx,
+                                  OSQPInt          A_new_n);
+
 
 # endif /* if OSQP_EMBEDDED_MODE != 1 */
 
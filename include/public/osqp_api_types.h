@@ -38,6 +38,23 @@ typedef struct {
   OSQPInt    nz;    ///< number of entries in triplet matrix, -1 for csc
 } OSQPCscMatrix;
 
+/**
+ * Matrix given by its products instead of its entries (see osqp_setup_operators)
+ *
+ * The estimates are optional. They replace the norms and diagonals that the
+ * scaling and the diagonal preconditioner otherwise read from the entries.
+ */
+typedef struct {
+  OSQPInt m;    ///< number of rows
+  OSQPInt n;    ///< number of columns
+  void*   data; ///< user data passed to the products
+  void  (*mult)(void* data, const OSQPFloat* x, OSQPFloat* y);       ///< y = M*x (full symmetric product for P)
+  void  (*mult_trans)(void* data, const OSQPFloat* x, OSQPFloat* y); ///< y = M'*x (not used for P)
+  const OSQPFloat* col_norm; ///< estimates of the column inf-norms (size n), OSQP_NULL if unknown
+  const OSQPFloat* row_norm; ///< estimates of the row inf-norms (size m), OSQP_NULL if unknown (not used for P)
+  const OSQPFloat* diag;     ///< diagonal of P, or of A'*A for A (size n), OSQP_NULL if unknown
+} OSQPOperator;
+
 /**
  * User settings
  */
@@ -83,6 +100,45 @@ typedef struct {
   // polishing parameters
   OSQPFloat delta;                  ///< regularization parameter for polishing
   OSQPInt   polish_refine_iter;     ///< number of iterative refinement steps in polishing
+  OSQPInt   polish_in_place;        ///< boolean; polish by refactoring the ADMM KKT matrix with the inactive rows decoupled
+
+  // memory management
+  OSQPInt   lean_memory;            ///< boolean; release setup-only buffers and recreate them on demand
+  OSQPInt   huge_pages;             ///< boolean; back large setup allocations with transparent huge pages
+  OSQPInt   numa_node;              ///< NUMA node to place large setup allocations on (-1 for first-touch)
+
+  // real-time operation
+  OSQPInt   realtime;               ///< 0: off; 1: no allocations after setup in solve, updates and polishing; 2: also in adjoint derivatives
+  OSQPInt   lock_memory;            ///< boolean; pre-fault and lock the buffers allocated during setup in RAM
+
+  // problem ordering
+  osqp_reorder_type reorder;        ///< ordering of the variables and constraints used internally
+  OSQPInt   group_constraints;      ///< boolean; group the constraints by type so rho_vec operations run on constant segments
+
+  // matrix storage
+  OSQPInt   compress_indices;       ///< boolean; delta-encode the row indices of P and A used by the matrix-vector products
+
+  // problem reduction
+  OSQPInt   eliminate_equalities;   ///< boolean; eliminate the constraints with l == u by substitution of variables
+
+  // stall detection
+  OSQPInt   stall_checks;           ///< stop after this many termination checks without progress of the residuals; 0 disables
+  OSQPInt   best_iterate;           ///< boolean; return the iterate with the smallest residuals if the solve does not converge
+
+  // direct linear system solver
+  OSQPInt   supernodal;             ///< boolean; factor and solve the large supernodes of the QDLDL factor with dense kernels
+
+  // termination checks
+  OSQPInt   async_termination;      ///< boolean; run the termination checks on a helper thread while the iterations go on
+
+  // setup
+  OSQPInt   setup_threads;          ///< threads of the setup; the stages that only read the patterns of P and A run on the ones beyond the first
+
+  // rho adaptation
+  OSQPInt   adaptive_rho_cost_model; ///< boolean; update rho only when the iterations it is expected to save take longer than the refactorization
+
+  // linear system solver library
+  osqp_linsys_library_type linsys_library; ///< library of the direct solver; the builtin algebra can load MKL Pardiso at runtime
 } OSQPSettings;
 
 
@@ -103,6 +159,7 @@ typedef struct {
   // algorithm information
   OSQPInt   iter;         ///< Number of iterations taken
   OSQPInt   rho_updates;  ///< Number of rho updates performned
+  OSQPInt   rho_updates_skipped; ///< Number of rho updates left out by adaptive_rho_cost_model
   OSQPFloat rho_estimate; ///< Best rho estimate so far from residuals
 
   // timing information
@@ -130,6 +187,10 @@ typedef struct {
 typedef struct OSQPWorkspace_ OSQPWorkspace;
 
 
+/* Consensus solver over blocks of constraint rows (contents not public) */
+typedef struct OSQPConsensus_ OSQPConsensus;
+
+
 /**
  * Main OSQP solver structure that holds all information.
  */
@@ -0,0 +1,386 @@
+#ifndef OSQP_SYMBOL_PREFIX_H
+#define OSQP_SYMBOL_PREFIX_H
+
+/*
+ * Rename every external symbol of the library by prepending OSQP_SYMBOL_PREFIX.
+ *
+ * This header is included by osqp_configure.h when the library is configured
+ * with a non-empty OSQP_SYMBOL_PREFIX, so libraries built with different
+ * precisions or index widths can be linked into the same program.
+ * The renaming is done by the preprocessor, so library symbols must not share
+ * their name with members of the public types.
+ *
+ * Any new non-static function or global variable must be added here.
+ */
+
+#define OSQP_PREFIX_CONCAT_(a, b) a##b
+#define OSQP_PREFIX_CONCAT(a, b)  OSQP_PREFIX_CONCAT_(a, b)
+#define OSQP_PREFIXED(name)       OSQP_PREFIX_CONCAT(OSQP_SYMBOL_PREFIX, name)
+
+/* Public API */
+# define csc_set_data                        OSQP_PREFIXED(csc_set_data)
+# define osqp_adjoint_derivative_compute     OSQP_PREFIXED(osqp_adjoint_derivative_compute)
+# define osqp_adjoint_derivative_get_mat     OSQP_PREFIXED(osqp_adjoint_derivative_get_mat)
+# define osqp_adjoint_derivative_get_vec     OSQP_PREFIXED(osqp_adjoint_derivative_get_vec)
+# define osqp_capabilities                   OSQP_PREFIXED(osqp_capabilities)
+# define osqp_cleanup                        OSQP_PREFIXED(osqp_cleanup)
+# define osqp_codegen                        OSQP_PREFIXED(osqp_codegen)
+# define osqp_consensus_cleanup              OSQP_PREFIXED(osqp_consensus_cleanup)
+# define osqp_consensus_setup                OSQP_PREFIXED(osqp_consensus_setup)
+# define osqp_consensus_solve                OSQP_PREFIXED(osqp_consensus_solve)
+# define osqp_csc_write_file                 OSQP_PREFIXED(osqp_csc_write_file)
+# define osqp_cold_start                     OSQP_PREFIXED(osqp_cold_start)
+# define osqp_error_message                  OSQP_PREFIXED(osqp_error_message)
+# define osqp_get_dimensions                 OSQP_PREFIXED(osqp_get_dimensions)
+# define osqp_operator_map_file              OSQP_PREFIXED(osqp_operator_map_file)
+# define osqp_operator_unmap_file            OSQP_PREFIXED(osqp_operator_unmap_file)
+# define osqp_set_default_codegen_defines    OSQP_PREFIXED(osqp_set_default_codegen_defines)
+# define osqp_set_default_settings           OSQP_PREFIXED(osqp_set_default_settings)
+# define osqp_setup                          OSQP_PREFIXED(osqp_setup)
+# define osqp_setup_operators                OSQP_PREFIXED(osqp_setup_operators)
+# define osqp_solve                          OSQP_PREFIXED(osqp_solve)
+# define osqp_solve_multi                    OSQP_PREFIXED(osqp_solve_multi)
+# define osqp_update_data                    OSQP_PREFIXED(osqp_update_data)
+# define osqp_update_data_mat                OSQP_PREFIXED(osqp_update_data_mat)
+# define osqp_update_data_vec                OSQP_PREFIXED(osqp_update_data_vec)
+# define osqp_update_rho                     OSQP_PREFIXED(osqp_update_rho)
+# define osqp_update_settings                OSQP_PREFIXED(osqp_update_settings)
+# define osqp_version                        OSQP_PREFIXED(osqp_version)
+# define osqp_warm_start                     OSQP_PREFIXED(osqp_warm_start)
+
+/* Solver internals */
+# define OSQPTimer_free                      OSQP_PREFIXED(OSQPTimer_free)
+# define OSQPTimer_new                       OSQP_PREFIXED(OSQPTimer_new)
+# define OSQP_ERROR_MESSAGE                  OSQP_PREFIXED(OSQP_ERROR_MESSAGE)
+# define OSQP_STATUS_MESSAGE                 OSQP_PREFIXED(OSQP_STATUS_MESSAGE)
+# define _osqp_error                         OSQP_PREFIXED(_osqp_error)
+# define _osqp_error_line                    OSQP_PREFIXED(_osqp_error_line)
+# define adapt_rho                           OSQP_PREFIXED(adapt_rho)
+# define adjoint_derivative_compute          OSQP_PREFIXED(adjoint_derivative_compute)
+# define adjoint_derivative_get_mat          OSQP_PREFIXED(adjoint_derivative_get_mat)
+# define adjoint_derivative_get_vec          OSQP_PREFIXED(adjoint_derivative_get_vec)
+# define adjoint_derivative_linsys_solver    OSQP_PREFIXED(adjoint_derivative_linsys_solver)
+# define adjoint_derivative_init_linsys_solver OSQP_PREFIXED(adjoint_derivative_init_linsys_solver)
+# define adjoint_derivative_alloc_system     OSQP_PREFIXED(adjoint_derivative_alloc_system)
+# define adjoint_derivative_free_system      OSQP_PREFIXED(adjoint_derivative_free_system)
+# define async_check_collect                 OSQP_PREFIXED(async_check_collect)
+# define async_check_free                    OSQP_PREFIXED(async_check_free)
+# define async_check_new                     OSQP_PREFIXED(async_check_new)
+# define async_check_post                    OSQP_PREFIXED(async_check_post)
+# define async_check_snapshot                OSQP_PREFIXED(async_check_snapshot)
+# define c_strcpy                            OSQP_PREFIXED(c_strcpy)
+# define check_stall                         OSQP_PREFIXED(check_stall)
+# define check_termination_conditions        OSQP_PREFIXED(check_termination_conditions)
+# define codegen_defines                     OSQP_PREFIXED(codegen_defines)
+# define codegen_example                     OSQP_PREFIXED(codegen_example)
+# define codegen_inc                         OSQP_PREFIXED(codegen_inc)
+# define codegen_src                         OSQP_PREFIXED(codegen_src)
+# define compute_inf_norm_cols_KKT           OSQP_PREFIXED(compute_inf_norm_cols_KKT)
+# define compute_obj_val                     OSQP_PREFIXED(compute_obj_val)
+# define compute_rhs                         OSQP_PREFIXED(compute_rhs)
+# define compute_rho_estimate                OSQP_PREFIXED(compute_rho_estimate)
+# define consensus_free                      OSQP_PREFIXED(consensus_free)
+# define consensus_setup                     OSQP_PREFIXED(consensus_setup)
+# define consensus_solve                     OSQP_PREFIXED(consensus_solve)
+# define copy_settings                       OSQP_PREFIXED(copy_settings)
+# define eliminate_data_vec                  OSQP_PREFIXED(eliminate_data_vec)
+# define eliminate_free                      OSQP_PREFIXED(eliminate_free)
+# define eliminate_iterates                  OSQP_PREFIXED(eliminate_iterates)
+# define eliminate_new                       OSQP_PREFIXED(eliminate_new)
+# define eliminate_solution                  OSQP_PREFIXED(eliminate_solution)
+# define has_solution                        OSQP_PREFIXED(has_solution)
+# define is_dual_infeasible                  OSQP_PREFIXED(is_dual_infeasible)
+# define is_primal_infeasible                OSQP_PREFIXED(is_primal_infeasible)
+# define limit_scaling_scalar                OSQP_PREFIXED(limit_scaling_scalar)
+# define limit_scaling_vector                OSQP_PREFIXED(limit_scaling_vector)
+# define mapped_csc_close                    OSQP_PREFIXED(mapped_csc_close)
+# define mapped_csc_open                     OSQP_PREFIXED(mapped_csc_open)
+# define mapped_csc_write                    OSQP_PREFIXED(mapped_csc_write)
+# define multi_rhs_solve                     OSQP_PREFIXED(multi_rhs_solve)
+# define oact                                OSQP_PREFIXED(oact)
+# define osqp_end_interrupt_listener         OSQP_PREFIXED(osqp_end_interrupt_listener)
+# define osqp_is_interrupted                 OSQP_PREFIXED(osqp_is_interrupted)
+# define osqp_placed_calloc                  OSQP_PREFIXED(osqp_placed_calloc)
+# define osqp_placed_free                    OSQP_PREFIXED(osqp_placed_free)
+# define osqp_placed_malloc                  OSQP_PREFIXED(osqp_placed_malloc)
+# define osqp_placed_realloc                 OSQP_PREFIXED(osqp_placed_realloc)
+# define osqp_placement_begin                OSQP_PREFIXED(osqp_placement_begin)
+# define osqp_placement_end                  OSQP_PREFIXED(osqp_placement_end)
+# define osqp_start_interrupt_listener       OSQP_PREFIXED(osqp_start_interrupt_listener)
+# define osqp_tic                            OSQP_PREFIXED(osqp_tic)
+# define osqp_toc                            OSQP_PREFIXED(osqp_toc)
+# define polish                              OSQP_PREFIXED(polish)
+# define polish_alloc                        OSQP_PREFIXED(polish_alloc)
+# define polish_free                         OSQP_PREFIXED(polish_free)
+# define polish_alloc_system                 OSQP_PREFIXED(polish_alloc_system)
+# define print_footer                        OSQP_PREFIXED(print_footer)
+# define print_header                        OSQP_PREFIXED(print_header)
+# define print_polish                        OSQP_PREFIXED(print_polish)
+# define print_setup_header                  OSQP_PREFIXED(print_setup_header)
+# define print_summary                       OSQP_PREFIXED(print_summary)
+# define reorder_check_segments              OSQP_PREFIXED(reorder_check_segments)
+# define reorder_data_mat                    OSQP_PREFIXED(reorder_data_mat)
+# define reorder_data_vec                    OSQP_PREFIXED(reorder_data_vec)
+# define reorder_free                        OSQP_PREFIXED(reorder_free)
+# define reorder_new                         OSQP_PREFIXED(reorder_new)
+# define reorder_solution                    OSQP_PREFIXED(reorder_solution)
+# define reset_info                          OSQP_PREFIXED(reset_info)
+# define restore_best_iterate                OSQP_PREFIXED(restore_best_iterate)
+# define rho_update_pays                     OSQP_PREFIXED(rho_update_pays)
+# define scale_data                          OSQP_PREFIXED(scale_data)
+# define set_rho_vec                         OSQP_PREFIXED(set_rho_vec)
+# define setup_pipeline_finish               OSQP_PREFIXED(setup_pipeline_finish)
+# define setup_pipeline_free                 OSQP_PREFIXED(setup_pipeline_free)
+# define setup_pipeline_start                OSQP_PREFIXED(setup_pipeline_start)
+# define store_solution                      OSQP_PREFIXED(store_solution)
+# define swap_vectors                        OSQP_PREFIXED(swap_vectors)
+# define unscale_PA                          OSQP_PREFIXED(unscale_PA)
+# define unscale_data                        OSQP_PREFIXED(unscale_data)
+# define unscale_lu                          OSQP_PREFIXED(unscale_lu)
+# define unscale_solution                    OSQP_PREFIXED(unscale_solution)
+# define update_info                         OSQP_PREFIXED(update_info)
+# define update_rho_vec                      OSQP_PREFIXED(update_rho_vec)
+# define update_status                       OSQP_PREFIXED(update_status)
+# define update_x                            OSQP_PREFIXED(update_x)
+# define update_xz_tilde                     OSQP_PREFIXED(update_xz_tilde)
+# define update_y                            OSQP_PREFIXED(update_y)
+# define update_z                            OSQP_PREFIXED(update_z)
+# define validate_data                       OSQP_PREFIXED(validate_data)
+# define validate_linsys_solver              OSQP_PREFIXED(validate_linsys_solver)
+# define validate_operators                  OSQP_PREFIXED(validate_operators)
+# define validate_settings                   OSQP_PREFIXED(validate_settings)
+
+/* Algebra and linear system solvers */
+# define OSQPMatrix_AtDA_extract_diag        OSQP_PREFIXED(OSQPMatrix_AtDA_extract_diag)
+# define OSQPMatrix_Atxpy                    OSQP_PREFIXED(OSQPMatrix_Atxpy)
+# define OSQPMatrix_Axpy                     OSQP_PREFIXED(OSQPMatrix_Axpy)
+# define OSQPMatrix_col_norm_inf             OSQP_PREFIXED(OSQPMatrix_col_norm_inf)
+# define OSQPMatrix_compress_indices         OSQP_PREFIXED(OSQPMatrix_compress_indices)
+# define OSQPMatrix_copy_new                 OSQP_PREFIXED(OSQPMatrix_copy_new)
+# define OSQPMatrix_extract_diag             OSQP_PREFIXED(OSQPMatrix_extract_diag)
+# define OSQPMatrix_free                     OSQP_PREFIXED(OSQPMatrix_free)
+# define OSQPMatrix_get_csc                  OSQP_PREFIXED(OSQPMatrix_get_csc)
+# define OSQPMatrix_get_i                    OSQP_PREFIXED(OSQPMatrix_get_i)
+# define OSQPMatrix_get_m                    OSQP_PREFIXED(OSQPMatrix_get_m)
+# define OSQPMatrix_get_n                    OSQP_PREFIXED(OSQPMatrix_get_n)
+# define OSQPMatrix_get_nz                   OSQP_PREFIXED(OSQPMatrix_get_nz)
+# define OSQPMatrix_get_p                    OSQP_PREFIXED(OSQPMatrix_get_p)
+# define OSQPMatrix_get_x                    OSQP_PREFIXED(OSQPMatrix_get_x)
+# define OSQPMatrix_is_eq                    OSQP_PREFIXED(OSQPMatrix_is_eq)
+# define OSQPMatrix_lmult_diag               OSQP_PREFIXED(OSQPMatrix_lmult_diag)
+# define OSQPMatrix_mult_scalar              OSQP_PREFIXED(OSQPMatrix_mult_scalar)
+# define OSQPMatrix_new_from_csc             OSQP_PREFIXED(OSQPMatrix_new_from_csc)
+# define OSQPMatrix_new_from_operator        OSQP_PREFIXED(OSQPMatrix_new_from_operator)
+# define OSQPMatrix_rmult_diag               OSQP_PREFIXED(OSQPMatrix_rmult_diag)
+# define OSQPMatrix_row_norm_inf             OSQP_PREFIXED(OSQPMatrix_row_norm_inf)
+# define OSQPMatrix_submatrix_byrows         OSQP_PREFIXED(OSQPMatrix_submatrix_byrows)
+# define OSQPMatrix_triu_to_symm             OSQP_PREFIXED(OSQPMatrix_triu_to_symm)
+# define OSQPMatrix_update_values            OSQP_PREFIXED(OSQPMatrix_update_values)
+# define OSQPMatrix_vstack                   OSQP_PREFIXED(OSQPMatrix_vstack)
+# define OSQPVectorf_add_scaled              OSQP_PREFIXED(OSQPVectorf_add_scaled)
+# define OSQPVectorf_add_scaled3             OSQP_PREFIXED(OSQPVectorf_add_scaled3)
+# define OSQPVectorf_all_leq                 OSQP_PREFIXED(OSQPVectorf_all_leq)
+# define OSQPVectorf_calloc                  OSQP_PREFIXED(OSQPVectorf_calloc)
+# define OSQPVectorf_concat                  OSQP_PREFIXED(OSQPVectorf_concat)
+# define OSQPVectorf_copy                    OSQP_PREFIXED(OSQPVectorf_copy)
+# define OSQPVectorf_copy_new                OSQP_PREFIXED(OSQPVectorf_copy_new)
+# define OSQPVectorf_data                    OSQP_PREFIXED(OSQPVectorf_data)
+# define OSQPVectorf_dot_prod                OSQP_PREFIXED(OSQPVectorf_dot_prod)
+# define OSQPVectorf_dot_prod_signed         OSQP_PREFIXED(OSQPVectorf_dot_prod_signed)
+# define OSQPVectorf_eval                    OSQP_PREFIXED(OSQPVectorf_eval)
+# define OSQPVectorf_eval_norm_inf           OSQP_PREFIXED(OSQPVectorf_eval_norm_inf)
+# define OSQPVectorf_ew_bound_vec            OSQP_PREFIXED(OSQPVectorf_ew_bound_vec)
+# define OSQPVectorf_ew_bounds_type          OSQP_PREFIXED(OSQPVectorf_ew_bounds_type)
+# define OSQPVectorf_ew_max_vec              OSQP_PREFIXED(OSQPVectorf_ew_max_vec)
+# define OSQPVectorf_ew_min_vec              OSQP_PREFIXED(OSQPVectorf_ew_min_vec)
+# define OSQPVectorf_ew_prod                 OSQP_PREFIXED(OSQPVectorf_ew_prod)
+# define OSQPVectorf_ew_reciprocal           OSQP_PREFIXED(OSQPVectorf_ew_reciprocal)
+# define OSQPVectorf_ew_sqrt                 OSQP_PREFIXED(OSQPVectorf_ew_sqrt)
+# define OSQPVectorf_expr_add                OSQP_PREFIXED(OSQPVectorf_expr_add)
+# define OSQPVectorf_expr_add_prod           OSQP_PREFIXED(OSQPVectorf_expr_add_prod)
+# define OSQPVectorf_expr_bound_vec          OSQP_PREFIXED(OSQPVectorf_expr_bound_vec)
+# define OSQPVectorf_expr_dot_prod           OSQP_PREFIXED(OSQPVectorf_expr_dot_prod)
+# define OSQPVectorf_expr_ew_prod            OSQP_PREFIXED(OSQPVectorf_expr_ew_prod)
+# define OSQPVectorf_expr_init               OSQP_PREFIXED(OSQPVectorf_expr_init)
+# define OSQPVectorf_expr_mult_scalar        OSQP_PREFIXED(OSQPVectorf_expr_mult_scalar)
+# define OSQPVectorf_free                    OSQP_PREFIXED(OSQPVectorf_free)
+# define OSQPVectorf_from_raw                OSQP_PREFIXED(OSQPVectorf_from_raw)
+# define OSQPVectorf_in_reccone              OSQP_PREFIXED(OSQPVectorf_in_reccone)
+# define OSQPVectorf_is_eq                   OSQP_PREFIXED(OSQPVectorf_is_eq)
+# define OSQPVectorf_length                  OSQP_PREFIXED(OSQPVectorf_length)
+# define OSQPVectorf_malloc                  OSQP_PREFIXED(OSQPVectorf_malloc)
+# define OSQPVectorf_minus                   OSQP_PREFIXED(OSQPVectorf_minus)
+# define OSQPVectorf_mult_scalar             OSQP_PREFIXED(OSQPVectorf_mult_scalar)
+# define OSQPVectorf_new                     OSQP_PREFIXED(OSQPVectorf_new)
+# define OSQPVectorf_norm_1                  OSQP_PREFIXED(OSQPVectorf_norm_1)
+# define OSQPVectorf_norm_2                  OSQP_PREFIXED(OSQPVectorf_norm_2)
+# define OSQPVectorf_norm_inf                OSQP_PREFIXED(OSQPVectorf_norm_inf)
+# define OSQPVectorf_norm_inf_diff           OSQP_PREFIXED(OSQPVectorf_norm_inf_diff)
+# define OSQPVectorf_plus                    OSQP_PREFIXED(OSQPVectorf_plus)
+# define OSQPVectorf_project_polar_reccone   OSQP_PREFIXED(OSQPVectorf_project_polar_reccone)
+# define OSQPVectorf_scaled_norm_inf         OSQP_PREFIXED(OSQPVectorf_scaled_norm_inf)
+# define OSQPVectorf_set_scalar              OSQP_PREFIXED(OSQPVectorf_set_scalar)
+# define OSQPVectorf_set_scalar_conditional  OSQP_PREFIXED(OSQPVectorf_set_scalar_conditional)
+# define OSQPVectorf_set_scalar_if_gt        OSQP_PREFIXED(OSQPVectorf_set_scalar_if_gt)
+# define OSQPVectorf_set_scalar_if_lt        OSQP_PREFIXED(OSQPVectorf_set_scalar_if_lt)
+# define OSQPVectorf_subvector_assign        OSQP_PREFIXED(OSQPVectorf_subvector_assign)
+# define OSQPVectorf_subvector_assign_scalar OSQP_PREFIXED(OSQPVectorf_subvector_assign_scalar)
+# define OSQPVectorf_subvector_byrows        OSQP_PREFIXED(OSQPVectorf_subvector_byrows)
+# define OSQPVectorf_to_raw                  OSQP_PREFIXED(OSQPVectorf_to_raw)
+# define OSQPVectorf_view                    OSQP_PREFIXED(OSQPVectorf_view)
+# define OSQPVectorf_view_free               OSQP_PREFIXED(OSQPVectorf_view_free)
+# define OSQPVectorf_view_update             OSQP_PREFIXED(OSQPVectorf_view_update)
+# define OSQPVectori_calloc                  OSQP_PREFIXED(OSQPVectori_calloc)
+# define OSQPVectori_free                    OSQP_PREFIXED(OSQPVectori_free)
+# define OSQPVectori_from_raw                OSQP_PREFIXED(OSQPVectori_from_raw)
+# define OSQPVectori_length                  OSQP_PREFIXED(OSQPVectori_length)
+# define OSQPVectori_malloc                  OSQP_PREFIXED(OSQPVectori_malloc)
+# define OSQPVectori_new                     OSQP_PREFIXED(OSQPVectori_new)
+# define OSQPVectori_to_raw                  OSQP_PREFIXED(OSQPVectori_to_raw)
+# define adjoint_derivative_qdldl            OSQP_PREFIXED(adjoint_derivative_qdldl)
+# define adjoint_derivative_init_qdldl       OSQP_PREFIXED(adjoint_derivative_init_qdldl)
+# define csc_AtDA_extract_diag               OSQP_PREFIXED(csc_AtDA_extract_diag)
+# define csc_Atxpy                           OSQP_PREFIXED(csc_Atxpy)
+# define csc_Axpy                            OSQP_PREFIXED(csc_Axpy)
+# define csc_Axpy_sym_triu                   OSQP_PREFIXED(csc_Axpy_sym_triu)
+# define csc_col_norm_inf                    OSQP_PREFIXED(csc_col_norm_inf)
+# define csc_copy                            OSQP_PREFIXED(csc_copy)
+# define csc_cumsum                          OSQP_PREFIXED(csc_cumsum)
+# define csc_done                            OSQP_PREFIXED(csc_done)
+# define csc_extract_diag                    OSQP_PREFIXED(csc_extract_diag)
+# define csc_is_eq                           OSQP_PREFIXED(csc_is_eq)
+# define csc_lmult_diag                      OSQP_PREFIXED(csc_lmult_diag)
+# define csc_packable                        OSQP_PREFIXED(csc_packable)
+# define csc_packed_Atxpy                    OSQP_PREFIXED(csc_packed_Atxpy)
+# define csc_packed_Axpy                     OSQP_PREFIXED(csc_packed_Axpy)
+# define csc_packed_Axpy_sym_triu            OSQP_PREFIXED(csc_packed_Axpy_sym_triu)
+# define csc_packed_free                     OSQP_PREFIXED(csc_packed_free)
+# define csc_packed_new                      OSQP_PREFIXED(csc_packed_new)
+# define csc_pinv                            OSQP_PREFIXED(csc_pinv)
+# define csc_rmult_diag                      OSQP_PREFIXED(csc_rmult_diag)
+# define csc_row_norm_inf                    OSQP_PREFIXED(csc_row_norm_inf)
+# define csc_row_norm_inf_sym_triu           OSQP_PREFIXED(csc_row_norm_inf_sym_triu)
+# define csc_scale                           OSQP_PREFIXED(csc_scale)
+# define csc_spalloc                         OSQP_PREFIXED(csc_spalloc)
+# define csc_spfree                          OSQP_PREFIXED(csc_spfree)
+# define csc_submatrix_byrows                OSQP_PREFIXED(csc_submatrix_byrows)
+# define csc_symperm                         OSQP_PREFIXED(csc_symperm)
+# define csc_to_dns                          OSQP_PREFIXED(csc_to_dns)
+# define csc_update_values                   OSQP_PREFIXED(csc_update_values)
+# define form_KKT                            OSQP_PREFIXED(form_KKT)
+# define form_KKT_pattern                    OSQP_PREFIXED(form_KKT_pattern)
+# define free_linsys_solver_hybrid           OSQP_PREFIXED(free_linsys_solver_hybrid)
+# define free_linsys_solver_pardiso          OSQP_PREFIXED(free_linsys_solver_pardiso)
+# define free_linsys_solver_qdldl            OSQP_PREFIXED(free_linsys_solver_qdldl)
+# define init_linsys_solver_hybrid           OSQP_PREFIXED(init_linsys_solver_hybrid)
+# define init_linsys_solver_pardiso          OSQP_PREFIXED(init_linsys_solver_pardiso)
+# define init_linsys_solver_qdldl            OSQP_PREFIXED(init_linsys_solver_qdldl)
+# define init_linsys_solver_qdldl_analysed   OSQP_PREFIXED(init_linsys_solver_qdldl_analysed)
+# define name_hybrid                         OSQP_PREFIXED(name_hybrid)
+# define name_pardiso                        OSQP_PREFIXED(name_pardiso)
+# define name_qdldl                          OSQP_PREFIXED(name_qdldl)
+# define op_matrix_AtDA_extract_diag         OSQP_PREFIXED(op_matrix_AtDA_extract_diag)
+# define op_matrix_Atxpy                     OSQP_PREFIXED(op_matrix_Atxpy)
+# define op_matrix_Axpy                      OSQP_PREFIXED(op_matrix_Axpy)
+# define op_matrix_col_norm_inf              OSQP_PREFIXED(op_matrix_col_norm_inf)
+# define op_matrix_extract_diag              OSQP_PREFIXED(op_matrix_extract_diag)
+# define op_matrix_free                      OSQP_PREFIXED(op_matrix_free)
+# define op_matrix_lmult_diag                OSQP_PREFIXED(op_matrix_lmult_diag)
+# define op_matrix_new                       OSQP_PREFIXED(op_matrix_new)
+# define op_matrix_rmult_diag                OSQP_PREFIXED(op_matrix_rmult_diag)
+# define op_matrix_row_norm_inf              OSQP_PREFIXED(op_matrix_row_norm_inf)
+# define op_matrix_scale                     OSQP_PREFIXED(op_matrix_scale)
+# define osqp_algebra_analyse_linsys         OSQP_PREFIXED(osqp_algebra_analyse_linsys)
+# define osqp_algebra_default_linsys         OSQP_PREFIXED(osqp_algebra_default_linsys)
+# define osqp_algebra_device_name            OSQP_PREFIXED(osqp_algebra_device_name)
+# define osqp_algebra_free_libs              OSQP_PREFIXED(osqp_algebra_free_libs)
+# define osqp_algebra_free_linsys_analysis   OSQP_PREFIXED(osqp_algebra_free_linsys_analysis)
+# define osqp_algebra_init_libs              OSQP_PREFIXED(osqp_algebra_init_libs)
+# define osqp_algebra_init_linsys_solver     OSQP_PREFIXED(osqp_algebra_init_linsys_solver)
+# define osqp_algebra_init_linsys_solver_analysed OSQP_PREFIXED(osqp_algebra_init_linsys_solver_analysed)
+# define osqp_algebra_linsys_supported       OSQP_PREFIXED(osqp_algebra_linsys_supported)
+# define osqp_algebra_name                   OSQP_PREFIXED(osqp_algebra_name)
+# define pardiso_runtime                     OSQP_PREFIXED(pardiso_runtime)
+# define pardiso_runtime_load                OSQP_PREFIXED(pardiso_runtime_load)
+# define pardiso_runtime_max_threads         OSQP_PREFIXED(pardiso_runtime_max_threads)
+# define polish_factor_linsys_qdldl          OSQP_PREFIXED(polish_factor_linsys_qdldl)
+# define qdldl_sn_factor                     OSQP_PREFIXED(qdldl_sn_factor)
+# define qdldl_sn_free                       OSQP_PREFIXED(qdldl_sn_free)
+# define qdldl_sn_new                        OSQP_PREFIXED(qdldl_sn_new)
+# define qdldl_sn_pattern                    OSQP_PREFIXED(qdldl_sn_pattern)
+# define qdldl_sn_solve                      OSQP_PREFIXED(qdldl_sn_solve)
+# define qdldl_symbolic_free                 OSQP_PREFIXED(qdldl_symbolic_free)
+# define qdldl_symbolic_new                  OSQP_PREFIXED(qdldl_symbolic_new)
+# define reduced_kkt_compute_rhs             OSQP_PREFIXED(reduced_kkt_compute_rhs)
+# define reduced_kkt_diagonal                OSQP_PREFIXED(reduced_kkt_diagonal)
+# define reduced_kkt_mv_times                OSQP_PREFIXED(reduced_kkt_mv_times)
+# define solve_linsys_pardiso                OSQP_PREFIXED(solve_linsys_pardiso)
+# define solve_linsys_qdldl                  OSQP_PREFIXED(solve_linsys_qdldl)
+# define solve_block_linsys_qdldl            OSQP_PREFIXED(solve_block_linsys_qdldl)
+# define solve_linsys_hybrid                 OSQP_PREFIXED(solve_linsys_hybrid)
+# define triplet_to_csc                      OSQP_PREFIXED(triplet_to_csc)
+# define triplet_to_csr                      OSQP_PREFIXED(triplet_to_csr)
+# define triu_to_csc                         OSQP_PREFIXED(triu_to_csc)
+# define update_KKT_A                        OSQP_PREFIXED(update_KKT_A)
+# define update_KKT_P                        OSQP_PREFIXED(update_KKT_P)
+# define update_KKT_param2                   OSQP_PREFIXED(update_KKT_param2)
+# define update_linsys_solver_matrices_hybrid OSQP_PREFIXED(update_linsys_solver_matrices_hybrid)
+# define update_linsys_solver_matrices_pardiso OSQP_PREFIXED(update_linsys_solver_matrices_pardiso)
+# define update_linsys_solver_matrices_qdldl OSQP_PREFIXED(update_linsys_solver_matrices_qdldl)
+# define update_linsys_solver_matrices_rho_vec_qdldl OSQP_PREFIXED(update_linsys_solver_matrices_rho_vec_qdldl)
+# define update_linsys_solver_rho_vec_hybrid OSQP_PREFIXED(update_linsys_solver_rho_vec_hybrid)
+# define update_linsys_solver_rho_vec_pardiso OSQP_PREFIXED(update_linsys_solver_rho_vec_pardiso)
+# define update_linsys_solver_rho_vec_qdldl  OSQP_PREFIXED(update_linsys_solver_rho_vec_qdldl)
+# define update_settings_linsys_solver_hybrid OSQP_PREFIXED(update_settings_linsys_solver_hybrid)
+# define update_settings_linsys_solver_pardiso OSQP_PREFIXED(update_settings_linsys_solver_pardiso)
+# define update_settings_linsys_solver_qdldl OSQP_PREFIXED(update_settings_linsys_solver_qdldl)
+# define vec_mult_scalar                     OSQP_PREFIXED(vec_mult_scalar)
+# define vec_negate                          OSQP_PREFIXED(vec_negate)
+# define vec_set_scalar                      OSQP_PREFIXED(vec_set_scalar)
+# define vstack                              OSQP_PREFIXED(vstack)
+# define warm_start_linsys_solver_hybrid     OSQP_PREFIXED(warm_start_linsys_solver_hybrid)
+# define warm_start_linsys_solver_pardiso    OSQP_PREFIXED(warm_start_linsys_solver_pardiso)
+# define warm_start_linsys_solver_qdldl      OSQP_PREFIXED(warm_start_linsys_solver_qdldl)
+
+/* QDLDL (also applied to the QDLDL sources by CMake) */
+# define QDLDL_Lsolve                        OSQP_PREFIXED(QDLDL_Lsolve)
+# define QDLDL_Ltsolve                       OSQP_PREFIXED(QDLDL_Ltsolve)
+# define QDLDL_etree                         OSQP_PREFIXED(QDLDL_etree)
+# define QDLDL_factor                        OSQP_PREFIXED(QDLDL_factor)
+# define QDLDL_solve                         OSQP_PREFIXED(QDLDL_solve)
+
+/* AMD and SuiteSparse configuration */
+# define SuiteSparse_config                  OSQP_PREFIXED(SuiteSparse_config)
+# define SuiteSparse_divcomplex              OSQP_PREFIXED(SuiteSparse_divcomplex)
+# define SuiteSparse_free                    OSQP_PREFIXED(SuiteSparse_free)
+# define SuiteSparse_hypot                   OSQP_PREFIXED(SuiteSparse_hypot)
+# define SuiteSparse_malloc                  OSQP_PREFIXED(SuiteSparse_malloc)
+# define SuiteSparse_realloc                 OSQP_PREFIXED(SuiteSparse_realloc)
+# define SuiteSparse_tic                     OSQP_PREFIXED(SuiteSparse_tic)
+# define SuiteSparse_time                    OSQP_PREFIXED(SuiteSparse_time)
+# define SuiteSparse_toc                     OSQP_PREFIXED(SuiteSparse_toc)
+# define SuiteSparse_version                 OSQP_PREFIXED(SuiteSparse_version)
+# define amd_1                               OSQP_PREFIXED(amd_1)
+# define amd_2                               OSQP_PREFIXED(amd_2)
+# define amd_aat                             OSQP_PREFIXED(amd_aat)
+# define amd_control                         OSQP_PREFIXED(amd_control)
+# define amd_defaults                        OSQP_PREFIXED(amd_defaults)
+# define amd_info                            OSQP_PREFIXED(amd_info)
+# define amd_order                           OSQP_PREFIXED(amd_order)
+# define amd_post_tree                       OSQP_PREFIXED(amd_post_tree)
+# define amd_postorder                       OSQP_PREFIXED(amd_postorder)
+# define amd_preprocess                      OSQP_PREFIXED(amd_preprocess)
+# define amd_valid                           OSQP_PREFIXED(amd_valid)
+# define amd_l1                              OSQP_PREFIXED(amd_l1)
+# define amd_l2                              OSQP_PREFIXED(amd_l2)
+# define amd_l_aat                           OSQP_PREFIXED(amd_l_aat)
+# define amd_l_control                       OSQP_PREFIXED(amd_l_control)
+# define amd_l_defaults                      OSQP_PREFIXED(amd_l_defaults)
+# define amd_l_info                          OSQP_PREFIXED(amd_l_info)
+# define amd_l_order                         OSQP_PREFIXED(amd_l_order)
+# define amd_l_post_tree                     OSQP_PREFIXED(amd_l_post_tree)
+# define amd_l_postorder                     OSQP_PREFIXED(amd_l_postorder)
+# define amd_l_preprocess                    OSQP_PREFIXED(amd_l_preprocess)
+# define amd_l_valid                         OSQP_PREFIXED(amd_l_valid)
+
+#endif /* ifndef OSQP_SYMBOL_PREFIX_H */
@@ -0,0 +1,251 @@
+#include "async_check.h"
+#include "auxil.h"
+#include "error.h"
+#include "printing.h"
+#include "timing.h"
+
+
+/* Run the termination check of a slot, as osqp_solve does at a check point */
+static void run_check(async_check_slot* s,
+                      OSQPInt           compute_obj) {
+
+  update_info(&s->solver, s->iter, compute_obj, 0);
+
+  s->exitflag = check_termination_conditions(&s->solver, 0);
+  if (!s->exitflag) s->exitflag = check_stall(&s->solver, s->iter);
+}
+
+static void* check_thread(void* arg) {
+
+  OSQPAsyncCheck*   ac = (OSQPAsyncCheck*)arg;
+  async_check_slot* s;
+  OSQPInt           compute_obj;
+
+  pthread_mutex_lock(&ac->lock);
+  for (;;) {
+    while (!ac->quit && (ac->posted < 0 || ac->done))
+      pthread_cond_wait(&ac->cond, &ac->lock);
+    if (ac->quit) break;
+
+    s           = &ac->slot[ac->posted];
+    compute_obj = ac->compute_obj;
+    pthread_mutex_unlock(&ac->lock);
+    run_check(s, compute_obj);
+    pthread_mutex_lock(&ac->lock);
+
+    ac->done = 1;
+    pthread_cond_broadcast(&ac->cond);
+  }
+  pthread_mutex_unlock(&ac->lock);
+
+  return OSQP_NULL;
+}
+
+static void free_buffers(OSQPAsyncCheck* ac) {
+
+  OSQPInt k;
+
+  for (k = 0; k < 2; k++) {
+    OSQPVectorf_free(ac->slot[k].x);
+    OSQPVectorf_free(ac->slot[k].z);
+    OSQPVectorf_free(ac->slot[k].y);
+    OSQPVectorf_free(ac->slot[k].delta_x);
+    OSQPVectorf_free(ac->slot[k].delta_y);
+  }
+  OSQPVectorf_free(ac->x_prev);
+  OSQPVectorf_free(ac->z_prev);
+  OSQPVectorf_free(ac->Ax);
+  OSQPVectorf_free(ac->Px);
+  OSQPVectorf_free(ac->Aty);
+  OSQPVectorf_free(ac->Atdelta_y);
+  OSQPVectorf_free(ac->Pdelta_x);
+  OSQPVectorf_free(ac->Adelta_x);
+#ifdef OSQP_ENABLE_PROFILING
+  OSQPTimer_free(ac->timer);
+#endif
+  c_free(ac);
+}
+
+OSQPInt async_check_new(OSQPAsyncCheck** acp,
+                        OSQPInt          n,
+                        OSQPInt          m) {
+
+  OSQPInt         k;
+  OSQPInt         failed = 0;
+  OSQPAsyncCheck* ac     = c_calloc(1, sizeof(OSQPAsyncCheck));
+
+  *acp = OSQP_NULL;
+  if (!ac) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  for (k = 0; k < 2; k++) {
+    ac->slot[k].x       = OSQPVectorf_calloc(n);
+    ac->slot[k].z       = OSQPVectorf_calloc(m);
+    ac->slot[k].y       = OSQPVectorf_calloc(m);
+    ac->slot[k].delta_x = OSQPVectorf_calloc(n);
+    ac->slot[k].delta_y = OSQPVectorf_calloc(m);
+    failed |= !ac->slot[k].x || !ac->slot[k].z || !ac->slot[k].y ||
+              !ac->slot[k].delta_x || !ac->slot[k].delta_y;
+  }
+  ac->x_prev    = OSQPVectorf_calloc(n);
+  ac->z_prev    = OSQPVectorf_calloc(m);
+  ac->Ax        = OSQPVectorf_calloc(m);
+  ac->Px        = OSQPVectorf_calloc(n);
+  ac->Aty       = OSQPVectorf_calloc(n);
+  ac->Atdelta_y = OSQPVectorf_calloc(n);
+  ac->Pdelta_x  = OSQPVectorf_calloc(n);
+  ac->Adelta_x  = OSQPVectorf_calloc(m);
+  failed |= !ac->x_prev || !ac->z_prev || !ac->Ax || !ac->Px || !ac->Aty ||
+            !ac->Atdelta_y || !ac->Pdelta_x || !ac->Adelta_x;
+#ifdef OSQP_ENABLE_PROFILING
+  ac->timer = OSQPTimer_new();
+  failed   |= !ac->timer;
+  if (ac->timer) osqp_tic(ac->timer);
+#endif
+  if (failed) {
+    free_buffers(ac);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  ac->posted = -1;
+
+  if (pthread_mutex_init(&ac->lock, OSQP_NULL)) {
+    free_buffers(ac);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+  if (pthread_cond_init(&ac->cond, OSQP_NULL)) {
+    pthread_mutex_destroy(&ac->lock);
+    free_buffers(ac);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+  if (pthread_create(&ac->thread, OSQP_NULL, &check_thread, ac)) {
+    c_eprint("Could not start the thread of the termination checks");
+    pthread_cond_destroy(&ac->cond);
+    pthread_mutex_destroy(&ac->lock);
+    free_buffers(ac);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  *acp = ac;
+  return 0;
+}
+
+void async_check_snapshot(OSQPAsyncCheck* ac,
+                          OSQPSolver*     solver,
+                          OSQPInt         iter) {
+
+  async_check_slot* s    = &ac->slot[ac->next];
+  OSQPWorkspace*    work = solver->work;
+
+  OSQPVectorf_copy(s->x,       work->x);
+  OSQPVectorf_copy(s->z,       work->z);
+  OSQPVectorf_copy(s->y,       work->y);
+  OSQPVectorf_copy(s->delta_x, work->delta_x);
+  OSQPVectorf_copy(s->delta_y, work->delta_y);
+  s->iter = iter;
+}
+
+void async_check_post(OSQPAsyncCheck* ac,
+                      OSQPSolver*     solver,
+                      OSQPInt         compute_obj) {
+
+  async_check_slot* s = &ac->slot[ac->next];
+
+  // The data, scaling and settings are shared; they do not change in a solve
+  s->work        = *solver->work;
+  s->work.x      = s->x;
+  s->work.z      = s->z;
+  s->work.y      = s->y;
+  s->work.x_prev = ac->x_prev;
+  s->work.z_prev = ac->z_prev;
+
+  s->work.Ax        = ac->Ax;
+  s->work.Px        = ac->Px;
+  s->work.Aty       = ac->Aty;
+  s->work.delta_y   = s->delta_y;
+  s->work.Atdelta_y = ac->Atdelta_y;
+  s->work.delta_x   = s->delta_x;
+  s->work.Pdelta_x  = ac->Pdelta_x;
+  s->work.Adelta_x  = ac->Adelta_x;
+#ifdef OSQP_ENABLE_PROFILING
+  s->work.timer     = ac->timer;
+#endif
+
+  s->info        = *solver->info;
+  s->solver      = *solver;
+  s->solver.work = &s->work;
+  s->solver.info = &s->info;
+
+  pthread_mutex_lock(&ac->lock);
+  ac->posted      = ac->next;
+  ac->done        = 0;
+  ac->compute_obj = compute_obj;
+  ac->next        = 1 - ac->next;
+  pthread_cond_broadcast(&ac->cond);
+  pthread_mutex_unlock(&ac->lock);
+}
+
+OSQPInt async_check_collect(OSQPAsyncCheck* ac,
+                            OSQPSolver*     solver) {
+
+  async_check_slot* s;
+  OSQPWorkspace*    work;
+  OSQPInfo*         info;
+
+  pthread_mutex_lock(&ac->lock);
+  while (ac->posted >= 0 && !ac->done) pthread_cond_wait(&ac->cond, &ac->lock);
+  s          = ac->posted >= 0 ? &ac->slot[ac->posted] : OSQP_NULL;
+  ac->posted = -1;
+  ac->done   = 0;
+  pthread_mutex_unlock(&ac->lock);
+
+  if (!s || !solver) return 0;
+
+  work = solver->work;
+  info = solver->info;
+
+  // Progress of the residuals, read by the next checks and the indirect solvers
+  work->stall_ref       = s->work.stall_ref;
+  work->stall_count     = s->work.stall_count;
+  work->best_ratio      = s->work.best_ratio;
+  work->best_iter       = s->work.best_iter;
+  work->scaled_prim_res = s->work.scaled_prim_res;
+  work->scaled_dual_res = s->work.scaled_dual_res;
+
+  if (!s->exitflag) return 0;
+
+  // Return the iterate of the check, with the products of its residuals
+  OSQPVectorf_copy(work->x,       s->x);
+  OSQPVectorf_copy(work->z,       s->z);
+  OSQPVectorf_copy(work->y,       s->y);
+  OSQPVectorf_copy(work->delta_x, s->delta_x);
+  OSQPVectorf_copy(work->delta_y, s->delta_y);
+  OSQPVectorf_copy(work->Ax,      ac->Ax);
+  OSQPVectorf_copy(work->Px,      ac->Px);
+  OSQPVectorf_copy(work->Aty,     ac->Aty);
+
+  info->iter     = s->info.iter;
+  info->obj_val  = s->info.obj_val;
+  info->prim_res = s->info.prim_res;
+  info->dual_res = s->info.dual_res;
+  update_status(info, s->info.status_val);
+#ifdef OSQP_ENABLE_PRINTING
+  work->summary_printed = 0;
+#endif
+
+  return 1;
+}
+
+void async_check_free(OSQPAsyncCheck* ac) {
+
+  if (!ac) return;
+
+  pthread_mutex_lock(&ac->lock);
+  ac->quit = 1;
+  pthread_cond_broadcast(&ac->cond);
+  pthread_mutex_unlock(&ac->lock);
+  pthread_join(ac->thread, OSQP_NULL);
+
+  pthread_cond_destroy(&ac->cond);
+  pthread_mutex_destroy(&ac->lock);
+  free_buffers(ac);
+}
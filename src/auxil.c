@@ -6,6 +6,11 @@
 #include "printing.h"
 #include "timing.h"
 
+#ifndef OSQP_EMBEDDED_MODE
+# include "reorder.h"
+# include "eliminate.h"
+#endif
+
 /***********************************************************
 * Auxiliary functions needed to compute ADMM iterations * *
 ***********************************************************/
@@ -55,6 +60,9 @@ OSQPInt adapt_rho(OSQPSolver* solver) {
 
   OSQPInt   exitflag; // Exitflag
   OSQPFloat rho_new;  // New rho value
+#if !defined(OSQP_EMBEDDED_MODE) && defined(OSQP_ENABLE_PROFILING)
+  OSQPFloat t_update; // Time of the rho update
+#endif
 
   OSQPInfo*      info     = solver->info;
   OSQPSettings*  settings = solver->settings;
@@ -70,8 +78,26 @@ OSQPInt adapt_rho(OSQPSolver* solver) {
   // Check if the new rho is large or small enough and update it in case
   if ((rho_new > settings->rho * settings->adaptive_rho_tolerance) ||
       (rho_new < settings->rho / settings->adaptive_rho_tolerance)) {
+#ifndef OSQP_EMBEDDED_MODE
+    // Leave out the updates that cost more than they are expected to save
+    if (settings->adaptive_rho_cost_model && !rho_update_pays(solver, rho_new)) {
+      info->rho_updates_skipped += 1;
+      return exitflag;
+    }
+# ifdef OSQP_ENABLE_PROFILING
+    t_update = osqp_toc(solver->work->timer);
+# endif
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
     exitflag                 = osqp_update_rho(solver, rho_new);
     info->rho_updates += 1;
+
+#if !defined(OSQP_EMBEDDED_MODE) && defined(OSQP_ENABLE_PROFILING)
+    // Measured for adaptive_rho_cost_model
+    t_update = osqp_toc(solver->work->timer) - t_update;
+    solver->work->rho_refactor_time   = t_update;
+    solver->work->rho_refactor_total += t_update;
+#endif
   }
 
   return exitflag;
@@ -105,6 +131,13 @@ OSQPInt set_rho_vec(OSQPSolver* solver) {
 
   OSQPVectorf_ew_reciprocal(work->rho_inv_vec, work->rho_vec);
 
+#ifndef OSQP_EMBEDDED_MODE
+  // The segment kernels need the constraint types to follow the grouping
+  if (work->reorder && work->reorder->grouped) {
+    work->reorder->segmented = reorder_check_segments(work->reorder, work->constr_type);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   return constr_types_changed;
 }
 
@@ -137,22 +170,77 @@ void swap_vectors(OSQPVectorf** a,
   *a   = temp;
 }
 
-static void compute_rhs(OSQPSolver* solver) {
+#ifndef OSQP_EMBEDDED_MODE
 
-  OSQPWorkspace* work     = solver->work;
-  OSQPSettings*  settings = solver->settings;
+/*
+ * Segment s of the grouped constraints (0: equalities, 1: inequalities,
+ * 2: loose constraints). Returns its length and sets its first row and the
+ * value of rho_vec on it.
+ */
+static OSQPInt rho_segment(const OSQPSolver* solver,
+                           OSQPInt           s,
+                           OSQPInt*          head,
+                           OSQPFloat*        rho) {
+
+  const OSQPReorder* r = solver->work->reorder;
+
+  switch (s) {
+  case 0:
+    *head = 0;
+    *rho  = OSQP_RHO_EQ_OVER_RHO_INEQ*solver->settings->rho;
+    return r->n_eq;
+  case 1:
+    *head = r->n_eq;
+    *rho  = solver->settings->rho;
+    return r->n_ineq;
+  default:
+    *head = r->n_eq + r->n_ineq;
+    *rho  = OSQP_RHO_MIN;
+    return r->m - r->n_eq - r->n_ineq;
+  }
+}
+
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+void compute_rhs(OSQPSolver* solver) {
+
+  OSQPWorkspace*   work     = solver->work;
+  OSQPSettings*    settings = solver->settings;
+  OSQPVectorf_expr e;
+
+#ifndef OSQP_EMBEDDED_MODE
+  OSQPInt      s, head, len;
+  OSQPFloat    rho;
+  OSQPVectorf** v;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
   //part related to x variables
   OSQPVectorf_add_scaled(work->xtilde_view,
                          settings->sigma,work->x_prev,
                          -1., work->data->q);
 
+#ifndef OSQP_EMBEDDED_MODE
+  // rho is constant on each segment of the grouped constraints
+  if (work->reorder && work->reorder->segmented) {
+    v = work->reorder->view;
+    for (s = 0; s < 3; s++) {
+      len = rho_segment(solver, s, &head, &rho);
+      if (len == 0) continue;
+      OSQPVectorf_view_update(v[0], work->ztilde_view, head, len);
+      OSQPVectorf_view_update(v[1], work->z_prev, head, len);
+      OSQPVectorf_view_update(v[2], work->y, head, len);
+      OSQPVectorf_add_scaled(v[0], 1.0, v[1], -1.0 / rho, v[2]);
+    }
+    return;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   //part related to dual variable in the equality constrained QP (nu)
   if (settings->rho_is_vec) {
-    OSQPVectorf_ew_prod(work->ztilde_view, work->rho_inv_vec, work->y);
-    OSQPVectorf_add_scaled(work->ztilde_view,
-                           -1.0, work->ztilde_view,
-                           1.0, work->z_prev);
+    OSQPVectorf_expr_init(&e);
+    OSQPVectorf_expr_add(&e, 1.0, work->z_prev);
+    OSQPVectorf_expr_add_prod(&e, -1.0, work->rho_inv_vec, work->y);
+    OSQPVectorf_eval(work->ztilde_view, &e);
   }
   else {
     OSQPVectorf_add_scaled(work->ztilde_view,
@@ -189,44 +277,102 @@ void update_x(OSQPSolver* solver) {
 
 void update_z(OSQPSolver* solver) {
 
-  OSQPSettings*  settings = solver->settings;
-  OSQPWorkspace* work     = solver->work;
+  OSQPSettings*    settings = solver->settings;
+  OSQPWorkspace*   work     = solver->work;
+  OSQPVectorf_expr e;
+
+#ifndef OSQP_EMBEDDED_MODE
+  OSQPInt      s, head, len;
+  OSQPFloat    rho;
+  OSQPVectorf** v;
+
+  // rho is constant on each segment of the grouped constraints
+  if (work->reorder && work->reorder->segmented) {
+    v = work->reorder->view;
+    for (s = 0; s < 3; s++) {
+      len = rho_segment(solver, s, &head, &rho);
+      if (len == 0) continue;
+      OSQPVectorf_view_update(v[0], work->z, head, len);
+      OSQPVectorf_view_update(v[1], work->y, head, len);
+      OSQPVectorf_view_update(v[2], work->ztilde_view, head, len);
+      OSQPVectorf_view_update(v[3], work->z_prev, head, len);
+      OSQPVectorf_add_scaled3(v[0],
+                              1.0 / rho, v[1],
+                              settings->alpha, v[2],
+                              (1.0 - settings->alpha), v[3]);
+    }
+
+    // project z onto C = [l,u]; loose constraints are never active
+    len = work->reorder->n_eq + work->reorder->n_ineq;
+    if (len > 0) {
+      OSQPVectorf_view_update(v[0], work->z, 0, len);
+      OSQPVectorf_view_update(v[1], work->data->l, 0, len);
+      OSQPVectorf_view_update(v[2], work->data->u, 0, len);
+      OSQPVectorf_ew_bound_vec(v[0], v[0], v[1], v[2]);
+    }
+    return;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
-  // update z
+  // update z and project it onto C = [l,u] in one pass
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add(&e, settings->alpha, work->ztilde_view);
+  OSQPVectorf_expr_add(&e, (1.0 - settings->alpha), work->z_prev);
   if (settings->rho_is_vec) {
-    OSQPVectorf_ew_prod(work->z, work->rho_inv_vec,work->y);
-    OSQPVectorf_add_scaled3(work->z,
-                            1., work->z,
-                            settings->alpha, work->ztilde_view,
-                            (1.0 - settings->alpha), work->z_prev);
+    OSQPVectorf_expr_add_prod(&e, 1.0, work->rho_inv_vec, work->y);
   }
   else {
-    OSQPVectorf_add_scaled3(work->z,
-                            settings->alpha, work->ztilde_view,
-                            (1.0 - settings->alpha), work->z_prev,
-                            work->rho_inv, work->y);
+    OSQPVectorf_expr_add(&e, work->rho_inv, work->y);
   }
-
-  // project z onto C = [l,u]
-  OSQPVectorf_ew_bound_vec(work->z, work->z, work->data->l, work->data->u);
+  OSQPVectorf_expr_bound_vec(&e, work->data->l, work->data->u);
+  OSQPVectorf_eval(work->z, &e);
 }
 
 void update_y(OSQPSolver* solver) {
 
-  OSQPSettings*  settings = solver->settings;
-  OSQPWorkspace* work     = solver->work;
+  OSQPSettings*    settings = solver->settings;
+  OSQPWorkspace*   work     = solver->work;
+  OSQPVectorf_expr e;
 
-  OSQPVectorf_add_scaled3(work->delta_y,
-                          settings->alpha, work->ztilde_view,
-                          (1.0 - settings->alpha), work->z_prev,
-                          -1.0, work->z);
+#ifndef OSQP_EMBEDDED_MODE
+  OSQPInt       s, head, len;
+  OSQPFloat     rho;
+  OSQPVectorf** v;
+
+  if (work->reorder && work->reorder->segmented) {
+    // rho is constant on each segment of the grouped constraints
+    v = work->reorder->view;
+    for (s = 0; s < 3; s++) {
+      len = rho_segment(solver, s, &head, &rho);
+      if (len == 0) continue;
+      OSQPVectorf_view_update(v[0], work->delta_y, head, len);
+      OSQPVectorf_view_update(v[1], work->ztilde_view, head, len);
+      OSQPVectorf_view_update(v[2], work->z_prev, head, len);
+      OSQPVectorf_view_update(v[3], work->z, head, len);
+      OSQPVectorf_expr_init(&e);
+      OSQPVectorf_expr_add(&e, settings->alpha, v[1]);
+      OSQPVectorf_expr_add(&e, (1.0 - settings->alpha), v[2]);
+      OSQPVectorf_expr_add(&e, -1.0, v[3]);
+      OSQPVectorf_expr_mult_scalar(&e, rho);
+      OSQPVectorf_eval(v[0], &e);
+    }
+    OSQPVectorf_plus(work->y, work->y, work->delta_y);
+    return;
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 
+  // delta_y = rho .* (alpha*ztilde + (1-alpha)*z_prev - z)
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add(&e, settings->alpha, work->ztilde_view);
+  OSQPVectorf_expr_add(&e, (1.0 - settings->alpha), work->z_prev);
+  OSQPVectorf_expr_add(&e, -1.0, work->z);
   if (settings->rho_is_vec) {
-    OSQPVectorf_ew_prod(work->delta_y, work->delta_y, work->rho_vec);
+    OSQPVectorf_expr_ew_prod(&e, work->rho_vec);
   }
   else {
-    OSQPVectorf_mult_scalar(work->delta_y, settings->rho);
+    OSQPVectorf_expr_mult_scalar(&e, settings->rho);
   }
+  OSQPVectorf_eval(work->delta_y, &e);
 
   OSQPVectorf_plus(work->y, work->y, work->delta_y);
 
@@ -235,17 +381,25 @@ void update_y(OSQPSolver* solver) {
 OSQPFloat compute_obj_val(const OSQPSolver*  solver,
                           const OSQPVectorf* x) {
 
-  OSQPFloat obj_val;
-  OSQPWorkspace* work = solver->work;
+  OSQPFloat        obj_val;
+  OSQPWorkspace*   work = solver->work;
+  OSQPVectorf_expr e;
 
   /* NB: The function is always called after dual_res is computed */
-  obj_val = 0.5 * OSQPVectorf_dot_prod(work->Px, x) +
-            OSQPVectorf_dot_prod(work->data->q, x);
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add(&e, 0.5, work->Px);
+  OSQPVectorf_expr_add(&e, 1.0, work->data->q);
+  obj_val = OSQPVectorf_expr_dot_prod(&e, x);
 
   if (solver->settings->scaling) {
     obj_val *= work->scaling->cinv;
   }
 
+#ifndef OSQP_EMBEDDED_MODE
+  // Cost of the substitution at x_r = 0
+  if (work->elim) obj_val += work->elim->obj_const;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   return obj_val;
 }
 
@@ -256,21 +410,25 @@ static OSQPFloat compute_prim_res(OSQPSolver*        solver,
   // NB: Use z_prev as working vector
   // pr = Ax - z
 
-  OSQPSettings*  settings = solver->settings;
-  OSQPWorkspace* work     = solver->work;
-  OSQPFloat prim_res;
+  OSQPSettings*    settings = solver->settings;
+  OSQPWorkspace*   work     = solver->work;
+  OSQPFloat        prim_res;
+  OSQPVectorf_expr e;
 
   OSQPMatrix_Axpy(work->data->A,x,work->Ax, 1.0, 0.0); //Ax = A*x
-  OSQPVectorf_minus(work->z_prev, work->Ax, z);
 
-  work->scaled_prim_res = OSQPVectorf_norm_inf(work->z_prev);
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add(&e, 1.0, work->Ax);
+  OSQPVectorf_expr_add(&e, -1.0, z);
 
-  // If scaling active -> rescale residual
+  // If scaling active -> rescale residual in the same pass
   if (settings->scaling && !settings->scaled_termination) {
-    prim_res =  OSQPVectorf_scaled_norm_inf(work->scaling->Einv, work->z_prev);
+    work->scaled_prim_res = OSQPVectorf_eval_norm_inf(work->z_prev, &e,
+                                                      work->scaling->Einv, &prim_res);
   }
   else{
-    prim_res  = work->scaled_prim_res;
+    work->scaled_prim_res = OSQPVectorf_eval_norm_inf(work->z_prev, &e, OSQP_NULL, OSQP_NULL);
+    prim_res              = work->scaled_prim_res;
   }
   return prim_res;
 }
@@ -320,34 +478,34 @@ static OSQPFloat compute_dual_res(OSQPSolver*        solver,
   // NB: Only upper triangular part of P is stored.
   // dr = q + A'*y + P*x
 
-  OSQPSettings*  settings = solver->settings;
-  OSQPWorkspace* work     = solver->work;
-  OSQPFloat      dual_res;
-
-  // dr = q
-  OSQPVectorf_copy(work->x_prev, work->data->q);
+  OSQPSettings*    settings = solver->settings;
+  OSQPWorkspace*   work     = solver->work;
+  OSQPFloat        dual_res;
+  OSQPVectorf_expr e;
 
   // Px = P * x
   OSQPMatrix_Axpy(work->data->P, x, work->Px, 1.0, 0.0);
 
-  // dr += Px
-  OSQPVectorf_plus(work->x_prev, work->x_prev, work->Px);
+  // dr = q + Px
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add(&e, 1.0, work->data->q);
+  OSQPVectorf_expr_add(&e, 1.0, work->Px);
 
   // dr += A' * y
   if (work->data->m) {
     OSQPMatrix_Atxpy(work->data->A, y, work->Aty, 1.0, 0.0);
-    OSQPVectorf_plus(work->x_prev, work->x_prev, work->Aty);
+    OSQPVectorf_expr_add(&e, 1.0, work->Aty);
   }
 
-  work->scaled_dual_res = OSQPVectorf_norm_inf(work->x_prev);
-
-  // If scaling active -> rescale residual
+  // If scaling active -> rescale residual in the same pass
   if (settings->scaling && !settings->scaled_termination) {
-    dual_res =  work->scaling->cinv * OSQPVectorf_scaled_norm_inf(work->scaling->Dinv,
-                                                                  work->x_prev);
+    work->scaled_dual_res = OSQPVectorf_eval_norm_inf(work->x_prev, &e,
+                                                      work->scaling->Dinv, &dual_res);
+    dual_res *= work->scaling->cinv;
   }
   else {
-    dual_res = work->scaled_dual_res;
+    work->scaled_dual_res = OSQPVectorf_eval_norm_inf(work->x_prev, &e, OSQP_NULL, OSQP_NULL);
+    dual_res              = work->scaled_dual_res;
   }
 
   return dual_res;
@@ -612,6 +770,12 @@ void store_solution(OSQPSolver *solver) {
 
 #endif /* ifndef OSQP_EMBEDDED_MODE */
   }
+
+#ifndef OSQP_EMBEDDED_MODE
+  // Return the solution in the user ordering, with the eliminated variables
+  if (work->reorder) reorder_solution(work->reorder, solution);
+  if (work->elim)    eliminate_solution(work->elim, solution, solver->info);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
 }
 
 void update_info(OSQPSolver* solver,
@@ -708,6 +872,7 @@ void reset_info(OSQPInfo *info) {
 
 #if OSQP_EMBEDDED_MODE != 1
   info->rho_updates = 0;              // Rho updates are now 0
+  info->rho_updates_skipped = 0;      // Skipped rho updates are now 0
 #endif /* if OSQP_EMBEDDED_MODE != 1 */
 }
 
@@ -723,7 +888,8 @@ const char *OSQP_STATUS_MESSAGE[] = {
   "run time limit reached",
   "problem non convex",
   "interrupted",
-  "unsolved"
+  "unsolved",
+  "stalled"
 };
 
 void update_status(OSQPInfo* info,
@@ -735,8 +901,8 @@ void update_status(OSQPInfo* info,
   c_strcpy(info->status, OSQP_STATUS_MESSAGE[status_val]);
 }
 
-OSQPInt check_termination(OSQPSolver* solver,
-                          OSQPInt     approximate) {
+OSQPInt check_termination_conditions(OSQPSolver* solver,
+                                     OSQPInt     approximate) {
 
   OSQPFloat eps_prim, eps_dual, eps_prim_inf, eps_dual_inf;
   OSQPInt   exitflag;
@@ -855,6 +1021,126 @@ OSQPInt check_termination(OSQPSolver* solver,
 
 #ifndef OSQP_EMBEDDED_MODE
 
+/* Residuals relative to the tolerances of the termination check (1 at convergence) */
+static OSQPFloat compute_res_ratio(const OSQPSolver* solver) {
+
+  OSQPFloat      ratio;
+  OSQPSettings*  settings = solver->settings;
+  OSQPInfo*      info     = solver->info;
+
+  ratio = info->dual_res / compute_dual_tol(solver, settings->eps_abs, settings->eps_rel);
+  if (solver->work->data->m) {
+    ratio = c_max(ratio, info->prim_res /
+                         compute_prim_tol(solver, settings->eps_abs, settings->eps_rel));
+  }
+  return ratio;
+}
+
+OSQPInt check_stall(OSQPSolver* solver,
+                    OSQPInt     iter) {
+
+  OSQPFloat      ratio;
+  OSQPSettings*  settings = solver->settings;
+  OSQPWorkspace* work     = solver->work;
+
+  if (!settings->stall_checks && !settings->best_iterate) return 0;
+
+  ratio = compute_res_ratio(solver);
+
+  if (settings->best_iterate && ratio < work->best_ratio) {
+    OSQPVectorf_copy(work->best_x, work->x);
+    OSQPVectorf_copy(work->best_z, work->z);
+    OSQPVectorf_copy(work->best_y, work->y);
+    work->best_ratio = ratio;
+    work->best_iter  = iter;
+  }
+
+  if (ratio < OSQP_STALL_DECREASE * work->stall_ref) {
+    work->stall_ref   = ratio;
+    work->stall_count = 0;
+  }
+  else {
+    work->stall_count++;
+  }
+
+  if (settings->stall_checks && work->stall_count >= settings->stall_checks) {
+    update_status(solver->info, OSQP_STALLED);
+    return 1;
+  }
+  return 0;
+}
+
+void restore_best_iterate(OSQPSolver* solver,
+                          OSQPInt     compute_obj) {
+
+  OSQPWorkspace* work = solver->work;
+
+  if (work->best_ratio >= compute_res_ratio(solver)) return;
+
+  OSQPVectorf_copy(work->x, work->best_x);
+  OSQPVectorf_copy(work->z, work->best_z);
+  OSQPVectorf_copy(work->y, work->best_y);
+
+  // The iteration count stays the number of iterations run
+  update_info(solver, solver->info->iter, compute_obj, 0);
+
+# ifdef OSQP_ENABLE_PRINTING
+  if (solver->settings->verbose)
+    c_print("returning the iterate of iteration %i\n", (int)work->best_iter);
+# endif
+}
+
+OSQPInt rho_update_pays(OSQPSolver* solver,
+                        OSQPFloat   rho_new) {
+
+# ifdef OSQP_ENABLE_PROFILING
+  OSQPInt   pays, iter;
+  OSQPFloat ratio, rate, left, mismatch, saved, t_iter;
+
+  OSQPSettings*  settings = solver->settings;
+  OSQPWorkspace* work     = solver->work;
+
+  iter  = solver->info->iter;
+  ratio = compute_res_ratio(solver);
+
+  // Iterations left at the rate the residual ratio decreased since the
+  // previous adaptation, up to max_iter
+  left = (OSQPFloat)(settings->max_iter - iter);
+  if (ratio <= 1.0) {
+    left = 0.0;
+  }
+  else if (work->rho_trend_iter && ratio < work->rho_trend_ratio) {
+    rate = (c_log(work->rho_trend_ratio) - c_log(ratio)) / (iter - work->rho_trend_iter);
+    left = c_min(left, c_log(ratio) / rate);
+  }
+
+  // A rho off by a factor k slows the iterations down by about sqrt(k)
+  mismatch = c_max(rho_new / settings->rho, settings->rho / rho_new);
+  saved    = left * (1.0 - 1.0 / c_sqrt(mismatch));
+
+  // Time per iteration of this solve, without the rho updates
+  t_iter = (osqp_toc(work->timer) - work->rho_refactor_total) / iter;
+
+  // Update at the first adaptation of a solve, whose trend is not known yet
+  pays = !work->rho_trend_iter || work->rho_refactor_time == 0.0 ||
+         saved * t_iter > work->rho_refactor_time;
+
+  work->rho_trend_ratio = ratio;
+  work->rho_trend_iter  = iter;
+
+#  ifdef OSQP_ENABLE_PRINTING
+  if (settings->verbose)
+    c_print("rho %.2e -> %.2e: saves %.2e s, costs %.2e s, %s\n",
+            settings->rho, rho_new, saved * t_iter, work->rho_refactor_time,
+            pays ? "updated" : "skipped");
+#  endif
+
+  return pays;
+# else /* ifdef OSQP_ENABLE_PROFILING */
+  return 1;
+# endif /* ifdef OSQP_ENABLE_PROFILING */
+}
+
 OSQPInt validate_data(const OSQPCscMatrix* P,
                       const OSQPFloat*     q,
                       const OSQPCscMatrix* A,
@@ -924,10 +1210,68 @@ OSQPInt validate_data(const OSQPCscMatrix* P,
   return 0;
 }
 
+OSQPInt validate_operators(const OSQPOperator* P,
+                           const OSQPFloat*    q,
+                           const OSQPOperator* A,
+                           const OSQPFloat*    l,
+                           const OSQPFloat*    u,
+                                 OSQPInt       m,
+                                 OSQPInt       n) {
+  OSQPInt j;
+
+  if (!P || !P->mult) {
+    c_eprint("Missing quadratic cost operator P");
+    return 1;
+  }
+
+  if (!A || !A->mult || !A->mult_trans) {
+    c_eprint("Missing constraint operator A (both products are required)");
+    return 1;
+  }
+
+  if (!q) {
+    c_eprint("Missing linear cost vector q");
+    return 1;
+  }
+
+  // General dimensions Tests
+  if ((n <= 0) || (m < 0)) {
+    c_eprint("n must be positive and m nonnegative; n = %i, m = %i",
+             (int)n, (int)m);
+    return 1;
+  }
+
+  if ((P->m != n) || (P->n != n)) {
+    c_eprint("P does not have dimension n x n with n = %i", (int)n);
+    return 1;
+  }
+
+  if ((A->m != m) || (A->n != n)) {
+    c_eprint("A does not have dimension %i x %i", (int)m, (int)n);
+    return 1;
+  }
+
+  // Lower and upper bounds
+  for (j = 0; j < m; j++) {
+    if (l[j] > u[j]) {
+      c_eprint("Lower bound at index %d is greater than upper bound: %.4e > %.4e",
+               (int)j, l[j], u[j]);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
 OSQPInt validate_linsys_solver(OSQPInt linsys_solver) {
+  /* Every algebra backend chooses one of its solvers */
+  if (linsys_solver == OSQP_AUTO_SOLVER) {
+    return 0;
+  }
+
   /* Verify the algebra backend supports the requested indirect solver */
   if ( (linsys_solver == OSQP_INDIRECT_SOLVER) &&
      (osqp_algebra_linsys_supported() & OSQP_CAPABILITY_INDIRECT_SOLVER) ) {
@@ -940,6 +1284,12 @@ OSQPInt validate_linsys_solver(OSQPInt linsys_solver) {
     return 0;
   }
 
+  /* Verify the algebra backend supports the requested hybrid solver */
+  if ( (linsys_solver == OSQP_HYBRID_SOLVER) &&
+     (osqp_algebra_linsys_supported() & OSQP_CAPABILITY_HYBRID_SOLVER) ) {
+    return 0;
+  }
+
   // Invalid solver
   return 1;
 }
@@ -1100,5 +1450,165 @@ OSQPInt validate_settings(const OSQPSettings* settings,
     return 1;
   }
 
+  if (from_setup &&
+      settings->polish_in_place != 0 &&
+      settings->polish_in_place != 1) {
+    c_eprint("polish_in_place must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->lean_memory != 0 &&
+      settings->lean_memory != 1) {
+    c_eprint("lean_memory must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->huge_pages != 0 &&
+      settings->huge_pages != 1) {
+    c_eprint("huge_pages must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup && settings->numa_node < -1) {
+    c_eprint("numa_node must be -1 or a valid node index");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->realtime != 0 &&
+      settings->realtime != 1 &&
+      settings->realtime != 2) {
+    c_eprint("realtime must be 0, 1 or 2");
+    return 1;
+  }
+
+#ifndef OSQP_ENABLE_DERIVATIVES
+  if (from_setup && settings->realtime == 2) {
+    c_eprint("realtime = 2 requires a build with derivatives");
+    return 1;
+  }
+#endif
+
+  if (from_setup && settings->realtime && settings->lean_memory) {
+    c_eprint("realtime and lean_memory cannot be enabled together");
+    return 1;
+  }
+
+  if (from_setup && settings->realtime == 2 && settings->reorder) {
+    c_eprint("realtime = 2 cannot be combined with reorder");
+    return 1;
+  }
+
+  if (from_setup && settings->realtime == 2 &&
+      settings->group_constraints && settings->rho_is_vec) {
+    c_eprint("realtime = 2 cannot be combined with group_constraints");
+    return 1;
+  }
+
+  if (from_setup && settings->realtime == 2 && settings->eliminate_equalities) {
+    c_eprint("realtime = 2 cannot be combined with eliminate_equalities");
+    return 1;
+  }
+
+  if (from_setup && settings->realtime &&
+      settings->linsys_solver != OSQP_DIRECT_SOLVER) {
+    c_eprint("realtime requires the direct linear system solver");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->lock_memory != 0 &&
+      settings->lock_memory != 1) {
+    c_eprint("lock_memory must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->reorder != OSQP_NO_REORDER &&
+      settings->reorder != OSQP_RCM_REORDER) {
+    c_eprint("reorder not recognized");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->group_constraints != 0 &&
+      settings->group_constraints != 1) {
+    c_eprint("group_constraints must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->compress_indices != 0 &&
+      settings->compress_indices != 1) {
+    c_eprint("compress_indices must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->eliminate_equalities != 0 &&
+      settings->eliminate_equalities != 1) {
+    c_eprint("eliminate_equalities must be either 0 or 1");
+    return 1;
+  }
+
+  if (settings->stall_checks < 0) {
+    c_eprint("stall_checks must be nonnegative");
+    return 1;
+  }
+
+  if (settings->best_iterate != 0 &&
+      settings->best_iterate != 1) {
+    c_eprint("best_iterate must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->supernodal != 0 &&
+      settings->supernodal != 1) {
+    c_eprint("supernodal must be either 0 or 1");
+    return 1;
+  }
+
+  if (settings->async_termination != 0 &&
+      settings->async_termination != 1) {
+    c_eprint("async_termination must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->setup_threads <= 0) {
+    c_eprint("setup_threads must be positive");
+    return 1;
+  }
+
+  if (settings->adaptive_rho_cost_model != 0 &&
+      settings->adaptive_rho_cost_model != 1) {
+    c_eprint("adaptive_rho_cost_model must be either 0 or 1");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->linsys_library != OSQP_ALGEBRA_LINSYS &&
+      settings->linsys_library != OSQP_MKL_PARDISO_LINSYS) {
+    c_eprint("linsys_library not recognized");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->linsys_library == OSQP_MKL_PARDISO_LINSYS &&
+      !(osqp_algebra_linsys_supported() & OSQP_CAPABILITY_MKL_PARDISO)) {
+    c_eprint("MKL Pardiso is not available (it needs the builtin algebra built with OSQP_ENABLE_RUNTIME_MKL and the MKL runtime library)");
+    return 1;
+  }
+
+  if (from_setup &&
+      settings->linsys_library == OSQP_MKL_PARDISO_LINSYS &&
+      settings->linsys_solver != OSQP_DIRECT_SOLVER) {
+    c_eprint("MKL Pardiso requires the direct linear system solver");
+    return 1;
+  }
+
   return 0;
 }
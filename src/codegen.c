@@ -196,6 +196,23 @@ static OSQPInt write_settings(FILE*               f,
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->time_limit);
   fprintf(f, "  (OSQPFloat)%.20f,\n", settings->delta);
   fprintf(f, "  %d,\n", settings->polish_refine_iter);
+  fprintf(f, "  0,\n"); // polish_in_place
+  fprintf(f, "  0,\n"); // lean_memory
+  fprintf(f, "  0,\n"); // huge_pages
+  fprintf(f, "  -1,\n"); // numa_node
+  fprintf(f, "  0,\n"); // realtime
+  fprintf(f, "  0,\n"); // lock_memory
+  fprintf(f, "  0,\n"); // reorder
+  fprintf(f, "  0,\n"); // group_constraints
+  fprintf(f, "  0,\n"); // compress_indices
+  fprintf(f, "  0,\n"); // eliminate_equalities
+  fprintf(f, "  0,\n"); // stall_checks
+  fprintf(f, "  0,\n"); // best_iterate
+  fprintf(f, "  0,\n"); // supernodal
+  fprintf(f, "  0,\n"); // async_termination
+  fprintf(f, "  1,\n"); // setup_threads
+  fprintf(f, "  0,\n"); // adaptive_rho_cost_model
+  fprintf(f, "  OSQP_ALGEBRA_LINSYS,\n"); // linsys_library
   fprintf(f, "};\n\n");
 
   return OSQP_NO_ERROR;
@@ -222,6 +239,7 @@ static OSQPInt write_info(FILE*           f,
   fprintf(f, "  (OSQPFloat)%.20f,\n", OSQP_INFTY); // dual_res
   fprintf(f, "  0,\n"); // iter (iteration count)
   fprintf(f, "  0,\n"); // rho_updates
+  fprintf(f, "  0,\n"); // rho_updates_skipped
   fprintf(f, "  (OSQPFloat)%.20f,\n", info->rho_estimate);
   fprintf(f, "  (OSQPFloat)0.0,\n"); // setup_time
   fprintf(f, "  (OSQPFloat)0.0,\n"); // solve_time
@@ -387,6 +405,10 @@ static OSQPInt write_linsys(FILE*               f,
     fprintf(f, "QDLDL_int   %slinsys_iwork[%d];\n", prefix, 3*(n+m));
     fprintf(f, "QDLDL_bool  %slinsys_bwork[%d];\n", prefix, n+m);
     fprintf(f, "QDLDL_float %slinsys_fwork[%d];\n", prefix, n+m);
+    if (linsys->row_work) {
+      sprintf(name, "%slinsys_row_work", prefix);
+      GENERATE_ERROR(write_vecf(f, linsys->row_work, n+m, name))
+    }
   }
 
   fprintf(f, "qdldl_solver %slinsys = {\n", prefix);
@@ -428,6 +450,12 @@ static OSQPInt write_linsys(FILE*               f,
     fprintf(f, "  %slinsys_iwork,\n", prefix);
     fprintf(f, "  %slinsys_bwork,\n", prefix);
     fprintf(f, "  %slinsys_fwork,\n", prefix);
+    if (linsys->row_work) {
+      fprintf(f, "  %slinsys_row_work,\n", prefix);
+    }
+    else {
+      fprintf(f, "  OSQP_NULL,\n");
+    }
   }
   fprintf(f, "};\n\n");
 
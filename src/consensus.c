@@ -0,0 +1,540 @@
+#include "consensus.h"
+#include "auxil.h"
+#include "error.h"
+#include "printing.h"
+#include "timing.h"
+#include "csc_utils.h"
+
+#ifdef OSQP_ENABLE_INTERRUPT
+# include "interrupt.h"
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+enum {
+  CONSENSUS_TASK_SETUP,
+  CONSENSUS_TASK_SOLVE,
+  CONSENSUS_TASK_UPDATE_RHO
+};
+
+
+/* Set up the solver of block k on the rows row_start[k]..row_start[k+1]-1 */
+static OSQPInt setup_block(OSQPConsensusJob* job) {
+
+  OSQPConsensus* cons  = job->cons;
+  OSQPInt        k     = job->k;
+  OSQPInt        first = cons->row_start[k];
+  OSQPInt        mk    = cons->row_start[k+1] - first;
+  OSQPInt        i, exitflag;
+  OSQPInt*       rows;
+  OSQPCscMatrix* Ak;
+
+  rows = c_calloc(c_max(cons->m, 1), sizeof(OSQPInt));
+  if (!rows) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  for (i = first; i < first + mk; i++) rows[i] = 1;
+  Ak = csc_submatrix_byrows(job->A, rows);
+  c_free(rows);
+  if (!Ak) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // The local linear cost is q/K until the first solve sets it
+  exitflag = osqp_setup(&cons->blocks[k], cons->Pk, cons->qk + k * cons->n, Ak,
+                        job->l + first, job->u + first, mk, cons->n, cons->settings);
+  csc_spfree(Ak);
+
+  return exitflag;
+}
+
+/* Local solve of block k from q_k = q/K + rho*(w_k - z) */
+static OSQPInt solve_block(OSQPConsensusJob* job) {
+
+  OSQPConsensus* cons = job->cons;
+  OSQPSolver*    s    = cons->blocks[job->k];
+  OSQPInt        n    = cons->n;
+  OSQPFloat*     qk   = cons->qk + job->k * n;
+  OSQPFloat*     wk   = cons->wk + job->k * n;
+  OSQPInt        j, exitflag;
+
+  for (j = 0; j < n; j++) qk[j] = cons->q[j] / cons->K + cons->rho * (wk[j] - cons->z[j]);
+
+  exitflag = osqp_update_data_vec(s, qk, OSQP_NULL, OSQP_NULL);
+  if (!exitflag) exitflag = osqp_solve(s);
+  if (exitflag) return exitflag;
+
+  cons->status[job->k] = s->info->status_val;
+  if (has_solution(s->info)) {
+    for (j = 0; j < n; j++) cons->xk[job->k * n + j] = s->solution->x[j];
+  }
+
+  return 0;
+}
+
+static OSQPInt run_task(OSQPConsensusJob* job) {
+
+  OSQPConsensus* cons = job->cons;
+
+  switch (job->task) {
+  case CONSENSUS_TASK_SETUP:
+    return setup_block(job);
+
+  case CONSENSUS_TASK_SOLVE:
+    return solve_block(job);
+
+  case CONSENSUS_TASK_UPDATE_RHO:
+    return osqp_update_data_mat(cons->blocks[job->k], cons->Pk_diag_x, cons->Pk_diag, cons->n,
+                                OSQP_NULL, OSQP_NULL, 0);
+
+  default:
+    return 1;
+  }
+}
+
+#ifdef OSQP_ENABLE_THREADS
+static void* block_thread(void* arg) {
+
+  OSQPConsensusJob* job = (OSQPConsensusJob*)arg;
+
+  job->exitflag = run_task(job);
+  return OSQP_NULL;
+}
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
+/*
+ * Run a task on every block: block 0 on the calling thread and the others on
+ * their own threads (or one after the other without threads, or when a thread
+ * cannot be created). Returns the first nonzero exitflag.
+ */
+static OSQPInt run_blocks(OSQPConsensus* cons,
+                          OSQPInt        task) {
+
+  OSQPInt k;
+
+  for (k = 0; k < cons->K; k++) {
+    cons->jobs[k].task     = task;
+    cons->jobs[k].exitflag = 0;
+  }
+
+#ifdef OSQP_ENABLE_THREADS
+  cons->jobs[0].threaded = 0;
+  for (k = 1; k < cons->K; k++) {
+    cons->jobs[k].threaded =
+      !pthread_create(&cons->threads[k], OSQP_NULL, &block_thread, &cons->jobs[k]);
+  }
+  for (k = 0; k < cons->K; k++) {
+    if (!cons->jobs[k].threaded) cons->jobs[k].exitflag = run_task(&cons->jobs[k]);
+  }
+  for (k = 1; k < cons->K; k++) {
+    if (cons->jobs[k].threaded) pthread_join(cons->threads[k], OSQP_NULL);
+  }
+#else
+  for (k = 0; k < cons->K; k++) cons->jobs[k].exitflag = run_task(&cons->jobs[k]);
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
+  for (k = 0; k < cons->K; k++) {
+    if (cons->jobs[k].exitflag) return cons->jobs[k].exitflag;
+  }
+  return 0;
+}
+
+/* Pk = P/K + rho*I with the diagonal entry last in each column */
+static OSQPInt build_local_cost(OSQPConsensus*       cons,
+                                const OSQPCscMatrix* P) {
+
+  OSQPInt   n = cons->n;
+  OSQPInt   i, j, ptr, nz = 0;
+  OSQPFloat d;
+
+  cons->Pk = csc_spalloc(n, n, P->p[n] + n, 1, 0);
+  if (!cons->Pk) return 1;
+
+  for (j = 0; j < n; j++) {
+    cons->Pk->p[j] = nz;
+    d = 0.0;
+    for (ptr = P->p[j]; ptr < P->p[j+1]; ptr++) {
+      i = P->i[ptr];
+      if (i == j) {
+        d += P->x[ptr];
+      }
+      else {
+        cons->Pk->i[nz]   = i;
+        cons->Pk->x[nz++] = P->x[ptr] / cons->K;
+      }
+    }
+    cons->P_diag[j]    = d / cons->K;
+    cons->Pk_diag[j]   = nz;
+    cons->Pk->i[nz]    = j;
+    cons->Pk->x[nz++]  = cons->P_diag[j] + cons->rho;
+  }
+  cons->Pk->p[n]  = nz;
+  cons->Pk->nzmax = nz;
+
+  return 0;
+}
+
+/* 1/2 x'Px + q'x with P upper triangular */
+static OSQPFloat objective(const OSQPConsensus* cons,
+                           const OSQPFloat*     x) {
+
+  const OSQPCscMatrix* P = cons->P;
+  OSQPInt   i, j, ptr;
+  OSQPFloat obj = 0.0;
+
+  for (j = 0; j < cons->n; j++) {
+    obj += cons->q[j] * x[j];
+    for (ptr = P->p[j]; ptr < P->p[j+1]; ptr++) {
+      i = P->i[ptr];
+      obj += (i == j ? 0.5 : 1.0) * P->x[ptr] * x[i] * x[j];
+    }
+  }
+  return obj;
+}
+
+static OSQPFloat norm_inf(const OSQPFloat* v,
+                          OSQPInt          len) {
+  OSQPInt   i;
+  OSQPFloat r = 0.0;
+
+  for (i = 0; i < len; i++) r = c_max(r, c_absval(v[i]));
+  return r;
+}
+
+
+OSQPInt consensus_setup(OSQPConsensus**      consp,
+                        const OSQPCscMatrix* P,
+                        const OSQPFloat*     q,
+                        const OSQPCscMatrix* A,
+                        const OSQPFloat*     l,
+                        const OSQPFloat*     u,
+                        OSQPInt              m,
+                        OSQPInt              n,
+                        OSQPInt              K,
+                        const OSQPInt*       row_start,
+                        const OSQPSettings*  settings) {
+
+  OSQPInt        j, k, exitflag;
+  OSQPConsensus* cons;
+
+  // Check the blocks before allocating anything
+  if (K < 1) {
+    c_eprint("Number of blocks must be positive");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (row_start) {
+    if (row_start[0] != 0 || row_start[K] != m) {
+      c_eprint("row_start must start at 0 and end at m");
+      return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+    }
+    for (k = 0; k < K; k++) {
+      if (row_start[k+1] < row_start[k]) {
+        c_eprint("row_start must be nondecreasing");
+        return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+      }
+    }
+  }
+
+  cons = c_calloc(1, sizeof(OSQPConsensus));
+  if (!cons) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  *consp = cons;
+
+#ifdef OSQP_ENABLE_PROFILING
+  cons->timer = OSQPTimer_new();
+  if (!cons->timer) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  osqp_tic(cons->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  cons->n   = n;
+  cons->m   = m;
+  cons->K   = K;
+  cons->rho = settings->rho;
+
+  cons->row_start = c_malloc((K + 1) * sizeof(OSQPInt));
+  cons->blocks    = c_calloc(K, sizeof(OSQPSolver*));
+  cons->settings  = c_malloc(sizeof(OSQPSettings));
+  cons->q         = c_malloc(n * sizeof(OSQPFloat));
+  cons->Pk_diag   = c_malloc(n * sizeof(OSQPInt));
+  cons->Pk_diag_x = c_malloc(n * sizeof(OSQPFloat));
+  cons->P_diag    = c_malloc(n * sizeof(OSQPFloat));
+  cons->z         = c_calloc(n, sizeof(OSQPFloat));
+  cons->z_prev    = c_calloc(n, sizeof(OSQPFloat));
+  cons->xk        = c_calloc(n * K, sizeof(OSQPFloat));
+  cons->wk        = c_calloc(n * K, sizeof(OSQPFloat));
+  cons->qk        = c_malloc(n * K * sizeof(OSQPFloat));
+  cons->status    = c_calloc(K, sizeof(OSQPInt));
+  cons->jobs      = c_calloc(K, sizeof(OSQPConsensusJob));
+  cons->P         = csc_copy(P);
+#ifdef OSQP_ENABLE_THREADS
+  cons->threads   = c_malloc(K * sizeof(pthread_t));
+#endif
+  if (!cons->row_start || !cons->blocks || !cons->settings || !cons->q ||
+      !cons->Pk_diag || !cons->Pk_diag_x || !cons->P_diag || !cons->z ||
+      !cons->z_prev || !cons->xk || !cons->wk || !cons->qk || !cons->status ||
+      !cons->jobs || !cons->P)
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+#ifdef OSQP_ENABLE_THREADS
+  if (!cons->threads) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+#endif
+
+  // Blocks of (nearly) equal size by default
+  for (k = 0; k <= K; k++) cons->row_start[k] = row_start ? row_start[k] : (k * m) / K;
+
+  for (j = 0; j < n; j++) cons->q[j] = q[j];
+  for (k = 0; k < K; k++) {
+    for (j = 0; j < n; j++) cons->qk[k * n + j] = q[j] / K;
+  }
+
+  // The consensus iterations are checked here, the local solves only print errors
+  *cons->settings = *settings;
+  cons->settings->verbose       = 0;
+  cons->settings->polishing     = 0;
+  cons->settings->warm_starting = 1;
+  cons->settings->time_limit    = OSQP_TIME_LIMIT;
+
+  // The local costs are updated through the diagonal of P
+  cons->settings->eliminate_equalities = 0;
+
+  // A local solve runs to its tolerances or max_iter
+  cons->settings->stall_checks = 0;
+  cons->settings->best_iterate = 0;
+
+  // The blocks already run on the threads of the consensus solve
+  cons->settings->async_termination = 0;
+
+  if (build_local_cost(cons, P)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  for (k = 0; k < K; k++) {
+    cons->jobs[k].cons = cons;
+    cons->jobs[k].k    = k;
+    cons->jobs[k].A    = A;
+    cons->jobs[k].l    = l;
+    cons->jobs[k].u    = u;
+  }
+  exitflag = run_blocks(cons, CONSENSUS_TASK_SETUP);
+
+  // The data of the blocks is only read during the setup
+  for (k = 0; k < K; k++) {
+    cons->jobs[k].A = OSQP_NULL;
+    cons->jobs[k].l = OSQP_NULL;
+    cons->jobs[k].u = OSQP_NULL;
+  }
+  if (exitflag) return exitflag;
+
+  // The consensus iterations keep the settings of the caller
+  *cons->settings = *settings;
+
+#ifdef OSQP_ENABLE_PROFILING
+  cons->setup_time = osqp_toc(cons->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  return 0;
+}
+
+
+OSQPInt consensus_solve(OSQPConsensus* cons,
+                        OSQPFloat*     x,
+                        OSQPFloat*     y,
+                        OSQPInfo*      info) {
+
+  OSQPInt    n = cons->n;
+  OSQPInt    K = cons->K;
+  OSQPInt    iter, j, k, exitflag = 0;
+  OSQPInt    status      = OSQP_UNSOLVED;
+  OSQPInt    rho_updates = 0;
+  OSQPInt    last_update = 0;
+  OSQPFloat  prim_res = 0.0, dual_res = 0.0;
+  OSQPFloat  eps_prim, eps_dual, xk_norm, wk_norm, scale;
+  OSQPFloat* xk;
+  OSQPFloat* wk;
+  OSQPSettings* settings = cons->settings;
+
+#ifdef OSQP_ENABLE_PROFILING
+  osqp_tic(cons->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+#ifdef OSQP_ENABLE_INTERRUPT
+  osqp_start_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+#ifdef OSQP_ENABLE_PRINTING
+  if (settings->verbose) {
+    c_print("consensus ADMM: %i blocks of rows, n = %i, m = %i\n",
+            (int)K, (int)n, (int)cons->m);
+    c_print("%5s %12s %12s %12s\n", "iter", "prim res", "dual res", "rho");
+  }
+#endif /* ifdef OSQP_ENABLE_PRINTING */
+
+  for (iter = 1; iter <= settings->max_iter; iter++) {
+
+    // Local solves, each block from its last iterate
+    exitflag = run_blocks(cons, CONSENSUS_TASK_SOLVE);
+    if (exitflag) goto exit;
+
+    // A block without a feasible point makes the whole problem infeasible
+    for (k = 0; k < K; k++) {
+      if (cons->status[k] == OSQP_PRIMAL_INFEASIBLE ||
+          cons->status[k] == OSQP_PRIMAL_INFEASIBLE_INACCURATE) {
+        status = cons->status[k];
+        break;
+      }
+    }
+    if (status != OSQP_UNSOLVED) break;
+
+    // z = mean(x_k + w_k), then w_k += x_k - z
+    for (j = 0; j < n; j++) {
+      cons->z_prev[j] = cons->z[j];
+      cons->z[j]      = 0.0;
+    }
+    for (k = 0; k < K; k++) {
+      xk = cons->xk + k * n;
+      wk = cons->wk + k * n;
+      for (j = 0; j < n; j++) cons->z[j] += xk[j] + wk[j];
+    }
+    for (j = 0; j < n; j++) cons->z[j] /= K;
+
+    prim_res = 0.0;
+    xk_norm  = 0.0;
+    wk_norm  = 0.0;
+    for (k = 0; k < K; k++) {
+      xk = cons->xk + k * n;
+      wk = cons->wk + k * n;
+      for (j = 0; j < n; j++) {
+        wk[j]   += xk[j] - cons->z[j];
+        prim_res = c_max(prim_res, c_absval(xk[j] - cons->z[j]));
+      }
+      xk_norm = c_max(xk_norm, norm_inf(xk, n));
+      wk_norm = c_max(wk_norm, norm_inf(wk, n));
+    }
+    dual_res = 0.0;
+    for (j = 0; j < n; j++) dual_res = c_max(dual_res, c_absval(cons->z[j] - cons->z_prev[j]));
+    dual_res *= cons->rho;
+
+#ifdef OSQP_ENABLE_PRINTING
+    if (settings->verbose && (iter == 1 || iter % 10 == 0)) {
+      c_print("%5i %12.4e %12.4e %12.4e\n", (int)iter, prim_res, dual_res, cons->rho);
+    }
+#endif /* ifdef OSQP_ENABLE_PRINTING */
+
+    eps_prim = settings->eps_abs + settings->eps_rel * c_max(xk_norm, norm_inf(cons->z, n));
+    eps_dual = settings->eps_abs + settings->eps_rel * cons->rho * wk_norm;
+    if (iter > 1 && prim_res <= eps_prim && dual_res <= eps_dual) {
+      status = OSQP_SOLVED;
+      break;
+    }
+
+#ifdef OSQP_ENABLE_INTERRUPT
+    if (osqp_is_interrupted()) {
+      status = OSQP_SIGINT;
+      c_print("Solver interrupted\n");
+      break;
+    }
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+#ifdef OSQP_ENABLE_PROFILING
+    if (settings->time_limit && osqp_toc(cons->timer) >= settings->time_limit) {
+      status = OSQP_TIME_LIMIT_REACHED;
+      break;
+    }
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+    // Residual balancing; the scaled duals w_k follow the change of rho
+    if (settings->adaptive_rho && iter - last_update >= CONSENSUS_RHO_INTERVAL) {
+      scale = 1.0;
+      if (prim_res > CONSENSUS_RHO_RATIO * dual_res)      scale = 2.0;
+      else if (dual_res > CONSENSUS_RHO_RATIO * prim_res) scale = 0.5;
+
+      if (scale != 1.0) {
+        cons->rho *= scale;
+        for (j = 0; j < n * K; j++) cons->wk[j] /= scale;
+        for (j = 0; j < n; j++)     cons->Pk_diag_x[j] = cons->P_diag[j] + cons->rho;
+
+        exitflag = run_blocks(cons, CONSENSUS_TASK_UPDATE_RHO);
+        if (exitflag) {
+          c_eprint("Failed rho update");
+          goto exit;
+        }
+        rho_updates++;
+        last_update = iter;
+      }
+    }
+  }
+  if (status == OSQP_UNSOLVED) {
+    status = OSQP_MAX_ITER_REACHED;
+    iter   = settings->max_iter;
+  }
+
+  // The duals of the blocks are the duals of the whole problem
+  if (status == OSQP_PRIMAL_INFEASIBLE || status == OSQP_PRIMAL_INFEASIBLE_INACCURATE) {
+    for (j = 0; j < n; j++)       x[j] = OSQP_NAN;
+    for (j = 0; j < cons->m; j++) y[j] = OSQP_NAN;
+  }
+  else {
+    for (j = 0; j < n; j++) x[j] = cons->z[j];
+    for (k = 0; k < K; k++) {
+      for (j = cons->row_start[k]; j < cons->row_start[k+1]; j++)
+        y[j] = cons->blocks[k]->solution->y[j - cons->row_start[k]];
+    }
+  }
+
+  if (info) {
+    reset_info(info);
+    update_status(info, status);
+    info->status_polish = OSQP_POLISH_NOT_PERFORMED;
+    info->obj_val       = has_solution(info) ? objective(cons, x) : OSQP_NAN;
+    info->prim_res      = prim_res;
+    info->dual_res      = dual_res;
+    info->iter          = iter;
+    info->rho_updates   = rho_updates;
+    info->rho_estimate  = cons->rho;
+#ifdef OSQP_ENABLE_PROFILING
+    info->setup_time    = cons->setup_time;
+    info->solve_time    = osqp_toc(cons->timer);
+    info->run_time      = info->setup_time + info->solve_time;
+    cons->setup_time    = 0.0;
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+  }
+
+#ifdef OSQP_ENABLE_PRINTING
+  if (settings->verbose) {
+    c_print("status: %s after %i iterations\n", OSQP_STATUS_MESSAGE[status], (int)iter);
+  }
+#endif /* ifdef OSQP_ENABLE_PRINTING */
+
+exit:
+#ifdef OSQP_ENABLE_INTERRUPT
+  osqp_end_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+  return exitflag;
+}
+
+
+void consensus_free(OSQPConsensus* cons) {
+
+  OSQPInt k;
+
+  if (!cons) return;
+
+  if (cons->blocks) {
+    for (k = 0; k < cons->K; k++) osqp_cleanup(cons->blocks[k]);
+  }
+#ifdef OSQP_ENABLE_PROFILING
+  OSQPTimer_free(cons->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+#ifdef OSQP_ENABLE_THREADS
+  c_free(cons->threads);
+#endif
+  csc_spfree(cons->P);
+  csc_spfree(cons->Pk);
+  c_free(cons->row_start);
+  c_free(cons->blocks);
+  c_free(cons->settings);
+  c_free(cons->q);
+  c_free(cons->Pk_diag);
+  c_free(cons->Pk_diag_x);
+  c_free(cons->P_diag);
+  c_free(cons->z);
+  c_free(cons->z_prev);
+  c_free(cons->xk);
+  c_free(cons->wk);
+  c_free(cons->qk);
+  c_free(cons->status);
+  c_free(cons->jobs);
+  c_free(cons);
+}
@@ -1,6 +1,7 @@
 #include "derivative.h"
 #include "lin_alg.h"
 #include "error.h"
+#include "printing.h"
 #include "csc_utils.h"
 #include "csc_math.h"
 
@@ -28,6 +29,34 @@ OSQPInt unscale_lu(OSQPSolver*  solver,
     return 0;
 }
 
+/* The derivatives are not translated from the internal ordering */
+static OSQPInt reorder_not_supported(void) {
+    c_eprint("derivatives are not supported for solvers set up with reorder or group_constraints");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+}
+
+/* The derivatives are taken from the entries of P and A */
+static OSQPInt operators_not_supported(void) {
+    c_eprint("derivatives are not supported for solvers set up with operators");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+}
+
+/* The derivatives are not translated from the reduced problem */
+static OSQPInt eliminate_not_supported(void) {
+    c_eprint("derivatives are not supported for solvers set up with eliminate_equalities");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+}
+
+/* Position of the x block in the second half of the solved adjoint system */
+static OSQPInt rx_position(OSQPSolver* solver) {
+
+    OSQPInt n = solver->work->data->n;
+    OSQPDerivativeData *derivative_data = solver->work->derivative_data;
+
+    if (derivative_data->adj_solver) return n + 3 * solver->work->data->m;
+    return n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
+}
+
 OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
                                         OSQPCscMatrix* dP,
                                         OSQPCscMatrix* dA) {
@@ -35,20 +64,20 @@ OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
     // Check if solver has been initialized
     if (!solver || !solver->work || !solver->work->derivative_data)
       return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+    if (solver->work->reorder) return reorder_not_supported();
+    if (solver->work->matrix_free) return operators_not_supported();
+    if (solver->work->elim) return eliminate_not_supported();
 
     OSQPInt n = solver->work->data->n;
     OSQPDerivativeData *derivative_data = solver->work->derivative_data;
-    OSQPVectorf* x = OSQPVectorf_new(solver->solution->x, n);  // unscaled solution
-    OSQPFloat* x_data = OSQPVectorf_data(x);
+    OSQPFloat* x_data = solver->solution->x;  // unscaled solution
 
     OSQPFloat* y_u_data = OSQPVectorf_data(derivative_data->y_u);
     OSQPFloat* y_l_data = OSQPVectorf_data(derivative_data->y_l);
     OSQPFloat* ryu_data = OSQPVectorf_data(derivative_data->ryu);
     OSQPFloat* ryl_data = OSQPVectorf_data(derivative_data->ryl);
 
-    OSQPInt pos = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
-    OSQPVectorf* rx = OSQPVectorf_view(derivative_data->rhs, pos, n);
-    OSQPFloat* rx_data  = OSQPVectorf_data(rx);
+    OSQPFloat* rx_data  = OSQPVectorf_data(derivative_data->rhs) + rx_position(solver);
 
     OSQPInt col;
     for (col=0; col<n; col++) {
@@ -63,9 +92,6 @@ OSQPInt adjoint_derivative_get_mat(OSQPSolver *solver,
         }
     }
 
-    OSQPVectorf_view_free(rx);
-    OSQPVectorf_free(x);
-
     return 0;
 }
 
@@ -77,22 +103,250 @@ OSQPInt adjoint_derivative_get_vec(OSQPSolver *solver,
     // Check if solver has been initialized
     if (!solver || !solver->work || !solver->work->derivative_data)
       return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+    if (solver->work->reorder) return reorder_not_supported();
+    if (solver->work->matrix_free) return operators_not_supported();
+    if (solver->work->elim) return eliminate_not_supported();
 
     OSQPInt n = solver->work->data->n;
     OSQPDerivativeData *derivative_data = solver->work->derivative_data;
 
-    OSQPInt pos = n + derivative_data->n_ineq_l + derivative_data->n_ineq_u + derivative_data->n_eq;
-    OSQPVectorf* rx = OSQPVectorf_view(derivative_data->rhs, pos, n);
+    OSQPFloat* rx_data = OSQPVectorf_data(derivative_data->rhs) + rx_position(solver);
 
     // Assign vector derivatives to function arguments
-    OSQPVectorf_to_raw(dq, rx);
+    for (OSQPInt i=0; i<n; i++) {
+        dq[i] = rx_data[i];
+    }
     OSQPVectorf_to_raw(dl, derivative_data->ryl);
     OSQPVectorf_to_raw(du, derivative_data->ryu);
     for (OSQPInt i=0; i<OSQPVectorf_length(derivative_data->ryu); i++) {
         du[i] = -du[i];
     }
 
-    OSQPVectorf_view_free(rx);
+    return 0;
+}
+
+/* Slots of a constraint in the fixed-structure adjoint system */
+#define SLOT_L  1  /* lower bound, row of -A in G */
+#define SLOT_U  2  /* upper bound, row of A in G */
+#define SLOT_EQ 4  /* equality, row of A_eq */
+
+OSQPInt adjoint_derivative_alloc_system(OSQPSolver* solver) {
+
+    OSQPWorkspace*      work = solver->work;
+    OSQPDerivativeData* derivative_data = work->derivative_data;
+    OSQPInt             n = work->data->n;
+    OSQPInt             m = work->data->m;
+    OSQPInt             nnz;
+
+    derivative_data->P_full   = OSQPMatrix_triu_to_symm(work->data->P);
+    derivative_data->G        = OSQPMatrix_vstack(work->data->A, work->data->A);
+    derivative_data->A_eq     = OSQPMatrix_copy_new(work->data->A);
+    derivative_data->slacks   = OSQPVectorf_malloc(2*m);
+    derivative_data->lambda   = OSQPVectorf_malloc(2*m);
+    derivative_data->G_scale  = OSQPVectorf_malloc(2*m);
+    derivative_data->eq_scale = OSQPVectorf_malloc(m);
+    derivative_data->x        = OSQPVectorf_malloc(n);
+    if (!derivative_data->P_full || !derivative_data->G || !derivative_data->A_eq ||
+        !derivative_data->slacks || !derivative_data->lambda || !derivative_data->G_scale ||
+        !derivative_data->eq_scale || !derivative_data->x)
+      return OSQP_MEM_ALLOC_ERROR;
+
+    derivative_data->GDiagLambda = OSQPMatrix_copy_new(derivative_data->G);
+
+    nnz = c_max(OSQPMatrix_get_nz(derivative_data->P_full), OSQPMatrix_get_nz(derivative_data->G));
+    derivative_data->ctype = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
+    derivative_data->iwork = (OSQPInt *) c_malloc(n * sizeof(OSQPInt));
+    derivative_data->fwork = (OSQPFloat *) c_malloc(nnz * sizeof(OSQPFloat));
+    if (!derivative_data->GDiagLambda || (m && !derivative_data->ctype) ||
+        !derivative_data->iwork || (nnz && !derivative_data->fwork))
+      return OSQP_MEM_ALLOC_ERROR;
+
+    // Only the structure matters for the ordering; keep the slack diagonal nonzero
+    OSQPVectorf_set_scalar(derivative_data->slacks, 1.0);
+
+    return adjoint_derivative_init_linsys_solver(&derivative_data->adj_solver, solver->settings,
+                                                 derivative_data->P_full, derivative_data->G,
+                                                 derivative_data->A_eq, derivative_data->GDiagLambda,
+                                                 derivative_data->slacks);
+}
+
+void adjoint_derivative_free_system(OSQPDerivativeData* derivative_data) {
+
+    if (derivative_data->adj_solver) derivative_data->adj_solver->free(derivative_data->adj_solver);
+    OSQPMatrix_free(derivative_data->P_full);
+    OSQPMatrix_free(derivative_data->G);
+    OSQPMatrix_free(derivative_data->A_eq);
+    OSQPMatrix_free(derivative_data->GDiagLambda);
+    OSQPVectorf_free(derivative_data->slacks);
+    OSQPVectorf_free(derivative_data->lambda);
+    OSQPVectorf_free(derivative_data->G_scale);
+    OSQPVectorf_free(derivative_data->eq_scale);
+    OSQPVectorf_free(derivative_data->x);
+    c_free(derivative_data->ctype);
+    c_free(derivative_data->iwork);
+    c_free(derivative_data->fwork);
+}
+
+/*
+ * Adjoint derivatives on the structure allocated by adjoint_derivative_alloc_system.
+ * Every constraint keeps its three slots and the slots that do not apply get
+ * zero rows, zero multipliers and a unit slack, so no allocation is needed.
+ */
+static OSQPInt adjoint_derivative_compute_fixed(OSQPSolver *solver,
+                                                OSQPFloat*     dx,
+                                                OSQPFloat*     dy_l,
+                                                OSQPFloat*     dy_u) {
+
+    OSQPWorkspace*      work = solver->work;
+    OSQPDerivativeData* derivative_data = work->derivative_data;
+    OSQPInt             m = work->data->m;
+    OSQPInt             n = work->data->n;
+    OSQPInt             half = n + 3*m;  // Half the dimension of the adjoint system
+
+    OSQPMatrix* P_full      = derivative_data->P_full;
+    OSQPMatrix* G           = derivative_data->G;
+    OSQPMatrix* A_eq        = derivative_data->A_eq;
+    OSQPMatrix* GDiagLambda = derivative_data->GDiagLambda;
+
+    OSQPFloat* l_data   = OSQPVectorf_data(work->data->l);
+    OSQPFloat* u_data   = OSQPVectorf_data(work->data->u);
+    OSQPFloat* y_data   = solver->solution->y;
+    OSQPFloat* Einv     = work->scaling ? OSQPVectorf_data(work->scaling->Einv) : OSQP_NULL;
+    OSQPFloat* G_scale  = OSQPVectorf_data(derivative_data->G_scale);
+    OSQPFloat* eq_scale = OSQPVectorf_data(derivative_data->eq_scale);
+    OSQPFloat* lambda   = OSQPVectorf_data(derivative_data->lambda);
+    OSQPFloat* slacks   = OSQPVectorf_data(derivative_data->slacks);
+    OSQPFloat* y_l      = OSQPVectorf_data(derivative_data->y_l);
+    OSQPFloat* y_u      = OSQPVectorf_data(derivative_data->y_u);
+    OSQPFloat* ryl      = OSQPVectorf_data(derivative_data->ryl);
+    OSQPFloat* ryu      = OSQPVectorf_data(derivative_data->ryu);
+    OSQPFloat* rhs      = OSQPVectorf_data(derivative_data->rhs);
+    OSQPFloat* fwork    = derivative_data->fwork;
+    OSQPInt*   iwork    = derivative_data->iwork;
+    OSQPInt*   ctype    = derivative_data->ctype;
+
+    OSQPFloat infval = OSQP_INFTY * OSQP_MIN_SCALING;
+    OSQPFloat e, _l, _u;
+    OSQPInt   j, col, ptr, len, pos;
+
+    const OSQPInt*   Ap = OSQPMatrix_get_p(work->data->A);
+    const OSQPFloat* Ax = OSQPMatrix_get_x(work->data->A);
+    const OSQPInt*   Pp = OSQPMatrix_get_p(work->data->P);
+    const OSQPInt*   Pi = OSQPMatrix_get_i(work->data->P);
+    const OSQPFloat* Px = OSQPMatrix_get_x(work->data->P);
+
+    // ---------- Constraint slots, multipliers and slacks
+    derivative_data->n_ineq_l = 0;
+    derivative_data->n_ineq_u = 0;
+    derivative_data->n_eq = 0;
+
+    for (j = 0; j < m; j++) {
+        e  = Einv ? Einv[j] : 1.0;
+        _l = l_data[j] * e;
+        _u = u_data[j] * e;
+
+        ctype[j] = 0;
+        if (_l < _u) {
+            if (_l > -infval) {
+                ctype[j] |= SLOT_L;
+                derivative_data->n_ineq_l++;
+            }
+            if (_u < infval) {
+                ctype[j] |= SLOT_U;
+                derivative_data->n_ineq_u++;
+            }
+        } else {
+            ctype[j] = SLOT_EQ;
+            derivative_data->n_eq++;
+        }
+
+        y_u[j] = c_max(y_data[j], 0.0);
+        y_l[j] = -c_min(y_data[j], 0.0);
+
+        G_scale[j]     = (ctype[j] & SLOT_L)  ? -e : 0.0;
+        G_scale[m + j] = (ctype[j] & SLOT_U)  ?  e : 0.0;
+        eq_scale[j]    = (ctype[j] & SLOT_EQ) ?  e : 0.0;
+        lambda[j]      = (ctype[j] & SLOT_L)  ? y_l[j] : 0.0;
+        lambda[m + j]  = (ctype[j] & SLOT_U)  ? y_u[j] : 0.0;
+
+        // h = [-l; u], becomes G*x - h below
+        slacks[j]      = (ctype[j] & SLOT_L)  ? -_l : 1.0;
+        slacks[m + j]  = (ctype[j] & SLOT_U)  ?  _u : 1.0;
+    }
+
+    // ---------- G = diag(G_scale) [A; A] D^-1 and GDiagLambda = diag(lambda) G
+    for (col = 0; col < n; col++) {
+        len = Ap[col+1] - Ap[col];
+        for (ptr = Ap[col]; ptr < Ap[col+1]; ptr++) {
+            fwork[Ap[col] + ptr]       = Ax[ptr];
+            fwork[Ap[col] + ptr + len] = Ax[ptr];
+        }
+    }
+    OSQPMatrix_update_values(G, fwork, OSQP_NULL, OSQPMatrix_get_nz(G));
+    OSQPMatrix_lmult_diag(G, derivative_data->G_scale);
+    if (work->scaling) OSQPMatrix_rmult_diag(G, work->scaling->Dinv);
+
+    OSQPMatrix_update_values(GDiagLambda, OSQPMatrix_get_x(G), OSQP_NULL, OSQPMatrix_get_nz(G));
+    OSQPMatrix_lmult_diag(GDiagLambda, derivative_data->lambda);
+
+    // ---------- A_eq = diag(eq_scale) A D^-1
+    OSQPMatrix_update_values(A_eq, Ax, OSQP_NULL, OSQPMatrix_get_nz(A_eq));
+    OSQPMatrix_lmult_diag(A_eq, derivative_data->eq_scale);
+    if (work->scaling) OSQPMatrix_rmult_diag(A_eq, work->scaling->Dinv);
+
+    // ---------- P_full, in the entry order of OSQPMatrix_triu_to_symm
+    for (col = 0; col < n; col++) iwork[col] = OSQPMatrix_get_p(P_full)[col];
+    for (col = 0; col < n; col++) {
+        for (ptr = Pp[col]; ptr < Pp[col+1]; ptr++) {
+            fwork[iwork[col]++] = Px[ptr];
+            if (Pi[ptr] < col) fwork[iwork[Pi[ptr]]++] = Px[ptr];
+        }
+    }
+    OSQPMatrix_update_values(P_full, fwork, OSQP_NULL, OSQPMatrix_get_nz(P_full));
+    if (work->scaling) {
+        OSQPMatrix_mult_scalar(P_full, work->scaling->cinv);
+        OSQPMatrix_lmult_diag(P_full, work->scaling->Dinv);
+        OSQPMatrix_rmult_diag(P_full, work->scaling->Dinv);
+    }
+
+    OSQPVectorf_from_raw(derivative_data->x, solver->solution->x);
+    OSQPMatrix_Axpy(G, derivative_data->x, derivative_data->slacks, 1, -1);
+
+    // ---------- Assemble RHS of the linear system
+    for (j = 0; j < n; j++) rhs[j] = -dx[j];
+    for (j = 0; j < m; j++) {
+        rhs[n + j]       = (ctype[j] & SLOT_L) ? -dy_l[j] : 0.0;
+        rhs[n + m + j]   = (ctype[j] & SLOT_U) ? -dy_u[j] : 0.0;
+        rhs[n + 2*m + j] = 0.0;
+        if (ctype[j] & SLOT_EQ) {
+            rhs[n + 2*m + j] = (y_data[j] >= 0) ? -dy_u[j] : dy_l[j];
+        }
+    }
+    for (j = half; j < 2*half; j++) rhs[j] = 0.0;
+
+    if (adjoint_derivative_linsys_solver(&derivative_data->adj_solver, solver->settings,
+                                         P_full, G, A_eq, GDiagLambda,
+                                         derivative_data->slacks, derivative_data->rhs))
+      return osqp_error(OSQP_LINSYS_SOLVER_INIT_ERROR);
+
+    // ---------- Multiplier sensitivities, read by slot
+    pos = half + n;
+    for (j = 0; j < m; j++) {
+        ryl[j] = 0.0;
+        ryu[j] = 0.0;
+        if (ctype[j] & SLOT_L) ryl[j] = -rhs[pos + j];
+        if (ctype[j] & SLOT_U) ryu[j] = rhs[pos + m + j];
+        if (ctype[j] & SLOT_EQ) {
+            if (y_data[j] >= 0) {
+                ryu[j] = rhs[pos + 2*m + j] / y_data[j];
+            } else {
+                ryl[j] = -rhs[pos + 2*m + j] / y_data[j];
+            }
+        }
+        ryl[j] = -ryl[j] * y_l[j];
+        ryu[j] = ryu[j] * y_u[j];
+    }
+
     return 0;
 }
 
@@ -104,6 +358,12 @@ OSQPInt adjoint_derivative_compute(OSQPSolver *solver,
     // Check if solver has been initialized
     if (!solver || !solver->work || !solver->work->derivative_data)
       return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+    if (solver->work->reorder) return reorder_not_supported();
+    if (solver->work->matrix_free) return operators_not_supported();
+    if (solver->work->elim) return eliminate_not_supported();
+
+    if (solver->work->derivative_data->adj_solver)
+      return adjoint_derivative_compute_fixed(solver, dx, dy_l, dy_u);
 
     OSQPInt m = solver->work->data->m;
     OSQPInt n = solver->work->data->n;
@@ -275,7 +535,7 @@ OSQPInt adjoint_derivative_compute(OSQPSolver *solver,
 
     OSQPMatrix* P_full = OSQPMatrix_triu_to_symm(P);
     OSQPMatrix_free(P);
-    adjoint_derivative_linsys_solver(solver, solver->settings, P_full, G, A_eq, GDiagLambda, slacks, rhs);
+    adjoint_derivative_linsys_solver(&derivative_data->adj_solver, solver->settings, P_full, G, A_eq, GDiagLambda, slacks, rhs);
     OSQPMatrix_free(P_full);
     OSQPMatrix_free(G);
     OSQPMatrix_free(A_eq);
@@ -0,0 +1,830 @@
+#include "eliminate.h"
+#include "auxil.h"
+#include "error.h"
+#include "printing.h"
+#include "csc_utils.h"
+
+
+/*
+ * Equalities during the elimination, stored by rows with sorted columns.
+ * Each column keeps a list of the rows that may contain it (rows are added
+ * when they gain the column, and not removed when they lose it).
+ */
+typedef struct {
+  OSQPInt     n_eq;
+  OSQPInt**   ri;       ///< columns of each row
+  OSQPFloat** rx;       ///< values of each row
+  OSQPInt*    rnz;      ///< number of entries of each row
+  OSQPInt*    rcap;     ///< capacity of each row
+  OSQPFloat*  b;        ///< right-hand side of each row
+  OSQPInt*    done;     ///< row has a pivot or is dependent
+  OSQPInt**   cl;       ///< rows that may contain each column
+  OSQPInt*    cl_n;
+  OSQPInt*    cl_cap;
+  OSQPInt*    ccount;   ///< number of rows without pivot containing each column
+  OSQPInt     nnz;      ///< number of entries of all rows
+  OSQPInt*    wi;       ///< merge buffer (size n)
+  OSQPFloat*  wx;       ///< merge buffer (size n)
+  OSQPInt     ops_cap;  ///< capacity of the elimination steps
+} eq_rows;
+
+
+static OSQPInt push_row(eq_rows* R,
+                        OSQPInt  j,
+                        OSQPInt  row) {
+  OSQPInt  cap;
+  OSQPInt* tmp;
+
+  if (R->cl_n[j] == R->cl_cap[j]) {
+    cap = c_max(2 * R->cl_cap[j], 4);
+    tmp = c_realloc(R->cl[j], cap * sizeof(OSQPInt));
+    if (!tmp) return 1;
+    R->cl[j]     = tmp;
+    R->cl_cap[j] = cap;
+  }
+  R->cl[j][R->cl_n[j]++] = row;
+  return 0;
+}
+
+static OSQPInt push_op(OSQPEliminate* e,
+                       eq_rows*       R,
+                       OSQPInt        row,
+                       OSQPInt        src,
+                       OSQPFloat      val) {
+  OSQPInt    cap;
+  OSQPInt*   ti;
+  OSQPFloat* tx;
+
+  if (e->n_ops == R->ops_cap) {
+    cap = c_max(2 * R->ops_cap, 16);
+    ti  = c_realloc(e->op_row, cap * sizeof(OSQPInt));
+    if (!ti) return 1;
+    e->op_row = ti;
+    ti  = c_realloc(e->op_src, cap * sizeof(OSQPInt));
+    if (!ti) return 1;
+    e->op_src = ti;
+    tx  = c_realloc(e->op_val, cap * sizeof(OSQPFloat));
+    if (!tx) return 1;
+    e->op_val  = tx;
+    R->ops_cap = cap;
+  }
+  e->op_row[e->n_ops] = row;
+  e->op_src[e->n_ops] = src;
+  e->op_val[e->n_ops] = val;
+  e->n_ops++;
+  return 0;
+}
+
+/* Position of column c in row r, or -1 */
+static OSQPInt find_col(const eq_rows* R,
+                        OSQPInt        r,
+                        OSQPInt        c) {
+  OSQPInt lo = 0, hi = R->rnz[r] - 1, mid;
+
+  while (lo <= hi) {
+    mid = (lo + hi) / 2;
+    if (R->ri[r][mid] == c)     return mid;
+    else if (R->ri[r][mid] < c) lo = mid + 1;
+    else                        hi = mid - 1;
+  }
+  return -1;
+}
+
+/* row i -= f * row p, without column c; keeps the column lists and counts */
+static OSQPInt merge_rows(eq_rows*  R,
+                          OSQPInt   i,
+                          OSQPInt   p,
+                          OSQPInt   c,
+                          OSQPFloat f) {
+  OSQPInt    na = R->rnz[i], nb = R->rnz[p];
+  OSQPInt*   ai = R->ri[i];
+  OSQPInt*   bi = R->ri[p];
+  OSQPFloat* ax = R->rx[i];
+  OSQPFloat* bx = R->rx[p];
+  OSQPInt    ka = 0, kb = 0, nz = 0;
+  OSQPInt    j, in_a, in_b, cap;
+  OSQPFloat  v, mag;
+
+  while (ka < na || kb < nb) {
+    in_a = ka < na && (kb >= nb || ai[ka] <= bi[kb]);
+    in_b = kb < nb && (ka >= na || bi[kb] <= ai[ka]);
+    j    = in_a ? ai[ka] : bi[kb];
+    v    = 0.0;
+    mag  = 0.0;
+    if (in_a) {
+      v   += ax[ka];
+      mag += c_absval(ax[ka]);
+      ka++;
+    }
+    if (in_b) {
+      v   -= f * bx[kb];
+      mag += c_absval(f * bx[kb]);
+      kb++;
+    }
+
+    if (j != c && c_absval(v) > ELIMINATE_DROP_TOL * mag) {
+      R->wi[nz]   = j;
+      R->wx[nz++] = v;
+      if (!in_a) {
+        // New entry of row i
+        if (!R->done[i]) R->ccount[j]++;
+        if (push_row(R, j, i)) return 1;
+      }
+    }
+    else if (in_a && !R->done[i]) {
+      // Entry of row i cancelled
+      R->ccount[j]--;
+    }
+  }
+
+  if (nz > R->rcap[i]) {
+    cap = c_max(nz, 2 * R->rcap[i]);
+    ai  = c_realloc(R->ri[i], cap * sizeof(OSQPInt));
+    if (!ai) return 1;
+    R->ri[i] = ai;
+    ax  = c_realloc(R->rx[i], cap * sizeof(OSQPFloat));
+    if (!ax) return 1;
+    R->rx[i]   = ax;
+    R->rcap[i] = cap;
+  }
+  for (j = 0; j < nz; j++) {
+    R->ri[i][j] = R->wi[j];
+    R->rx[i][j] = R->wx[j];
+  }
+  R->nnz   += nz - na;
+  R->rnz[i] = nz;
+  R->b[i]  -= f * R->b[p];
+
+  return 0;
+}
+
+static void free_rows(eq_rows* R,
+                      OSQPInt  n) {
+  OSQPInt k;
+
+  if (R->ri) for (k = 0; k < R->n_eq; k++) c_free(R->ri[k]);
+  if (R->rx) for (k = 0; k < R->n_eq; k++) c_free(R->rx[k]);
+  if (R->cl) for (k = 0; k < n; k++)       c_free(R->cl[k]);
+  c_free(R->ri);
+  c_free(R->rx);
+  c_free(R->rnz);
+  c_free(R->rcap);
+  c_free(R->b);
+  c_free(R->done);
+  c_free(R->cl);
+  c_free(R->cl_n);
+  c_free(R->cl_cap);
+  c_free(R->ccount);
+  c_free(R->wi);
+  c_free(R->wx);
+}
+
+/*
+ * Reduced row echelon form of the equalities, recording the steps in e.
+ * Returns 0 on success, 1 if out of memory, and -1 if the equalities are
+ * inconsistent or fill in beyond max_nnz.
+ */
+static OSQPInt eliminate_rows(OSQPEliminate* e,
+                              eq_rows*       R,
+                              OSQPInt        max_nnz) {
+  OSQPInt   r, p, k, c, pos, best;
+  OSQPFloat amax, bmax = 0.0, apiv, f;
+
+  for (r = 0; r < R->n_eq; r++) bmax = c_max(bmax, c_absval(R->b[r]));
+
+  for (;;) {
+    // Sparsest row without pivot; empty rows are dependent or inconsistent
+    best = -1;
+    for (r = 0; r < R->n_eq; r++) {
+      if (R->done[r]) continue;
+      if (R->rnz[r] == 0) {
+        if (c_absval(R->b[r]) > ELIMINATE_FEAS_TOL * (1.0 + bmax)) return -1;
+        R->done[r]  = 1;
+        e->pivot[r] = -1;
+        continue;
+      }
+      if (best < 0 || R->rnz[r] < R->rnz[best]) best = r;
+    }
+    if (best < 0) break;
+    p = best;
+
+    // Column of fewest rows among the large enough entries (Markowitz)
+    amax = 0.0;
+    for (k = 0; k < R->rnz[p]; k++) amax = c_max(amax, c_absval(R->rx[p][k]));
+    pos = -1;
+    for (k = 0; k < R->rnz[p]; k++) {
+      if (c_absval(R->rx[p][k]) < ELIMINATE_PIVOT_TOL * amax) continue;
+      if (pos < 0 ||
+          R->ccount[R->ri[p][k]] < R->ccount[R->ri[p][pos]] ||
+          (R->ccount[R->ri[p][k]] == R->ccount[R->ri[p][pos]] &&
+           c_absval(R->rx[p][k]) > c_absval(R->rx[p][pos])))
+        pos = k;
+    }
+    c    = R->ri[p][pos];
+    apiv = R->rx[p][pos];
+
+    R->done[p]  = 1;
+    e->pivot[p] = c;
+    for (k = 0; k < R->rnz[p]; k++) R->ccount[R->ri[p][k]]--;
+
+    // Remove the pivot column from every other row, including the rows with a pivot
+    for (k = 0; k < R->cl_n[c]; k++) {
+      r = R->cl[c][k];
+      if (r == p) continue;
+      pos = find_col(R, r, c);
+      if (pos < 0) continue;
+
+      f = R->rx[r][pos] / apiv;
+      if (merge_rows(R, r, p, c, f) || push_op(e, R, r, p, f)) return 1;
+      if (R->nnz > max_nnz) return -1;
+    }
+    c_free(R->cl[c]);
+    R->cl[c]     = OSQP_NULL;
+    R->cl_n[c]   = 0;
+    R->cl_cap[c] = 0;
+  }
+
+  // Unit pivots
+  for (r = 0; r < R->n_eq; r++) {
+    if (e->pivot[r] < 0) continue;
+    pos = find_col(R, r, e->pivot[r]);
+    f   = 1.0 / R->rx[r][pos];
+    for (k = 0; k < R->rnz[r]; k++) R->rx[r][k] *= f;
+    R->b[r] *= f;
+    if (push_op(e, R, r, r, f)) return 1;
+  }
+
+  return 0;
+}
+
+/* Transpose, with sorted row indices */
+static OSQPCscMatrix* transpose(const OSQPCscMatrix* A) {
+  OSQPInt        j, k, pos;
+  OSQPInt*       w;
+  OSQPCscMatrix* C;
+
+  C = csc_spalloc(A->n, A->m, c_max(A->p[A->n], 1), 1, 0);
+  w = c_calloc(c_max(A->m, 1), sizeof(OSQPInt));
+  if (!C || !w) {
+    csc_spfree(C);
+    c_free(w);
+    return OSQP_NULL;
+  }
+
+  for (k = 0; k < A->p[A->n]; k++) w[A->i[k]]++;
+  for (j = 0, pos = 0; j < A->m; j++) {
+    C->p[j] = pos;
+    pos    += w[j];
+    w[j]    = C->p[j];
+  }
+  C->p[A->m] = pos;
+  for (j = 0; j < A->n; j++) {
+    for (k = A->p[j]; k < A->p[j+1]; k++) {
+      pos       = w[A->i[k]]++;
+      C->i[pos] = j;
+      C->x[pos] = A->x[k];
+    }
+  }
+  C->nzmax = A->p[A->n];
+
+  c_free(w);
+  return C;
+}
+
+/* A*B, or its upper triangular part, with sorted row indices */
+static OSQPCscMatrix* multiply(const OSQPCscMatrix* A,
+                               const OSQPCscMatrix* B,
+                               OSQPInt              triu) {
+  OSQPInt        i, j, k, kk, nz = 0;
+  OSQPInt*       mark;
+  OSQPFloat*     acc;
+  OSQPCscMatrix* C  = OSQP_NULL;
+  OSQPCscMatrix* Ct = OSQP_NULL;
+  OSQPCscMatrix* Cs = OSQP_NULL;
+
+  mark = c_malloc(c_max(A->m, 1) * sizeof(OSQPInt));
+  acc  = c_malloc(c_max(A->m, 1) * sizeof(OSQPFloat));
+  if (!mark || !acc) goto done;
+
+  // Pattern
+  for (i = 0; i < A->m; i++) mark[i] = -1;
+  for (j = 0; j < B->n; j++) {
+    for (k = B->p[j]; k < B->p[j+1]; k++) {
+      for (kk = A->p[B->i[k]]; kk < A->p[B->i[k]+1]; kk++) {
+        i = A->i[kk];
+        if ((triu && i > j) || mark[i] == j) continue;
+        mark[i] = j;
+        nz++;
+      }
+    }
+  }
+
+  C = csc_spalloc(A->m, B->n, c_max(nz, 1), 1, 0);
+  if (!C) goto done;
+
+  // Values
+  nz = 0;
+  for (i = 0; i < A->m; i++) mark[i] = -1;
+  for (j = 0; j < B->n; j++) {
+    C->p[j] = nz;
+    for (k = B->p[j]; k < B->p[j+1]; k++) {
+      for (kk = A->p[B->i[k]]; kk < A->p[B->i[k]+1]; kk++) {
+        i = A->i[kk];
+        if (triu && i > j) continue;
+        if (mark[i] != j) {
+          mark[i]    = j;
+          acc[i]     = 0.0;
+          C->i[nz++] = i;
+        }
+        acc[i] += A->x[kk] * B->x[k];
+      }
+    }
+    for (k = C->p[j]; k < nz; k++) C->x[k] = acc[C->i[k]];
+  }
+  C->p[B->n] = nz;
+  C->nzmax   = nz;
+
+  // Sort the rows of each column by transposing twice
+  Ct = transpose(C);
+  if (Ct) Cs = transpose(Ct);
+
+done:
+  csc_spfree(C);
+  csc_spfree(Ct);
+  c_free(mark);
+  c_free(acc);
+  return Cs;
+}
+
+/* y = P*x with P upper triangular */
+static void sym_triu_mult(const OSQPCscMatrix* P,
+                          const OSQPFloat*     x,
+                                OSQPFloat*     y) {
+  OSQPInt i, j, k;
+
+  for (j = 0; j < P->n; j++) y[j] = 0.0;
+  for (j = 0; j < P->n; j++) {
+    for (k = P->p[j]; k < P->p[j+1]; k++) {
+      i     = P->i[k];
+      y[i] += P->x[k] * x[j];
+      if (i != j) y[j] += P->x[k] * x[i];
+    }
+  }
+}
+
+/* t from the bounds of the equalities, then the reduced bounds */
+static void update_bounds(OSQPEliminate* e) {
+  OSQPInt    i, j, k;
+  OSQPFloat* b  = e->fwork + 2 * e->n;         // size n_eq
+  OSQPFloat* At = e->fwork + 2 * e->n + e->n_eq; // size m_r
+
+  // Apply the elimination steps to the right-hand sides
+  for (i = 0; i < e->n_eq; i++) b[i] = e->l[e->eq_row[i]];
+  for (k = 0; k < e->n_ops; k++) {
+    if (e->op_src[k] == e->op_row[k]) b[e->op_row[k]] *= e->op_val[k];
+    else                              b[e->op_row[k]] -= e->op_val[k] * b[e->op_src[k]];
+  }
+
+  for (j = 0; j < e->n; j++) e->t[j] = 0.0;
+  for (i = 0; i < e->n_eq; i++) {
+    if (e->pivot[i] >= 0) e->t[e->pivot[i]] = b[i];
+  }
+
+  // Shift the inequalities by A_I*t; infinite bounds stay infinite
+  for (i = 0; i < e->m_r; i++) At[i] = 0.0;
+  for (j = 0; j < e->n; j++) {
+    for (k = e->A_ineq->p[j]; k < e->A_ineq->p[j+1]; k++)
+      At[e->A_ineq->i[k]] += e->A_ineq->x[k] * e->t[j];
+  }
+  for (i = 0; i < e->m_r; i++) {
+    e->l_r[i] = e->l[e->ineq_row[i]];
+    e->u_r[i] = e->u[e->ineq_row[i]];
+    if (e->l_r[i] > -OSQP_INFTY) e->l_r[i] -= At[i];
+    if (e->u_r[i] <  OSQP_INFTY) e->u_r[i] -= At[i];
+  }
+}
+
+/* q_r = T'(P*t + q) and the objective at x_r = 0 */
+static void update_cost(OSQPEliminate* e) {
+  OSQPInt    i, j, k;
+  OSQPFloat* Pt = e->fwork;
+
+  sym_triu_mult(e->P, e->t, Pt);
+
+  e->obj_const = 0.0;
+  for (j = 0; j < e->n; j++) {
+    e->obj_const += e->t[j] * (0.5 * Pt[j] + e->q[j]);
+    Pt[j]        += e->q[j];
+  }
+
+  for (i = 0; i < e->n_r; i++) e->q_r[i] = 0.0;
+  for (j = 0; j < e->n; j++) {
+    for (k = e->Tt->p[j]; k < e->Tt->p[j+1]; k++) e->q_r[e->Tt->i[k]] += e->Tt->x[k] * Pt[j];
+  }
+}
+
+/* Substitution matrix from the rows in reduced row echelon form */
+static OSQPInt build_substitution(OSQPEliminate* e,
+                                  const eq_rows* R) {
+  OSQPInt  n = e->n;
+  OSQPInt  i, j, k, nz = 0;
+  OSQPInt* row_of = e->free_var;  // free_var is filled afterwards
+
+  // Row solving for each variable, or -1 for the remaining variables
+  for (j = 0; j < n; j++) row_of[j] = -1;
+  for (i = 0; i < e->n_eq; i++) {
+    if (e->pivot[i] >= 0) row_of[e->pivot[i]] = i;
+  }
+
+  // Index of each remaining variable in x_r (stored in t for now)
+  e->n_r = 0;
+  for (j = 0; j < n; j++) {
+    if (row_of[j] < 0) nz++;
+    else               nz += R->rnz[row_of[j]] - 1;
+    e->t[j] = row_of[j] < 0 ? (OSQPFloat)(e->n_r++) : -1.0;
+  }
+  if (e->n_r == 0) return -1;
+
+  // Row j of T is e_j for a remaining variable, and -(row without pivot) for a pivot
+  e->Tt = csc_spalloc(e->n_r, n, c_max(nz, 1), 1, 0);
+  if (!e->Tt) return 1;
+  nz = 0;
+  for (j = 0; j < n; j++) {
+    e->Tt->p[j] = nz;
+    if (row_of[j] < 0) {
+      e->Tt->i[nz]   = (OSQPInt)e->t[j];
+      e->Tt->x[nz++] = 1.0;
+    }
+    else {
+      i = row_of[j];
+      for (k = 0; k < R->rnz[i]; k++) {
+        if (R->ri[i][k] == j) continue;
+        e->Tt->i[nz]   = (OSQPInt)e->t[R->ri[i][k]];
+        e->Tt->x[nz++] = -R->rx[i][k];
+      }
+    }
+  }
+  e->Tt->p[n]  = nz;
+  e->Tt->nzmax = nz;
+
+  e->T = transpose(e->Tt);
+  if (!e->T) return 1;
+
+  for (j = 0, k = 0; j < n; j++) {
+    if (row_of[j] < 0) e->free_var[k++] = j;
+  }
+  return 0;
+}
+
+
+OSQPInt eliminate_new(OSQPEliminate**      elimp,
+                      const OSQPCscMatrix* P,
+                      const OSQPFloat*     q,
+                      const OSQPCscMatrix* A,
+                      const OSQPFloat*     l,
+                      const OSQPFloat*     u,
+                      OSQPInt              m,
+                      OSQPInt              n,
+                      OSQPCscMatrix**      Pr,
+                      OSQPCscMatrix**      Ar) {
+
+  OSQPInt        i, j, k, r, exitflag = 1;
+  OSQPInt        max_nnz;
+  OSQPInt*       eq_idx = OSQP_NULL;
+  OSQPInt*       mask   = OSQP_NULL;
+  OSQPCscMatrix* P_full = OSQP_NULL;
+  OSQPCscMatrix* W      = OSQP_NULL;
+  OSQPEliminate* e;
+  eq_rows        R = {0};
+
+  *elimp = OSQP_NULL;
+  *Pr    = OSQP_NULL;
+  *Ar    = OSQP_NULL;
+
+  for (i = 0, k = 0; i < m; i++) {
+    if (l[i] == u[i] && c_absval(l[i]) < OSQP_INFTY) k++;
+  }
+  if (k == 0) return 0;
+
+  e = c_calloc(1, sizeof(OSQPEliminate));
+  if (!e) return 1;
+
+  e->n    = n;
+  e->m    = m;
+  e->n_eq = k;
+  e->m_r  = m - k;
+
+  e->eq_row   = c_malloc(e->n_eq * sizeof(OSQPInt));
+  e->ineq_row = c_malloc(c_max(e->m_r, 1) * sizeof(OSQPInt));
+  e->pivot    = c_malloc(e->n_eq * sizeof(OSQPInt));
+  e->free_var = c_malloc(n * sizeof(OSQPInt));
+  e->q        = c_malloc(n * sizeof(OSQPFloat));
+  e->l        = c_malloc(c_max(m, 1) * sizeof(OSQPFloat));
+  e->u        = c_malloc(c_max(m, 1) * sizeof(OSQPFloat));
+  e->t        = c_calloc(n, sizeof(OSQPFloat));
+  e->fwork    = c_malloc((2 * n + 2 * m) * sizeof(OSQPFloat));
+  e->P        = csc_copy(P);
+  eq_idx      = c_malloc(c_max(m, 1) * sizeof(OSQPInt));
+  mask        = c_calloc(c_max(m, 1), sizeof(OSQPInt));
+  if (!e->eq_row || !e->ineq_row || !e->pivot || !e->free_var || !e->q || !e->l ||
+      !e->u || !e->t || !e->fwork || !e->P || !eq_idx || !mask)
+    goto fail;
+
+  for (j = 0; j < n; j++) e->q[j] = q[j];
+  for (i = 0, k = 0, r = 0; i < m; i++) {
+    e->l[i] = l[i];
+    e->u[i] = u[i];
+    if (l[i] == u[i] && c_absval(l[i]) < OSQP_INFTY) {
+      eq_idx[i]     = k;
+      e->eq_row[k++] = i;
+    }
+    else {
+      eq_idx[i]       = -1;
+      mask[i]         = 1;
+      e->ineq_row[r++] = i;
+    }
+  }
+
+  // The equalities by rows
+  R.n_eq   = e->n_eq;
+  R.ri     = c_calloc(e->n_eq, sizeof(OSQPInt*));
+  R.rx     = c_calloc(e->n_eq, sizeof(OSQPFloat*));
+  R.rnz    = c_calloc(e->n_eq, sizeof(OSQPInt));
+  R.rcap   = c_calloc(e->n_eq, sizeof(OSQPInt));
+  R.b      = c_malloc(e->n_eq * sizeof(OSQPFloat));
+  R.done   = c_calloc(e->n_eq, sizeof(OSQPInt));
+  R.cl     = c_calloc(n, sizeof(OSQPInt*));
+  R.cl_n   = c_calloc(n, sizeof(OSQPInt));
+  R.cl_cap = c_calloc(n, sizeof(OSQPInt));
+  R.ccount = c_calloc(n, sizeof(OSQPInt));
+  R.wi     = c_malloc(n * sizeof(OSQPInt));
+  R.wx     = c_malloc(n * sizeof(OSQPFloat));
+  if (!R.ri || !R.rx || !R.rnz || !R.rcap || !R.b || !R.done || !R.cl || !R.cl_n ||
+      !R.cl_cap || !R.ccount || !R.wi || !R.wx)
+    goto fail;
+
+  for (j = 0; j < n; j++) {
+    for (k = A->p[j]; k < A->p[j+1]; k++) {
+      if (eq_idx[A->i[k]] >= 0) R.rcap[eq_idx[A->i[k]]]++;
+    }
+  }
+  for (r = 0; r < e->n_eq; r++) {
+    R.rcap[r] = c_max(R.rcap[r], 1);
+    R.ri[r]   = c_malloc(R.rcap[r] * sizeof(OSQPInt));
+    R.rx[r]   = c_malloc(R.rcap[r] * sizeof(OSQPFloat));
+    if (!R.ri[r] || !R.rx[r]) goto fail;
+    R.b[r] = l[e->eq_row[r]];
+  }
+  for (j = 0; j < n; j++) {
+    for (k = A->p[j]; k < A->p[j+1]; k++) {
+      r = eq_idx[A->i[k]];
+      if (r < 0 || A->x[k] == 0.0) continue;
+      R.ri[r][R.rnz[r]]   = j;
+      R.rx[r][R.rnz[r]++] = A->x[k];
+      R.ccount[j]++;
+      R.nnz++;
+      if (push_row(&R, j, r)) goto fail;
+    }
+  }
+
+  max_nnz  = ELIMINATE_MAX_FILL * (P->p[n] + A->p[n]);
+  exitflag = eliminate_rows(e, &R, max_nnz);
+  if (!exitflag) exitflag = build_substitution(e, &R);
+  if (exitflag) goto fail;
+
+  // Reduced problem
+  e->A_ineq = csc_submatrix_byrows(A, mask);
+  P_full    = triu_to_csc(e->P);
+  if (!e->A_ineq || !P_full) goto fail;
+  W   = multiply(P_full, e->T, 0);
+  if (!W) goto fail;
+  *Pr = multiply(e->Tt, W, 1);
+  *Ar = multiply(e->A_ineq, e->T, 0);
+  if (!*Pr || !*Ar) goto fail;
+  if ((*Pr)->p[e->n_r] + (*Ar)->p[e->n_r] > max_nnz) {
+    exitflag = -1;
+    goto fail;
+  }
+
+  e->q_r = c_malloc(e->n_r * sizeof(OSQPFloat));
+  e->l_r = c_malloc(c_max(e->m_r, 1) * sizeof(OSQPFloat));
+  e->u_r = c_malloc(c_max(e->m_r, 1) * sizeof(OSQPFloat));
+  if (!e->q_r || !e->l_r || !e->u_r) goto fail;
+
+  update_bounds(e);
+  update_cost(e);
+
+  free_rows(&R, n);
+  csc_spfree(P_full);
+  csc_spfree(W);
+  c_free(eq_idx);
+  c_free(mask);
+  *elimp = e;
+  return 0;
+
+fail:
+  free_rows(&R, n);
+  csc_spfree(P_full);
+  csc_spfree(W);
+  csc_spfree(*Pr);
+  csc_spfree(*Ar);
+  *Pr = OSQP_NULL;
+  *Ar = OSQP_NULL;
+  c_free(eq_idx);
+  c_free(mask);
+  eliminate_free(e);
+
+  // Without a sparse substitution the problem is solved as it is
+  return exitflag < 0 ? 0 : 1;
+}
+
+
+OSQPInt eliminate_data_vec(OSQPEliminate*    e,
+                           const OSQPFloat** q,
+                           const OSQPFloat** l,
+                           const OSQPFloat** u) {
+  OSQPInt   i;
+  OSQPFloat li, ui;
+
+  if (*l || *u) {
+    for (i = 0; i < e->n_eq; i++) {
+      li = *l ? (*l)[e->eq_row[i]] : e->l[e->eq_row[i]];
+      ui = *u ? (*u)[e->eq_row[i]] : e->u[e->eq_row[i]];
+      if (li != ui) {
+        c_eprint("eliminated equality constraint %i must keep l == u", (int)e->eq_row[i]);
+        return OSQP_DATA_VALIDATION_ERROR;
+      }
+    }
+    for (i = 0; i < e->m; i++) {
+      if (*l) e->l[i] = (*l)[i];
+      if (*u) e->u[i] = (*u)[i];
+    }
+    if (*q) {
+      for (i = 0; i < e->n; i++) e->q[i] = (*q)[i];
+    }
+
+    // t moves with the equalities, and with it all the reduced vectors
+    update_bounds(e);
+    update_cost(e);
+    *q = e->q_r;
+    *l = e->l_r;
+    *u = e->u_r;
+  }
+  else if (*q) {
+    for (i = 0; i < e->n; i++) e->q[i] = (*q)[i];
+    update_cost(e);
+    *q = e->q_r;
+  }
+
+  return 0;
+}
+
+
+void eliminate_iterates(OSQPEliminate*    e,
+                        const OSQPFloat** x,
+                        const OSQPFloat** y) {
+  OSQPInt    i;
+  OSQPFloat* xr = e->fwork;
+  OSQPFloat* yr = e->fwork + e->n;
+
+  if (*x) {
+    for (i = 0; i < e->n_r; i++) xr[i] = (*x)[e->free_var[i]];
+    *x = xr;
+  }
+  if (*y) {
+    for (i = 0; i < e->m_r; i++) yr[i] = (*y)[e->ineq_row[i]];
+    *y = yr;
+  }
+}
+
+
+/*
+ * Duals y of the user constraints such that A'y = g, from the duals of the
+ * inequalities in yr: the equalities get the solution of E'y_E = g - A_I'y_I.
+ */
+static void expand_duals(OSQPEliminate* e,
+                         OSQPFloat*     g,
+                         OSQPFloat*     y) {
+  OSQPInt    i, j, k;
+  OSQPFloat* yr = e->fwork + 2 * e->n;          // size m_r
+  OSQPFloat* v  = e->fwork + 2 * e->n + e->m_r; // size n_eq
+
+  for (j = 0; j < e->n; j++) {
+    for (k = e->A_ineq->p[j]; k < e->A_ineq->p[j+1]; k++)
+      g[j] -= e->A_ineq->x[k] * yr[e->A_ineq->i[k]];
+  }
+
+  // In the reduced row echelon form the pivot columns are the unit vectors
+  for (i = 0; i < e->n_eq; i++) v[i] = e->pivot[i] >= 0 ? g[e->pivot[i]] : 0.0;
+
+  // y_E = M'v for the steps M of the elimination
+  for (k = e->n_ops - 1; k >= 0; k--) {
+    if (e->op_src[k] == e->op_row[k]) v[e->op_row[k]] *= e->op_val[k];
+    else                              v[e->op_src[k]] -= e->op_val[k] * v[e->op_row[k]];
+  }
+
+  for (i = 0; i < e->m_r; i++)  y[e->ineq_row[i]] = yr[i];
+  for (i = 0; i < e->n_eq; i++) y[e->eq_row[i]]   = v[i];
+}
+
+static void set_nan(OSQPFloat* v,
+                    OSQPInt    len) {
+  OSQPInt i;
+  for (i = 0; i < len; i++) v[i] = OSQP_NAN;
+}
+
+static void normalize(OSQPFloat* v,
+                      OSQPInt    len) {
+  OSQPInt   i;
+  OSQPFloat nrm = 0.0;
+
+  for (i = 0; i < len; i++) nrm = c_max(nrm, c_absval(v[i]));
+  if (nrm > 0.0) for (i = 0; i < len; i++) v[i] /= nrm;
+}
+
+
+void eliminate_solution(OSQPEliminate*  e,
+                        OSQPSolution*   solution,
+                        const OSQPInfo* info) {
+  OSQPInt    i, j, k;
+  OSQPInt    status = info->status_val;
+  OSQPFloat* xr     = e->fwork;
+  OSQPFloat* g      = e->fwork + e->n;
+  OSQPFloat* yr     = e->fwork + 2 * e->n;
+
+  if (has_solution(info)) {
+    for (i = 0; i < e->n_r; i++) xr[i] = solution->x[i];
+    for (i = 0; i < e->m_r; i++) yr[i] = solution->y[i];
+
+    // x = T*x_r + t
+    for (j = 0; j < e->n; j++) solution->x[j] = e->t[j];
+    for (i = 0; i < e->n_r; i++) {
+      for (k = e->T->p[i]; k < e->T->p[i+1]; k++) solution->x[e->T->i[k]] += e->T->x[k] * xr[i];
+    }
+
+    // Stationarity: A'y = -(P*x + q)
+    sym_triu_mult(e->P, solution->x, g);
+    for (j = 0; j < e->n; j++) g[j] = -(g[j] + e->q[j]);
+    expand_duals(e, g, solution->y);
+
+    set_nan(solution->prim_inf_cert, e->m);
+    set_nan(solution->dual_inf_cert, e->n);
+  }
+  else if (status == OSQP_PRIMAL_INFEASIBLE || status == OSQP_PRIMAL_INFEASIBLE_INACCURATE) {
+    // A'dy = 0 for the inequality part of the certificate extended to the equalities
+    for (i = 0; i < e->m_r; i++) yr[i] = solution->prim_inf_cert[i];
+    for (j = 0; j < e->n; j++)   g[j]  = 0.0;
+    expand_duals(e, g, solution->prim_inf_cert);
+    normalize(solution->prim_inf_cert, e->m);
+
+    set_nan(solution->x, e->n);
+    set_nan(solution->y, e->m);
+    set_nan(solution->dual_inf_cert, e->n);
+  }
+  else if (status == OSQP_DUAL_INFEASIBLE || status == OSQP_DUAL_INFEASIBLE_INACCURATE) {
+    // dx = T*dx_r keeps the equalities
+    for (i = 0; i < e->n_r; i++) xr[i] = solution->dual_inf_cert[i];
+    for (j = 0; j < e->n; j++)   solution->dual_inf_cert[j] = 0.0;
+    for (i = 0; i < e->n_r; i++) {
+      for (k = e->T->p[i]; k < e->T->p[i+1]; k++)
+        solution->dual_inf_cert[e->T->i[k]] += e->T->x[k] * xr[i];
+    }
+    normalize(solution->dual_inf_cert, e->n);
+
+    set_nan(solution->x, e->n);
+    set_nan(solution->y, e->m);
+    set_nan(solution->prim_inf_cert, e->m);
+  }
+  else {
+    set_nan(solution->x, e->n);
+    set_nan(solution->y, e->m);
+    set_nan(solution->prim_inf_cert, e->m);
+    set_nan(solution->dual_inf_cert, e->n);
+  }
+}
+
+
+void eliminate_free(OSQPEliminate* e) {
+  if (!e) return;
+
+  c_free(e->free_var);
+  c_free(e->ineq_row);
+  c_free(e->eq_row);
+  c_free(e->pivot);
+  c_free(e->op_row);
+  c_free(e->op_src);
+  c_free(e->op_val);
+  csc_spfree(e->T);
+  csc_spfree(e->Tt);
+  csc_spfree(e->P);
+  csc_spfree(e->A_ineq);
+  c_free(e->q);
+  c_free(e->l);
+  c_free(e->u);
+  c_free(e->t);
+  c_free(e->q_r);
+  c_free(e->l_r);
+  c_free(e->u_r);
+  c_free(e->fwork);
+  c_free(e);
+}
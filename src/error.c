@@ -12,7 +12,7 @@ const char *OSQP_ERROR_MESSAGE[] = {
   "Memory allocation.",
   "Solver workspace not initialized.",
   "Algebra libraries not loaded.",
-  "Unable to open file for writing.",
+  "Unable to open file.",
   "Invalid defines for codegen",
   "Vector/matrix not initialized.",
   "Function not implemented.",
@@ -1,11 +1,22 @@
 /*
  * Implements interrupt using ctrl-c on unix (linux + macos) systems.
+ *
+ * Solvers running at the same time (e.g. the blocks of a consensus solve)
+ * share the handler: it is installed by the first listener and restored by
+ * the last one, and an interrupt stops all of them.
  */
 
 #include "interrupt.h"
 #include <signal.h>
 
+#ifdef OSQP_ENABLE_THREADS
+# include <pthread.h>
+
+static pthread_mutex_t listener_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 static int int_detected;
+static int listeners;
 struct sigaction oact;
 
 static void handle_ctrlc(int dummy) {
@@ -15,17 +26,31 @@ static void handle_ctrlc(int dummy) {
 void osqp_start_interrupt_listener(void) {
   struct sigaction act;
 
-  int_detected = 0;
-  act.sa_flags = 0;
-  sigemptyset(&act.sa_mask);
-  act.sa_handler = handle_ctrlc;
-  sigaction(SIGINT, &act, &oact);
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_lock(&listener_lock);
+#endif
+  if (listeners++ == 0) {
+    int_detected = 0;
+    act.sa_flags = 0;
+    sigemptyset(&act.sa_mask);
+    act.sa_handler = handle_ctrlc;
+    sigaction(SIGINT, &act, &oact);
+  }
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_unlock(&listener_lock);
+#endif
 }
 
 void osqp_end_interrupt_listener(void) {
   struct sigaction act;
 
-  sigaction(SIGINT, &oact, &act);
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_lock(&listener_lock);
+#endif
+  if (--listeners == 0) sigaction(SIGINT, &oact, &act);
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_unlock(&listener_lock);
+#endif
 }
 
 int osqp_is_interrupted(void) {
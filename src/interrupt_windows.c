@@ -1,12 +1,21 @@
 /*
  * Implements interrupt using ctrl-c on Windows.
+ *
+ * Solvers running at the same time (e.g. the blocks of a consensus solve)
+ * share the handler: it is installed by the first listener and removed by
+ * the last one, and an interrupt stops all of them.
  */
 
 #include "interrupt.h"
 #include <windows.h>
 
+#ifdef OSQP_ENABLE_THREADS
+static SRWLOCK listener_lock = SRWLOCK_INIT;
+#endif
+
 /* Use Windows SetConsoleCtrlHandler for signal handling */
 static int int_detected;
+static int listeners;
 static BOOL WINAPI handle_ctrlc(DWORD dwCtrlType) {
   if (dwCtrlType != CTRL_C_EVENT) return FALSE;
 
@@ -15,12 +24,26 @@ static BOOL WINAPI handle_ctrlc(DWORD dwCtrlType) {
 }
 
 void osqp_start_interrupt_listener(void) {
-  int_detected = 0;
-  SetConsoleCtrlHandler(handle_ctrlc, TRUE);
+#ifdef OSQP_ENABLE_THREADS
+  AcquireSRWLockExclusive(&listener_lock);
+#endif
+  if (listeners++ == 0) {
+    int_detected = 0;
+    SetConsoleCtrlHandler(handle_ctrlc, TRUE);
+  }
+#ifdef OSQP_ENABLE_THREADS
+  ReleaseSRWLockExclusive(&listener_lock);
+#endif
 }
 
 void osqp_end_interrupt_listener(void) {
-  SetConsoleCtrlHandler(handle_ctrlc, FALSE);
+#ifdef OSQP_ENABLE_THREADS
+  AcquireSRWLockExclusive(&listener_lock);
+#endif
+  if (--listeners == 0) SetConsoleCtrlHandler(handle_ctrlc, FALSE);
+#ifdef OSQP_ENABLE_THREADS
+  ReleaseSRWLockExclusive(&listener_lock);
+#endif
 }
 
 int osqp_is_interrupted(void) {
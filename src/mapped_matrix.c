@@ -0,0 +1,353 @@
+/*
+ * Streams the products of a CSC matrix stored in a memory-mapped file.
+ *
+ * Both products read the file once, front to back: A*x scatters each column
+ * into y and A'*x gathers each column from x, so only x and y stay in memory.
+ * The nonzeros are used in chunks. While a chunk is processed, the kernel is
+ * asked to read the next one, and the pages of the finished chunks are
+ * dropped from the mapping, so the matrix can be larger than the RAM.
+ */
+
+#ifndef _DEFAULT_SOURCE
+# define _DEFAULT_SOURCE
+#endif
+
+#include "glob_opts.h"
+#include "printing.h"
+#include "error.h"
+#include "mapped_matrix.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAPPED_CSC_MAGIC "OSQPCSC"
+
+typedef struct {
+  char    magic[8];
+  int32_t int_size;
+  int32_t float_size;
+  int64_t m;
+  int64_t n;
+  int64_t nnz;
+} mapped_csc_header;
+
+typedef struct {
+  void*            map;      ///< mapping of the whole file
+  size_t           map_size;
+  uintptr_t        page;     ///< page size
+  OSQPInt          m;
+  OSQPInt          n;
+  OSQPInt          nnz;
+  const OSQPInt*   p;
+  const OSQPInt*   i;
+  const OSQPFloat* x;
+  OSQPInt          chunk;    ///< nonzeros per chunk
+  OSQPFloat*       col_norm;
+  OSQPFloat*       row_norm;
+  OSQPFloat*       AtA_diag;
+} mapped_csc;
+
+
+/* Arrays start on 8-byte boundaries */
+static size_t pad8(size_t size) {
+  return (size + 7) & ~(size_t)7;
+}
+
+/* Advise the pages of [start, start+len), widened to whole pages */
+static void advise_range(const mapped_csc* M,
+                         const void*       start,
+                         size_t            len,
+                         int               advice) {
+  uintptr_t a = (uintptr_t)start & ~(M->page - 1);
+  uintptr_t b = (uintptr_t)start + len;
+
+  if (b > a) madvise((void*)a, b - a, advice);
+}
+
+/* Advise the row indices and values of the nonzeros k0 to k1-1 */
+static void advise_nonzeros(const mapped_csc* M,
+                            OSQPInt           k0,
+                            OSQPInt           k1,
+                            int               advice) {
+  k0 = c_max(k0, 0);
+  k1 = c_min(k1, M->nnz);
+  if (k1 <= k0) return;
+
+  advise_range(M, M->i + k0, (size_t)(k1 - k0) * sizeof(OSQPInt), advice);
+  advise_range(M, M->x + k0, (size_t)(k1 - k0) * sizeof(OSQPFloat), advice);
+}
+
+/*
+ * The nonzeros before kdone are used and the current chunk ends at next:
+ * drop the finished chunks and read ahead the one after the new current
+ * chunk. Returns the end of the new current chunk.
+ */
+static OSQPInt stream_advance(const mapped_csc* M,
+                              OSQPInt           next,
+                              OSQPInt           kdone) {
+  OSQPInt start = next - M->chunk;
+
+  while (next <= kdone) next += M->chunk;
+
+  advise_nonzeros(M, start, next - M->chunk, MADV_DONTNEED);
+  advise_nonzeros(M, next, next + M->chunk, MADV_WILLNEED);
+
+  return next;
+}
+
+/* Drop the last chunks and read ahead the first ones for the next product */
+static void stream_end(const mapped_csc* M,
+                       OSQPInt           next) {
+  advise_nonzeros(M, next - 2 * M->chunk, M->nnz, MADV_DONTNEED);
+  advise_nonzeros(M, 0, 2 * M->chunk, MADV_WILLNEED);
+}
+
+/* y = A*x */
+static void mapped_csc_mult(void*            data,
+                            const OSQPFloat* x,
+                                  OSQPFloat* y) {
+  const mapped_csc* M = (const mapped_csc*)data;
+
+  OSQPInt j, k;
+  OSQPInt next = M->chunk;
+
+  for (j = 0; j < M->m; j++) y[j] = 0.0;
+
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) y[M->i[k]] += M->x[k] * x[j];
+    if (M->p[j+1] >= next) next = stream_advance(M, next, M->p[j+1]);
+  }
+
+  stream_end(M, next);
+}
+
+/* y = A'*x */
+static void mapped_csc_mult_trans(void*            data,
+                                  const OSQPFloat* x,
+                                        OSQPFloat* y) {
+  const mapped_csc* M = (const mapped_csc*)data;
+
+  OSQPInt   j, k;
+  OSQPInt   next = M->chunk;
+  OSQPFloat yj;
+
+  for (j = 0; j < M->n; j++) {
+    yj = 0.0;
+    for (k = M->p[j]; k < M->p[j+1]; k++) yj += M->x[k] * x[M->i[k]];
+    y[j] = yj;
+    if (M->p[j+1] >= next) next = stream_advance(M, next, M->p[j+1]);
+  }
+
+  stream_end(M, next);
+}
+
+/* Check the column pointers and row indices while computing the estimates */
+static OSQPInt compute_estimates(mapped_csc* M) {
+
+  OSQPInt   i, j, k;
+  OSQPInt   next = M->chunk;
+  OSQPFloat a;
+
+  if (M->p[0] != 0 || M->p[M->n] != M->nnz) return 1;
+
+  for (i = 0; i < M->m; i++) M->row_norm[i] = 0.0;
+
+  for (j = 0; j < M->n; j++) {
+    if (M->p[j+1] < M->p[j] || M->p[j+1] > M->nnz) return 1;
+
+    M->col_norm[j] = 0.0;
+    M->AtA_diag[j] = 0.0;
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      i = M->i[k];
+      if (i < 0 || i >= M->m) return 1;
+
+      a = c_absval(M->x[k]);
+      M->col_norm[j]  = c_max(M->col_norm[j], a);
+      M->row_norm[i]  = c_max(M->row_norm[i], a);
+      M->AtA_diag[j] += a * a;
+    }
+    if (M->p[j+1] >= next) next = stream_advance(M, next, M->p[j+1]);
+  }
+
+  stream_end(M, next);
+
+  return 0;
+}
+
+/* Write n elements of the given size followed by the padding to 8 bytes */
+static OSQPInt write_array(FILE*       f,
+                           const void* data,
+                           size_t      size,
+                           size_t      n) {
+  static const char zeros[8] = {0};
+  size_t pad = pad8(size * n) - size * n;
+
+  if (n && fwrite(data, size, n, f) != n) return 1;
+  if (pad && fwrite(zeros, 1, pad, f) != pad) return 1;
+  return 0;
+}
+
+
+OSQPInt mapped_csc_write(const OSQPCscMatrix* M,
+                         const char*          filename) {
+
+  mapped_csc_header h;
+  OSQPInt           nnz, failed;
+  FILE*             f;
+
+  if (!M || !M->p || M->m < 0 || M->n < 0) {
+    c_eprint("Invalid matrix");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  nnz = M->p[M->n];
+
+  f = fopen(filename, "wb");
+  if (!f) {
+    c_eprint("Could not open %s", filename);
+    return osqp_error(OSQP_FOPEN_ERROR);
+  }
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAPPED_CSC_MAGIC, sizeof(MAPPED_CSC_MAGIC));
+  h.int_size   = (int32_t)sizeof(OSQPInt);
+  h.float_size = (int32_t)sizeof(OSQPFloat);
+  h.m          = (int64_t)M->m;
+  h.n          = (int64_t)M->n;
+  h.nnz        = (int64_t)nnz;
+
+  failed = fwrite(&h, sizeof(h), 1, f) != 1;
+  if (!failed) failed = write_array(f, M->p, sizeof(OSQPInt), (size_t)M->n + 1);
+  if (!failed) failed = write_array(f, M->i, sizeof(OSQPInt), (size_t)nnz);
+  if (!failed) failed = write_array(f, M->x, sizeof(OSQPFloat), (size_t)nnz);
+  if (fclose(f)) failed = 1;
+
+  if (failed) {
+    c_eprint("Could not write %s", filename);
+    return osqp_error(OSQP_FOPEN_ERROR);
+  }
+
+  return 0;
+}
+
+
+OSQPInt mapped_csc_open(OSQPOperator* op,
+                        const char*   filename,
+                        OSQPInt       chunk_size) {
+
+  mapped_csc_header h;
+  mapped_csc*       M;
+  struct stat       st;
+  size_t            p_size, i_size, x_size;
+  char*             base;
+  int               fd;
+
+  memset(op, 0, sizeof(OSQPOperator));
+
+  fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    c_eprint("Could not open %s", filename);
+    return osqp_error(OSQP_FOPEN_ERROR);
+  }
+
+  if (fstat(fd, &st) || (size_t)st.st_size < sizeof(h) ||
+      pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h)) {
+    close(fd);
+    c_eprint("Could not read the header of %s", filename);
+    return osqp_error(OSQP_FOPEN_ERROR);
+  }
+
+  // The file has to match the types of this build and hold the whole matrix
+  if (memcmp(h.magic, MAPPED_CSC_MAGIC, sizeof(MAPPED_CSC_MAGIC)) ||
+      h.int_size != (int32_t)sizeof(OSQPInt) || h.float_size != (int32_t)sizeof(OSQPFloat) ||
+      h.m < 0 || h.n < 0 || h.nnz < 0 || h.n >= (int64_t)st.st_size || h.nnz > (int64_t)st.st_size ||
+      (OSQPInt)h.m != h.m || (OSQPInt)h.n != h.n || (OSQPInt)h.nnz != h.nnz) {
+    close(fd);
+    c_eprint("%s is not a CSC file of this build (see osqp_csc_write_file)", filename);
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  p_size = pad8(((size_t)h.n + 1) * sizeof(OSQPInt));
+  i_size = pad8((size_t)h.nnz * sizeof(OSQPInt));
+  x_size = (size_t)h.nnz * sizeof(OSQPFloat);
+  if ((size_t)st.st_size < sizeof(h) + p_size + i_size + x_size) {
+    close(fd);
+    c_eprint("%s is truncated", filename);
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  M = c_calloc(1, sizeof(mapped_csc));
+  if (!M) {
+    close(fd);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // The mapping stays valid once the file is closed
+  M->map_size = (size_t)st.st_size;
+  M->map      = mmap(NULL, M->map_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (M->map == MAP_FAILED) {
+    c_free(M);
+    c_eprint("Could not map %s", filename);
+    return osqp_error(OSQP_FOPEN_ERROR);
+  }
+  madvise(M->map, M->map_size, MADV_SEQUENTIAL);
+
+  base      = (char*)M->map;
+  M->page   = (uintptr_t)sysconf(_SC_PAGESIZE);
+  M->m      = (OSQPInt)h.m;
+  M->n      = (OSQPInt)h.n;
+  M->nnz    = (OSQPInt)h.nnz;
+  M->p      = (const OSQPInt*)(base + sizeof(h));
+  M->i      = (const OSQPInt*)(base + sizeof(h) + p_size);
+  M->x      = (const OSQPFloat*)(base + sizeof(h) + p_size + i_size);
+
+  if (chunk_size <= 0) chunk_size = MAPPED_CSC_CHUNK_SIZE;
+  M->chunk = c_max(chunk_size / (OSQPInt)(sizeof(OSQPInt) + sizeof(OSQPFloat)), 1);
+
+  M->col_norm = c_malloc(c_max(M->n, 1) * sizeof(OSQPFloat));
+  M->row_norm = c_malloc(c_max(M->m, 1) * sizeof(OSQPFloat));
+  M->AtA_diag = c_malloc(c_max(M->n, 1) * sizeof(OSQPFloat));
+
+  op->m          = M->m;
+  op->n          = M->n;
+  op->data       = M;
+  op->mult       = mapped_csc_mult;
+  op->mult_trans = mapped_csc_mult_trans;
+  op->col_norm   = M->col_norm;
+  op->row_norm   = M->row_norm;
+  op->diag       = M->AtA_diag;
+
+  if (!M->col_norm || !M->row_norm || !M->AtA_diag) {
+    mapped_csc_close(op);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  advise_nonzeros(M, 0, 2 * M->chunk, MADV_WILLNEED);
+  if (compute_estimates(M)) {
+    mapped_csc_close(op);
+    c_eprint("%s has invalid column pointers or row indices", filename);
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  return 0;
+}
+
+
+void mapped_csc_close(OSQPOperator* op) {
+  mapped_csc* M = (mapped_csc*)op->data;
+
+  if (M) {
+    munmap(M->map, M->map_size);
+    c_free(M->col_norm);
+    c_free(M->row_norm);
+    c_free(M->AtA_diag);
+    c_free(M);
+  }
+
+  memset(op, 0, sizeof(OSQPOperator));
+}
@@ -0,0 +1,228 @@
+/*
+ * Implements huge-page and NUMA-aware placement of large buffers on Linux.
+ *
+ * Placed buffers get their own anonymous mapping, so their pages are fresh:
+ * the NUMA policy set with mbind (called directly to avoid a dependency on
+ * libnuma) applies to the first touch, and transparent huge pages are
+ * requested with madvise(MADV_HUGEPAGE) on 2 MiB aligned mappings. The
+ * mappings are recorded so that osqp_placed_free and osqp_placed_realloc can
+ * tell them apart from heap memory; unmapping a buffer also unlocks it.
+ */
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+
+#include "memory_placement.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifdef OSQP_ENABLE_THREADS
+# include <pthread.h>
+
+static pthread_mutex_t placed_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* From <numaif.h>, which is only available with the libnuma headers */
+#define PLACEMENT_MPOL_PREFERRED 1
+
+static __thread int placement_active      = 0;
+static __thread int placement_huge_pages  = 0;
+static __thread int placement_numa_node   = -1;
+static __thread int placement_prefault    = 0;
+static __thread int placement_lock        = 0;
+static __thread int placement_lock_failed = 0;
+
+/* Mappings handed out by placed_alloc, shared by all threads */
+typedef struct placed_block_ {
+  void*                 ptr;   ///< start of the mapping
+  size_t                len;   ///< length of the mapping
+  struct placed_block_* next;
+} placed_block;
+
+static placed_block* placed_blocks = NULL;
+
+
+void osqp_placement_begin(int huge_pages,
+                          int numa_node,
+                          int prefault,
+                          int lock) {
+  placement_huge_pages  = huge_pages ? 1 : 0;
+  placement_numa_node   = numa_node;
+  placement_lock        = lock ? 1 : 0;
+  placement_prefault    = prefault || placement_lock;
+  placement_lock_failed = 0;
+  placement_active      = placement_huge_pages || placement_numa_node >= 0 || placement_prefault;
+}
+
+int osqp_placement_end(void) {
+  int lock_failed = placement_lock_failed;
+
+  placement_active      = 0;
+  placement_huge_pages  = 0;
+  placement_numa_node   = -1;
+  placement_prefault    = 0;
+  placement_lock        = 0;
+  placement_lock_failed = 0;
+
+  return lock_failed;
+}
+
+/* Whether an allocation of the given size gets its own mapping */
+static int placement_applies(size_t size) {
+  // Locked allocations need pages of their own to be unlocked when freed
+  if (placement_lock) return 1;
+  return size >= OSQP_PLACEMENT_MIN_SIZE &&
+         (placement_huge_pages || placement_numa_node >= 0);
+}
+
+/* Pre-fault an allocation from the standard library */
+static void* placement_touch(void*  ptr,
+                             size_t size) {
+  // Write to every page; calloc may hand out untouched zero pages
+  if (ptr && placement_prefault) memset(ptr, 0, size);
+  return ptr;
+}
+
+/* Record a mapping, return nonzero on failure */
+static int placed_register(void*  ptr,
+                           size_t len) {
+  placed_block* b = malloc(sizeof(placed_block));
+
+  if (!b) return 1;
+  b->ptr = ptr;
+  b->len = len;
+
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_lock(&placed_lock);
+#endif
+  b->next       = placed_blocks;
+  placed_blocks = b;
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_unlock(&placed_lock);
+#endif
+  return 0;
+}
+
+/* Length of the mapping starting at ptr, 0 if ptr is not a placed buffer.
+ * With remove set, the mapping is also forgotten. */
+static size_t placed_lookup(void* ptr,
+                            int   remove) {
+  placed_block** b;
+  placed_block*  found;
+  size_t         len = 0;
+
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_lock(&placed_lock);
+#endif
+  for (b = &placed_blocks; *b; b = &(*b)->next) {
+    if ((*b)->ptr == ptr) {
+      found = *b;
+      len   = found->len;
+      if (remove) {
+        *b = found->next;
+        free(found);
+      }
+      break;
+    }
+  }
+#ifdef OSQP_ENABLE_THREADS
+  pthread_mutex_unlock(&placed_lock);
+#endif
+  return len;
+}
+
+static void* placed_alloc(size_t size) {
+
+  char*         map;
+  char*         ptr;
+  size_t        page;
+  size_t        align;
+  size_t        len;
+  size_t        map_len;
+  size_t        head;
+  unsigned long nodemask;
+
+  if (size == 0) size = 1;
+
+  // Rounding a smaller buffer up to a huge page would mostly waste memory
+  page  = (size_t)sysconf(_SC_PAGESIZE);
+  align = (placement_huge_pages && size >= OSQP_PLACEMENT_HUGE_PAGE_SIZE)
+          ? OSQP_PLACEMENT_HUGE_PAGE_SIZE : page;
+  len   = (size + align - 1) / align * align;
+
+  // Over-map by the alignment and trim both ends
+  map_len = len + (align > page ? align : 0);
+  map     = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) return NULL;
+
+  ptr  = (char*)(((uintptr_t)map + align - 1) / align * align);
+  head = (size_t)(ptr - map);
+  if (head) munmap(map, head);
+  if (map_len - head > len) munmap(ptr + len, map_len - head - len);
+
+  if (placed_register(ptr, len)) {
+    munmap(ptr, len);
+    return NULL;
+  }
+
+  // Placement is best-effort: the buffer is usable even if the kernel refuses
+  if (align == OSQP_PLACEMENT_HUGE_PAGE_SIZE) madvise(ptr, len, MADV_HUGEPAGE);
+
+  // The pages are not faulted in yet, so the policy decides where they go
+  if (placement_numa_node >= 0 &&
+      placement_numa_node < (int)(8 * sizeof(unsigned long))) {
+    nodemask = 1UL << placement_numa_node;
+    syscall(SYS_mbind, ptr, len, PLACEMENT_MPOL_PREFERRED,
+            &nodemask, 8 * sizeof(unsigned long) + 1, 0);
+  }
+
+  // First touch on the calling thread so the pages in use are faulted in here
+  memset(ptr, 0, size);
+
+  if (placement_lock && mlock(ptr, size)) placement_lock_failed = 1;
+
+  return ptr;
+}
+
+void* osqp_placed_malloc(size_t size) {
+  if (!placement_active) return malloc(size);
+  if (!placement_applies(size)) return placement_touch(malloc(size), size);
+  return placed_alloc(size);
+}
+
+void* osqp_placed_calloc(size_t num,
+                         size_t size) {
+  if (!placement_active) return calloc(num, size);
+  if (size && num > (size_t)-1 / size) return NULL;
+  if (!placement_applies(num * size)) return placement_touch(calloc(num, size), num * size);
+  return placed_alloc(num * size);
+}
+
+void* osqp_placed_realloc(void*  ptr,
+                          size_t size) {
+  void*  ptr_new;
+  size_t len = ptr ? placed_lookup(ptr, 0) : 0;
+
+  if (!len) return realloc(ptr, size);
+
+  // Move the contents to a buffer placed by the policy of the calling thread
+  ptr_new = osqp_placed_malloc(size);
+  if (!ptr_new) return NULL;
+  memcpy(ptr_new, ptr, size < len ? size : len);
+  osqp_placed_free(ptr);
+  return ptr_new;
+}
+
+void osqp_placed_free(void* ptr) {
+  size_t len = ptr ? placed_lookup(ptr, 1) : 0;
+
+  if (len) munmap(ptr, len);
+  else     free(ptr);
+}
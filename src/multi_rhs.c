@@ -0,0 +1,349 @@
+#include "multi_rhs.h"
+#include "lin_alg.h"
+#include "util.h"
+#include "auxil.h"
+#include "error.h"
+#include "printing.h"
+#include "timing.h"
+#include "reorder.h"
+
+#ifdef OSQP_ENABLE_INTERRUPT
+# include "interrupt.h"
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+/*
+ * State of one problem of the block. swap_column() exchanges it with the
+ * corresponding workspace, data and solver pointers, so that the ADMM steps
+ * and the termination checks of auxil.c run unchanged on that problem.
+ */
+typedef struct {
+  OSQPVectorf* x;
+  OSQPVectorf* z;
+  OSQPVectorf* y;
+  OSQPVectorf* x_prev;
+  OSQPVectorf* z_prev;
+  OSQPVectorf* xz_tilde;
+  OSQPVectorf* xtilde_view;
+  OSQPVectorf* ztilde_view;
+  OSQPVectorf* q;
+  OSQPVectorf* l;
+  OSQPVectorf* u;
+  OSQPInfo*     info;
+  OSQPSolution* solution;
+} OSQPColumn;
+
+
+static void swap_column(OSQPSolver* solver,
+                        OSQPColumn* col) {
+
+  OSQPWorkspace* work = solver->work;
+  OSQPInfo*      info = solver->info;
+  OSQPSolution*  sol  = solver->solution;
+
+  swap_vectors(&work->x,           &col->x);
+  swap_vectors(&work->z,           &col->z);
+  swap_vectors(&work->y,           &col->y);
+  swap_vectors(&work->x_prev,      &col->x_prev);
+  swap_vectors(&work->z_prev,      &col->z_prev);
+  swap_vectors(&work->xz_tilde,    &col->xz_tilde);
+  swap_vectors(&work->xtilde_view, &col->xtilde_view);
+  swap_vectors(&work->ztilde_view, &col->ztilde_view);
+  swap_vectors(&work->data->q,     &col->q);
+  swap_vectors(&work->data->l,     &col->l);
+  swap_vectors(&work->data->u,     &col->u);
+
+  solver->info     = col->info;
+  solver->solution = col->solution;
+  col->info        = info;
+  col->solution    = sol;
+}
+
+static void free_column(OSQPColumn* col) {
+  OSQPVectorf_free(col->x);
+  OSQPVectorf_free(col->z);
+  OSQPVectorf_free(col->y);
+  OSQPVectorf_free(col->x_prev);
+  OSQPVectorf_free(col->z_prev);
+  OSQPVectorf_view_free(col->xtilde_view);
+  OSQPVectorf_view_free(col->ztilde_view);
+  OSQPVectorf_free(col->xz_tilde);
+  OSQPVectorf_free(col->q);
+  OSQPVectorf_free(col->l);
+  OSQPVectorf_free(col->u);
+}
+
+/* Allocate the state of problem j and load its scaled data and initial iterates */
+static OSQPInt init_column(OSQPSolver*      solver,
+                           OSQPColumn*      col,
+                           OSQPInt          j,
+                           const OSQPFloat* q,
+                           const OSQPFloat* l,
+                           const OSQPFloat* u) {
+
+  OSQPWorkspace*   work    = solver->work;
+  OSQPScaling*     scaling = work->scaling;
+  OSQPInt          n       = work->data->n;
+  OSQPInt          m       = work->data->m;
+  OSQPVectorf_expr e;
+
+  if (solver->settings->warm_starting) {
+    col->x = OSQPVectorf_copy_new(work->x);
+    col->z = OSQPVectorf_copy_new(work->z);
+    col->y = OSQPVectorf_copy_new(work->y);
+  }
+  else {
+    col->x = OSQPVectorf_calloc(n);
+    col->z = OSQPVectorf_calloc(m);
+    col->y = OSQPVectorf_calloc(m);
+  }
+  col->x_prev   = OSQPVectorf_calloc(n);
+  col->z_prev   = OSQPVectorf_calloc(m);
+  col->xz_tilde = OSQPVectorf_calloc(n + m);
+  if (!col->x || !col->z || !col->y || !col->x_prev || !col->z_prev || !col->xz_tilde)
+    return 1;
+
+  col->xtilde_view = OSQPVectorf_view(col->xz_tilde, 0, n);
+  col->ztilde_view = OSQPVectorf_view(col->xz_tilde, n, m);
+  if (!col->xtilde_view || !col->ztilde_view) return 1;
+
+  col->q = OSQPVectorf_copy_new(work->data->q);
+  col->l = OSQPVectorf_copy_new(work->data->l);
+  col->u = OSQPVectorf_copy_new(work->data->u);
+  if (!col->q || !col->l || !col->u) return 1;
+
+  /* Reorder and scale the data as osqp_update_data_vec does */
+  if (q) q += j*n;
+  if (l) l += j*m;
+  if (u) u += j*m;
+  if (work->reorder) reorder_data_vec(work->reorder, &q, &l, &u);
+  if (q) {
+    OSQPVectorf_from_raw(col->q, q);
+    if (solver->settings->scaling) {
+      OSQPVectorf_expr_init(&e);
+      OSQPVectorf_expr_add_prod(&e, scaling->c, col->q, scaling->D);
+      OSQPVectorf_eval(col->q, &e);
+    }
+  }
+  if (l) {
+    OSQPVectorf_from_raw(col->l, l);
+    if (solver->settings->scaling) OSQPVectorf_ew_prod(col->l, col->l, scaling->E);
+  }
+  if (u) {
+    OSQPVectorf_from_raw(col->u, u);
+    if (solver->settings->scaling) OSQPVectorf_ew_prod(col->u, col->u, scaling->E);
+  }
+
+  return 0;
+}
+
+/* Finish the problem swapped into the solver after its last iteration */
+static void finish_column(OSQPSolver* solver,
+                          OSQPInt     iter,
+                          OSQPInt     checked) {
+
+  OSQPInfo* info = solver->info;
+
+  if (!checked) {
+    update_info(solver, iter, 0, 0);
+    check_termination_conditions(solver, 0);
+  }
+
+  if (info->status_val == OSQP_UNSOLVED) {
+    if (!check_termination_conditions(solver, 1)) {
+      update_status(info, OSQP_MAX_ITER_REACHED);
+    }
+  }
+#ifdef OSQP_ENABLE_PROFILING
+  else if (info->status_val == OSQP_TIME_LIMIT_REACHED) {
+    if (!check_termination_conditions(solver, 1)) {
+      update_status(info, OSQP_TIME_LIMIT_REACHED);
+    }
+  }
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  if (has_solution(info)) info->obj_val = compute_obj_val(solver, solver->work->x);
+  info->rho_estimate = compute_rho_estimate(solver);
+
+#ifdef OSQP_ENABLE_PROFILING
+  info->solve_time = osqp_toc(solver->work->timer);
+  info->run_time   = info->solve_time;
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  store_solution(solver);
+}
+
+
+OSQPInt multi_rhs_solve(OSQPSolver*      solver,
+                        OSQPInt          k,
+                        const OSQPFloat* q,
+                        const OSQPFloat* l,
+                        const OSQPFloat* u,
+                        OSQPFloat*       x,
+                        OSQPFloat*       y,
+                        OSQPInfo*        info) {
+
+  OSQPInt        i, j, iter, n_active, n_left;
+  OSQPInt        last_iter = 0;
+  OSQPInt        exitflag = 0;
+  OSQPInt        can_check_termination = 0;
+  OSQPInt        done;
+  OSQPInt        segmented = 0;
+  OSQPInt        max_iter = solver->settings->max_iter;
+  OSQPWorkspace* work     = solver->work;
+  LinSysSolver*  linsys   = work->linsys_solver;
+  OSQPInt        n        = work->data->n;
+  OSQPInt        m        = work->data->m;
+
+  OSQPColumn*    cols;
+  OSQPInfo*      infos;
+  OSQPSolution*  sols;
+  OSQPInt*       active;
+  OSQPVectorf**  rhs;
+  OSQPFloat*     cert;
+
+  /* The bounds of the columns can have other constraint types than the
+     solver's, so the grouped constraints do not skip the projection */
+  if (work->reorder) {
+    segmented = work->reorder->segmented;
+    work->reorder->segmented = 0;
+  }
+
+  cols   = (OSQPColumn *)   c_calloc(k, sizeof(OSQPColumn));
+  infos  = (OSQPInfo *)     c_calloc(k, sizeof(OSQPInfo));
+  sols   = (OSQPSolution *) c_calloc(k, sizeof(OSQPSolution));
+  active = (OSQPInt *)      c_malloc(k * sizeof(OSQPInt));
+  rhs    = (OSQPVectorf **) c_malloc(k * sizeof(OSQPVectorf*));
+  cert   = (OSQPFloat *)    c_malloc((n + m) * sizeof(OSQPFloat));
+  if (!cols || !infos || !sols || !active || !rhs || !cert) {
+    exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+    goto exit;
+  }
+
+  for (j = 0; j < k; j++) {
+    if (init_column(solver, &cols[j], j, q, l, u)) {
+      exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+      goto exit;
+    }
+    if (!OSQPVectorf_all_leq(cols[j].l, cols[j].u)) {
+      c_eprint("Lower bound must be lower than or equal to upper bound in problem %d", (int)j);
+      exitflag = osqp_error(OSQP_DATA_VALIDATION_ERROR);
+      goto exit;
+    }
+
+    /* The infeasibility certificates are not returned */
+    sols[j].x             = x + j*n;
+    sols[j].y             = y + j*m;
+    sols[j].prim_inf_cert = cert;
+    sols[j].dual_inf_cert = cert + m;
+    infos[j]              = *solver->info;
+    reset_info(&infos[j]);
+    cols[j].info          = &infos[j];
+    cols[j].solution      = &sols[j];
+    active[j]             = j;
+  }
+  n_active = k;
+
+#ifdef OSQP_ENABLE_PROFILING
+  osqp_tic(work->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+#ifdef OSQP_ENABLE_INTERRUPT
+  osqp_start_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+  for (iter = 1; iter <= max_iter && n_active > 0; iter++) {
+
+    /* Right-hand sides of all the unconverged problems */
+    for (i = 0; i < n_active; i++) {
+      swap_column(solver, &cols[active[i]]);
+      swap_vectors(&work->x, &work->x_prev);
+      swap_vectors(&work->z, &work->z_prev);
+      compute_rhs(solver);
+      rhs[i] = work->xz_tilde;
+      swap_column(solver, &cols[active[i]]);
+    }
+
+    /* One linear system solve for the whole block */
+    if (linsys->solve_block) {
+      if (linsys->solve_block(linsys, rhs, n_active, iter)) {
+        exitflag = osqp_error(OSQP_MEM_ALLOC_ERROR);
+        break;
+      }
+    }
+    else {
+      for (i = 0; i < n_active; i++) linsys->solve(linsys, rhs[i], iter);
+    }
+
+    can_check_termination = solver->settings->check_termination &&
+                            (iter % solver->settings->check_termination == 0);
+
+    /* Remaining ADMM steps; terminated problems are dropped from the block */
+    n_left = 0;
+    for (i = 0; i < n_active; i++) {
+      j = active[i];
+      swap_column(solver, &cols[j]);
+      update_x(solver);
+      update_z(solver);
+      update_y(solver);
+
+      done = 0;
+      if (can_check_termination || iter == 1) {
+        update_info(solver, iter, 0, 0);
+        if (can_check_termination) done = check_termination_conditions(solver, 0);
+      }
+      if (done) finish_column(solver, iter, 1);
+      swap_column(solver, &cols[j]);
+
+      if (!done) active[n_left++] = j;
+    }
+    n_active = n_left;
+    last_iter = iter;
+
+#ifdef OSQP_ENABLE_INTERRUPT
+    if (osqp_is_interrupted()) {
+      for (i = 0; i < n_active; i++) update_status(&infos[active[i]], OSQP_SIGINT);
+      c_print("Solver interrupted\n");
+      break;
+    }
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+#ifdef OSQP_ENABLE_PROFILING
+    if (solver->settings->time_limit &&
+        (osqp_toc(work->timer) >= solver->settings->time_limit)) {
+      for (i = 0; i < n_active; i++) update_status(&infos[active[i]], OSQP_TIME_LIMIT_REACHED);
+      break;
+    }
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+  }
+
+  /* Problems still in the block ran out of iterations (or time) */
+  if (!exitflag) {
+    for (i = 0; i < n_active; i++) {
+      swap_column(solver, &cols[active[i]]);
+      finish_column(solver, last_iter, can_check_termination);
+      swap_column(solver, &cols[active[i]]);
+    }
+  }
+
+#ifdef OSQP_ENABLE_INTERRUPT
+  osqp_end_interrupt_listener();
+#endif /* ifdef OSQP_ENABLE_INTERRUPT */
+
+  if (info && !exitflag) {
+    for (j = 0; j < k; j++) info[j] = infos[j];
+  }
+
+exit:
+  if (work->reorder) work->reorder->segmented = segmented;
+  if (cols) {
+    for (j = 0; j < k; j++) free_column(&cols[j]);
+    c_free(cols);
+  }
+  c_free(infos);
+  c_free(sols);
+  c_free(active);
+  c_free(rhs);
+  c_free(cert);
+
+  return exitflag;
+}
@@ -17,6 +17,11 @@
 
 #ifndef OSQP_EMBEDDED_MODE
 # include "polish.h"
+# include "multi_rhs.h"
+# include "consensus.h"
+# include "reorder.h"
+# include "eliminate.h"
+# include "csc_utils.h"
 #endif
 
 #ifdef OSQP_ENABLE_DERIVATIVES
@@ -27,6 +32,19 @@
 # include "interrupt.h"
 #endif
 
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+# include "memory_placement.h"
+#endif
+
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+# include "mapped_matrix.h"
+#endif
+
+#ifdef OSQP_ENABLE_THREADS
+# include "async_check.h"
+# include "setup_pipeline.h"
+#endif
+
 
 /**********************
 * Main API Functions *
@@ -48,6 +66,10 @@ OSQPInt osqp_capabilities(void) {
     capabilities |= OSQP_CAPABILITY_DERIVATIVES;
 #endif
 
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+  capabilities |= OSQP_CAPABILITY_OUT_OF_CORE;
+#endif
+
   return capabilities;
 }
 
@@ -75,6 +97,13 @@ void osqp_get_dimensions(OSQPSolver* solver,
     *m = -1;
     *n = -1;
   }
+#ifndef OSQP_EMBEDDED_MODE
+  else if (solver->work->elim) {
+    // Dimensions of the user problem, not of the reduced one
+    *m = solver->work->elim->m;
+    *n = solver->work->elim->n;
+  }
+#endif
   else {
     *m = solver->work->data->m;
     *n = solver->work->data->n;
@@ -136,31 +165,70 @@ void osqp_set_default_settings(OSQPSettings* settings) {
 
   settings->delta              = OSQP_DELTA;                    /* regularization parameter for polishing */
   settings->polish_refine_iter = OSQP_POLISH_REFINE_ITER;       /* iterative refinement steps in polish */
+  settings->polish_in_place    = OSQP_POLISH_IN_PLACE;          /* polish with a separate reduced KKT matrix */
+
+  settings->lean_memory        = OSQP_LEAN_MEMORY;              /* release setup-only buffers after setup */
+  settings->huge_pages         = OSQP_HUGE_PAGES;               /* huge pages for large buffers */
+  settings->numa_node          = OSQP_NUMA_NODE;                /* NUMA node for large buffers */
+
+  settings->realtime           = OSQP_REALTIME;                 /* no allocations after setup */
+  settings->lock_memory        = OSQP_LOCK_MEMORY;              /* lock setup buffers in RAM */
+  settings->reorder            = OSQP_REORDER;                  /* keep the user ordering */
+  settings->group_constraints  = OSQP_GROUP_CONSTRAINTS;        /* keep the constraints interleaved */
+  settings->compress_indices   = OSQP_COMPRESS_INDICES;         /* plain row indices */
+  settings->eliminate_equalities = OSQP_ELIMINATE_EQUALITIES;   /* keep the equality constraints */
+  settings->stall_checks       = OSQP_STALL_CHECKS;             /* no stall detection */
+  settings->best_iterate       = OSQP_BEST_ITERATE;             /* return the last iterate */
+  settings->supernodal         = OSQP_SUPERNODAL;               /* dense kernels for large supernodes */
+  settings->async_termination  = OSQP_ASYNC_TERMINATION;        /* termination checks in the iterations */
+  settings->setup_threads      = OSQP_SETUP_THREADS;            /* setup on the calling thread */
+  settings->adaptive_rho_cost_model = OSQP_ADAPTIVE_RHO_COST_MODEL; /* update rho at every adaptation */
+  settings->linsys_library     = OSQP_LINSYS_LIBRARY;           /* solvers of the algebra backend */
 }
 
 #ifndef OSQP_EMBEDDED_MODE
 
-
-OSQPInt osqp_setup(OSQPSolver**         solverp,
-                   const OSQPCscMatrix* P,
-                   const OSQPFloat*     q,
-                   const OSQPCscMatrix* A,
-                   const OSQPFloat*     l,
-                   const OSQPFloat*     u,
-                   OSQPInt              m,
-                   OSQPInt              n,
-                   const OSQPSettings*  settings) {
-
+/*
+ * Setup shared by osqp_setup and osqp_setup_operators, with P and A given
+ * either as CSC matrices (Pop and Aop are OSQP_NULL) or as operators (P and A
+ * are OSQP_NULL). The data and settings are already validated.
+ */
+static OSQPInt setup_solver(OSQPSolver**         solverp,
+                            const OSQPCscMatrix* P,
+                            const OSQPOperator*  Pop,
+                            const OSQPFloat*     q,
+                            const OSQPCscMatrix* A,
+                            const OSQPOperator*  Aop,
+                            const OSQPFloat*     l,
+                            const OSQPFloat*     u,
+                            OSQPInt              m,
+                            OSQPInt              n,
+                            const OSQPSettings*  settings) {
+
+  OSQPInt i;
   OSQPInt exitflag;
 
   OSQPSolver*    solver;
   OSQPWorkspace* work;
-
-  // Validate data
-  if (validate_data(P,q,A,l,u,m,n)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
-
-  // Validate settings
-  if (validate_settings(settings, 1)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  OSQPCscMatrix* Pr = OSQP_NULL;
+  OSQPCscMatrix* Ar = OSQP_NULL;
+  OSQPCscMatrix* Pe = OSQP_NULL;
+  OSQPCscMatrix* Ae = OSQP_NULL;
+  OSQPInt        m_user = m;
+  OSQPInt        n_user = n;
+  OSQPInt        pipelined = 0;
+# ifdef OSQP_ENABLE_THREADS
+  LinSysAnalysis* analysis = OSQP_NULL;
+# endif
+# ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  OSQPInt        unlocked = 0;
+# endif
+
+# ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  // Place the large buffers allocated from here on (reset at the end of setup or in cleanup)
+  osqp_placement_begin((int)settings->huge_pages, (int)settings->numa_node,
+                       settings->realtime != 0, (int)settings->lock_memory);
+# endif
 
   // Allocate empty solver
   solver = c_calloc(1, sizeof(OSQPSolver));
@@ -190,17 +258,73 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   // Copy problem data into workspace
   work->data = c_calloc(1, sizeof(OSQPData));
   if (!(work->data)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // Equality constraints eliminated by substitution of variables
+  if (!Pop && settings->eliminate_equalities) {
+    exitflag = eliminate_new(&work->elim, P, q, A, l, u, m, n, &Pe, &Ae);
+    if (exitflag) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    if (work->elim) {
+      P = Pe;
+      A = Ae;
+      q = work->elim->q_r;
+      l = work->elim->l_r;
+      u = work->elim->u_r;
+      n = work->elim->n_r;
+      m = work->elim->m_r;
+    }
+  }
   work->data->m = m;
   work->data->n = n;
 
-  // objective function
-  work->data->P = OSQPMatrix_new_from_csc(P,1);   //copy assuming triu form
+  // Internal ordering of the variables and constraints
+  if (!Pop && (settings->reorder == OSQP_RCM_REORDER ||
+               (settings->group_constraints && settings->rho_is_vec))) {
+    work->reorder = reorder_new(P, A, l, u, settings, &Pr, &Ar);
+    if (!(work->reorder)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    P = Pr;
+    A = Ar;
+    reorder_data_vec(work->reorder, &q, &l, &u);
+  }
+
+  if (Pop) {
+    // Matrices only known through their products
+    work->matrix_free = 1;
+    work->data->P = OSQPMatrix_new_from_operator(Pop,1);
+    work->data->A = OSQPMatrix_new_from_operator(Aop,0);
+  }
+  else {
+    // objective function
+    work->data->P = OSQPMatrix_new_from_csc(P,1);   //copy assuming triu form
+
+    // Constraints
+    work->data->A = OSQPMatrix_new_from_csc(A,0); //assumes non-triu form (i.e. full)
+  }
   work->data->q = OSQPVectorf_new(q,n);
-  if (!(work->data->P) || !(work->data->q)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
-  // Constraints
-  work->data->A = OSQPMatrix_new_from_csc(A,0); //assumes non-triu form (i.e. full)
+  // The permuted and reduced copies are not needed anymore
+  csc_spfree(Pr);
+  csc_spfree(Ar);
+  csc_spfree(Pe);
+  csc_spfree(Ae);
+  if (!(work->data->P) || !(work->data->q)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   if (!(work->data->A)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+# ifdef OSQP_ENABLE_THREADS
+  // The stages that only read the patterns of P and A run on helper threads
+  // while the data is scaled below
+  if (settings->setup_threads > 1 && !work->matrix_free) {
+    exitflag = setup_pipeline_start(&work->pipeline, work, settings);
+    if (exitflag) return exitflag;
+    pipelined = 1;
+  }
+# endif
+
+  // Compressed row indices for the matrix-vector products
+  if (settings->compress_indices && !work->matrix_free && !pipelined) {
+    if (OSQPMatrix_compress_indices(work->data->P) ||
+        OSQPMatrix_compress_indices(work->data->A))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
   work->data->l = OSQPVectorf_new(l,m);
   work->data->u = OSQPVectorf_new(u,m);
   if (!(work->data->l) || !(work->data->u))
@@ -238,6 +362,32 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   if (!(work->x_prev) || !(work->z_prev) || !(work->y))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
+  // Copies of the iterate with the smallest residuals
+  if (settings->best_iterate) {
+    work->best_x = OSQPVectorf_calloc(n);
+    work->best_z = OSQPVectorf_calloc(m);
+    work->best_y = OSQPVectorf_calloc(m);
+    if (!(work->best_x) || !(work->best_z) || !(work->best_y))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+# ifdef OSQP_ENABLE_THREADS
+  // Helper thread of the termination checks. The products of user operators
+  // share their workspace, so those solvers check in the iterations.
+  if (settings->async_termination && !work->matrix_free) {
+    exitflag = async_check_new(&work->async, n, m);
+    if (exitflag) return exitflag;
+  }
+# endif
+
+  // Views used by the kernels on the constraint segments
+  if (work->reorder && work->reorder->grouped) {
+    for (i = 0; i < 4; i++) {
+      work->reorder->view[i] = OSQPVectorf_view(work->z, 0, m);
+      if (!(work->reorder->view[i])) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
+  }
+
   // Primal and dual residuals variables
   work->Ax  = OSQPVectorf_calloc(m);
   work->Px  = OSQPVectorf_calloc(n);
@@ -278,14 +428,17 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
 
 
     // Allocate workspace variables used in scaling
-    work->D_temp   = OSQPVectorf_calloc(n);
-    work->D_temp_A = OSQPVectorf_calloc(n);
-    work->E_temp   = OSQPVectorf_calloc(m);
-    if (!(work->D_temp) || !(work->D_temp_A) || !(work->E_temp))
-      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    // (in lean mode they are allocated only while scaling)
+    if (!settings->lean_memory) {
+      work->D_temp   = OSQPVectorf_calloc(n);
+      work->D_temp_A = OSQPVectorf_calloc(n);
+      work->E_temp   = OSQPVectorf_calloc(m);
+      if (!(work->D_temp) || !(work->D_temp_A) || !(work->E_temp))
+        return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
 
     // Scale data
-    scale_data(solver);
+    if (scale_data(solver)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   } else {
     work->scaling  = OSQP_NULL;
     work->D_temp   = OSQP_NULL;
@@ -304,9 +457,25 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   }
 
   // Initialize linear system solver structure
+# ifdef OSQP_ENABLE_THREADS
+  if (work->pipeline) {
+    exitflag = setup_pipeline_finish(work->pipeline, &analysis);
+    if (exitflag) return exitflag;
+#  ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+    unlocked = work->pipeline->unlocked;
+#  endif
+  }
+  exitflag = osqp_algebra_init_linsys_solver_analysed(&(work->linsys_solver), work->data->P, work->data->A,
+                                                      work->rho_vec, solver->settings,
+                                                      &work->scaled_prim_res, &work->scaled_dual_res,
+                                                      analysis);
+  setup_pipeline_free(work->pipeline);
+  work->pipeline = OSQP_NULL;
+# else
   exitflag = osqp_algebra_init_linsys_solver(&(work->linsys_solver), work->data->P, work->data->A,
                                              work->rho_vec, solver->settings,
                                              &work->scaled_prim_res, &work->scaled_dual_res, 0);
+# endif
 
   if (exitflag == OSQP_NONCVX_ERROR) {
     update_status(solver->info, OSQP_NON_CVX);
@@ -316,31 +485,36 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
     return osqp_error(exitflag);
   }
 
+  // The rest of the solver follows the linear system solver the algebra chose
+  if (solver->settings->linsys_solver == OSQP_AUTO_SOLVER)
+    solver->settings->linsys_solver = work->linsys_solver->type;
+
   // Initialize variables x, y, z to 0
   osqp_cold_start(solver);
 
   // Initialize active constraints structure
-  work->pol = c_malloc(sizeof(OSQPPolish));
+  // (in lean mode its vectors are allocated only while polishing)
+  work->pol = c_calloc(1, sizeof(OSQPPolish));
   if (!(work->pol)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  work->pol->active_flags = OSQPVectori_malloc(m);
-  work->pol->x            = OSQPVectorf_malloc(n);
-  work->pol->z            = OSQPVectorf_malloc(m);
-  work->pol->y            = OSQPVectorf_malloc(m);
-  if (!(work->pol->x)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if (!(work->pol->active_flags) ||
-      !(work->pol->z) || !(work->pol->y))
-    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (!settings->lean_memory) {
+    if (polish_alloc(work)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+  if (settings->polishing && (settings->realtime ||
+                              (settings->polish_in_place && !settings->lean_memory))) {
+    exitflag = polish_alloc_system(solver);
+    if (exitflag) return osqp_error(exitflag);
+  }
 
   // Allocate solution
   solver->solution = c_calloc(1, sizeof(OSQPSolution));
   if (!(solver->solution)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  solver->solution->x             = c_calloc(1, n * sizeof(OSQPFloat));
-  solver->solution->y             = c_calloc(1, m * sizeof(OSQPFloat));
-  solver->solution->prim_inf_cert = c_calloc(1, m * sizeof(OSQPFloat));
-  solver->solution->dual_inf_cert = c_calloc(1, n * sizeof(OSQPFloat));
+  solver->solution->x             = c_calloc(1, n_user * sizeof(OSQPFloat));
+  solver->solution->y             = c_calloc(1, m_user * sizeof(OSQPFloat));
+  solver->solution->prim_inf_cert = c_calloc(1, m_user * sizeof(OSQPFloat));
+  solver->solution->dual_inf_cert = c_calloc(1, n_user * sizeof(OSQPFloat));
   if ( !(solver->solution->x) || !(solver->solution->dual_inf_cert) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if ( m && (!(solver->solution->y) || !(solver->solution->prim_inf_cert)) )
+  if ( m_user && (!(solver->solution->y) || !(solver->solution->prim_inf_cert)) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   // Initialize information
@@ -358,6 +532,7 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   work->rho_update_from_solve = 0;
 # endif /* ifdef OSQP_ENABLE_PROFILING */
   solver->info->rho_updates  = 0;                      // Rho updates set to 0
+  solver->info->rho_updates_skipped = 0;               // Skipped rho updates set to 0
   solver->info->rho_estimate = solver->settings->rho;  // Best rho estimate
   solver->info->obj_val      = OSQP_INFTY;
   solver->info->prim_res     = OSQP_INFTY;
@@ -371,9 +546,14 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
 
 
   // If adaptive rho and automatic interval, but profiling disabled, we need to
-  // set the interval to a default value
-# ifndef OSQP_ENABLE_PROFILING
+  // set the interval to a default value. So does the hybrid solver, whose setup
+  // time does not include the factorization the interval is meant to amortize.
+# ifdef OSQP_ENABLE_PROFILING
+  if ((solver->settings->linsys_solver == OSQP_HYBRID_SOLVER || work->matrix_free) &&
+      solver->settings->adaptive_rho && !solver->settings->adaptive_rho_interval) {
+# else
   if (solver->settings->adaptive_rho && !solver->settings->adaptive_rho_interval) {
+# endif
     if (solver->settings->check_termination) {
       // If check_termination is enabled, we set it to a multiple of the check
       // termination interval
@@ -384,7 +564,6 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
       solver->settings->adaptive_rho_interval = OSQP_ADAPTIVE_RHO_FIXED;
     }
   }
-# endif /* ifndef OSQP_ENABLE_PROFILING */
 
 # ifdef OSQP_ENABLE_DERIVATIVES
   work->derivative_data = c_calloc(1, sizeof(OSQPDerivativeData));
@@ -393,16 +572,121 @@ OSQPInt osqp_setup(OSQPSolver**         solverp,
   work->derivative_data->y_l = OSQPVectorf_malloc(m);
   work->derivative_data->ryl = OSQPVectorf_malloc(m);
   work->derivative_data->ryu = OSQPVectorf_malloc(m);
-  work->derivative_data->rhs = OSQPVectorf_malloc(2 * (n + 2*m));
+  work->derivative_data->rhs = OSQPVectorf_malloc(2 * (n + (settings->realtime == 2 ? 3 : 2)*m));
   if (!(work->derivative_data->y_u) || !(work->derivative_data->y_l) ||
-    !(work->derivative_data->ryl) || !(work->derivative_data->ryu))
+    !(work->derivative_data->ryl) || !(work->derivative_data->ryu) ||
+    !(work->derivative_data->rhs))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (settings->realtime == 2) {
+    exitflag = adjoint_derivative_alloc_system(solver);
+    if (exitflag) return osqp_error(exitflag);
+  }
 # endif /* ifdef OSQP_ENABLE_DERIVATIVES */
 
+# ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  // The helper threads of the setup pipeline lock their own allocations
+  unlocked |= osqp_placement_end();
+  if (unlocked && settings->verbose)
+    c_print("WARNING: Could not lock the solver memory in RAM (check RLIMIT_MEMLOCK)\n");
+# endif
+
   // Return exit flag
   return 0;
 }
 
+
+OSQPInt osqp_setup(OSQPSolver**         solverp,
+                   const OSQPCscMatrix* P,
+                   const OSQPFloat*     q,
+                   const OSQPCscMatrix* A,
+                   const OSQPFloat*     l,
+                   const OSQPFloat*     u,
+                   OSQPInt              m,
+                   OSQPInt              n,
+                   const OSQPSettings*  settings) {
+
+  // Validate data
+  if (validate_data(P,q,A,l,u,m,n)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+
+  // Validate settings
+  if (validate_settings(settings, 1)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  return setup_solver(solverp, P, OSQP_NULL, q, A, OSQP_NULL, l, u, m, n, settings);
+}
+
+
+OSQPInt osqp_setup_operators(OSQPSolver**        solverp,
+                             const OSQPOperator* P,
+                             const OSQPFloat*    q,
+                             const OSQPOperator* A,
+                             const OSQPFloat*    l,
+                             const OSQPFloat*    u,
+                             OSQPInt             m,
+                             OSQPInt             n,
+                             const OSQPSettings* settings) {
+
+  // The algebra has to solve the KKT system from the products alone
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_OPERATORS)) {
+    c_eprint("Operators are not supported by this algebra");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+  }
+
+  // Validate data
+  if (validate_operators(P,q,A,l,u,m,n)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+
+  // Validate settings
+  if (validate_settings(settings, 1)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  // Everything that needs the matrix entries
+  if (settings->polishing) {
+    c_eprint("polishing is not supported for operators");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (settings->reorder != OSQP_NO_REORDER || settings->group_constraints) {
+    c_eprint("reorder and group_constraints are not supported for operators");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (settings->eliminate_equalities) {
+    c_eprint("eliminate_equalities is not supported for operators");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  if (settings->realtime == 2) {
+    c_eprint("realtime = 2 is not supported for operators");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  return setup_solver(solverp, OSQP_NULL, P, q, OSQP_NULL, A, l, u, m, n, settings);
+}
+
+
+/****************************
+* Memory-mapped matrices
+****************************/
+OSQPInt osqp_csc_write_file(const OSQPCscMatrix* M,
+                            const char*          filename) {
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+  return mapped_csc_write(M, filename);
+#else
+  return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+#endif
+}
+
+OSQPInt osqp_operator_map_file(OSQPOperator* op,
+                               const char*   filename,
+                               OSQPInt       chunk_size) {
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+  return mapped_csc_open(op, filename, chunk_size);
+#else
+  return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+#endif
+}
+
+void osqp_operator_unmap_file(OSQPOperator* op) {
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+  if (op) mapped_csc_close(op);
+#endif
+}
+
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
 
@@ -422,6 +706,11 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
   OSQPInt can_print;             // Boolean whether you can print
 #endif /* ifdef OSQP_ENABLE_PRINTING */
 
+#ifdef OSQP_ENABLE_THREADS
+  OSQPInt async_post;            // boolean: hand the check of this iteration to the helper thread
+  OSQPInt async_pending = 0;     // boolean: a check is running on the helper thread
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
   // Check if solver has been initialized
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
   work = solver->work;
@@ -465,6 +754,17 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
   // If not warm start -> set x, z, y to zero
   if (!solver->settings->warm_starting) osqp_cold_start(solver);
 
+#ifndef OSQP_EMBEDDED_MODE
+  // The progress of the residuals is tracked over this solve only
+  work->stall_ref   = OSQP_INFTY;
+  work->stall_count = 0;
+  work->best_ratio  = OSQP_INFTY;
+  work->best_iter   = 0;
+
+  work->rho_refactor_total = 0.0;
+  work->rho_trend_iter     = 0;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   // Main ADMM algorithm
 
   max_iter = solver->settings->max_iter;
@@ -529,10 +829,44 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
                             (iter % solver->settings->check_termination == 0);
 
 #ifdef OSQP_ENABLE_PRINTING
-
     // Can we print ?
     can_print = solver->settings->verbose &&
                 ((iter % OSQP_PRINT_INTERVAL == 0) || (iter == 1));
+#endif /* ifdef OSQP_ENABLE_PRINTING */
+
+#ifdef OSQP_ENABLE_THREADS
+    // The check runs on the helper thread unless the info of this iteration
+    // is printed or rho is adapted, which needs the residuals anyway and
+    // would not happen in an iteration that terminates. The snapshot goes to
+    // the free buffer before the check of the previous iteration is
+    // collected, and if that one terminates the solve its iterate is
+    // returned instead of this one.
+    async_post = can_check_termination && work->async && solver->settings->async_termination &&
+                 !(solver->settings->adaptive_rho &&
+                   (!solver->settings->adaptive_rho_interval ||
+                    iter % solver->settings->adaptive_rho_interval == 0));
+# ifdef OSQP_ENABLE_PRINTING
+    async_post = async_post && !can_print && iter != 1;
+# endif /* ifdef OSQP_ENABLE_PRINTING */
+
+    if (async_post) async_check_snapshot(work->async, solver, iter);
+
+    if (async_pending) {
+      async_pending = 0;
+      if (async_check_collect(work->async, solver)) {
+        can_check_termination = 1; // The info is the one of the check
+        break;
+      }
+    }
+
+    if (async_post) {
+      async_check_post(work->async, solver, compute_obj);
+      async_pending         = 1;
+      can_check_termination = 0;
+    }
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
+#ifdef OSQP_ENABLE_PRINTING
 
     // NB: We always update info in the first iteration because indirect solvers
     //     use residual values to compute required accuracy of their solution.
@@ -548,10 +882,14 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
       if (can_check_termination) {
         // Check algorithm termination
-        if (check_termination(solver, 0)) {
+        if (check_termination_conditions(solver, 0)) {
           // Terminate algorithm
           break;
         }
+#ifndef OSQP_EMBEDDED_MODE
+        // Stop if the residuals no longer decrease
+        if (check_stall(solver, iter)) break;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
       }
     }
 #else /* ifdef OSQP_ENABLE_PRINTING */
@@ -561,10 +899,14 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
       update_info(solver, iter, compute_obj, 0);
 
       // Check algorithm termination
-      if (check_termination(solver, 0)) {
+      if (check_termination_conditions(solver, 0)) {
         // Terminate algorithm
         break;
       }
+#ifndef OSQP_EMBEDDED_MODE
+      // Stop if the residuals no longer decrease
+      if (check_stall(solver, iter)) break;
+#endif /* ifndef OSQP_EMBEDDED_MODE */
     }
 #endif /* ifdef OSQP_ENABLE_PRINTING */
 
@@ -648,6 +990,14 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
   }        // End of ADMM for loop
 
+#ifdef OSQP_ENABLE_THREADS
+  // Collect the check of the last iterations
+  if (async_pending) {
+    async_pending         = 0;
+    can_check_termination = async_check_collect(work->async, solver);
+  }
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
 
   // Update information and check termination condition if it hasn't been done
   // during last iteration (max_iter reached or check_termination disabled)
@@ -673,10 +1023,20 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 #endif /* ifdef OSQP_ENABLE_PRINTING */
 
     /* Check whether a termination criterion is triggered */
-    check_termination(solver, 0);
+    check_termination_conditions(solver, 0);
 
   }
 
+#ifndef OSQP_EMBEDDED_MODE
+  // Without convergence, return the iterate with the smallest residuals
+  if (solver->settings->best_iterate &&
+      (solver->info->status_val == OSQP_UNSOLVED ||
+       solver->info->status_val == OSQP_TIME_LIMIT_REACHED ||
+       solver->info->status_val == OSQP_STALLED)) {
+    restore_best_iterate(solver, compute_obj);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   // Compute objective value in case it was not
   // computed during the iterations
   if (!compute_obj && has_solution(solver->info)){
@@ -693,15 +1053,24 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 
   /* if max iterations reached, change status accordingly */
   if (solver->info->status_val == OSQP_UNSOLVED) {
-    if (!check_termination(solver, 1)) { // Try to check for approximate
+    if (!check_termination_conditions(solver, 1)) { // Try to check for approximate
       update_status(solver->info, OSQP_MAX_ITER_REACHED);
     }
   }
 
+#ifndef OSQP_EMBEDDED_MODE
+  /* if stalled, the last iterate may still be an approximate solution */
+  if (solver->info->status_val == OSQP_STALLED) {
+    if (!check_termination_conditions(solver, 1)) {
+      update_status(solver->info, OSQP_STALLED);
+    }
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 #ifdef OSQP_ENABLE_PROFILING
   /* if time-limit reached check termination and update status accordingly */
  if (solver->info->status_val == OSQP_TIME_LIMIT_REACHED) {
-    if (!check_termination(solver, 1)) { // Try for approximate solutions
+    if (!check_termination_conditions(solver, 1)) { // Try for approximate solutions
       update_status(solver->info, OSQP_TIME_LIMIT_REACHED); /* Change update status back to OSQP_TIME_LIMIT_REACHED */
     }
   }
@@ -763,6 +1132,11 @@ OSQPInt osqp_solve(OSQPSolver *solver) {
 exit:
 #endif /* if defined(OSQP_ENABLE_PROFILING) || defined(OSQP_ENABLE_INTERRUPT) || OSQP_EMBEDDED_MODE != 1 */
 
+#ifdef OSQP_ENABLE_THREADS
+  // The helper thread reads the problem data, which may change after the solve
+  if (async_pending) async_check_collect(work->async, OSQP_NULL);
+#endif /* ifdef OSQP_ENABLE_THREADS */
+
 #ifdef OSQP_ENABLE_INTERRUPT
   // Restore previous signal handler
   osqp_end_interrupt_listener();
@@ -774,16 +1148,106 @@ exit:
 
 #ifndef OSQP_EMBEDDED_MODE
 
+OSQPInt osqp_solve_multi(OSQPSolver*      solver,
+                         OSQPInt          k,
+                         const OSQPFloat* q,
+                         const OSQPFloat* l,
+                         const OSQPFloat* u,
+                         OSQPFloat*       x,
+                         OSQPFloat*       y,
+                         OSQPInfo*        info) {
+
+  // Check if solver has been initialized
+  if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  if (k < 0) {
+    c_eprint("Number of problems must be nonnegative");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (k == 0) return 0;
+
+  if (!x || !y) {
+    c_eprint("Missing solution arrays");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  if (solver->work->elim) {
+    c_eprint("solves with several right-hand sides are not supported with eliminate_equalities");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+  }
+
+  return multi_rhs_solve(solver, k, q, l, u, x, y, info);
+}
+
+
+
+OSQPInt osqp_consensus_setup(OSQPConsensus**      consp,
+                             const OSQPCscMatrix* P,
+                             const OSQPFloat*     q,
+                             const OSQPCscMatrix* A,
+                             const OSQPFloat*     l,
+                             const OSQPFloat*     u,
+                             OSQPInt              m,
+                             OSQPInt              n,
+                             OSQPInt              K,
+                             const OSQPInt*       row_start,
+                             const OSQPSettings*  settings) {
+
+  if (!consp) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  *consp = OSQP_NULL;
+
+  // Validate data
+  if (validate_data(P,q,A,l,u,m,n)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+
+  // Validate settings
+  if (validate_settings(settings, 1)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  return consensus_setup(consp, P, q, A, l, u, m, n, K, row_start, settings);
+}
+
+
+OSQPInt osqp_consensus_solve(OSQPConsensus* cons,
+                             OSQPFloat*     x,
+                             OSQPFloat*     y,
+                             OSQPInfo*      info) {
+
+  if (!cons || !cons->blocks) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  if (!x || !y) {
+    c_eprint("Missing solution arrays");
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+
+  return consensus_solve(cons, x, y, info);
+}
+
+
+OSQPInt osqp_consensus_cleanup(OSQPConsensus* cons) {
+  consensus_free(cons);
+  return 0;
+}
+
+
 OSQPInt osqp_cleanup(OSQPSolver* solver) {
 
   OSQPInt exitflag = 0;
   OSQPWorkspace* work;
 
+# ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  // Setup may have failed before resetting the placement policy
+  osqp_placement_end();
+# endif
+
   if(!solver) return 0;   //exit on null
 
   work = solver->work;
 
   if (work) { // If workspace has been allocated
+#if defined(OSQP_ENABLE_THREADS) && !defined(OSQP_EMBEDDED_MODE)
+    // Wait for the stages of a failed setup before freeing the data they read
+    setup_pipeline_free(work->pipeline);
+#endif
+
     // Free algebra library handlers
     osqp_algebra_free_libs();
 
@@ -821,12 +1285,23 @@ OSQPInt osqp_cleanup(OSQPSolver* solver) {
 #ifndef OSQP_EMBEDDED_MODE
     // Free active constraints structure
     if (work->pol) {
-      OSQPVectori_free(work->pol->active_flags);
-      OSQPVectorf_free(work->pol->x);
-      OSQPVectorf_free(work->pol->z);
-      OSQPVectorf_free(work->pol->y);
+      polish_free(work);
       c_free(work->pol);
     }
+
+    // Free internal ordering and eliminated equalities
+    reorder_free(work->reorder);
+    eliminate_free(work->elim);
+
+    // Free the copies of the best iterate
+    OSQPVectorf_free(work->best_x);
+    OSQPVectorf_free(work->best_z);
+    OSQPVectorf_free(work->best_y);
+
+# ifdef OSQP_ENABLE_THREADS
+    // Stop the helper thread of the termination checks
+    async_check_free(work->async);
+# endif
 #endif /* ifndef OSQP_EMBEDDED_MODE */
 
     // Free other Variables
@@ -879,6 +1354,7 @@ OSQPInt osqp_cleanup(OSQPSolver* solver) {
           if (work->derivative_data->ryl) OSQPVectorf_free(work->derivative_data->ryl);
           if (work->derivative_data->ryu) OSQPVectorf_free(work->derivative_data->ryu);
           if (work->derivative_data->rhs) OSQPVectorf_free(work->derivative_data->rhs);
+          adjoint_derivative_free_system(work->derivative_data);
           c_free(work->derivative_data);
       }
 #endif /* ifdef OSQP_ENABLE_SCALING */
@@ -908,9 +1384,10 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
 
   OSQPInt exitflag = 0;
 
-  OSQPVectorf*   l_tmp;
-  OSQPVectorf*   u_tmp;
-  OSQPWorkspace* work;
+  OSQPVectorf*     l_tmp;
+  OSQPVectorf*     u_tmp;
+  OSQPWorkspace*   work;
+  OSQPVectorf_expr e;
 
   /* Check if workspace has been initialized */
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
@@ -925,6 +1402,14 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
   osqp_tic(work->timer);
 #endif /* ifdef OSQP_ENABLE_PROFILING */
 
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->elim) {
+    exitflag = eliminate_data_vec(work->elim, &q_new, &l_new, &u_new);
+    if (exitflag) return osqp_error(exitflag);
+  }
+  if (work->reorder) reorder_data_vec(work->reorder, &q_new, &l_new, &u_new);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   /* Update constraint bounds */
   if (l_new || u_new) {
     /* Use z_prev and delta_y to store l_new and u_new */
@@ -961,8 +1446,9 @@ OSQPInt osqp_update_data_vec(OSQPSolver*      solver,
   if (q_new) {
     OSQPVectorf_from_raw(work->data->q, q_new);
     if (solver->settings->scaling) {
-      OSQPVectorf_ew_prod(work->data->q, work->data->q, work->scaling->D);
-      OSQPVectorf_mult_scalar(work->data->q, work->scaling->c);
+      OSQPVectorf_expr_init(&e);
+      OSQPVectorf_expr_add_prod(&e, work->scaling->c, work->data->q, work->scaling->D);
+      OSQPVectorf_eval(work->data->q, &e);
     }
   }
 
@@ -981,7 +1467,8 @@ OSQPInt osqp_warm_start(OSQPSolver*      solver,
                         const OSQPFloat* x,
                         const OSQPFloat* y) {
 
-  OSQPWorkspace* work;
+  OSQPWorkspace*   work;
+  OSQPVectorf_expr e;
 
   /* Check if workspace has been initialized */
   if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
@@ -990,6 +1477,11 @@ OSQPInt osqp_warm_start(OSQPSolver*      solver,
   /* Update warm_start setting to true */
   if (!solver->settings->warm_starting) solver->settings->warm_starting = 1;
 
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->elim)    eliminate_iterates(work->elim, &x, &y);
+  if (work->reorder) reorder_data_vec(work->reorder, &x, &y, OSQP_NULL);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   /* Copy primal and dual variables into the iterates */
   if (x) OSQPVectorf_from_raw(work->x, x);
   if (y) OSQPVectorf_from_raw(work->y, y);
@@ -998,8 +1490,9 @@ OSQPInt osqp_warm_start(OSQPSolver*      solver,
   if (solver->settings->scaling) {
     if (x) OSQPVectorf_ew_prod(work->x, work->x, work->scaling->Dinv);
     if (y) {
-      OSQPVectorf_ew_prod(work->y, work->y, work->scaling->Einv);
-      OSQPVectorf_mult_scalar(work->y, work->scaling->c);
+      OSQPVectorf_expr_init(&e);
+      OSQPVectorf_expr_add_prod(&e, work->scaling->c, work->y, work->scaling->Einv);
+      OSQPVectorf_eval(work->y, &e);
     }
   }
 
@@ -1026,29 +1519,27 @@ void osqp_cold_start(OSQPSolver *solver) {
 
 #if OSQP_EMBEDDED_MODE != 1
 
-OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
-                             const OSQPFloat* Px_new,
-                             const OSQPInt*   Px_new_idx,
-                             OSQPInt          P_new_n,
-                             const OSQPFloat* Ax_new,
-                             const OSQPInt*   Ax_new_idx,
-                             OSQPInt          A_new_n) {
+/* Check that the matrices can be updated with the given elements */
+static OSQPInt validate_data_mat(OSQPWorkspace* work,
+                                 const OSQPInt* Px_new_idx,
+                                 OSQPInt        P_new_n,
+                                 const OSQPInt* Ax_new_idx,
+                                 OSQPInt        A_new_n) {
 
-  OSQPInt exitflag;   // Exit flag
   OSQPInt nnzP, nnzA; // Number of nonzeros in P and A
-  OSQPWorkspace *work;
 
-  // Check if workspace has been initialized
-  if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
-  work = solver->work;
-
-#ifdef OSQP_ENABLE_PROFILING
-  if (work->clear_update_time == 1) {
-    work->clear_update_time = 0;
-    solver->info->update_time = 0.0;
+#ifndef OSQP_EMBEDDED_MODE
+  // Operators have no entries to update
+  if (work->matrix_free) {
+    c_eprint("matrix updates are not supported for solvers set up with operators");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
   }
-  osqp_tic(work->timer); // Start timer
-#endif /* ifdef OSQP_ENABLE_PROFILING */
+  // The reduced matrices are products with the substitution
+  if (work->elim) {
+    c_eprint("matrix updates are not supported with eliminate_equalities");
+    return osqp_error(OSQP_FUNC_NOT_IMPLEMENTED);
+  }
+#endif
 
   nnzP = OSQPMatrix_get_nz(work->data->P);
   nnzA = OSQPMatrix_get_nz(work->data->A);
@@ -1079,6 +1570,46 @@ OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
     return 2;
   }
 
+  return 0;
+}
+
+OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
+                             const OSQPFloat* Px_new,
+                             const OSQPInt*   Px_new_idx,
+                             OSQPInt          P_new_n,
+                             const OSQPFloat* Ax_new,
+                             const OSQPInt*   Ax_new_idx,
+                             OSQPInt          A_new_n) {
+
+  OSQPInt exitflag;   // Exit flag
+  OSQPInt nnzP, nnzA; // Number of nonzeros in P and A
+  OSQPWorkspace *work;
+
+  // Check if workspace has been initialized
+  if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+  work = solver->work;
+
+  exitflag = validate_data_mat(work, Px_new_idx, P_new_n, Ax_new_idx, A_new_n);
+  if (exitflag) return exitflag;
+
+#ifdef OSQP_ENABLE_PROFILING
+  if (work->clear_update_time == 1) {
+    work->clear_update_time = 0;
+    solver->info->update_time = 0.0;
+  }
+  osqp_tic(work->timer); // Start timer
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  nnzP = OSQPMatrix_get_nz(work->data->P);
+  nnzA = OSQPMatrix_get_nz(work->data->A);
+
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->reorder) {
+    reorder_data_mat(work->reorder, &Px_new, &Px_new_idx, P_new_n,
+                     &Ax_new, &Ax_new_idx, A_new_n);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   if (solver->settings->scaling) unscale_data(solver);
 
   if (Px_new){
@@ -1119,6 +1650,139 @@ OSQPInt osqp_update_data_mat(OSQPSolver*      solver,
 }
 
 
+OSQPInt osqp_update_data(OSQPSolver*      solver,
+                         const OSQPFloat* q_new,
+                         const OSQPFloat* l_new,
+                         const OSQPFloat* u_new,
+                         const OSQPFloat* Px_new,
+                         const OSQPInt*   Px_new_idx,
+                         OSQPInt          P_new_n,
+                         const OSQPFloat* Ax_new,
+                         const OSQPInt*   Ax_new_idx,
+                         OSQPInt          A_new_n) {
+
+  OSQPInt exitflag;
+  OSQPInt constr_types_changed = 0;
+  OSQPInt nnzP, nnzA;
+
+  OSQPVectorf*   l_tmp;
+  OSQPVectorf*   u_tmp;
+  OSQPVectorf*   q_tmp;
+  OSQPWorkspace* work;
+  LinSysSolver*  linsys;
+
+  // Check if workspace has been initialized
+  if (!solver || !solver->work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+  work   = solver->work;
+  linsys = work->linsys_solver;
+
+  // Without new matrices nothing is refactored unless the constraint types change
+  if (!Px_new && !Ax_new) return osqp_update_data_vec(solver, q_new, l_new, u_new);
+
+  exitflag = validate_data_mat(work, Px_new_idx, P_new_n, Ax_new_idx, A_new_n);
+  if (exitflag) return exitflag;
+
+#ifdef OSQP_ENABLE_PROFILING
+  if (work->clear_update_time == 1) {
+    work->clear_update_time = 0;
+    solver->info->update_time = 0.0;
+  }
+  osqp_tic(work->timer); // Start timer
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  nnzP = OSQPMatrix_get_nz(work->data->P);
+  nnzA = OSQPMatrix_get_nz(work->data->A);
+  if (!Px_new) P_new_n = 0;
+  if (!Ax_new) A_new_n = 0;
+
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->reorder) reorder_data_vec(work->reorder, &q_new, &l_new, &u_new);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+  /* Use z_prev, delta_y and x_prev to store the unscaled l, u and q, so that
+   * the bounds are checked before anything changes */
+  l_tmp = work->z_prev;
+  u_tmp = work->delta_y;
+  q_tmp = work->x_prev;
+
+  if (l_new) OSQPVectorf_from_raw(l_tmp, l_new);
+  else       OSQPVectorf_copy(l_tmp, work->data->l);
+  if (u_new) OSQPVectorf_from_raw(u_tmp, u_new);
+  else       OSQPVectorf_copy(u_tmp, work->data->u);
+  if (q_new) OSQPVectorf_from_raw(q_tmp, q_new);
+
+  if (solver->settings->scaling) {
+    if (!l_new) OSQPVectorf_ew_prod(l_tmp, l_tmp, work->scaling->Einv);
+    if (!u_new) OSQPVectorf_ew_prod(u_tmp, u_tmp, work->scaling->Einv);
+  }
+  if (!OSQPVectorf_all_leq(l_tmp, u_tmp)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->reorder) {
+    reorder_data_mat(work->reorder, &Px_new, &Px_new_idx, P_new_n,
+                     &Ax_new, &Ax_new_idx, A_new_n);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
+  /* Replace the unscaled data and scale it once */
+  if (solver->settings->scaling) unscale_data(solver);
+
+  swap_vectors(&work->z_prev,  &work->data->l);
+  swap_vectors(&work->delta_y, &work->data->u);
+  if (q_new) OSQPVectorf_copy(work->data->q, q_tmp);
+
+  if (Px_new) OSQPMatrix_update_values(work->data->P, Px_new, Px_new_idx, P_new_n);
+  if (Ax_new) OSQPMatrix_update_values(work->data->A, Ax_new, Ax_new_idx, A_new_n);
+
+  if (solver->settings->scaling) {
+    if (scale_data(solver)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+    // The scaled matrices change as a whole
+    Px_new_idx = OSQP_NULL;
+    P_new_n    = nnzP;
+    Ax_new_idx = OSQP_NULL;
+    A_new_n    = nnzA;
+  }
+
+  /* Constraint types of the new scaled bounds */
+  if (solver->settings->rho_is_vec) constr_types_changed = set_rho_vec(solver);
+
+  /* Refactor once with the new matrices and rho_vec */
+  if (!constr_types_changed) {
+    exitflag = linsys->update_matrices(linsys,
+                                       work->data->P, Px_new_idx, P_new_n,
+                                       work->data->A, Ax_new_idx, A_new_n);
+  }
+#ifndef OSQP_EMBEDDED_MODE
+  else if (linsys->update_matrices_rho_vec) {
+    exitflag = linsys->update_matrices_rho_vec(linsys,
+                                               work->data->P, Px_new_idx, P_new_n,
+                                               work->data->A, Ax_new_idx, A_new_n,
+                                               work->rho_vec, solver->settings->rho);
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+  else {
+    exitflag = linsys->update_matrices(linsys,
+                                       work->data->P, Px_new_idx, P_new_n,
+                                       work->data->A, Ax_new_idx, A_new_n);
+    if (!exitflag) {
+      exitflag = linsys->update_rho_vec(linsys, work->rho_vec, solver->settings->rho);
+    }
+  }
+
+  // Reset solver information
+  reset_info(solver->info);
+
+  if (exitflag != 0){c_eprint("new KKT matrix is not quasidefinite");}
+
+#ifdef OSQP_ENABLE_PROFILING
+  solver->info->update_time += osqp_toc(work->timer);
+#endif /* ifdef OSQP_ENABLE_PROFILING */
+
+  return exitflag;
+}
+
+
 OSQPInt osqp_update_rho(OSQPSolver* solver,
                         OSQPFloat     rho_new) {
 
@@ -1197,6 +1861,18 @@ OSQPInt osqp_update_settings(OSQPSolver*         solver,
   settings->verbose       = new_settings->verbose;
   settings->warm_starting = new_settings->warm_starting;
   // scaling ignored
+#ifndef OSQP_EMBEDDED_MODE
+  // Polishing without allocations needs the reduced system built during setup
+  if (settings->realtime && new_settings->polishing && !solver->work->pol->plsh) {
+    c_eprint("polishing cannot be enabled after setup in real-time mode");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  // Polishing factors the reduced KKT matrix, which operators do not provide
+  if (solver->work->matrix_free && new_settings->polishing) {
+    c_eprint("polishing is not supported for solvers set up with operators");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+#endif
   settings->polishing     = new_settings->polishing;
 
   // rho        ignored
@@ -1225,6 +1901,44 @@ OSQPInt osqp_update_settings(OSQPSolver*         solver,
 
   settings->delta              = new_settings->delta;
   settings->polish_refine_iter = new_settings->polish_refine_iter;
+  // polish_in_place ignored
+
+  // lean_memory ignored
+  // huge_pages ignored
+  // numa_node ignored
+  // realtime ignored
+  // lock_memory ignored
+  // reorder ignored
+  // group_constraints ignored
+  // compress_indices ignored
+  // eliminate_equalities ignored
+
+  settings->stall_checks = new_settings->stall_checks;
+#ifndef OSQP_EMBEDDED_MODE
+  // The copies of the best iterate are allocated during setup
+  if (new_settings->best_iterate && !solver->work->best_x) {
+    c_eprint("best_iterate cannot be enabled after setup");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+  settings->best_iterate = new_settings->best_iterate;
+#endif
+
+  // supernodal ignored
+
+#ifdef OSQP_ENABLE_THREADS
+  // The helper thread of the termination checks is started during setup
+  if (new_settings->async_termination && !solver->work->async && !solver->work->matrix_free) {
+    c_eprint("async_termination cannot be enabled after setup");
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+#endif
+  settings->async_termination = new_settings->async_termination;
+
+  // setup_threads ignored
+
+  settings->adaptive_rho_cost_model = new_settings->adaptive_rho_cost_model;
+
+  // linsys_library ignored
 
   /* Update settings in the linear system solver */
   solver->work->linsys_solver->update_settings(solver->work->linsys_solver, settings);
@@ -1264,6 +1978,36 @@ OSQPInt osqp_codegen(OSQPSolver*         solver,
                     || (defines->derivatives_enable != 0 && defines->derivatives_enable != 1)) {
     return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
   }
+  /* Matrix updates in the generated code need the buffers released in lean mode */
+  else if (defines->embedded_mode == 2 && solver->settings->lean_memory) {
+    c_eprint("embedded_mode 2 is not supported for solvers set up with lean_memory");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
+  /* The generated code embeds the matrices and their factorization */
+  else if (solver->work->matrix_free) {
+    c_eprint("code generation is not supported for solvers set up with operators");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
+  /* The generated code embeds the factorization of the direct solver */
+  else if (solver->settings->linsys_solver != OSQP_DIRECT_SOLVER) {
+    c_eprint("code generation requires the direct linear system solver");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
+  /* ... and only QDLDL can be embedded */
+  else if (solver->settings->linsys_library != OSQP_ALGEBRA_LINSYS) {
+    c_eprint("code generation is not supported for solvers set up with MKL Pardiso");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
+  /* The generated code takes its data in the order of the workspace */
+  else if (solver->work->reorder) {
+    c_eprint("code generation is not supported for solvers set up with reorder or group_constraints");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
+  /* The generated code solves the problem without the substitution */
+  else if (solver->work->elim) {
+    c_eprint("code generation is not supported for solvers set up with eliminate_equalities");
+    return osqp_error(OSQP_CODEGEN_DEFINES_ERROR);
+  }
 
   exitflag = codegen_inc(solver, output_dir, file_prefix);
   if (!exitflag) exitflag = codegen_src(solver, output_dir, file_prefix, defines->embedded_mode);
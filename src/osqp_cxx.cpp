@@ -0,0 +1,233 @@
+/*
+ * Implements the templated C++ interface for the precision this library is built with.
+ */
+
+#include "osqp.hpp"
+#include "osqp.h"
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace osqp {
+
+/* Fixed-width integer with the size of OSQPInt (OSQPInt may be long long where int64_t is long) */
+typedef std::conditional<sizeof(OSQPInt) == 8, std::int64_t, std::int32_t>::type CxxInt;
+
+static_assert(sizeof(CxxInt) == sizeof(OSQPInt), "Unsupported OSQPInt size");
+
+
+template <typename Float, typename Int>
+struct Solver<Float, Int>::Impl {
+  OSQPSolver* solver;
+
+  Impl() : solver(OSQP_NULL) {}
+  ~Impl() { osqp_cleanup(solver); }
+};
+
+
+template <typename Float, typename Int>
+static void settings_to_c(const Settings<Float, Int>& s,
+                          OSQPSettings*               c) {
+  c->verbose            = s.verbose;
+  c->warm_starting      = s.warm_starting;
+  c->scaling            = s.scaling;
+  c->polishing          = s.polishing;
+  c->rho                = s.rho;
+  c->rho_is_vec         = s.rho_is_vec;
+  c->sigma              = s.sigma;
+  c->alpha              = s.alpha;
+  c->adaptive_rho       = s.adaptive_rho;
+  c->max_iter           = s.max_iter;
+  c->eps_abs            = s.eps_abs;
+  c->eps_rel            = s.eps_rel;
+  c->eps_prim_inf       = s.eps_prim_inf;
+  c->eps_dual_inf       = s.eps_dual_inf;
+  c->scaled_termination = s.scaled_termination;
+  c->check_termination  = s.check_termination;
+  c->time_limit         = s.time_limit;
+  c->delta              = s.delta;
+  c->polish_refine_iter = s.polish_refine_iter;
+}
+
+/* Copy the indices, since OSQPInt and Int may be distinct types of the same size */
+template <typename Float, typename Int>
+static void csc_to_c(const CscMatrix<Float, Int>& M,
+                     std::vector<OSQPInt>&        p,
+                     std::vector<OSQPInt>&        i,
+                     OSQPCscMatrix*               c) {
+  OSQPInt nnz = (OSQPInt)M.p[M.n];
+
+  p.assign(M.p, M.p + M.n + 1);
+  i.assign(M.i, M.i + nnz);
+  csc_set_data(c, M.m, M.n, nnz, const_cast<Float*>(M.x), i.data(), p.data());
+}
+
+
+template <typename Float, typename Int>
+Settings<Float, Int> Solver<Float, Int>::default_settings() {
+  OSQPSettings c;
+  Settings     s;
+
+  osqp_set_default_settings(&c);
+
+  s.verbose            = c.verbose;
+  s.warm_starting      = c.warm_starting;
+  s.scaling            = c.scaling;
+  s.polishing          = c.polishing;
+  s.rho                = c.rho;
+  s.rho_is_vec         = c.rho_is_vec;
+  s.sigma              = c.sigma;
+  s.alpha              = c.alpha;
+  s.adaptive_rho       = c.adaptive_rho;
+  s.max_iter           = c.max_iter;
+  s.eps_abs            = c.eps_abs;
+  s.eps_rel            = c.eps_rel;
+  s.eps_prim_inf       = c.eps_prim_inf;
+  s.eps_dual_inf       = c.eps_dual_inf;
+  s.scaled_termination = c.scaled_termination;
+  s.check_termination  = c.check_termination;
+  s.time_limit         = c.time_limit;
+  s.delta              = c.delta;
+  s.polish_refine_iter = c.polish_refine_iter;
+  return s;
+}
+
+template <typename Float, typename Int>
+Solver<Float, Int>::Solver() : impl_(new Impl()) {}
+
+template <typename Float, typename Int>
+Solver<Float, Int>::~Solver() {}
+
+template <typename Float, typename Int>
+Solver<Float, Int>::Solver(Solver&& other) noexcept : impl_(std::move(other.impl_)) {}
+
+template <typename Float, typename Int>
+Solver<Float, Int>& Solver<Float, Int>::operator=(Solver&& other) noexcept {
+  impl_ = std::move(other.impl_);
+  return *this;
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::setup(const CscMatrix& P,
+                              const Float*     q,
+                              const CscMatrix& A,
+                              const Float*     l,
+                              const Float*     u,
+                              const Settings&  settings) {
+  OSQPCscMatrix        P_c, A_c;
+  OSQPSettings         settings_c;
+  std::vector<OSQPInt> P_p, P_i, A_p, A_i;
+
+  if (!impl_) impl_.reset(new Impl());
+
+  osqp_cleanup(impl_->solver);
+  impl_->solver = OSQP_NULL;
+
+  csc_to_c(P, P_p, P_i, &P_c);
+  csc_to_c(A, A_p, A_i, &A_c);
+  osqp_set_default_settings(&settings_c);
+  settings_to_c(settings, &settings_c);
+
+  return (Int)osqp_setup(&impl_->solver, &P_c, q, &A_c, l, u, A.m, P.n, &settings_c);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::solve() {
+  return (Int)osqp_solve(impl_ ? impl_->solver : OSQP_NULL);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::update_data_vec(const Float* q_new,
+                                        const Float* l_new,
+                                        const Float* u_new) {
+  return (Int)osqp_update_data_vec(impl_ ? impl_->solver : OSQP_NULL, q_new, l_new, u_new);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::update_settings(const Settings& settings) {
+  OSQPSettings settings_c;
+
+  if (!impl_ || !impl_->solver) return (Int)OSQP_WORKSPACE_NOT_INIT_ERROR;
+
+  // Start from the current settings so the fields not exposed here are kept
+  settings_c = *impl_->solver->settings;
+  settings_to_c(settings, &settings_c);
+  return (Int)osqp_update_settings(impl_->solver, &settings_c);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::update_rho(Float rho_new) {
+  return (Int)osqp_update_rho(impl_ ? impl_->solver : OSQP_NULL, rho_new);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::warm_start(const Float* x,
+                                   const Float* y) {
+  return (Int)osqp_warm_start(impl_ ? impl_->solver : OSQP_NULL, x, y);
+}
+
+template <typename Float, typename Int>
+void Solver<Float, Int>::cold_start() {
+  if (impl_ && impl_->solver) osqp_cold_start(impl_->solver);
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::n() const {
+  OSQPInt m = 0, n = 0;
+  if (impl_ && impl_->solver) osqp_get_dimensions(impl_->solver, &m, &n);
+  return (Int)n;
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::m() const {
+  OSQPInt m = 0, n = 0;
+  if (impl_ && impl_->solver) osqp_get_dimensions(impl_->solver, &m, &n);
+  return (Int)m;
+}
+
+template <typename Float, typename Int>
+const Float* Solver<Float, Int>::x() const {
+  return (impl_ && impl_->solver) ? impl_->solver->solution->x : OSQP_NULL;
+}
+
+template <typename Float, typename Int>
+const Float* Solver<Float, Int>::y() const {
+  return (impl_ && impl_->solver) ? impl_->solver->solution->y : OSQP_NULL;
+}
+
+template <typename Float, typename Int>
+const char* Solver<Float, Int>::status() const {
+  return (impl_ && impl_->solver) ? impl_->solver->info->status : "unsolved";
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::status_val() const {
+  return (impl_ && impl_->solver) ? (Int)impl_->solver->info->status_val : (Int)OSQP_UNSOLVED;
+}
+
+template <typename Float, typename Int>
+Int Solver<Float, Int>::iter() const {
+  return (impl_ && impl_->solver) ? (Int)impl_->solver->info->iter : 0;
+}
+
+template <typename Float, typename Int>
+Float Solver<Float, Int>::obj_val() const {
+  return (impl_ && impl_->solver) ? impl_->solver->info->obj_val : std::numeric_limits<Float>::quiet_NaN();
+}
+
+template <typename Float, typename Int>
+Float Solver<Float, Int>::prim_res() const {
+  return (impl_ && impl_->solver) ? impl_->solver->info->prim_res : std::numeric_limits<Float>::quiet_NaN();
+}
+
+template <typename Float, typename Int>
+Float Solver<Float, Int>::dual_res() const {
+  return (impl_ && impl_->solver) ? impl_->solver->info->dual_res : std::numeric_limits<Float>::quiet_NaN();
+}
+
+
+/* Instantiate the interface for this library's precision */
+template class Solver<OSQPFloat, CxxInt>;
+
+} // namespace osqp
@@ -12,29 +12,28 @@
  * Ared = vstack[Alow, Aupp]
  * Active constraints are guessed from the primal and dual solution returned by
  * the ADMM.
- * @param  work Workspace
- * @return      Number of rows in Ared, negative if error
+ * In real-time mode Ared keeps all the rows of A and the inactive ones are
+ * zeroed instead, so that the reduced KKT system keeps its pattern. When
+ * polishing in place only the row mask is formed.
+ * @param  work  Workspace
+ * @param  iwork Raw workspace (size m)
+ * @param  fwork Raw workspace (size 4m)
+ * @return       Number of active rows, negative if error
  */
-static OSQPInt form_Ared(OSQPWorkspace* work){
+static OSQPInt form_Ared(OSQPWorkspace* work,
+                         OSQPInt*       iwork,
+                         OSQPFloat*     fwork) {
 
   OSQPInt j, n_active;
   OSQPInt m = work->data->m;
 
-  OSQPInt* active_flags;
-  OSQPFloat* z;
-  OSQPFloat* y;
-  OSQPFloat* u;
-  OSQPFloat* l;
-
-  // Allocate raw arrays
-  active_flags = (OSQPInt *) c_malloc(m * sizeof(OSQPInt));
-  z = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
-  y = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
-  l = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
-  u = (OSQPFloat *) c_malloc(m * sizeof(OSQPFloat));
+  OSQPInt*   active_flags = iwork;
+  OSQPFloat* z = fwork;
+  OSQPFloat* y = fwork + m;
+  OSQPFloat* l = fwork + 2 * m;
+  OSQPFloat* u = fwork + 3 * m;
 
   // Copy data to raw arrays
-  OSQPVectori_to_raw(active_flags, work->pol->active_flags);
   OSQPVectorf_to_raw(z, work->z);
   OSQPVectorf_to_raw(y, work->y);
   OSQPVectorf_to_raw(l, work->data->l);
@@ -72,15 +71,22 @@ static OSQPInt form_Ared(OSQPWorkspace* work){
   //total active constraints
   work->pol->n_active = n_active;
 
-  //extract the relevant rows
-  work->pol->Ared = OSQPMatrix_submatrix_byrows(work->data->A, work->pol->active_flags);
+  if (work->pol->plsh) {
+    for (j = 0; j < m; j++) z[j] = active_flags[j] ? 1.0 : 0.0;
+    OSQPVectorf_from_raw(work->pol->row_mask, z);
 
-  // Memory clean-up
-  c_free(active_flags);
-  c_free(z);
-  c_free(y);
-  c_free(l);
-  c_free(u);
+    // Zero the inactive rows of the preallocated copy of A
+    if (!work->pol->in_place) {
+      OSQPMatrix_update_values(work->pol->Ared, OSQPMatrix_get_x(work->data->A),
+                               OSQP_NULL, OSQPMatrix_get_nz(work->data->A));
+      OSQPMatrix_lmult_diag(work->pol->Ared, work->pol->row_mask);
+    }
+  }
+  else {
+    //extract the relevant rows
+    work->pol->Ared = OSQPMatrix_submatrix_byrows(work->data->A, work->pol->active_flags);
+    if (!work->pol->Ared) return -1;
+  }
 
   // Return number of rows in Ared
   return n_active;
@@ -88,33 +94,31 @@ static OSQPInt form_Ared(OSQPWorkspace* work){
 
 /**
  * Form reduced right-hand side rhs_red = vstack[-q, l_low, u_upp]
- * @param  work Workspace
- * @param  rhs  right-hand-side
- * @return      reduced rhs
+ * (in real-time mode the entries of inactive rows are zero instead of dropped)
+ * @param  work  Workspace
+ * @param  rhs   right-hand-side
+ * @param  iwork Raw workspace holding the active flags
+ * @param  fwork Raw workspace (size 2n+3m)
+ * @return       reduced rhs
  */
-static void form_rhs_red(OSQPWorkspace* work, OSQPVectorf* rhs) {
+static void form_rhs_red(OSQPWorkspace* work,
+                         OSQPVectorf*   rhs,
+                         const OSQPInt* iwork,
+                         OSQPFloat*     fwork) {
 
   OSQPInt j, counter;
   OSQPInt n = work->data->n;
   OSQPInt m = work->data->m;
   OSQPInt n_plus_mred = OSQPVectorf_length(rhs);
+  OSQPInt compact = !work->pol->plsh;
 
-  OSQPInt *active_flags;
-  OSQPFloat* rhsv;
-  OSQPFloat* q;
-  OSQPFloat* l;
-  OSQPFloat* u;
-
-  // Allocate raw arrays
-  active_flags = (OSQPInt *)   c_malloc(m           * sizeof(OSQPInt));
-  rhsv         = (OSQPFloat *) c_malloc(n_plus_mred * sizeof(OSQPFloat));
-  q            = (OSQPFloat *) c_malloc(n           * sizeof(OSQPFloat));
-  l            = (OSQPFloat *) c_malloc(m           * sizeof(OSQPFloat));
-  u            = (OSQPFloat *) c_malloc(m           * sizeof(OSQPFloat));
+  const OSQPInt* active_flags = iwork;
+  OSQPFloat* rhsv = fwork;
+  OSQPFloat* q    = fwork + n_plus_mred;
+  OSQPFloat* l    = q + n;
+  OSQPFloat* u    = l + m;
 
   // Copy data to raw arrays
-  OSQPVectori_to_raw(active_flags, work->pol->active_flags);
-  OSQPVectorf_to_raw(rhsv, rhs);
   OSQPVectorf_to_raw(q, work->data->q);
   OSQPVectorf_to_raw(l, work->data->l);
   OSQPVectorf_to_raw(u, work->data->u);
@@ -127,24 +131,20 @@ static void form_rhs_red(OSQPWorkspace* work, OSQPVectorf* rhs) {
 
   for (j = 0; j < work->data->m; j++) {
     if(active_flags[j] == -1){ // lower active
-       rhsv[work->data->n + counter] = l[j];
+       rhsv[work->data->n + (compact ? counter : j)] = l[j];
        counter++;
     }
     else if(active_flags[j] == 1){ //upper actice
-       rhsv[work->data->n + counter] = u[j];
+       rhsv[work->data->n + (compact ? counter : j)] = u[j];
        counter++;
     }
+    else if (!compact) {
+       rhsv[work->data->n + j] = 0.0;
+    }
   }
 
   // Copy raw vector into OSQPVectorf structure
   OSQPVectorf_from_raw(rhs, rhsv);
-
-  // Memory clean-up
-  c_free(active_flags);
-  c_free(rhsv);
-  c_free(q);
-  c_free(l);
-  c_free(u);
 }
 
 /**
@@ -168,21 +168,35 @@ static OSQPInt iterative_refinement(OSQPSolver*   solver,
 
   OSQPSettings*  settings = solver->settings;
   OSQPWorkspace* work     = solver->work;
+  OSQPPolish*    pol      = work->pol;
 
-  if (settings->polish_refine_iter > 0) {
-    mred = OSQPMatrix_get_m(work->pol->Ared);
-
-    // Allocate dz and rhs vectors
-    rhs = OSQPVectorf_malloc(work->data->n + mred);
-
-    //form views of the top/bottom parts of rhs and z
-    rhs1 = OSQPVectorf_view(rhs,0,work->data->n);
-    rhs2 = OSQPVectorf_view(rhs,work->data->n,mred);
-    z1   = OSQPVectorf_view(z,0,work->data->n);
-    z2   = OSQPVectorf_view(z,work->data->n,mred);
+  // In place, the y part of z is zero on the inactive rows, so A can stand in for Ared
+  OSQPMatrix* Ared = pol->in_place ? work->data->A : pol->Ared;
 
-    if (!rhs || !rhs1 || !rhs2 || !z1 || !z2) {
-      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (settings->polish_refine_iter > 0) {
+    mred = OSQPMatrix_get_m(Ared);
+
+    if (pol->plsh) {
+      // Preallocated in real-time mode (z is pol->sol)
+      rhs  = pol->ref;
+      rhs1 = pol->ref_x;
+      rhs2 = pol->ref_y;
+      z1   = pol->sol_x;
+      z2   = pol->sol_y;
+    }
+    else {
+      // Allocate dz and rhs vectors
+      rhs = OSQPVectorf_malloc(work->data->n + mred);
+
+      //form views of the top/bottom parts of rhs and z
+      rhs1 = OSQPVectorf_view(rhs,0,work->data->n);
+      rhs2 = OSQPVectorf_view(rhs,work->data->n,mred);
+      z1   = OSQPVectorf_view(z,0,work->data->n);
+      z2   = OSQPVectorf_view(z,work->data->n,mred);
+
+      if (!rhs || !rhs1 || !rhs2 || !z1 || !z2) {
+        return osqp_error(OSQP_MEM_ALLOC_ERROR);
+      }
     }
 
     for (i = 0; i < settings->polish_refine_iter; i++) {
@@ -195,11 +209,12 @@ static OSQPInt iterative_refinement(OSQPSolver*   solver,
       OSQPMatrix_Axpy(work->data->P, z1, rhs1, -1.0, 1.0);
 
       // -= Ared'*y_red  (in the top partition)
-      OSQPMatrix_Atxpy(work->pol->Ared, z2, rhs1, -1.0, 1.0);
+      OSQPMatrix_Atxpy(Ared, z2, rhs1, -1.0, 1.0);
 
       // Lower Part: R^{m}
       // -= A*x  (in the bottom partition)
-      OSQPMatrix_Axpy(work->pol->Ared, z1, rhs2, -1.0, 1.0);
+      OSQPMatrix_Axpy(Ared, z1, rhs2, -1.0, 1.0);
+      if (pol->in_place) OSQPVectorf_ew_prod(rhs2, rhs2, pol->row_mask);
 
       // Solve linear system. Store solution in rhs
       p->solve(p, rhs, 1);
@@ -208,50 +223,46 @@ static OSQPInt iterative_refinement(OSQPSolver*   solver,
       OSQPVectorf_plus(z,z,rhs);
     }
 
-    OSQPVectorf_free(rhs);
-    OSQPVectorf_view_free(rhs1);
-    OSQPVectorf_view_free(rhs2);
-    OSQPVectorf_view_free(z1);
-    OSQPVectorf_view_free(z2);
+    if (!pol->plsh) {
+      OSQPVectorf_free(rhs);
+      OSQPVectorf_view_free(rhs1);
+      OSQPVectorf_view_free(rhs2);
+      OSQPVectorf_view_free(z1);
+      OSQPVectorf_view_free(z2);
+    }
   }
   return 0;
 }
 
 /**
  * Compute dual variable y from yred
- * @param work Workspace
- * @param yred Dual variables associated to active constraints
+ * @param work  Workspace
+ * @param yred  Dual variables associated to active constraints
+ * @param iwork Raw workspace holding the active flags
+ * @param fwork Raw workspace (size 2m)
  */
-static void get_ypol_from_yred(OSQPWorkspace* work, OSQPVectorf* yred_vf) {
+static void get_ypol_from_yred(OSQPWorkspace* work,
+                               OSQPVectorf*   yred_vf,
+                               const OSQPInt* iwork,
+                               OSQPFloat*     fwork) {
 
   OSQPInt j, counter;
   OSQPInt m = work->data->m;
-  OSQPInt mred = OSQPVectorf_length(yred_vf);
+  OSQPInt compact = !work->pol->plsh;
 
-  OSQPInt *active_flags;
-  OSQPFloat *y, *yred;
-
-  // Allocate raw arrays
-  active_flags = (OSQPInt *)   c_malloc(m    * sizeof(OSQPInt));
-  y            = (OSQPFloat *) c_malloc(m    * sizeof(OSQPFloat));
-  yred         = (OSQPFloat *) c_malloc(mred * sizeof(OSQPFloat));
-
-  // Copy data to raw arrays
-  OSQPVectori_to_raw(active_flags, work->pol->active_flags);
-  OSQPVectorf_to_raw(y, work->y);
-  OSQPVectorf_to_raw(yred, yred_vf);
+  const OSQPInt* active_flags = iwork;
+  OSQPFloat* y    = fwork;
+  OSQPFloat* yred = fwork + m;
 
   // If there are no active constraints
   if (work->pol->n_active == 0) {
     OSQPVectorf_set_scalar(work->pol->y, 0.);
-
-    // Memory clean-up
-    c_free(active_flags);
-    c_free(y);
-    c_free(yred);
     return;
   }
 
+  // Copy data to raw arrays
+  OSQPVectorf_to_raw(yred, yred_vf);
+
   counter = 0;
 
   for (j = 0; j < work->data->m; j++) {
@@ -260,43 +271,93 @@ static void get_ypol_from_yred(OSQPWorkspace* work, OSQPVectorf* yred_vf) {
       y[j] = 0;
     }
     else {  // active
-      y[j] = yred[counter];
+      y[j] = yred[compact ? counter : j];
       counter++;
     }
   }
 
   // Copy raw vector into OSQPVectorf structure
   OSQPVectorf_from_raw(work->pol->y, y);
+}
 
-  // Memory clean-up
-  c_free(active_flags);
-  c_free(y);
-  c_free(yred);
+/* Size of the raw float workspace of the polishing helpers */
+static OSQPInt polish_fwork_size(OSQPInt n,
+                                 OSQPInt m) {
+  return 2 * n + 4 * m;
 }
 
-OSQPInt polish(OSQPSolver* solver) {
+/**
+ * Release what polish_solution allocated for this call; the reduced system
+ * of real-time mode is kept, and the ADMM solver gets its factorization back
+ * when polishing in place.
+ */
+static void free_polish_system(OSQPWorkspace* work,
+                               LinSysSolver*  plsh,
+                               OSQPVectorf*   rhs_red,
+                               OSQPVectorf*   pol_sol,
+                               OSQPVectorf*   pol_sol_xview,
+                               OSQPVectorf*   pol_sol_yview,
+                               OSQPInt*       iwork,
+                               OSQPFloat*     fwork) {
+  if (work->pol->plsh) {
+    if (work->pol->in_place) work->pol->plsh->polish_factor(work->pol->plsh, OSQP_NULL);
+    return;
+  }
+
+  if (plsh) plsh->free(plsh);
+  OSQPMatrix_free(work->pol->Ared);
+  work->pol->Ared = OSQP_NULL;
+  OSQPVectorf_free(rhs_red);
+  OSQPVectorf_free(pol_sol);
+  OSQPVectorf_view_free(pol_sol_xview);
+  OSQPVectorf_view_free(pol_sol_yview);
+  c_free(iwork);
+  c_free(fwork);
+}
+
+static OSQPInt polish_solution(OSQPSolver* solver) {
 
   OSQPInt mred, polish_successful, exitflag;
 
-  LinSysSolver* plsh;
-  OSQPVectorf*  rhs_red;
-  OSQPVectorf*  pol_sol; // Polished solution (x and reduced y)
-  OSQPVectorf*  pol_sol_xview; // view into x part of polished solution
-  OSQPVectorf*  pol_sol_yview; // view into (reduced) y part of polished solutions
+  LinSysSolver* plsh          = OSQP_NULL;
+  OSQPVectorf*  rhs_red       = OSQP_NULL;
+  OSQPVectorf*  pol_sol       = OSQP_NULL; // Polished solution (x and reduced y)
+  OSQPVectorf*  pol_sol_xview = OSQP_NULL; // view into x part of polished solution
+  OSQPVectorf*  pol_sol_yview = OSQP_NULL; // view into (reduced) y part of polished solutions
+  OSQPInt*      iwork;
+  OSQPFloat*    fwork;
 
   OSQPInfo*      info     = solver->info;
   OSQPSettings*  settings = solver->settings;
   OSQPWorkspace* work     = solver->work;
+  OSQPPolish*    pol      = work->pol;
 
 #ifdef OSQP_ENABLE_PROFILING
   osqp_tic(work->timer); // Start timer
 #endif /* ifdef OSQP_ENABLE_PROFILING */
 
+  // Raw workspace of the helpers
+  if (pol->plsh) {
+    iwork = pol->iwork;
+    fwork = pol->fwork;
+  }
+  else {
+    iwork = (OSQPInt *)   c_malloc(work->data->m * sizeof(OSQPInt));
+    fwork = (OSQPFloat *) c_malloc(polish_fwork_size(work->data->n, work->data->m) * sizeof(OSQPFloat));
+    if ((work->data->m && !iwork) || !fwork) {
+      info->status_polish = OSQP_POLISH_FAILED;
+      c_free(iwork);
+      c_free(fwork);
+      return OSQP_POLISH_FAILED;
+    }
+  }
+
   // Form Ared by assuming the active constraints and store in work->pol->Ared
-  mred = form_Ared(work);
+  mred = form_Ared(work, iwork, fwork);
   if (mred < 0) {
     // Polishing failed
     info->status_polish = OSQP_POLISH_FAILED;
+    free_polish_system(work, plsh, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
     return OSQP_POLISH_FAILED;
   } else if (mred == 0) {
     /* No active constraints, so skip polishing */
@@ -304,57 +365,68 @@ OSQPInt polish(OSQPSolver* solver) {
     info->status_polish = OSQP_POLISH_NO_ACTIVE_SET_FOUND;
 
     // Memory clean-up
-    OSQPMatrix_free(work->pol->Ared);
+    free_polish_system(work, plsh, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
 
     return OSQP_POLISH_NO_ACTIVE_SET_FOUND;
   }
 
-  // Form and factorize reduced KKT
-  exitflag = osqp_algebra_init_linsys_solver(&plsh, work->data->P, work->pol->Ared,
-                                             OSQP_NULL, settings, OSQP_NULL, OSQP_NULL, 1);
+  if (pol->plsh) {
+    plsh          = pol->plsh;
+    rhs_red       = pol->rhs_red;
+    pol_sol       = pol->sol;
+    pol_sol_xview = pol->sol_x;
+    pol_sol_yview = pol->sol_y;
+    mred          = work->data->m;
+
+    if (pol->in_place) {
+      // Refactor the ADMM KKT with the inactive rows decoupled
+      exitflag = plsh->polish_factor(plsh, pol->active_flags);
+    }
+    else {
+      // Refactor the preallocated reduced KKT with the current P and masked A
+      exitflag = plsh->update_matrices(plsh,
+                                       work->data->P, OSQP_NULL, OSQPMatrix_get_nz(work->data->P),
+                                       pol->Ared, OSQP_NULL, OSQPMatrix_get_nz(pol->Ared));
+    }
+  }
+  else {
+    // Form and factorize reduced KKT
+    exitflag = osqp_algebra_init_linsys_solver(&plsh, work->data->P, pol->Ared,
+                                               OSQP_NULL, settings, OSQP_NULL, OSQP_NULL, 1);
+  }
 
   if (exitflag) {
     // Polishing failed
     info->status_polish = OSQP_POLISH_LINSYS_ERROR;
 
     // Memory clean-up
-    OSQPMatrix_free(work->pol->Ared);
+    free_polish_system(work, OSQP_NULL, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
 
     return OSQP_POLISH_FAILED;
   }
 
   // Form reduced right-hand side rhs_red
-  rhs_red = OSQPVectorf_malloc(work->data->n + mred);
-  if (!rhs_red) {
-    // Polishing failed
-    info->status_polish = OSQP_POLISH_FAILED;
-
-    // Memory clean-up
-    OSQPMatrix_free(work->pol->Ared);
-
-    return OSQP_POLISH_FAILED;
+  if (!pol->plsh) {
+    rhs_red       = OSQPVectorf_malloc(work->data->n + mred);
+    pol_sol       = OSQPVectorf_malloc(work->data->n + mred);
+    pol_sol_xview = OSQPVectorf_view(pol_sol,0,work->data->n);
+    pol_sol_yview = OSQPVectorf_view(pol_sol,work->data->n,mred);
   }
-  form_rhs_red(work, rhs_red);
-
-  pol_sol = OSQPVectorf_copy_new(rhs_red);
-  pol_sol_xview = OSQPVectorf_view(pol_sol,0,work->data->n);
-  pol_sol_yview = OSQPVectorf_view(pol_sol,work->data->n,mred);
 
-  if (!pol_sol || !pol_sol_xview || !pol_sol_yview) {
+  if (!rhs_red || !pol_sol || !pol_sol_xview || !pol_sol_yview) {
 
     // Polishing failed
     info->status_polish = OSQP_POLISH_FAILED;
 
     // Memory clean-up
-    OSQPMatrix_free(work->pol->Ared);
-    OSQPVectorf_free(rhs_red);
-    OSQPVectorf_free(pol_sol);
-    OSQPVectorf_view_free(pol_sol_xview);
-    OSQPVectorf_view_free(pol_sol_yview);
+    free_polish_system(work, plsh, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
 
     return OSQP_POLISH_FAILED;
   }
 
+  form_rhs_red(work, rhs_red, iwork, fwork);
+  OSQPVectorf_copy(pol_sol, rhs_red);
+
   // Warm start the polished solution
   plsh->warm_start(plsh, work->x);
 
@@ -369,11 +441,7 @@ OSQPInt polish(OSQPSolver* solver) {
     info->status_polish = OSQP_POLISH_FAILED;
 
     // Memory clean-up
-    OSQPMatrix_free(work->pol->Ared);
-    OSQPVectorf_free(rhs_red);
-    OSQPVectorf_free(pol_sol);
-    OSQPVectorf_view_free(pol_sol_xview);
-    OSQPVectorf_view_free(pol_sol_yview);
+    free_polish_system(work, plsh, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
 
     return OSQP_POLISH_FAILED;
   }
@@ -381,7 +449,7 @@ OSQPInt polish(OSQPSolver* solver) {
   // Store the polished solution (x,z,y)
   OSQPVectorf_copy(work->pol->x, pol_sol_xview);   // pol->x
   OSQPMatrix_Axpy(work->data->A, work->pol->x, work->pol->z, 1.0, 0.0);
-  get_ypol_from_yred(work, pol_sol_yview);     // pol->y
+  get_ypol_from_yred(work, pol_sol_yview, iwork, fwork);     // pol->y
 
   // Ensure z is in C and y is in the normal cone N_C(z)
   // by doing: y <- y + z;  z <- proj_C(y);  y <- y - z
@@ -434,13 +502,130 @@ OSQPInt polish(OSQPSolver* solver) {
   }
 
   // Memory clean-up
-  plsh->free(plsh);
-
-  // Checks that they are not NULL are already performed earlier
-  OSQPMatrix_free(work->pol->Ared);
-  OSQPVectorf_free(rhs_red);
-  OSQPVectorf_free(pol_sol);
-  OSQPVectorf_view_free(pol_sol_xview);
-  OSQPVectorf_view_free(pol_sol_yview);
+  free_polish_system(work, plsh, rhs_red, pol_sol, pol_sol_xview, pol_sol_yview, iwork, fwork);
   return info->status_polish;
 }
+
+
+OSQPInt polish_alloc(OSQPWorkspace* work) {
+
+  OSQPInt n = work->data->n;
+  OSQPInt m = work->data->m;
+
+  work->pol->active_flags = OSQPVectori_malloc(m);
+  work->pol->x            = OSQPVectorf_malloc(n);
+  work->pol->z            = OSQPVectorf_malloc(m);
+  work->pol->y            = OSQPVectorf_malloc(m);
+  if (!(work->pol->x)) return OSQP_MEM_ALLOC_ERROR;
+  if (!(work->pol->active_flags) ||
+      !(work->pol->z) || !(work->pol->y))
+    return OSQP_MEM_ALLOC_ERROR;
+
+  return 0;
+}
+
+OSQPInt polish_alloc_system(OSQPSolver* solver) {
+
+  OSQPWorkspace* work = solver->work;
+  OSQPPolish*    pol  = work->pol;
+  OSQPInt        n    = work->data->n;
+  OSQPInt        m    = work->data->m;
+
+  // The ADMM solver can factor the polishing system on its own pattern, which
+  // real-time mode prefers to keeping a second KKT system
+  pol->in_place = (solver->settings->polish_in_place || solver->settings->realtime) &&
+                  work->linsys_solver->polish_factor;
+  if (!pol->in_place && !solver->settings->realtime) return 0;
+
+  // Real-time fallback: copy of A whose inactive rows are zeroed before each polish
+  if (!pol->in_place) {
+    pol->Ared = OSQPMatrix_copy_new(work->data->A);
+    if (!pol->Ared) return OSQP_MEM_ALLOC_ERROR;
+  }
+  pol->row_mask = OSQPVectorf_malloc(m);
+  pol->rhs_red  = OSQPVectorf_malloc(n + m);
+  pol->sol      = OSQPVectorf_malloc(n + m);
+  pol->ref      = OSQPVectorf_malloc(n + m);
+  if (!pol->row_mask || !pol->rhs_red || !pol->sol || !pol->ref)
+    return OSQP_MEM_ALLOC_ERROR;
+
+  pol->sol_x = OSQPVectorf_view(pol->sol, 0, n);
+  pol->sol_y = OSQPVectorf_view(pol->sol, n, m);
+  pol->ref_x = OSQPVectorf_view(pol->ref, 0, n);
+  pol->ref_y = OSQPVectorf_view(pol->ref, n, m);
+  pol->iwork = (OSQPInt *)   c_malloc(m * sizeof(OSQPInt));
+  pol->fwork = (OSQPFloat *) c_malloc(polish_fwork_size(n, m) * sizeof(OSQPFloat));
+  if (!pol->sol_x || !pol->sol_y || !pol->ref_x || !pol->ref_y ||
+      (m && !pol->iwork) || !pol->fwork)
+    return OSQP_MEM_ALLOC_ERROR;
+
+  if (pol->in_place) {
+    pol->plsh = work->linsys_solver;
+    return 0;
+  }
+
+  // The solver keeps the KKT matrix and its index maps in real-time mode
+  return osqp_algebra_init_linsys_solver(&pol->plsh, work->data->P, pol->Ared,
+                                         OSQP_NULL, solver->settings, OSQP_NULL, OSQP_NULL, 1);
+}
+
+void polish_free(OSQPWorkspace* work) {
+  OSQPPolish* pol = work->pol;
+
+  OSQPVectori_free(pol->active_flags);
+  OSQPVectorf_free(pol->x);
+  OSQPVectorf_free(pol->z);
+  OSQPVectorf_free(pol->y);
+  pol->active_flags = OSQP_NULL;
+  pol->x            = OSQP_NULL;
+  pol->z            = OSQP_NULL;
+  pol->y            = OSQP_NULL;
+
+  // Reduced system of real-time mode (the ADMM solver when polishing in place)
+  if (pol->plsh && !pol->in_place) pol->plsh->free(pol->plsh);
+  OSQPMatrix_free(pol->Ared);
+  OSQPVectorf_free(pol->row_mask);
+  OSQPVectorf_free(pol->rhs_red);
+  OSQPVectorf_view_free(pol->sol_x);
+  OSQPVectorf_view_free(pol->sol_y);
+  OSQPVectorf_free(pol->sol);
+  OSQPVectorf_view_free(pol->ref_x);
+  OSQPVectorf_view_free(pol->ref_y);
+  OSQPVectorf_free(pol->ref);
+  c_free(pol->iwork);
+  c_free(pol->fwork);
+  pol->in_place = 0;
+  pol->plsh     = OSQP_NULL;
+  pol->Ared     = OSQP_NULL;
+  pol->row_mask = OSQP_NULL;
+  pol->rhs_red  = OSQP_NULL;
+  pol->sol_x    = OSQP_NULL;
+  pol->sol_y    = OSQP_NULL;
+  pol->sol      = OSQP_NULL;
+  pol->ref_x    = OSQP_NULL;
+  pol->ref_y    = OSQP_NULL;
+  pol->ref      = OSQP_NULL;
+  pol->iwork    = OSQP_NULL;
+  pol->fwork    = OSQP_NULL;
+}
+
+OSQPInt polish(OSQPSolver* solver) {
+
+  OSQPInt status;
+
+  OSQPSettings*  settings = solver->settings;
+  OSQPWorkspace* work     = solver->work;
+
+  // In lean mode the polishing vectors only exist while polishing
+  if (settings->lean_memory && (polish_alloc(work) || polish_alloc_system(solver))) {
+    polish_free(work);
+    solver->info->status_polish = OSQP_POLISH_FAILED;
+    return OSQP_POLISH_FAILED;
+  }
+
+  status = polish_solution(solver);
+
+  if (settings->lean_memory) polish_free(work);
+
+  return status;
+}
@@ -0,0 +1,528 @@
+#include "reorder.h"
+#include "lin_alg.h"
+#include "csc_utils.h"
+#include "glob_opts.h"
+
+
+/*
+ * Breadth-first search from root through the nodes that are not placed yet
+ * (mark != -1). The visited nodes are stored level by level in queue and
+ * stamped in mark. Returns the number of levels; the last level is
+ * queue[*last] to queue[*size - 1].
+ */
+static OSQPInt bfs_levels(const OSQPInt* adjp,
+                          const OSQPInt* adj,
+                          OSQPInt        root,
+                          OSQPInt*       queue,
+                          OSQPInt*       mark,
+                          OSQPInt        stamp,
+                          OSQPInt*       last,
+                          OSQPInt*       size) {
+
+  OSQPInt head, tail, level_end, k, v, w;
+  OSQPInt levels = 0;
+
+  queue[0]   = root;
+  mark[root] = stamp;
+  head       = 0;
+  tail       = 1;
+
+  while (head < tail) {
+    *last     = head;
+    level_end = tail;
+    levels++;
+
+    for (; head < level_end; head++) {
+      v = queue[head];
+      for (k = adjp[v]; k < adjp[v+1]; k++) {
+        w = adj[k];
+        if (mark[w] != -1 && mark[w] != stamp) {
+          mark[w] = stamp;
+          queue[tail++] = w;
+        }
+      }
+    }
+  }
+
+  *size = tail;
+  return levels;
+}
+
+/*
+ * Pseudo-peripheral node of the component of root (George and Liu): restart
+ * from a node of minimum degree in the last level for as long as the number
+ * of levels grows.
+ */
+static OSQPInt pseudo_peripheral(const OSQPInt* adjp,
+                                 const OSQPInt* adj,
+                                 OSQPInt        root,
+                                 OSQPInt*       queue,
+                                 OSQPInt*       mark,
+                                 OSQPInt*       stamp) {
+
+  OSQPInt levels, new_levels, last, size, k, x;
+
+  levels = bfs_levels(adjp, adj, root, queue, mark, ++(*stamp), &last, &size);
+
+  for (;;) {
+    x = queue[last];
+    for (k = last + 1; k < size; k++) {
+      if (adjp[queue[k]+1] - adjp[queue[k]] < adjp[x+1] - adjp[x]) x = queue[k];
+    }
+
+    new_levels = bfs_levels(adjp, adj, x, queue, mark, ++(*stamp), &last, &size);
+    if (new_levels <= levels) break;
+    root   = x;
+    levels = new_levels;
+  }
+
+  return root;
+}
+
+/*
+ * Reverse Cuthill-McKee ordering of the graph with adjacency (adjp, adj) and
+ * N nodes. Components are started from the unplaced node of lowest degree.
+ * order receives the ordering, mark and work are workspaces of size N.
+ */
+static void rcm_order(const OSQPInt* adjp,
+                      const OSQPInt* adj,
+                      OSQPInt        N,
+                      OSQPInt*       order,
+                      OSQPInt*       mark,
+                      OSQPInt*       work) {
+
+  OSQPInt i, j, k, v, w, d, head, tail, first, root;
+  OSQPInt stamp   = 0;
+  OSQPInt pos     = 0;
+  OSQPInt max_deg = 0;
+
+  /* Nodes by increasing degree (counting sort, using order as the counts) */
+  for (v = 0; v < N; v++) max_deg = c_max(max_deg, adjp[v+1] - adjp[v]);
+  for (d = 0; d <= max_deg; d++) order[d] = 0;
+  for (v = 0; v < N; v++) order[adjp[v+1] - adjp[v]]++;
+  for (d = 0, k = 0; d <= max_deg; d++) {
+    i        = order[d];
+    order[d] = k;
+    k       += i;
+  }
+  for (v = 0; v < N; v++) work[order[adjp[v+1] - adjp[v]]++] = v;
+
+  for (v = 0; v < N; v++) mark[v] = 0;
+
+  for (i = 0; i < N; i++) {
+    if (mark[work[i]] == -1) continue;
+
+    /* Cuthill-McKee on the component, new neighbors by increasing degree */
+    root = pseudo_peripheral(adjp, adj, work[i], order + pos, mark, &stamp);
+    order[pos] = root;
+    mark[root] = -1;
+    head = pos;
+    tail = pos + 1;
+
+    while (head < tail) {
+      v     = order[head++];
+      first = tail;
+      for (k = adjp[v]; k < adjp[v+1]; k++) {
+        w = adj[k];
+        if (mark[w] == -1) continue;
+        mark[w] = -1;
+
+        d = adjp[w+1] - adjp[w];
+        for (j = tail++; j > first && adjp[order[j-1]+1] - adjp[order[j-1]] > d; j--) {
+          order[j] = order[j-1];
+        }
+        order[j] = w;
+      }
+    }
+    pos = tail;
+  }
+
+  /* Reverse */
+  for (i = 0, k = N - 1; i < k; i++, k--) {
+    v        = order[i];
+    order[i] = order[k];
+    order[k] = v;
+  }
+}
+
+/*
+ * C = M(rinv, cinv), i.e. entry (i, j) of M is entry (rinv[i], cinv[j]) of C,
+ * with the rows of each column of C sorted. With upper, entries that land
+ * below the diagonal are mirrored above it. map[k] receives the position in C
+ * of entry k of M.
+ */
+static OSQPCscMatrix* permute_csc(const OSQPCscMatrix* M,
+                                  const OSQPInt*       rinv,
+                                  const OSQPInt*       cinv,
+                                  OSQPInt              upper,
+                                  OSQPInt*             map) {
+
+  OSQPInt i, j, k, q, t, nnz;
+  OSQPInt*  rowp;
+  OSQPInt*  rowj;
+  OSQPInt*  rowk;
+  OSQPInt*  next;
+  OSQPCscMatrix* C;
+
+  nnz  = M->p[M->n];
+  C    = csc_spalloc(M->m, M->n, c_max(nnz, 1), 1, 0);
+  rowp = c_calloc(M->m + 1, sizeof(OSQPInt));
+  rowj = c_malloc(c_max(nnz, 1) * sizeof(OSQPInt));
+  rowk = c_malloc(c_max(nnz, 1) * sizeof(OSQPInt));
+  next = c_calloc(M->n + 1, sizeof(OSQPInt));
+  if (!C || !rowp || !rowj || !rowk || !next) {
+    csc_spfree(C);
+    C = OSQP_NULL;
+    goto done;
+  }
+
+  /* Bucket the entries by row of C... */
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      i = rinv[M->i[k]];
+      if (upper) i = c_min(i, cinv[j]);
+      rowp[i+1]++;
+    }
+  }
+  for (i = 0; i < M->m; i++) rowp[i+1] += rowp[i];
+  for (j = 0; j < M->n; j++) {
+    for (k = M->p[j]; k < M->p[j+1]; k++) {
+      i = rinv[M->i[k]];
+      q = cinv[j];
+      if (upper && i > q) {
+        t = i;
+        i = q;
+        q = t;
+      }
+      rowj[rowp[i]]   = q;
+      rowk[rowp[i]++] = k;
+    }
+  }
+  for (i = M->m; i > 0; i--) rowp[i] = rowp[i-1];
+  rowp[0] = 0;
+
+  /* ...then by column of C, visiting the rows in order */
+  for (t = 0; t < nnz; t++) next[rowj[t]+1]++;
+  for (j = 0; j < M->n; j++) next[j+1] += next[j];
+  for (j = 0; j <= M->n; j++) C->p[j] = next[j];
+  for (i = 0; i < M->m; i++) {
+    for (t = rowp[i]; t < rowp[i+1]; t++) {
+      q = next[rowj[t]]++;
+      C->i[q] = i;
+      C->x[q] = M->x[rowk[t]];
+      map[rowk[t]] = q;
+    }
+  }
+
+done:
+  c_free(rowp);
+  c_free(rowj);
+  c_free(rowk);
+  c_free(next);
+  return C;
+}
+
+/*
+ * Reverse Cuthill-McKee ordering of the graph of the KKT matrix, whose node
+ * j < n is variable j and node n + i constraint i, split into the orderings
+ * of the variables and of the constraints.
+ */
+static OSQPInt rcm_split(const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         OSQPInt*             xperm,
+                         OSQPInt*             yperm) {
+
+  OSQPInt i, j, k, v;
+  OSQPInt status = 1;
+  OSQPInt n = A->n;
+  OSQPInt m = A->m;
+  OSQPInt N = n + m;
+
+  OSQPInt* adjp  = c_calloc(N + 1, sizeof(OSQPInt));
+  OSQPInt* next  = c_malloc(N * sizeof(OSQPInt));
+  OSQPInt* order = c_malloc(N * sizeof(OSQPInt));
+  OSQPInt* mark  = c_malloc(N * sizeof(OSQPInt));
+  OSQPInt* adj   = OSQP_NULL;
+
+  if (!adjp || !next || !order || !mark) goto done;
+
+  for (j = 0; j < n; j++) {
+    for (k = P->p[j]; k < P->p[j+1]; k++) {
+      if (P->i[k] == j) continue;
+      adjp[P->i[k]+1]++;
+      adjp[j+1]++;
+    }
+    for (k = A->p[j]; k < A->p[j+1]; k++) {
+      adjp[n + A->i[k] + 1]++;
+      adjp[j+1]++;
+    }
+  }
+  for (v = 0; v < N; v++) adjp[v+1] += adjp[v];
+
+  adj = c_malloc(c_max(adjp[N], 1) * sizeof(OSQPInt));
+  if (!adj) goto done;
+
+  for (v = 0; v < N; v++) next[v] = adjp[v];
+  for (j = 0; j < n; j++) {
+    for (k = P->p[j]; k < P->p[j+1]; k++) {
+      i = P->i[k];
+      if (i == j) continue;
+      adj[next[i]++] = j;
+      adj[next[j]++] = i;
+    }
+    for (k = A->p[j]; k < A->p[j+1]; k++) {
+      i = n + A->i[k];
+      adj[next[i]++] = j;
+      adj[next[j]++] = i;
+    }
+  }
+
+  rcm_order(adjp, adj, N, order, mark, next);
+
+  for (k = 0, i = 0, j = 0; k < N; k++) {
+    v = order[k];
+    if (v < n) xperm[i++] = v;
+    else       yperm[j++] = v - n;
+  }
+  status = 0;
+
+done:
+  c_free(adjp);
+  c_free(adj);
+  c_free(next);
+  c_free(order);
+  c_free(mark);
+  return status;
+}
+
+/*
+ * Type of constraint i as set_rho_vec determines it: 1 for an equality, 0 for
+ * an inequality and -1 for a loose constraint.
+ */
+static OSQPInt bound_type(OSQPFloat l,
+                           OSQPFloat u) {
+  OSQPFloat infval = OSQP_INFTY * OSQP_MIN_SCALING;
+
+  if (l < -infval && u > infval) return -1;
+  if (u - l < OSQP_RHO_TOL)      return 1;
+  return 0;
+}
+
+/*
+ * Stable partition of the constraint ordering into equalities, inequalities
+ * and loose constraints. The types are those of the unscaled bounds, so the
+ * scaled ones can disagree near the tolerances; reorder_check_segments()
+ * catches that.
+ */
+static void group_by_type(OSQPReorder*     r,
+                          const OSQPFloat* l,
+                          const OSQPFloat* u,
+                          OSQPInt*         work) {
+
+  OSQPInt i, t, pos[3];
+  OSQPInt count[3] = {0, 0, 0};
+
+  for (i = 0; i < r->m; i++) count[1 - bound_type(l[i], u[i])]++;
+  pos[0] = 0;
+  pos[1] = count[0];
+  pos[2] = count[0] + count[1];
+
+  for (i = 0; i < r->m; i++) {
+    t = 1 - bound_type(l[r->yperm[i]], u[r->yperm[i]]);
+    work[pos[t]++] = r->yperm[i];
+  }
+  for (i = 0; i < r->m; i++) r->yperm[i] = work[i];
+
+  r->n_eq   = count[0];
+  r->n_ineq = count[1];
+}
+
+OSQPReorder* reorder_new(const OSQPCscMatrix* P,
+                         const OSQPCscMatrix* A,
+                         const OSQPFloat*     l,
+                         const OSQPFloat*     u,
+                         const OSQPSettings*  settings,
+                         OSQPCscMatrix**      Pr,
+                         OSQPCscMatrix**      Ar) {
+
+  OSQPInt  i, nnzP, nnzA;
+  OSQPInt* inv;
+  OSQPReorder* r;
+
+  OSQPInt n = A->n;
+  OSQPInt m = A->m;
+
+  *Pr = OSQP_NULL;
+  *Ar = OSQP_NULL;
+
+  nnzP = P->p[n];
+  nnzA = A->p[n];
+
+  r = c_calloc(1, sizeof(OSQPReorder));
+  if (!r) return OSQP_NULL;
+  r->n     = n;
+  r->m     = m;
+  r->nnzP  = nnzP;
+  r->nnzA  = nnzA;
+  r->xperm = c_malloc(n * sizeof(OSQPInt));
+  r->yperm = c_malloc(c_max(m, 1) * sizeof(OSQPInt));
+  r->Pmap  = c_malloc(c_max(nnzP, 1) * sizeof(OSQPInt));
+  r->Amap  = c_malloc(c_max(nnzA, 1) * sizeof(OSQPInt));
+  r->iwork = c_malloc(c_max(c_max(nnzP + nnzA, m), 1) * sizeof(OSQPInt));
+  r->fwork = c_malloc(c_max(n + 2*m, nnzP + nnzA) * sizeof(OSQPFloat));
+  inv      = c_malloc((n + m) * sizeof(OSQPInt));
+
+  if (!r->xperm || !r->yperm || !r->Pmap || !r->Amap || !r->iwork || !r->fwork || !inv)
+    goto fail;
+
+  if (settings->reorder == OSQP_RCM_REORDER) {
+    if (rcm_split(P, A, r->xperm, r->yperm)) goto fail;
+  }
+  else {
+    for (i = 0; i < n; i++) r->xperm[i] = i;
+    for (i = 0; i < m; i++) r->yperm[i] = i;
+  }
+
+  if (settings->group_constraints && settings->rho_is_vec) {
+    group_by_type(r, l, u, r->iwork);
+    r->grouped = 1;
+  }
+
+  /* Inverse orderings of the variables and of the constraints */
+  for (i = 0; i < n; i++) inv[r->xperm[i]] = i;
+  for (i = 0; i < m; i++) inv[n + r->yperm[i]] = i;
+
+  *Pr = permute_csc(P, inv, inv, 1, r->Pmap);
+  *Ar = permute_csc(A, inv + n, inv, 0, r->Amap);
+  if (!(*Pr) || !(*Ar)) goto fail;
+
+  c_free(inv);
+  return r;
+
+fail:
+  csc_spfree(*Pr);
+  csc_spfree(*Ar);
+  *Pr = OSQP_NULL;
+  *Ar = OSQP_NULL;
+  c_free(inv);
+  reorder_free(r);
+  return OSQP_NULL;
+}
+
+OSQPInt reorder_check_segments(OSQPReorder*       r,
+                               const OSQPVectori* constr_type) {
+
+  OSQPInt i;
+  OSQPInt* type = r->iwork;
+
+  OSQPVectori_to_raw(type, constr_type);
+
+  for (i = 0; i < r->n_eq; i++) {
+    if (type[i] != 1) return 0;
+  }
+  for (; i < r->n_eq + r->n_ineq; i++) {
+    if (type[i] != 0) return 0;
+  }
+  for (; i < r->m; i++) {
+    if (type[i] != -1) return 0;
+  }
+  return 1;
+}
+
+void reorder_free(OSQPReorder* r) {
+  OSQPInt i;
+
+  if (r) {
+    for (i = 0; i < 4; i++) OSQPVectorf_view_free(r->view[i]);
+    c_free(r->xperm);
+    c_free(r->yperm);
+    c_free(r->Pmap);
+    c_free(r->Amap);
+    c_free(r->iwork);
+    c_free(r->fwork);
+    c_free(r);
+  }
+}
+
+void reorder_data_vec(OSQPReorder*      r,
+                      const OSQPFloat** q,
+                      const OSQPFloat** l,
+                      const OSQPFloat** u) {
+
+  OSQPInt i;
+  OSQPInt n = r->n;
+  OSQPInt m = r->m;
+
+  OSQPFloat* qr = r->fwork;
+  OSQPFloat* lr = r->fwork + n;
+  OSQPFloat* ur = r->fwork + n + m;
+
+  if (q && *q) {
+    for (i = 0; i < n; i++) qr[i] = (*q)[r->xperm[i]];
+    *q = qr;
+  }
+  if (l && *l) {
+    for (i = 0; i < m; i++) lr[i] = (*l)[r->yperm[i]];
+    *l = lr;
+  }
+  if (u && *u) {
+    for (i = 0; i < m; i++) ur[i] = (*u)[r->yperm[i]];
+    *u = ur;
+  }
+}
+
+void reorder_data_mat(OSQPReorder*      r,
+                      const OSQPFloat** Px,
+                      const OSQPInt**   Px_idx,
+                      OSQPInt           P_n,
+                      const OSQPFloat** Ax,
+                      const OSQPInt**   Ax_idx,
+                      OSQPInt           A_n) {
+
+  OSQPInt k;
+
+  OSQPInt*   Pi = r->iwork;
+  OSQPInt*   Ai = r->iwork + r->nnzP;
+  OSQPFloat* Pv = r->fwork;
+  OSQPFloat* Av = r->fwork + r->nnzP;
+
+  if (*Px_idx) {
+    for (k = 0; k < P_n; k++) Pi[k] = r->Pmap[(*Px_idx)[k]];
+    *Px_idx = Pi;
+  }
+  else if (*Px && P_n) {
+    for (k = 0; k < P_n; k++) Pv[r->Pmap[k]] = (*Px)[k];
+    *Px = Pv;
+  }
+
+  if (*Ax_idx) {
+    for (k = 0; k < A_n; k++) Ai[k] = r->Amap[(*Ax_idx)[k]];
+    *Ax_idx = Ai;
+  }
+  else if (*Ax && A_n) {
+    for (k = 0; k < A_n; k++) Av[r->Amap[k]] = (*Ax)[k];
+    *Ax = Av;
+  }
+}
+
+/* v = v(perm^-1), in place */
+static void scatter(OSQPFloat*     v,
+                    const OSQPInt* perm,
+                    OSQPInt        len,
+                    OSQPFloat*     work) {
+  OSQPInt i;
+
+  for (i = 0; i < len; i++) work[perm[i]] = v[i];
+  for (i = 0; i < len; i++) v[i] = work[i];
+}
+
+void reorder_solution(OSQPReorder*  r,
+                      OSQPSolution* solution) {
+
+  scatter(solution->x, r->xperm, r->n, r->fwork);
+  scatter(solution->dual_inf_cert, r->xperm, r->n, r->fwork);
+  if (r->m) {
+    scatter(solution->y, r->yperm, r->m, r->fwork);
+    scatter(solution->prim_inf_cert, r->yperm, r->m, r->fwork);
+  }
+}
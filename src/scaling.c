@@ -16,6 +16,20 @@ void limit_scaling_vector(OSQPVectorf* v) {
   OSQPVectorf_set_scalar_if_gt(v,v,OSQP_MAX_SCALING,OSQP_MAX_SCALING);
 }
 
+#ifndef OSQP_EMBEDDED_MODE
+
+// Free the temporary scaling vectors
+static void free_scaling_temp(OSQPWorkspace* work) {
+  OSQPVectorf_free(work->D_temp);
+  OSQPVectorf_free(work->D_temp_A);
+  OSQPVectorf_free(work->E_temp);
+  work->D_temp   = OSQP_NULL;
+  work->D_temp_A = OSQP_NULL;
+  work->E_temp   = OSQP_NULL;
+}
+
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
 /**
  * Compute infinite norm of the columns of the KKT matrix without forming it
  *
@@ -69,6 +83,19 @@ OSQPInt scale_data(OSQPSolver* solver) {
   n = work->data->n;
   m = work->data->m;
 
+#ifndef OSQP_EMBEDDED_MODE
+  // In lean mode the temporary vectors only exist while scaling
+  if (settings->lean_memory) {
+    work->D_temp   = OSQPVectorf_malloc(n);
+    work->D_temp_A = OSQPVectorf_malloc(n);
+    work->E_temp   = OSQPVectorf_malloc(m);
+    if (!(work->D_temp) || !(work->D_temp_A) || !(work->E_temp)) {
+      free_scaling_temp(work);
+      return OSQP_MEM_ALLOC_ERROR;
+    }
+  }
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   // Initialize scaling to 1
   work->scaling->c = 1.0;
   OSQPVectorf_set_scalar(work->scaling->D,    1.);
@@ -162,6 +189,10 @@ OSQPInt scale_data(OSQPSolver* solver) {
   OSQPVectorf_ew_prod(work->data->l, work->data->l, work->scaling->E);
   OSQPVectorf_ew_prod(work->data->u, work->data->u, work->scaling->E);
 
+#ifndef OSQP_EMBEDDED_MODE
+  if (settings->lean_memory) free_scaling_temp(work);
+#endif /* ifndef OSQP_EMBEDDED_MODE */
+
   return 0;
 }
 
@@ -199,12 +230,14 @@ OSQPInt unscale_solution(OSQPVectorf*       usolx,
                          const OSQPVectorf* soly,
                          OSQPWorkspace*     work) {
 
+  OSQPVectorf_expr e;
+
   // primal
   OSQPVectorf_ew_prod(usolx,solx,work->scaling->D);
 
   // dual
-  OSQPVectorf_ew_prod(usoly,soly,work->scaling->E);
-
-  OSQPVectorf_mult_scalar(usoly,work->scaling->cinv);
+  OSQPVectorf_expr_init(&e);
+  OSQPVectorf_expr_add_prod(&e, work->scaling->cinv, soly, work->scaling->E);
+  OSQPVectorf_eval(usoly, &e);
   return 0;
 }
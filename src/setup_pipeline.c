@@ -0,0 +1,142 @@
+#include "setup_pipeline.h"
+#include "error.h"
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+# include "memory_placement.h"
+#endif
+
+
+static void run_stage(OSQPSetupPipeline* pl,
+                      OSQPInt            k) {
+
+  switch (k) {
+  case SETUP_STAGE_ANALYSE_KKT:
+    pl->status[k] = osqp_algebra_analyse_linsys(&pl->analysis, pl->P, pl->A, &pl->settings);
+    break;
+  case SETUP_STAGE_COMPRESS_P:
+    pl->status[k] = OSQPMatrix_compress_indices(pl->P) ? OSQP_MEM_ALLOC_ERROR : 0;
+    break;
+  case SETUP_STAGE_COMPRESS_A:
+    pl->status[k] = OSQPMatrix_compress_indices(pl->A) ? OSQP_MEM_ALLOC_ERROR : 0;
+    break;
+  }
+}
+
+// Take the stages in order until none is left
+static void run_stages(OSQPSetupPipeline* pl) {
+
+  OSQPInt k;
+
+  for (;;) {
+    pthread_mutex_lock(&pl->lock);
+    while (pl->next < SETUP_STAGES && !pl->run[pl->next]) pl->next++;
+    k = pl->next < SETUP_STAGES ? pl->next++ : -1;
+    pthread_mutex_unlock(&pl->lock);
+
+    if (k < 0) return;
+    run_stage(pl, k);
+  }
+}
+
+static void* stage_thread(void* arg) {
+
+  OSQPSetupPipeline* pl = (OSQPSetupPipeline*)arg;
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  // The placement policy is per thread: place the analysis like the buffers of the setup
+  osqp_placement_begin((int)pl->settings.huge_pages, (int)pl->settings.numa_node,
+                       pl->settings.realtime != 0, (int)pl->settings.lock_memory);
+#endif
+
+  run_stages(pl);
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+  if (osqp_placement_end()) {
+    pthread_mutex_lock(&pl->lock);
+    pl->unlocked = 1;
+    pthread_mutex_unlock(&pl->lock);
+  }
+#endif
+  return OSQP_NULL;
+}
+
+// Join the helper threads; the stages no thread has taken are left out
+static void join_threads(OSQPSetupPipeline* pl) {
+
+  OSQPInt i;
+
+  if (pl->finished) return;
+
+  pthread_mutex_lock(&pl->lock);
+  pl->next = SETUP_STAGES;
+  pthread_mutex_unlock(&pl->lock);
+
+  for (i = 0; i < pl->nthreads; i++) pthread_join(pl->threads[i], OSQP_NULL);
+  pl->finished = 1;
+}
+
+OSQPInt setup_pipeline_start(OSQPSetupPipeline**  plp,
+                             OSQPWorkspace*       work,
+                             const OSQPSettings*  settings) {
+
+  OSQPInt            i, nstages;
+  OSQPSetupPipeline* pl = c_calloc(1, sizeof(OSQPSetupPipeline));
+
+  *plp = OSQP_NULL;
+  if (!pl) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  pl->P        = work->data->P;
+  pl->A        = work->data->A;
+  pl->settings = *settings;
+
+  pl->run[SETUP_STAGE_ANALYSE_KKT] = 1;
+  pl->run[SETUP_STAGE_COMPRESS_P]  = settings->compress_indices;
+  pl->run[SETUP_STAGE_COMPRESS_A]  = settings->compress_indices;
+
+  nstages = 0;
+  for (i = 0; i < SETUP_STAGES; i++) nstages += pl->run[i];
+
+  pl->threads = c_malloc(c_min(settings->setup_threads - 1, nstages) * sizeof(pthread_t));
+  if (!pl->threads || pthread_mutex_init(&pl->lock, OSQP_NULL)) {
+    c_free(pl->threads);
+    c_free(pl);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // No more threads than stages; the calling thread takes the stages left
+  for (i = 0; i < c_min(settings->setup_threads - 1, nstages); i++) {
+    if (pthread_create(&pl->threads[i], OSQP_NULL, &stage_thread, pl)) break;
+    pl->nthreads++;
+  }
+
+  *plp = pl;
+  return 0;
+}
+
+OSQPInt setup_pipeline_finish(OSQPSetupPipeline* pl,
+                              LinSysAnalysis**   analysis) {
+
+  OSQPInt k;
+
+  run_stages(pl);
+  join_threads(pl);
+
+  // Without the analysis the KKT matrix is analysed when it is factored
+  *analysis = pl->analysis;
+
+  for (k = SETUP_STAGE_COMPRESS_P; k < SETUP_STAGES; k++) {
+    if (pl->status[k]) return osqp_error(pl->status[k]);
+  }
+  return 0;
+}
+
+void setup_pipeline_free(OSQPSetupPipeline* pl) {
+
+  if (!pl) return;
+
+  join_threads(pl);
+  pthread_mutex_destroy(&pl->lock);
+  osqp_algebra_free_linsys_analysis(pl->analysis);
+  c_free(pl->threads);
+  c_free(pl);
+}
@@ -89,7 +89,17 @@ void print_setup_header(const OSQPSolver* solver) {
   c_print("variables n = %i, constraints m = %i\n          ",
                                     (int)data->n,
           (int)data->m);
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->matrix_free)
+    c_print("P and A given as operators\n");
+  else
+#endif
   c_print("nnz(P) + nnz(A) = %i\n", (int)nnz);
+#ifndef OSQP_EMBEDDED_MODE
+  if (work->elim)
+    c_print("          %i equalities eliminated from n = %i, m = %i\n",
+            (int)work->elim->n_eq, (int)work->elim->n, (int)work->elim->m);
+#endif
 
   // Print Settings
   c_print("settings: ");
@@ -164,6 +174,16 @@ void print_setup_header(const OSQPSolver* solver) {
     c_print("polishing: off, ");
   }
 
+  if (settings->reorder == OSQP_RCM_REORDER) {
+    c_print("\n          reordering: rcm");
+    if (settings->group_constraints && settings->rho_is_vec) {
+      c_print(", constraints grouped by type");
+    }
+  }
+  else if (settings->group_constraints && settings->rho_is_vec) {
+    c_print("\n          reordering: constraints grouped by type");
+  }
+
   c_print("\n");
 }
 
@@ -305,6 +325,33 @@ OSQPSettings* copy_settings(const OSQPSettings *settings) {
 
   new->delta              = settings->delta;
   new->polish_refine_iter = settings->polish_refine_iter;
+  new->polish_in_place    = settings->polish_in_place;
+
+  new->lean_memory = settings->lean_memory;
+  new->huge_pages  = settings->huge_pages;
+  new->numa_node   = settings->numa_node;
+
+  new->realtime    = settings->realtime;
+  new->lock_memory = settings->lock_memory;
+
+  new->reorder           = settings->reorder;
+  new->group_constraints = settings->group_constraints;
+
+  new->compress_indices = settings->compress_indices;
+
+  new->eliminate_equalities = settings->eliminate_equalities;
+
+  new->stall_checks = settings->stall_checks;
+  new->best_iterate = settings->best_iterate;
+
+  new->supernodal = settings->supernodal;
+
+  new->async_termination = settings->async_termination;
+  new->setup_threads = settings->setup_threads;
+
+  new->adaptive_rho_cost_model = settings->adaptive_rho_cost_model;
+
+  new->linsys_library = settings->linsys_library;
 
   return new;
 }
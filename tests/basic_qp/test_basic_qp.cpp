@@ -1,11 +1,30 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include "osqp_api.h"    /* OSQP API wrapper (public + some private) */
 #include "osqp_tester.h" /* Tester helpers */
 #include "test_utils.h"  /* Testing Helper functions */
 
 #include "basic_qp_data.h"
 
+#ifdef OSQP_ENABLE_PROFILING
+# include "auxil.h"
+#endif
+
+#ifdef OSQP_ENABLE_OUT_OF_CORE
+# include <cstdlib>
+# include <unistd.h>
+#endif
+
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+# include <cstdint>
+# include <unistd.h>
+# include "memory_placement.h"
+#endif
+
 
 TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve", "[solve][qp]")
 {
@@ -17,7 +36,7 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve", "[solve][qp]")
   settings->warm_starting = 0;
 
   /* Test all possible linear system solvers in this test case */
-  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
+  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER, OSQP_HYBRID_SOLVER})));
 
   CAPTURE(settings->linsys_solver);
 
@@ -54,6 +73,100 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve", "[solve][qp]")
       TESTS_TOL);
 }
 
+#ifdef OSQP_ENABLE_MEMORY_PLACEMENT
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Memory placement", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  SECTION("Placed allocations") {
+    const size_t    huge  = OSQP_PLACEMENT_HUGE_PAGE_SIZE + 7;
+    const size_t    large = 3 * OSQP_PLACEMENT_MIN_SIZE + 7;
+    const size_t    small = OSQP_PLACEMENT_MIN_SIZE / 2;
+    const uintptr_t page  = (uintptr_t)sysconf(_SC_PAGESIZE);
+
+    char* buf;
+    char* large_buf;
+    char* small_buf;
+
+    // Only buffers of a huge page or more start on a huge page; all placed
+    // buffers are zero-filled
+    osqp_placement_begin(1, -1, 0, 0);
+    buf       = (char*)osqp_placed_calloc(huge, 1);
+    large_buf = (char*)osqp_placed_malloc(large);
+    small_buf = (char*)osqp_placed_malloc(small);
+    mu_assert("Basic QP test placement: Allocation error!", buf != nullptr);
+    mu_assert("Basic QP test placement: Allocation error!", large_buf != nullptr);
+    mu_assert("Basic QP test placement: Allocation error!", small_buf != nullptr);
+    mu_assert("Basic QP test placement: Huge buffer not aligned to a huge page!",
+              (uintptr_t)buf % OSQP_PLACEMENT_HUGE_PAGE_SIZE == 0);
+    mu_assert("Basic QP test placement: Large buffer not aligned to a page!",
+              (uintptr_t)large_buf % page == 0);
+    mu_assert("Basic QP test placement: Huge buffer not zeroed!",
+              (buf[0] == 0 && buf[huge - 1] == 0));
+    mu_assert("Basic QP test placement: Large buffer not zeroed!",
+              (large_buf[0] == 0 && large_buf[large - 1] == 0));
+
+    // Resizing a placed buffer keeps its contents
+    large_buf[0]         = 1;
+    large_buf[large - 1] = 2;
+    large_buf = (char*)osqp_placed_realloc(large_buf, huge);
+    mu_assert("Basic QP test placement: Reallocation error!", large_buf != nullptr);
+    mu_assert("Basic QP test placement: Contents lost in reallocation!",
+              (large_buf[0] == 1 && large_buf[large - 1] == 2));
+    mu_assert("Basic QP test placement: Error in placement status!",
+              osqp_placement_end() == 0);
+    osqp_placed_free(buf);
+    osqp_placed_free(large_buf);
+    osqp_placed_free(small_buf);
+
+    // Bound to a NUMA node, on whole pages
+    osqp_placement_begin(0, 0, 0, 0);
+    buf = (char*)osqp_placed_malloc(large);
+    mu_assert("Basic QP test placement: Allocation error!", buf != nullptr);
+    mu_assert("Basic QP test placement: Large buffer not aligned to a page!",
+              (uintptr_t)buf % page == 0);
+    mu_assert("Basic QP test placement: Error in placement status!",
+              osqp_placement_end() == 0);
+    osqp_placed_free(buf);
+
+    // Locked buffers get pages of their own, however small
+    osqp_placement_begin(0, -1, 0, 1);
+    small_buf = (char*)osqp_placed_malloc(small);
+    mu_assert("Basic QP test placement: Allocation error!", small_buf != nullptr);
+    mu_assert("Basic QP test placement: Locked buffer not aligned to a page!",
+              (uintptr_t)small_buf % page == 0);
+    osqp_placement_end();
+    osqp_placed_free(small_buf);
+
+    // Memory from the standard library is released as usual
+    osqp_placed_free(malloc(small));
+    osqp_placed_free(nullptr);
+  }
+
+  SECTION("Solve") {
+    settings->verbose    = 0;
+    settings->huge_pages = 1;
+    settings->numa_node  = 0;
+
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test placement: Setup error!", exitflag == 0);
+
+    osqp_solve(solver.get());
+
+    // Placement must not change the result
+    mu_assert("Basic QP test placement: Error in solver status!",
+              solver->info->status_val == sols_data->status_test);
+    mu_assert("Basic QP test placement: Error in primal solution!",
+              vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+    mu_assert("Basic QP test placement: Error in dual solution!",
+              vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+  }
+}
+#endif /* ifdef OSQP_ENABLE_MEMORY_PLACEMENT */
+
 TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Settings", "[solve][qp]")
 {
   OSQPInt        exitflag;
@@ -881,6 +994,128 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Time limit", "[solve][qp]")
 #endif // OSQP_ENABLE_PROFILING
 
 
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Stall detection", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  // Tolerances below the accuracy of the iterates, so the residuals stop decreasing
+  settings->eps_abs      = 1e-15;
+  settings->eps_rel      = 1e-15;
+  settings->max_iter     = 100000;
+  settings->stall_checks = 5;
+
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test stall detection: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test stall detection: Error in solver status!",
+            solver->info->status_val == OSQP_STALLED);
+  mu_assert("Basic QP test stall detection: Stall not detected before max_iter!",
+            solver->info->iter < settings->max_iter);
+  mu_assert("Basic QP test stall detection: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test stall detection: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+
+  // The last iterate against the best one over the same iterations
+  settings->stall_checks      = 0;
+  settings->max_iter          = 203;
+  settings->check_termination = 10;
+
+  setup_with_reference(refSolver, solver, *data, settings.get(),
+                       [](OSQPSettings* s) { s->best_iterate = 1; });
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  // The best iterate can meet the tolerances for an inaccurate solution
+  mu_assert("Basic QP test stall detection: Error in best iterate status!",
+            ((solver->info->status_val == OSQP_MAX_ITER_REACHED) ||
+             (solver->info->status_val == OSQP_SOLVED_INACCURATE)));
+  mu_assert("Basic QP test stall detection: Error in number of iterations!",
+            solver->info->iter == refSolver->info->iter);
+  mu_assert("Basic QP test stall detection: Best iterate has larger residuals!",
+            ((solver->info->prim_res <= refSolver->info->prim_res) ||
+             (solver->info->dual_res <= refSolver->info->dual_res)));
+
+  // The copies of the best iterate are only allocated during setup
+  settings->best_iterate = 1;
+  exitflag = osqp_update_settings(refSolver.get(), settings.get());
+  mu_assert("Basic QP test stall detection: Late best_iterate not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+
+  settings->stall_checks = -1;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Basic QP test stall detection: Invalid setting not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Polish in place", "[solve][qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt iter;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->polishing     = 1;
+  settings->warm_starting = 0;
+
+  /* Real-time mode polishes in place without the setting */
+  OSQPInt realtime;
+  std::tie( settings->lean_memory, realtime ) =
+      GENERATE( table<OSQPInt, OSQPInt>(
+          { std::make_tuple( 0, 0 ),
+            std::make_tuple( 1, 0 ),
+            std::make_tuple( 0, 1 ) } ) );
+
+  CAPTURE(settings->lean_memory, realtime);
+
+  // Reference polished with a reduced system built on each polish
+  compare_with_reference(refSolver, solver, *data, settings.get(),
+                         [=](OSQPSettings* s) {
+                           s->polish_in_place = !realtime;
+                           s->realtime        = realtime;
+                         });
+
+  mu_assert("Basic QP test polish in place: Reduced system kept!",
+            solver->work->pol->Ared == OSQP_NULL);
+
+  mu_assert("Basic QP test polish in place: Error in polish status!",
+            solver->info->status_polish == OSQP_POLISH_SUCCESS);
+  mu_assert("Basic QP test polish in place: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test polish in place: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+  mu_assert("Basic QP test polish in place: Error in objective value!",
+            c_absval(solver->info->obj_val - sols_data->obj_value_test) < TESTS_TOL);
+
+  // The ADMM factorization is left untouched by polishing
+  iter = solver->info->iter;
+  osqp_solve(solver.get());
+  mu_assert("Basic QP test polish in place: Error in number of iterations after polishing!",
+            solver->info->iter == iter);
+  mu_assert("Basic QP test polish in place: Error in second polish status!",
+            solver->info->status_polish == OSQP_POLISH_SUCCESS);
+
+  // Refactoring for a new rho starts from the ADMM values of the KKT matrix
+  exitflag = osqp_update_rho(refSolver.get(), 0.5);
+  mu_assert("Basic QP test polish in place: Reference rho update error!", exitflag == 0);
+  exitflag = osqp_update_rho(solver.get(), 0.5);
+  mu_assert("Basic QP test polish in place: Rho update error!", exitflag == 0);
+
+  solve_and_compare(refSolver.get(), solver.get());
+  mu_assert("Basic QP test polish in place: Error in primal solution after a rho update!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+}
+
+
 TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Warm start", "[solve][qp][warm-start]")
 {
   OSQPInt exitflag;
@@ -930,3 +1165,1090 @@ TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Warm start", "[solve][qp][war
     mu_assert("Basic QP test warm start: Warm start error!", solver->info->iter == 1);
   }
 }
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Solve multiple right-hand sides", "[solve][qp][multi]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, j;
+
+  // Problems: original data, new linear cost, new bounds (n = 2, m = 4)
+  OSQPFloat q[6];
+  OSQPFloat l[12];
+  OSQPFloat u[12];
+  OSQPFloat x[6];
+  OSQPFloat y[12];
+  OSQPInfo  info[3];
+
+  for (i = 0; i < data->n; i++) {
+    q[i]               = data->q[i];
+    q[data->n + i]     = sols_data->q_new[i];
+    q[2 * data->n + i] = data->q[i];
+  }
+  for (i = 0; i < data->m; i++) {
+    l[i]               = data->l[i];
+    l[data->m + i]     = data->l[i];
+    l[2 * data->m + i] = sols_data->l_new[i];
+    u[i]               = data->u[i];
+    u[data->m + i]     = data->u[i];
+    u[2 * data->m + i] = sols_data->u_new[i];
+  }
+
+  // The problems share rho, so keep it scalar for the sequential solves to match
+  settings->polishing     = 0;
+  settings->warm_starting = 0;
+  settings->adaptive_rho  = 0;
+  settings->rho_is_vec    = 0;
+
+  // Setup solver
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+
+  // Setup correct
+  mu_assert("Basic QP test multi: Setup error!", exitflag == 0);
+
+  OSQPVectorf_ptr q_before{OSQPVectorf_copy_new(solver->work->data->q)};
+
+  // Solve all the problems at once
+  exitflag = osqp_solve_multi(solver.get(), 3, q, l, u, x, y, info);
+  mu_assert("Basic QP test multi: Solve error!", exitflag == 0);
+
+  // The solver data must be untouched
+  mu_assert("Basic QP test multi: Solver data modified!",
+            OSQPVectorf_norm_inf_diff(solver->work->data->q, q_before.get()) == 0.0);
+
+  // Compare with solving the problems one after the other
+  for (j = 0; j < 3; j++) {
+    CAPTURE(j);
+
+    exitflag = osqp_update_data_vec(solver.get(), q + j * data->n, l + j * data->m, u + j * data->m);
+    mu_assert("Basic QP test multi: Data update error!", exitflag == 0);
+    osqp_solve(solver.get());
+
+    mu_assert("Basic QP test multi: Error in solver status!",
+              info[j].status_val == solver->info->status_val);
+
+    mu_assert("Basic QP test multi: Error in number of iterations!",
+              info[j].iter == solver->info->iter);
+
+    mu_assert("Basic QP test multi: Error in primal solution!",
+              vec_norm_inf_diff(x + j * data->n, solver->solution->x, data->n) < TESTS_TOL);
+
+    mu_assert("Basic QP test multi: Error in dual solution!",
+              vec_norm_inf_diff(y + j * data->m, solver->solution->y, data->m) < TESTS_TOL);
+
+    mu_assert("Basic QP test multi: Error in objective value!",
+              c_absval(info[j].obj_val - solver->info->obj_val) < TESTS_TOL);
+  }
+
+  // Inconsistent bounds are rejected
+  l[2 * data->m] = u[2 * data->m] + 1.0;
+  mu_assert("Basic QP test multi: Inconsistent bounds not caught!",
+            osqp_solve_multi(solver.get(), 3, q, l, u, x, y, info) == OSQP_DATA_VALIDATION_ERROR);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Reorder", "[solve][qp][reorder]")
+{
+  OSQPInt i;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  OSQPFloat Px_new[3];
+  OSQPFloat Ax_new[1]     = {2.0};
+  OSQPInt   Ax_new_idx[1] = {1};
+  OSQPFloat u_infeas[4];
+
+  settings->polishing = GENERATE(0, 1);
+  CAPTURE(settings->polishing);
+
+  // Reference solver in the user ordering
+  setup_with_reference(refSolver, solver, *data, settings.get(),
+                       [](OSQPSettings* s) { s->reorder = OSQP_RCM_REORDER; });
+  mu_assert("Basic QP test reorder: Ordering not computed!", solver->work->reorder != OSQP_NULL);
+
+  // Every step must give the same result as in the user ordering
+  auto compare = [&](const char* step) {
+    CAPTURE(step);
+    solve_and_compare(refSolver.get(), solver.get());
+  };
+
+  compare("setup");
+
+  mu_assert("Basic QP test reorder: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test reorder: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+
+  // Vector updates
+  osqp_update_data_vec(refSolver.get(), sols_data->q_new, sols_data->l_new, sols_data->u_new);
+  osqp_update_data_vec(solver.get(), sols_data->q_new, sols_data->l_new, sols_data->u_new);
+  compare("vector update");
+
+  // Matrix updates, all of P and a single entry of A
+  for (i = 0; i < 3; i++) Px_new[i] = 2.0 * data->P->x[i];
+  osqp_update_data_mat(refSolver.get(), Px_new, OSQP_NULL, 3, Ax_new, Ax_new_idx, 1);
+  osqp_update_data_mat(solver.get(), Px_new, OSQP_NULL, 3, Ax_new, Ax_new_idx, 1);
+  compare("matrix update");
+
+  // Warm start
+  osqp_warm_start(refSolver.get(), sols_data->x_test, sols_data->y_test);
+  osqp_warm_start(solver.get(), sols_data->x_test, sols_data->y_test);
+  compare("warm start");
+
+  // x0 + x1 = 1 cannot hold with x0 <= 0.2 and x1 <= 0.2
+  for (i = 0; i < 4; i++) u_infeas[i] = sols_data->u_new[i];
+  u_infeas[1] = 0.2;
+  u_infeas[2] = 0.2;
+  osqp_update_data_vec(refSolver.get(), data->q, data->l, u_infeas);
+  osqp_update_data_vec(solver.get(), data->q, data->l, u_infeas);
+  compare("primal infeasibility");
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Group constraints", "[solve][qp][reorder]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  OSQPFloat x[2], x_ref[2];
+  OSQPFloat y[4], y_ref[4];
+
+  settings->reorder = GENERATE(OSQP_NO_REORDER, OSQP_RCM_REORDER);
+  CAPTURE(settings->reorder);
+
+  // Reference solver with interleaved constraints. The new bounds have the
+  // types [ineq, ineq, loose, eq], so grouping them moves the last row first.
+  OSQPTestProblem prob(data->P, sols_data->q_new, data->A, sols_data->l_new, sols_data->u_new,
+                       data->m, data->n);
+  setup_with_reference(refSolver, solver, prob, settings.get(),
+                       [](OSQPSettings* s) { s->group_constraints = 1; });
+  mu_assert("Basic QP test group constraints: Constraints not grouped!",
+            (solver->work->reorder && solver->work->reorder->grouped));
+  mu_assert("Basic QP test group constraints: Error in number of equalities!",
+            solver->work->reorder->n_eq == 1);
+  mu_assert("Basic QP test group constraints: Error in number of inequalities!",
+            solver->work->reorder->n_ineq == 2);
+
+  auto compare = [&](const char* step, OSQPInt segmented) {
+    CAPTURE(step);
+    mu_assert("Basic QP test group constraints: Error in segment layout!",
+              solver->work->reorder->segmented == segmented);
+    solve_and_compare(refSolver.get(), solver.get());
+  };
+
+  compare("setup", 1);
+
+  // The original bounds put the loose row before the others: element-wise fallback
+  osqp_update_data_vec(refSolver.get(), data->q, data->l, data->u);
+  osqp_update_data_vec(solver.get(), data->q, data->l, data->u);
+  compare("interleaved types", 0);
+
+  mu_assert("Basic QP test group constraints: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test group constraints: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+
+  // Back to the grouped types
+  osqp_update_data_vec(refSolver.get(), sols_data->q_new, sols_data->l_new, sols_data->u_new);
+  osqp_update_data_vec(solver.get(), sols_data->q_new, sols_data->l_new, sols_data->u_new);
+  compare("grouped types", 1);
+
+  // A block solve with bounds of other types than the grouped ones
+  exitflag = osqp_solve_multi(refSolver.get(), 1, data->q, data->l, data->u, x_ref, y_ref, OSQP_NULL);
+  mu_assert("Basic QP test group constraints: Reference multi-RHS solve error!", exitflag == 0);
+  exitflag = osqp_solve_multi(solver.get(), 1, data->q, data->l, data->u, x, y, OSQP_NULL);
+  mu_assert("Basic QP test group constraints: Multi-RHS solve error!", exitflag == 0);
+  mu_assert("Basic QP test group constraints: Error in multi-RHS primal solution!",
+            vec_norm_inf_diff(x, x_ref, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test group constraints: Error in multi-RHS dual solution!",
+            vec_norm_inf_diff(y, y_ref, data->m) < TESTS_TOL);
+  compare("after multi-RHS solve", 1);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Compressed indices", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  // The products are exact, so the iterations are the same
+  compare_with_reference(refSolver, solver, *data, settings.get(),
+                         [](OSQPSettings* s) { s->compress_indices = 1; });
+
+  mu_assert("Basic QP test compressed indices: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+  mu_assert("Basic QP test compressed indices: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test compressed indices: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+
+  tmpSolver = nullptr;
+  settings->compress_indices = 2;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test compressed indices: Invalid setting not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Eliminate equalities", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+  OSQPInt m_dim, n_dim;
+
+  OSQPSolver*    tmpRefSolver = nullptr;
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->eps_abs = 1e-7;
+  settings->eps_rel = 1e-7;
+
+  exitflag = osqp_setup(&tmpRefSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  refSolver.reset(tmpRefSolver);
+  mu_assert("Basic QP test eliminate equalities: Reference setup error!", exitflag == 0);
+
+  // Row 0 (x_0 + x_1 = 1) is removed with x_0
+  settings->eliminate_equalities = 1;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test eliminate equalities: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test eliminate equalities: Equality not eliminated!",
+            ((solver->work->data->n == n - 1) && (solver->work->data->m == m - 1)));
+
+  osqp_get_dimensions(solver.get(), &m_dim, &n_dim);
+  mu_assert("Basic QP test eliminate equalities: Error in dimensions!",
+            ((m_dim == m) && (n_dim == n)));
+
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test eliminate equalities: Error in solver status!",
+            solver->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test eliminate equalities: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, n) < TESTS_TOL);
+  mu_assert("Basic QP test eliminate equalities: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, m) < TESTS_TOL);
+  mu_assert("Basic QP test eliminate equalities: Error in objective value!",
+            c_absval(solver->info->obj_val - sols_data->obj_value_test) < TESTS_TOL);
+
+  // New q and a new right-hand side of the equality
+  std::vector<OSQPFloat> l(data->l, data->l + m), u(data->u, data->u + m);
+  l[0] = u[0] = 0.9;
+
+  exitflag = osqp_update_data_vec(refSolver.get(), sols_data->q_new, l.data(), u.data());
+  mu_assert("Basic QP test eliminate equalities: Reference update error!", exitflag == 0);
+  exitflag = osqp_update_data_vec(solver.get(), sols_data->q_new, l.data(), u.data());
+  mu_assert("Basic QP test eliminate equalities: Update error!", exitflag == 0);
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test eliminate equalities: Error in solver status after update!",
+            solver->info->status_val == refSolver->info->status_val);
+  mu_assert("Basic QP test eliminate equalities: Error in primal solution after update!",
+            vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+  mu_assert("Basic QP test eliminate equalities: Error in dual solution after update!",
+            vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+  mu_assert("Basic QP test eliminate equalities: Error in objective value after update!",
+            c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+
+  // x_0 + x_1 = 2 cannot hold with x_0, x_1 <= 0.7
+  l[0] = u[0] = 2.0;
+  exitflag = osqp_update_data_vec(solver.get(), OSQP_NULL, l.data(), u.data());
+  mu_assert("Basic QP test eliminate equalities: Infeasible update error!", exitflag == 0);
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test eliminate equalities: Infeasibility not detected!",
+            solver->info->status_val == OSQP_PRIMAL_INFEASIBLE);
+
+  // A'dy = 0 and u'dy_+ + l'dy_- < 0 over the rows of the user problem (row 3 has no bounds)
+  std::vector<OSQPFloat> Atdy(n, 0.0);
+  OSQPFloat* dy  = solver->solution->prim_inf_cert;
+  OSQPFloat  sup = 0.0;
+  for (OSQPInt j = 0; j < n; j++)
+    for (OSQPInt k = data->A->p[j]; k < data->A->p[j+1]; k++)
+      Atdy[j] += data->A->x[k] * dy[data->A->i[k]];
+  for (OSQPInt i = 0; i < 3; i++) sup += dy[i] > 0.0 ? dy[i] * u[i] : dy[i] * l[i];
+  mu_assert("Basic QP test eliminate equalities: Error in infeasibility certificate!",
+            ((vec_norm_inf(Atdy.data(), n) < TESTS_TOL) && (sup < 0.0)));
+
+  // The eliminated row has to stay an equality
+  exitflag = osqp_update_data_vec(solver.get(), OSQP_NULL, sols_data->l_new, sols_data->u_new);
+  mu_assert("Basic QP test eliminate equalities: Changed equality not caught!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+
+  exitflag = osqp_update_data_mat(solver.get(), data->P->x, OSQP_NULL, data->P->nzmax,
+                                  OSQP_NULL, OSQP_NULL, 0);
+  mu_assert("Basic QP test eliminate equalities: Matrix update not rejected!",
+            exitflag == OSQP_FUNC_NOT_IMPLEMENTED);
+
+  tmpSolver = nullptr;
+  settings->eliminate_equalities = 2;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test eliminate equalities: Invalid setting not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+/* Products of the basic QP matrices, as a user operator would compute them */
+static void csc_mult(void* data, const OSQPFloat* x, OSQPFloat* y)
+{
+  const OSQPCscMatrix* M = (const OSQPCscMatrix*)data;
+
+  for (OSQPInt i = 0; i < M->m; i++) y[i] = 0.0;
+  for (OSQPInt j = 0; j < M->n; j++)
+    for (OSQPInt k = M->p[j]; k < M->p[j+1]; k++)
+      y[M->i[k]] += M->x[k] * x[j];
+}
+
+static void csc_mult_trans(void* data, const OSQPFloat* x, OSQPFloat* y)
+{
+  const OSQPCscMatrix* M = (const OSQPCscMatrix*)data;
+
+  for (OSQPInt j = 0; j < M->n; j++) {
+    y[j] = 0.0;
+    for (OSQPInt k = M->p[j]; k < M->p[j+1]; k++)
+      y[j] += M->x[k] * x[M->i[k]];
+  }
+}
+
+/* Full symmetric product from the upper triangular part */
+static void csc_mult_sym_triu(void* data, const OSQPFloat* x, OSQPFloat* y)
+{
+  const OSQPCscMatrix* M = (const OSQPCscMatrix*)data;
+
+  for (OSQPInt i = 0; i < M->n; i++) y[i] = 0.0;
+  for (OSQPInt j = 0; j < M->n; j++) {
+    for (OSQPInt k = M->p[j]; k < M->p[j+1]; k++) {
+      y[M->i[k]] += M->x[k] * x[j];
+      if (M->i[k] != j) y[j] += M->x[k] * x[M->i[k]];
+    }
+  }
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Operators", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+
+  OSQPCscMatrix* P = data->P;
+  OSQPCscMatrix* A = data->A;
+
+  std::vector<OSQPFloat> P_col_norm(n, 0.0), P_diag(n, 0.0);
+  std::vector<OSQPFloat> A_col_norm(n, 0.0), A_row_norm(m, 0.0), AtA_diag(n, 0.0);
+
+  // Exact estimates of the norms and diagonals
+  for (OSQPInt j = 0; j < n; j++) {
+    for (OSQPInt k = P->p[j]; k < P->p[j+1]; k++) {
+      OSQPInt i = P->i[k];
+      P_col_norm[j] = c_max(P_col_norm[j], c_absval(P->x[k]));
+      P_col_norm[i] = c_max(P_col_norm[i], c_absval(P->x[k]));
+      if (i == j) P_diag[j] = P->x[k];
+    }
+    for (OSQPInt k = A->p[j]; k < A->p[j+1]; k++) {
+      A_col_norm[j]       = c_max(A_col_norm[j], c_absval(A->x[k]));
+      A_row_norm[A->i[k]] = c_max(A_row_norm[A->i[k]], c_absval(A->x[k]));
+      AtA_diag[j]        += A->x[k] * A->x[k];
+    }
+  }
+
+  OSQPOperator Pop = {n, n, P, csc_mult_sym_triu, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL};
+  OSQPOperator Aop = {m, n, A, csc_mult, csc_mult_trans, OSQP_NULL, OSQP_NULL, OSQP_NULL};
+
+  settings->polishing = 0;
+
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_OPERATORS)) {
+    exitflag = osqp_setup_operators(&tmpSolver, &Pop, data->q, &Aop,
+                                    data->l, data->u, m, n, settings.get());
+    mu_assert("Basic QP test operators: Missing capability not reported!",
+              exitflag == OSQP_FUNC_NOT_IMPLEMENTED);
+    return;
+  }
+
+  SECTION("Solve")
+  {
+    // Without estimates there is nothing to scale or precondition with
+    OSQPInt estimates = GENERATE(0, 1);
+
+    if (estimates) {
+      Pop.col_norm = Pop.row_norm = P_col_norm.data();
+      Pop.diag     = P_diag.data();
+      Aop.col_norm = A_col_norm.data();
+      Aop.row_norm = A_row_norm.data();
+      Aop.diag     = AtA_diag.data();
+    }
+    else {
+      settings->scaling = 0;
+    }
+
+    CAPTURE(estimates);
+
+    exitflag = osqp_setup_operators(&tmpSolver, &Pop, data->q, &Aop,
+                                    data->l, data->u, m, n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test operators: Setup error!", exitflag == 0);
+
+    osqp_solve(solver.get());
+
+    mu_assert("Basic QP test operators: Error in solver status!",
+              solver->info->status_val == sols_data->status_test);
+    mu_assert("Basic QP test operators: Error in primal solution!",
+              vec_norm_inf_diff(solver->solution->x, sols_data->x_test, n) < TESTS_TOL);
+    mu_assert("Basic QP test operators: Error in dual solution!",
+              vec_norm_inf_diff(solver->solution->y, sols_data->y_test, m) < TESTS_TOL);
+    mu_assert("Basic QP test operators: Error in objective value!",
+              c_absval(solver->info->obj_val - sols_data->obj_value_test) < TESTS_TOL);
+
+    // The matrices cannot be updated nor polished
+    exitflag = osqp_update_data_mat(solver.get(), OSQP_NULL, OSQP_NULL, 0,
+                                    OSQP_NULL, OSQP_NULL, 0);
+    mu_assert("Basic QP test operators: Matrix update not rejected!",
+              exitflag == OSQP_FUNC_NOT_IMPLEMENTED);
+
+    settings->polishing = 1;
+    exitflag = osqp_update_settings(solver.get(), settings.get());
+    mu_assert("Basic QP test operators: Polishing update not rejected!",
+              exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  SECTION("Invalid setup")
+  {
+    tmpSolver = nullptr;
+    settings->polishing = 1;
+    exitflag = osqp_setup_operators(&tmpSolver, &Pop, data->q, &Aop,
+                                    data->l, data->u, m, n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test operators: Polishing not rejected!",
+              exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+
+    tmpSolver = nullptr;
+    settings->polishing = 0;
+    Aop.mult_trans      = OSQP_NULL;
+    exitflag = osqp_setup_operators(&tmpSolver, &Pop, data->q, &Aop,
+                                    data->l, data->u, m, n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test operators: Missing product not rejected!",
+              exitflag == OSQP_DATA_VALIDATION_ERROR);
+  }
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Memory-mapped constraints", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+
+  OSQPOperator Pop = {n, n, data->P, csc_mult_sym_triu, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL};
+  OSQPOperator Aop;
+
+#ifndef OSQP_ENABLE_OUT_OF_CORE
+  exitflag = osqp_operator_map_file(&Aop, CODEGEN_DIR "basic_qp_A.csc", 0);
+  mu_assert("Basic QP test mapped constraints: Missing capability not reported!",
+            exitflag == OSQP_FUNC_NOT_IMPLEMENTED);
+#else
+  // A file of its own, since the testers can run in parallel, removed on
+  // every exit of the test including the failed assertions
+  char filename[] = CODEGEN_DIR "basic_qp_A_XXXXXX";
+  int  fd         = mkstemp(filename);
+  REQUIRE(fd != -1);
+  close(fd);
+
+  struct FileRemover {
+    const char* name;
+    ~FileRemover() { remove(name); }
+  } remover{filename};
+
+  exitflag = osqp_csc_write_file(data->A, filename);
+  mu_assert("Basic QP test mapped constraints: Write error!", exitflag == 0);
+
+  // A chunk of a single nonzero moves the read-ahead after every column
+  OSQPInt chunk_size = GENERATE(1, 0);
+  CAPTURE(chunk_size);
+
+  exitflag = osqp_operator_map_file(&Aop, filename, chunk_size);
+  mu_assert("Basic QP test mapped constraints: Map error!", exitflag == 0);
+
+  // The products match the ones of the matrix in memory
+  std::vector<OSQPFloat> x(n), y(m), y_ref(m), z(n), z_ref(n);
+  for (OSQPInt j = 0; j < n; j++) x[j] = 1.0 + j;
+  for (OSQPInt i = 0; i < m; i++) y[i] = 1.0 - i;
+
+  Aop.mult(Aop.data, x.data(), y_ref.data());
+  csc_mult(data->A, x.data(), y.data());
+  mu_assert("Basic QP test mapped constraints: Error in A*x!",
+            vec_norm_inf_diff(y.data(), y_ref.data(), m) < TESTS_TOL);
+
+  Aop.mult_trans(Aop.data, y.data(), z_ref.data());
+  csc_mult_trans(data->A, y.data(), z.data());
+  mu_assert("Basic QP test mapped constraints: Error in A'*y!",
+            vec_norm_inf_diff(z.data(), z_ref.data(), n) < TESTS_TOL);
+
+  settings->polishing = 0;
+  exitflag = osqp_setup_operators(&tmpSolver, &Pop, data->q, &Aop,
+                                  data->l, data->u, m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test mapped constraints: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test mapped constraints: Error in solver status!",
+            solver->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test mapped constraints: Error in primal solution!",
+            vec_norm_inf_diff(solver->solution->x, sols_data->x_test, n) < TESTS_TOL);
+  mu_assert("Basic QP test mapped constraints: Error in dual solution!",
+            vec_norm_inf_diff(solver->solution->y, sols_data->y_test, m) < TESTS_TOL);
+
+  solver.reset(nullptr);
+  osqp_operator_unmap_file(&Aop);
+
+  // Files that are not matrices of this build are rejected
+  mu_assert("Basic QP test mapped constraints: Missing file not caught!",
+            osqp_operator_map_file(&Aop, CODEGEN_DIR "missing.csc", 0) == OSQP_FOPEN_ERROR);
+
+  FILE* f = fopen(filename, "r+b");
+  REQUIRE(f != nullptr);
+  fputc('X', f);
+  fclose(f);
+  mu_assert("Basic QP test mapped constraints: Invalid file not caught!",
+            osqp_operator_map_file(&Aop, filename, 0) == OSQP_DATA_VALIDATION_ERROR);
+#endif
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Consensus", "[solve][qp][consensus]")
+{
+  OSQPInt exitflag;
+
+  OSQPInt n = data->n;
+  OSQPInt m = data->m;
+
+  OSQPConsensus* cons = OSQP_NULL;
+  OSQPInfo       info;
+
+  std::vector<OSQPFloat> x(n), y(m);
+
+  // The local solves are inexact, so they need tighter tolerances than the checks
+  settings->verbose  = 0;
+  settings->eps_abs  = 1e-7;
+  settings->eps_rel  = 1e-7;
+  settings->max_iter = 4000;
+
+  // Blocks of one row each, then the equality and the bounds
+  OSQPInt  one_row[]    = {0, 1, 2, 3, 4};
+  OSQPInt  two_blocks[] = {0, 1, 4};
+  OSQPInt  K            = GENERATE(1, 2, 3, 4);
+  OSQPInt* row_start    = K == 4 ? one_row : (K == 2 ? two_blocks : OSQP_NULL);
+  CAPTURE(K);
+
+  exitflag = osqp_consensus_setup(&cons, data->P, data->q, data->A, data->l, data->u,
+                                  m, n, K, row_start, settings.get());
+  mu_assert("Basic QP test consensus: Setup error!", exitflag == 0);
+
+  exitflag = osqp_consensus_solve(cons, x.data(), y.data(), &info);
+  mu_assert("Basic QP test consensus: Solve error!", exitflag == 0);
+
+  mu_assert("Basic QP test consensus: Error in solver status!",
+            info.status_val == sols_data->status_test);
+  mu_assert("Basic QP test consensus: Error in primal solution!",
+            vec_norm_inf_diff(x.data(), sols_data->x_test, n) < TESTS_TOL);
+  mu_assert("Basic QP test consensus: Error in dual solution!",
+            vec_norm_inf_diff(y.data(), sols_data->y_test, m) < TESTS_TOL);
+  mu_assert("Basic QP test consensus: Error in objective value!",
+            c_absval(info.obj_val - sols_data->obj_value_test) < TESTS_TOL);
+
+  // A second solve starts from the solution
+  OSQPInt iter = info.iter;
+  exitflag = osqp_consensus_solve(cons, x.data(), y.data(), &info);
+  mu_assert("Basic QP test consensus: Warm-started solve error!",
+            ((exitflag == 0) && (info.status_val == OSQP_SOLVED)));
+  mu_assert("Basic QP test consensus: Warm start not used!", ((K == 1) || (info.iter < iter)));
+
+  osqp_consensus_cleanup(cons);
+
+  // The blocks have to cover the rows in order
+  OSQPInt bad_start[] = {0, 3, 2, 4};
+  cons = OSQP_NULL;
+  exitflag = osqp_consensus_setup(&cons, data->P, data->q, data->A, data->l, data->u,
+                                  m, n, 3, bad_start, settings.get());
+  mu_assert("Basic QP test consensus: Unordered blocks not caught!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+  osqp_consensus_cleanup(cons);
+
+  exitflag = osqp_consensus_setup(&cons, data->P, data->q, data->A, data->l, data->u,
+                                  m, n, 0, OSQP_NULL, settings.get());
+  mu_assert("Basic QP test consensus: No blocks not caught!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+  osqp_consensus_cleanup(cons);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Asynchronous termination checks", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->verbose           = 0;
+  settings->check_termination = GENERATE(1, 5);
+  CAPTURE(settings->check_termination);
+
+  // The check of an iteration is collected one iteration later, but the solve
+  // returns the iterate that met the criteria
+  compare_with_reference(refSolver, solver, *data, settings.get(),
+                         [](OSQPSettings* s) { s->async_termination = 1; });
+
+  // The progress of the residuals follows the checks on the helper thread
+  settings->eps_abs      = 1e-15;
+  settings->eps_rel      = 1e-15;
+  settings->max_iter     = 100000;
+  settings->stall_checks = 5;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Basic QP test async termination: Update error!", exitflag == 0);
+
+  settings->async_termination = 0;
+  exitflag = osqp_update_settings(refSolver.get(), settings.get());
+  mu_assert("Basic QP test async termination: Reference update error!", exitflag == 0);
+
+  osqp_cold_start(refSolver.get());
+  osqp_cold_start(solver.get());
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  mu_assert("Basic QP test async termination: Error in stalled solver status!",
+            solver->info->status_val == refSolver->info->status_val);
+  mu_assert("Basic QP test async termination: Error in number of stalled iterations!",
+            solver->info->iter == refSolver->info->iter);
+
+#ifdef OSQP_ENABLE_THREADS
+  // The helper thread is only started during setup
+  settings->async_termination = 1;
+  exitflag = osqp_update_settings(refSolver.get(), settings.get());
+  mu_assert("Basic QP test async termination: Late async_termination not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+#endif
+
+  settings->async_termination = 2;
+  exitflag = osqp_update_settings(solver.get(), settings.get());
+  mu_assert("Basic QP test async termination: Invalid setting not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Setup pipeline", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->verbose          = 0;
+  settings->compress_indices = GENERATE(0, 1);
+  OSQPInt setup_threads      = GENERATE(2, 3, 4);
+
+  // The helper threads pre-fault and lock their allocations like the calling thread
+  std::tie( settings->realtime, settings->lock_memory ) =
+      GENERATE( table<OSQPInt, OSQPInt>(
+          { std::make_tuple( 0, 0 ),
+            std::make_tuple( 1, 0 ),
+            std::make_tuple( 1, 1 ) } ) );
+
+  CAPTURE(settings->compress_indices, setup_threads, settings->realtime, settings->lock_memory);
+
+  // The analysis of the KKT pattern on the helper threads gives the same factorization
+  compare_with_reference(refSolver, solver, *data, settings.get(),
+                         [=](OSQPSettings* s) { s->setup_threads = setup_threads; });
+
+  // The setup needs at least the calling thread
+  settings->setup_threads = 0;
+  tmpSolver = nullptr;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test setup pipeline: Invalid setting not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Automatic linear system solver", "[solve][qp]")
+{
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->verbose     = 0;
+  OSQPInt setup_threads = GENERATE(1, 2);
+  CAPTURE(setup_threads);
+
+  // Reference with the default solver of the algebra
+  setup_with_reference(refSolver, solver, *data, settings.get(),
+                       [=](OSQPSettings* s) {
+                         s->linsys_solver = OSQP_AUTO_SOLVER;
+                         s->setup_threads = setup_threads;
+                       });
+
+  // A problem this small takes the default solver, and the settings show it
+  mu_assert("Basic QP test auto linsys: Error in chosen solver!",
+            solver->settings->linsys_solver == refSolver->settings->linsys_solver);
+
+  solve_and_compare(refSolver.get(), solver.get());
+  mu_assert("Basic QP test auto linsys: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+}
+
+#ifdef OSQP_ENABLE_THREADS
+TEST_CASE_METHOD(OSQPTestFixture, "Basic QP: Automatic hybrid linear system solver", "[solve][qp]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, j, k;
+
+  // P with a few random entries per column: the KKT matrix is very sparse,
+  // but its factor fills in enough for the factorization to cost more than
+  // the thresholds of OSQP_AUTO_SOLVER
+  const OSQPInt n   = 8000;
+  const OSQPInt deg = 3;
+  const OSQPInt m   = n;
+
+  std::vector<OSQPInt>   Pp(n+1), Pi, Ap(n+1), Ai(n);
+  std::vector<OSQPFloat> Px, Ax(n, 1.0), q(n), l(m, -1.0), u(m, 1.0);
+  std::minstd_rand       gen(1);
+
+  for (j = 0; j < n; j++) {
+    std::vector<OSQPInt> rows;
+    for (k = 0; k < deg && j > 0; k++) rows.push_back((OSQPInt)(gen() % j));
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    Pp[j] = (OSQPInt)Pi.size();
+    for (OSQPInt r : rows) {
+      Pi.push_back(r);
+      Px.push_back(0.1);
+    }
+    Pi.push_back(j);
+    Px.push_back(4.0 * deg);
+
+    Ap[j] = j;
+    Ai[j] = j;
+    q[j]  = (j % 3) ? 1.0 : -2.0;
+  }
+  Pp[n] = (OSQPInt)Pi.size();
+  Ap[n] = n;
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+
+  csc_set_data(&P, n, n, Pp[n], Px.data(), Pi.data(), Pp.data());
+  csc_set_data(&A, m, n, n,     Ax.data(), Ai.data(), Ap.data());
+
+  // With setup threads the choice reuses the analysis of the setup pipeline
+  settings->verbose       = 0;
+  settings->linsys_solver = OSQP_AUTO_SOLVER;
+  settings->setup_threads = GENERATE(1, 2);
+  CAPTURE(settings->setup_threads);
+
+  exitflag = osqp_setup(&tmpSolver, &P, q.data(), &A, l.data(), u.data(),
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test auto hybrid: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test auto hybrid: Error in chosen solver!",
+            solver->settings->linsys_solver == OSQP_HYBRID_SOLVER);
+
+  osqp_solve(solver.get());
+  mu_assert("Basic QP test auto hybrid: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  // Optimality of the box-constrained problem: P*x + q + y = 0, and y is
+  // only nonzero at the bound it pushes x against
+  const OSQPFloat tol = 1e-3;
+  const OSQPFloat* x  = solver->solution->x;
+  const OSQPFloat* y  = solver->solution->y;
+  std::vector<OSQPFloat> r(n);
+
+  csc_mult_sym_triu(&P, x, r.data());
+  for (i = 0; i < n; i++) r[i] += q[i] + y[i];
+  mu_assert("Basic QP test auto hybrid: Error in dual residual!",
+            vec_norm_inf(r.data(), n) < tol);
+
+  OSQPFloat bound_viol = 0.0;
+  OSQPFloat compl_viol = 0.0;
+  for (i = 0; i < n; i++) {
+    bound_viol = c_max(bound_viol, c_absval(x[i]) - 1.0);
+    compl_viol = c_max(compl_viol, c_min(c_absval(y[i]), y[i] > 0 ? 1.0 - x[i] : x[i] + 1.0));
+  }
+  mu_assert("Basic QP test auto hybrid: Primal solution out of bounds!", bound_viol < tol);
+  mu_assert("Basic QP test auto hybrid: Error in complementarity!", compl_viol < tol);
+}
+#endif
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: MKL Pardiso loaded at runtime", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver_ptr refSolver{nullptr};
+
+  settings->verbose = 0;
+
+  // Without the library (or the build option) the setting is refused
+  if (!(osqp_capabilities() & OSQP_CAPABILITY_MKL_PARDISO)) {
+    settings->linsys_library = OSQP_MKL_PARDISO_LINSYS;
+    tmpSolver = nullptr;
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test MKL Pardiso: Missing capability not caught!",
+              exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+    return;
+  }
+
+  // Polishing solves its reduced system with Pardiso too
+  settings->polishing = GENERATE(0, 1);
+  CAPTURE(settings->polishing);
+
+  setup_with_reference(refSolver, solver, *data, settings.get(),
+                       [](OSQPSettings* s) { s->linsys_library = OSQP_MKL_PARDISO_LINSYS; });
+
+  std::string name = solver->work->linsys_solver->name(solver->work->linsys_solver);
+  mu_assert("Basic QP test MKL Pardiso: Wrong linear system solver!", name == "Pardiso");
+
+  solve_and_compare(refSolver.get(), solver.get());
+  mu_assert("Basic QP test MKL Pardiso: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  // Only the direct solver can be replaced
+  settings->linsys_library = OSQP_MKL_PARDISO_LINSYS;
+  settings->linsys_solver  = OSQP_HYBRID_SOLVER;
+  tmpSolver = nullptr;
+  exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test MKL Pardiso: Invalid solver not caught!",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+}
+
+TEST_CASE_METHOD(basic_qp_test_fixture, "Basic QP: Rho update cost model", "[solve][qp]")
+{
+  OSQPInt exitflag;
+
+  OSQPSolver*    tmpRefSolver = nullptr;
+  OSQPSolver_ptr refSolver{nullptr};
+
+  // A rho far from the estimate, adapted at every iteration
+  settings->verbose               = 0;
+  settings->rho                   = 1e-4;
+  settings->adaptive_rho_interval = 1;
+
+  // Reference updating rho at every adaptation
+  exitflag = osqp_setup(&tmpRefSolver, data->P, data->q,
+                        data->A, data->l, data->u,
+                        data->m, data->n, settings.get());
+  refSolver.reset(tmpRefSolver);
+  mu_assert("Basic QP test rho cost model: Reference setup error!", exitflag == 0);
+
+  osqp_solve(refSolver.get());
+  mu_assert("Basic QP test rho cost model: Error in reference rho updates!",
+            refSolver->info->rho_updates > 0);
+  mu_assert("Basic QP test rho cost model: Error in reference skipped rho updates!",
+            refSolver->info->rho_updates_skipped == 0);
+
+  SECTION("Invalid setting") {
+    settings->adaptive_rho_cost_model = 2;
+
+    tmpSolver = nullptr;
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test rho cost model: Setup should fail!",
+              exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  }
+
+  SECTION("Solve") {
+    settings->adaptive_rho_cost_model = 1;
+
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test rho cost model: Setup error!", exitflag == 0);
+
+    // Solve twice: the second solve starts with the cost of an update measured
+    for (OSQPInt k = 0; k < 2; k++) {
+      osqp_cold_start(solver.get());
+      osqp_update_rho(solver.get(), settings->rho);
+      osqp_solve(solver.get());
+
+      mu_assert("Basic QP test rho cost model: Error in solver status!",
+                solver->info->status_val == OSQP_SOLVED);
+      mu_assert("Basic QP test rho cost model: Error in primal solution!",
+                vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, data->n) < TESTS_TOL);
+      mu_assert("Basic QP test rho cost model: Error in dual solution!",
+                vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, data->m) < TESTS_TOL);
+
+      // The first adaptation of a solve always updates rho
+      mu_assert("Basic QP test rho cost model: Error in rho updates!",
+                solver->info->rho_updates > 0);
+#ifndef OSQP_ENABLE_PROFILING
+      // Without the timings every update is performed
+      mu_assert("Basic QP test rho cost model: Error in skipped rho updates!",
+                solver->info->rho_updates_skipped == 0);
+      mu_assert("Basic QP test rho cost model: Error in number of iterations!",
+                solver->info->iter == refSolver->info->iter);
+#endif
+    }
+  }
+
+#ifdef OSQP_ENABLE_PROFILING
+  SECTION("Skipped update") {
+    OSQPInt   skipped;
+    OSQPFloat rho;
+
+    // Any change of the estimate asks for an update
+    settings->adaptive_rho_cost_model = 1;
+    settings->adaptive_rho_tolerance  = 1.0;
+
+    exitflag = osqp_setup(&tmpSolver, data->P, data->q,
+                          data->A, data->l, data->u,
+                          data->m, data->n, settings.get());
+    solver.reset(tmpSolver);
+    mu_assert("Basic QP test rho cost model: Setup error!", exitflag == 0);
+
+    osqp_solve(solver.get());
+    skipped = solver->info->rho_updates_skipped;
+    rho     = solver->settings->rho;
+
+    // An update known to cost far more than the iterations left could save,
+    // once the trend of the residuals is known
+    solver->work->rho_refactor_time = 1e6;
+    solver->work->rho_trend_iter    = solver->info->iter;
+
+    exitflag = adapt_rho(solver.get());
+    CAPTURE(rho, solver->info->rho_estimate);
+    mu_assert("Basic QP test rho cost model: Adaptation error!", exitflag == 0);
+    mu_assert("Basic QP test rho cost model: Update not skipped!",
+              solver->info->rho_updates_skipped == skipped + 1);
+    mu_assert("Basic QP test rho cost model: Rho changed by a skipped update!",
+              solver->settings->rho == rho);
+
+    // The skipped update leaves rho and the factorization as they were
+    osqp_solve(solver.get());
+    mu_assert("Basic QP test rho cost model: Error in solver status after a skipped update!",
+              solver->info->status_val == OSQP_SOLVED);
+    mu_assert("Basic QP test rho cost model: Error in primal solution after a skipped update!",
+              vec_norm_inf_diff(solver->solution->x, sols_data->x_test, data->n) < TESTS_TOL);
+    mu_assert("Basic QP test rho cost model: Error in dual solution after a skipped update!",
+              vec_norm_inf_diff(solver->solution->y, sols_data->y_test, data->m) < TESTS_TOL);
+  }
+#endif
+}
+
+#ifdef OSQP_ENABLE_DERIVATIVES
+TEST_CASE_METHOD(OSQPTestFixture, "Basic QP: Derivatives of a few outputs", "[solve][qp][derivatives]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, j, k;
+
+  // Independent groups of variables with a dense P block, sum(x_g) = 1 and
+  // 0 <= x <= 0.6: the adjoint system splits into one block per group, so
+  // the gradient of one output only reaches the rows of its group
+  const OSQPInt ng  = 10;
+  const OSQPInt gs  = 4;
+  const OSQPInt n   = ng * gs;
+  const OSQPInt m   = ng + n;
+  const OSQPInt Pnz = ng * gs * (gs + 1) / 2;
+
+  std::vector<OSQPInt>   Pp(n+1), Pi(Pnz), Ap(n+1), Ai(2*n);
+  std::vector<OSQPFloat> Px(Pnz), Ax(2*n), q(n), l(m), u(m);
+
+  k = 0;
+  for (j = 0; j < n; j++) {
+    Pp[j] = k;
+    for (i = j - j % gs; i <= j; i++) {
+      Pi[k]   = i;
+      Px[k++] = (i == j) ? 4.0 : 0.5;
+    }
+    Ap[j]       = 2 * j;
+    Ai[2*j]     = j / gs;
+    Ax[2*j]     = 1.0;
+    Ai[2*j + 1] = ng + j;
+    Ax[2*j + 1] = 1.0;
+    q[j]        = -1.0 + 0.5 * (j % gs) + 0.05 * (j / gs);
+  }
+  Pp[n] = Pnz;
+  Ap[n] = 2 * n;
+  for (i = 0; i < ng; i++) {
+    l[i] = 1.0;
+    u[i] = 1.0;
+  }
+  for (i = ng; i < m; i++) {
+    l[i] = 0.0;
+    u[i] = 0.6;
+  }
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+
+  csc_set_data(&P, n, n, Pnz,   Px.data(), Pi.data(), Pp.data());
+  csc_set_data(&A, m, n, 2 * n, Ax.data(), Ai.data(), Ap.data());
+
+  // Derivatives are computed in a solver kept from setup in real-time mode
+  settings->verbose   = 0;
+  settings->polishing = 1;
+  settings->eps_abs   = 1e-7;
+  settings->eps_rel   = 1e-7;
+  settings->realtime  = GENERATE(0, 2);
+  CAPTURE(settings->realtime);
+
+  exitflag = osqp_setup(&tmpSolver, &P, q.data(), &A, l.data(), u.data(),
+                        m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Basic QP test derivatives: Setup error!", exitflag == 0);
+
+  osqp_solve(solver.get());
+  mu_assert("Basic QP test derivatives: Error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+
+  // The derivatives are linear in the gradient: the one-hot gradients are
+  // solved by reach and their sum with all the rows of the system
+  std::vector<OSQPFloat> dx(n), dy(m, 0.0);
+  std::vector<OSQPFloat> dq(n), dl(m), du(m);
+  std::vector<OSQPFloat> dq_sum(n, 0.0), dl_sum(m, 0.0), du_sum(m, 0.0);
+
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) dx[j] = (i == j) ? 1.0 + 0.1 * (j % 3) : 0.0;
+
+    exitflag = osqp_adjoint_derivative_compute(solver.get(), dx.data(), dy.data(), dy.data());
+    mu_assert("Basic QP test derivatives: Error computing one-hot derivative!", exitflag == 0);
+    exitflag = osqp_adjoint_derivative_get_vec(solver.get(), dq.data(), dl.data(), du.data());
+    mu_assert("Basic QP test derivatives: Error getting one-hot derivative!", exitflag == 0);
+
+    for (j = 0; j < n; j++) dq_sum[j] += dq[j];
+    for (j = 0; j < m; j++) {
+      dl_sum[j] += dl[j];
+      du_sum[j] += du[j];
+    }
+  }
+
+  for (j = 0; j < n; j++) dx[j] = 1.0 + 0.1 * (j % 3);
+
+  exitflag = osqp_adjoint_derivative_compute(solver.get(), dx.data(), dy.data(), dy.data());
+  mu_assert("Basic QP test derivatives: Error computing dense derivative!", exitflag == 0);
+  exitflag = osqp_adjoint_derivative_get_vec(solver.get(), dq.data(), dl.data(), du.data());
+  mu_assert("Basic QP test derivatives: Error getting dense derivative!", exitflag == 0);
+
+  mu_assert("Basic QP test derivatives: Error in derivative w.r.t. q!",
+            vec_norm_inf_diff(dq.data(), dq_sum.data(), n) < TESTS_TOL);
+  mu_assert("Basic QP test derivatives: Error in derivative w.r.t. l!",
+            vec_norm_inf_diff(dl.data(), dl_sum.data(), m) < TESTS_TOL);
+  mu_assert("Basic QP test derivatives: Error in derivative w.r.t. u!",
+            vec_norm_inf_diff(du.data(), du_sum.data(), m) < TESTS_TOL);
+  mu_assert("Basic QP test derivatives: Zero derivative!",
+            vec_norm_inf(dq.data(), n) > TESTS_TOL);
+}
+#endif
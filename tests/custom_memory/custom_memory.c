@@ -7,9 +7,13 @@
  */
 long int alloc_counter = 0;
 
+/* Total number of calls to the allocators (including realloc and free) */
+long int alloc_calls = 0;
+
 void* my_malloc(size_t size) {
   void *m = malloc(size);
   alloc_counter++;
+  alloc_calls++;
   /* printf("OSQP allocator  (malloc): %zu bytes, %ld allocations \n",size, alloc_counter); */
   return m;
 }
@@ -17,12 +21,14 @@ void* my_malloc(size_t size) {
 void* my_calloc(size_t num, size_t size) {
   void *m = calloc(num, size);
   alloc_counter++;
+  alloc_calls++;
   /* printf("OSQP allocator  (calloc): %zu bytes, %ld allocations \n",num*size, alloc_counter); */
   return m;
 }
 
 void* my_realloc(void *ptr, size_t size) {
   void *m = realloc(ptr,size);
+  alloc_calls++;
   /* printf("OSQP allocator (realloc) : %zu bytes, %ld allocations \n",size, alloc_counter); */
   return m;
 }
@@ -31,6 +37,7 @@ void my_free(void *ptr) {
   if(ptr != NULL){
     free(ptr);
     alloc_counter--;
+    alloc_calls++;
     /* printf("OSQP allocator   (free) : %ld allocations \n", alloc_counter); */
   }
 }
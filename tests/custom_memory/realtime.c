@@ -0,0 +1,151 @@
+/*
+ * Counts the calls to the custom allocators after osqp_setup in real-time
+ * mode. Solving, updating the problem, polishing and (when available)
+ * computing adjoint derivatives must not allocate, and must give the same
+ * results as without real-time mode. Returns nonzero on failure.
+ */
+#include "osqp.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+extern long int alloc_calls;
+
+#define N     2
+#define M     3
+#define P_NNZ 3
+#define A_NNZ 4
+
+static OSQPFloat P_x[P_NNZ] = { 4.0, 1.0, 2.0, };
+static OSQPInt   P_i[P_NNZ] = { 0, 0, 1, };
+static OSQPInt   P_p[N+1]   = { 0, 1, 3, };
+static OSQPFloat q[N]       = { 1.0, 1.0, };
+static OSQPFloat A_x[A_NNZ] = { 1.0, 1.0, 1.0, 1.0, };
+static OSQPInt   A_i[A_NNZ] = { 0, 1, 0, 2, };
+static OSQPInt   A_p[N+1]   = { 0, 2, 4, };
+static OSQPFloat l[M]       = { 1.0, 0.0, -OSQP_INFTY, };
+static OSQPFloat u[M]       = { 1.0, 0.7, 0.7, };
+
+static OSQPFloat P_x_new[P_NNZ] = { 5.0, 1.5, 1.0, };
+static OSQPFloat A_x_new[A_NNZ] = { 1.2, 1.5, 1.1, 0.8, };
+static OSQPFloat q_new[N]       = { 2.0, 3.0, };
+static OSQPFloat u_new[M]       = { 1.0, 0.8, 0.8, };
+
+typedef struct {
+  OSQPFloat x[N];
+  OSQPFloat y[M];
+  OSQPInt   status_polish;
+  OSQPFloat dq[N];
+  OSQPFloat dl[M];
+  OSQPFloat du[M];
+  OSQPFloat dP_x[P_NNZ];
+  OSQPFloat dA_x[A_NNZ];
+} result_t;
+
+/* Returns the number of allocator calls after setup, or -1 on error */
+static long int run(OSQPInt realtime, result_t* res) {
+
+  OSQPSolver*   solver = NULL;
+  OSQPSettings  settings;
+  OSQPCscMatrix P, A;
+  OSQPInt       exitflag = 0;
+  OSQPInt       i;
+  long int      calls;
+
+  csc_set_data(&P, N, N, P_NNZ, P_x, P_i, P_p);
+  csc_set_data(&A, M, N, A_NNZ, A_x, A_i, A_p);
+
+  osqp_set_default_settings(&settings);
+  settings.verbose   = 0;
+  settings.polishing = 1;
+  settings.realtime  = realtime;
+
+  if (osqp_setup(&solver, &P, q, &A, l, u, M, N, &settings)) return -1;
+
+  calls = alloc_calls;
+
+  exitflag |= osqp_solve(solver);
+  exitflag |= osqp_update_data_mat(solver, P_x_new, OSQP_NULL, P_NNZ, A_x_new, OSQP_NULL, A_NNZ);
+  exitflag |= osqp_update_data_vec(solver, q_new, OSQP_NULL, u_new);
+  exitflag |= osqp_update_rho(solver, 0.5);
+  exitflag |= osqp_warm_start(solver, solver->solution->x, solver->solution->y);
+  exitflag |= osqp_solve(solver);
+
+  for (i = 0; i < N; i++) res->x[i] = solver->solution->x[i];
+  for (i = 0; i < M; i++) res->y[i] = solver->solution->y[i];
+  res->status_polish = solver->info->status_polish;
+
+#ifdef OSQP_ENABLE_DERIVATIVES
+  {
+    OSQPFloat     dx[N]   = { 1.0, -0.5, };
+    OSQPFloat     dy_l[M] = { 0.0, 0.2, 0.0, };
+    OSQPFloat     dy_u[M] = { 0.3, 0.0, 0.1, };
+    OSQPCscMatrix dP, dA;
+
+    csc_set_data(&dP, N, N, P_NNZ, res->dP_x, P_i, P_p);
+    csc_set_data(&dA, M, N, A_NNZ, res->dA_x, A_i, A_p);
+
+    exitflag |= osqp_adjoint_derivative_compute(solver, dx, dy_l, dy_u);
+    exitflag |= osqp_adjoint_derivative_get_vec(solver, res->dq, res->dl, res->du);
+    exitflag |= osqp_adjoint_derivative_get_mat(solver, &dP, &dA);
+  }
+#endif
+
+  calls = alloc_calls - calls;
+
+  osqp_cleanup(solver);
+  return exitflag ? -1 : calls;
+}
+
+static int near(const OSQPFloat* a, const OSQPFloat* b, OSQPInt len) {
+  OSQPInt i;
+  for (i = 0; i < len; i++) {
+    if (a[i] - b[i] > 1e-5 || b[i] - a[i] > 1e-5) return 0;
+  }
+  return 1;
+}
+
+int main(void) {
+
+  result_t ref, rt;
+  long int calls;
+  OSQPInt  realtime = 1;
+  int      failed = 0;
+
+#ifdef OSQP_ENABLE_DERIVATIVES
+  realtime = 2;
+#endif
+
+  if (run(0, &ref) < 0) {
+    printf("Reference run failed\n");
+    return 1;
+  }
+
+  calls = run(realtime, &rt);
+  if (calls < 0) {
+    printf("Real-time run failed\n");
+    return 1;
+  }
+
+  if (calls != 0) {
+    printf("FAILED: %ld allocator calls after setup in real-time mode\n", calls);
+    failed = 1;
+  }
+  if (rt.status_polish != ref.status_polish || rt.status_polish != OSQP_POLISH_SUCCESS) {
+    printf("FAILED: polishing status %d (reference %d)\n", (int)rt.status_polish, (int)ref.status_polish);
+    failed = 1;
+  }
+  if (!near(rt.x, ref.x, N) || !near(rt.y, ref.y, M)) {
+    printf("FAILED: real-time solution differs from the reference\n");
+    failed = 1;
+  }
+#ifdef OSQP_ENABLE_DERIVATIVES
+  if (!near(rt.dq, ref.dq, N) || !near(rt.dl, ref.dl, M) || !near(rt.du, ref.du, M) ||
+      !near(rt.dP_x, ref.dP_x, P_NNZ) || !near(rt.dA_x, ref.dA_x, A_NNZ)) {
+    printf("FAILED: real-time derivatives differ from the reference\n");
+    failed = 1;
+  }
+#endif
+
+  if (!failed) printf("Real-time mode: no allocations after setup\n");
+  return failed;
+}
@@ -38,6 +38,22 @@ OSQPSettings prob1_settings = {
   (OSQPFloat)1000.00000000000000000000,
   (OSQPFloat)0.00000100000000000000,
   3,
+  0,
+  0,
+  0,
+  -1,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  1,
+  0,
 };
 
 /* Define the data structure */
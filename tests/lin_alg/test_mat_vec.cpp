@@ -147,3 +147,87 @@ TEST_CASE("Matrix-vector: Empty matrix multiplication", "[mat-vec][operation]")
     "Linear algebra tests: error with no column matrix, matrix-transpose-vector multiplication",
     OSQPVectorf_norm_inf_diff(result.get(), ee.get()) < TESTS_TOL);
 }
+
+TEST_CASE("Matrix-vector: Compressed indices", "[mat-vec][operation]") {
+  lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
+
+  OSQPInt   i, j, k;
+  OSQPInt   m = 100000;
+  OSQPFloat alphas[3] = {1.0, -1.0, 0.7};
+  OSQPFloat betas[4]  = {0.0, 1.0, -1.0, 0.3};
+
+  // Gaps of 1, 2 and 4 bytes, a first row below the previous one and an empty column
+  OSQPInt   Wp[5] = {0, 3, 5, 5, 7};
+  OSQPInt   Wi[7] = {0, 70000, 99999, 5, 300, 2, 3};
+  OSQPFloat Wx[7] = {1.0, -2.0, 3.0, 0.5, 4.0, -1.5, 2.5};
+  OSQPCscMatrix Wcsc;
+  csc_set_data(&Wcsc, m, 4, 7, Wx, Wi, Wp);
+
+  OSQPMatrix_ptr A{OSQPMatrix_new_from_csc(data->test_mat_vec_A, 0)};
+  OSQPMatrix_ptr Ac{OSQPMatrix_new_from_csc(data->test_mat_vec_A, 0)};
+  OSQPMatrix_ptr Pu{OSQPMatrix_new_from_csc(data->test_mat_vec_Pu, 1)};
+  OSQPMatrix_ptr Puc{OSQPMatrix_new_from_csc(data->test_mat_vec_Pu, 1)};
+  OSQPMatrix_ptr W{OSQPMatrix_new_from_csc(&Wcsc, 0)};
+  OSQPMatrix_ptr Wc{OSQPMatrix_new_from_csc(&Wcsc, 0)};
+
+  mu_assert("Linear algebra tests: error compressing the indices",
+            OSQPMatrix_compress_indices(Ac.get()) == 0);
+  mu_assert("Linear algebra tests: error compressing the indices",
+            OSQPMatrix_compress_indices(Puc.get()) == 0);
+  mu_assert("Linear algebra tests: error compressing the indices",
+            OSQPMatrix_compress_indices(Wc.get()) == 0);
+
+  OSQPMatrix* plain[3]      = {A.get(), Pu.get(), W.get()};
+  OSQPMatrix* compressed[3] = {Ac.get(), Puc.get(), Wc.get()};
+
+  for (k = 0; k < 3; k++) {
+    OSQPInt rows = OSQPMatrix_get_m(plain[k]);
+    OSQPInt cols = OSQPMatrix_get_n(plain[k]);
+
+    OSQPVectorf_ptr x{OSQPVectorf_malloc(cols)};
+    OSQPVectorf_ptr y{OSQPVectorf_malloc(rows)};
+    OSQPVectorf_ptr ref_x{OSQPVectorf_malloc(cols)};
+    OSQPVectorf_ptr res_x{OSQPVectorf_malloc(cols)};
+    OSQPVectorf_ptr ref_y{OSQPVectorf_malloc(rows)};
+    OSQPVectorf_ptr res_y{OSQPVectorf_malloc(rows)};
+
+    for (j = 0; j < cols; j++) OSQPVectorf_data(x.get())[j] = 1.0 + 0.25 * j;
+    for (j = 0; j < rows; j++) OSQPVectorf_data(y.get())[j] = 1.0 - 1e-5 * j;
+
+    // The products must match the plain ones exactly
+    for (i = 0; i < 3; i++) {
+      for (j = 0; j < 4; j++) {
+        CAPTURE(k, alphas[i], betas[j]);
+
+        OSQPVectorf_copy(ref_y.get(), y.get());
+        OSQPVectorf_copy(res_y.get(), y.get());
+        OSQPMatrix_Axpy(plain[k], x.get(), ref_y.get(), alphas[i], betas[j]);
+        OSQPMatrix_Axpy(compressed[k], x.get(), res_y.get(), alphas[i], betas[j]);
+        mu_assert("Linear algebra tests: error in compressed matrix-vector multiplication",
+                  OSQPVectorf_norm_inf_diff(res_y.get(), ref_y.get()) == 0.0);
+
+        OSQPVectorf_copy(ref_x.get(), x.get());
+        OSQPVectorf_copy(res_x.get(), x.get());
+        OSQPMatrix_Atxpy(plain[k], y.get(), ref_x.get(), alphas[i], betas[j]);
+        OSQPMatrix_Atxpy(compressed[k], y.get(), res_x.get(), alphas[i], betas[j]);
+        mu_assert("Linear algebra tests: error in compressed matrix-transpose-vector multiplication",
+                  OSQPVectorf_norm_inf_diff(res_x.get(), ref_x.get()) == 0.0);
+      }
+    }
+  }
+
+  // Value updates keep the compressed indices valid
+  OSQPFloat Ax_new[1]     = {-3.0};
+  OSQPInt   Ax_new_idx[1] = {0};
+  OSQPMatrix_update_values(A.get(), Ax_new, Ax_new_idx, 1);
+  OSQPMatrix_update_values(Ac.get(), Ax_new, Ax_new_idx, 1);
+
+  OSQPVectorf_ptr x{OSQPVectorf_new(data->test_mat_vec_x, data->test_mat_vec_n)};
+  OSQPVectorf_ptr ref{OSQPVectorf_malloc(data->test_mat_vec_m)};
+  OSQPVectorf_ptr result{OSQPVectorf_malloc(data->test_mat_vec_m)};
+
+  OSQPMatrix_Axpy(A.get(), x.get(), ref.get(), 1.0, 0.0);
+  OSQPMatrix_Axpy(Ac.get(), x.get(), result.get(), 1.0, 0.0);
+  mu_assert("Linear algebra tests: error in compressed matrix-vector multiplication after update",
+            OSQPVectorf_norm_inf_diff(result.get(), ref.get()) == 0.0);
+}
@@ -426,6 +426,91 @@ TEST_CASE("Vector: Elementwise bound vector", "[vector],[operation]")
   }
 }
 
+TEST_CASE("Vector: Expressions", "[vector],[operation]")
+{
+  lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
+
+  OSQPVectorf_ptr v1{OSQPVectorf_new(data->test_vec_ops_v1, data->test_vec_ops_n)};
+  OSQPVectorf_ptr v2{OSQPVectorf_new(data->test_vec_ops_v2, data->test_vec_ops_n)};
+  OSQPVectorf_ptr v3{OSQPVectorf_new(data->test_vec_ops_v3, data->test_vec_ops_n)};
+  OSQPVectorf_ptr lb{OSQPVectorf_new(data->test_vec_ops_vn_neg, data->test_vec_ops_n)};
+  OSQPVectorf_ptr ub{OSQPVectorf_new(data->test_vec_ops_vn, data->test_vec_ops_n)};
+  OSQPVectorf_ptr ref{OSQPVectorf_malloc(data->test_vec_ops_n)};
+  OSQPVectorf_ptr tmp{OSQPVectorf_malloc(data->test_vec_ops_n)};
+  OSQPVectorf_ptr result{OSQPVectorf_malloc(data->test_vec_ops_n)};
+
+  OSQPVectorf_expr e;
+  OSQPVectorf_expr_init(&e);
+
+  SECTION("Sum of scaled vectors")
+  {
+    OSQPVectorf_from_raw(ref.get(), data->test_vec_ops_add_scaled3);
+
+    OSQPVectorf_expr_add(&e, data->test_vec_ops_sc1, v1.get());
+    OSQPVectorf_expr_add(&e, data->test_vec_ops_sc2, v2.get());
+    OSQPVectorf_expr_add(&e, data->test_vec_ops_sc3, v3.get());
+    OSQPVectorf_eval(result.get(), &e);
+
+    mu_assert("Error evaluating sum of scaled vectors",
+              OSQPVectorf_norm_inf_diff(ref.get(), result.get()) < TESTS_TOL);
+
+    // Evaluate into one of the vectors of the expression
+    OSQPVectorf_eval(v1.get(), &e);
+
+    mu_assert("Error evaluating sum of scaled vectors in place",
+              OSQPVectorf_norm_inf_diff(ref.get(), v1.get()) < TESTS_TOL);
+  }
+
+  SECTION("Products, scaling and bounds")
+  {
+    // ref = min(max(sc1 * v3 .* (sc2*v1 + sc3*(v1.*v2)), lb), ub)
+    OSQPVectorf_ew_prod(tmp.get(), v1.get(), v2.get());
+    OSQPVectorf_add_scaled(ref.get(), data->test_vec_ops_sc2, v1.get(), data->test_vec_ops_sc3, tmp.get());
+    OSQPVectorf_ew_prod(ref.get(), ref.get(), v3.get());
+    OSQPVectorf_mult_scalar(ref.get(), data->test_vec_ops_sc1);
+    OSQPVectorf_ew_bound_vec(ref.get(), ref.get(), lb.get(), ub.get());
+
+    OSQPVectorf_expr_add(&e, data->test_vec_ops_sc2, v1.get());
+    OSQPVectorf_expr_add_prod(&e, data->test_vec_ops_sc3, v1.get(), v2.get());
+    OSQPVectorf_expr_ew_prod(&e, v3.get());
+    OSQPVectorf_expr_mult_scalar(&e, data->test_vec_ops_sc1);
+    OSQPVectorf_expr_bound_vec(&e, lb.get(), ub.get());
+    OSQPVectorf_eval(result.get(), &e);
+
+    mu_assert("Error evaluating expression with products, scaling and bounds",
+              OSQPVectorf_norm_inf_diff(ref.get(), result.get()) < TESTS_TOL);
+  }
+
+  SECTION("Norms and inner product")
+  {
+    OSQPFloat norm, snorm;
+
+    OSQPVectorf_minus(ref.get(), v1.get(), v2.get());
+
+    OSQPVectorf_expr_add(&e, 1.0, v1.get());
+    OSQPVectorf_expr_add(&e, -1.0, v2.get());
+
+    norm = OSQPVectorf_eval_norm_inf(result.get(), &e, v3.get(), &snorm);
+
+    mu_assert("Error evaluating expression with norms",
+              OSQPVectorf_norm_inf_diff(ref.get(), result.get()) < TESTS_TOL);
+    mu_assert("Error in infinity norm of expression",
+              c_absval(norm - OSQPVectorf_norm_inf(ref.get())) < TESTS_TOL);
+    mu_assert("Error in scaled infinity norm of expression",
+              c_absval(snorm - OSQPVectorf_scaled_norm_inf(v3.get(), ref.get())) < TESTS_TOL);
+
+    // Only the norm, without storing the expression
+    norm = OSQPVectorf_eval_norm_inf(OSQP_NULL, &e, OSQP_NULL, OSQP_NULL);
+
+    mu_assert("Error in infinity norm of unstored expression",
+              c_absval(norm - OSQPVectorf_norm_inf(ref.get())) < TESTS_TOL);
+
+    mu_assert("Error in inner product with expression",
+              c_absval(OSQPVectorf_expr_dot_prod(&e, v3.get()) -
+                       OSQPVectorf_dot_prod(ref.get(), v3.get())) < TESTS_TOL);
+  }
+}
+
 TEST_CASE("Vector: Norms")
 {
   lin_alg_sols_data_ptr data{generate_problem_lin_alg_sols_data()};
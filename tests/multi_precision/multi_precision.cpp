@@ -0,0 +1,50 @@
+#include "osqp.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+/* Solve the demo problem with the given precision and return the objective value */
+template <typename Float, typename Int>
+static int solve_demo(double* obj_val) {
+  Float P_x[3] = { 4.0, 1.0, 2.0, };
+  Int   P_i[3] = { 0, 0, 1, };
+  Int   P_p[3] = { 0, 1, 3, };
+  Float q[2]   = { 1.0, 1.0, };
+  Float A_x[4] = { 1.0, 1.0, 1.0, 1.0, };
+  Int   A_i[4] = { 0, 1, 0, 2, };
+  Int   A_p[3] = { 0, 2, 4, };
+  Float l[3]   = { 1.0, 0.0, 0.0, };
+  Float u[3]   = { 1.0, 0.7, 0.7, };
+
+  typedef osqp::Solver<Float, Int> Solver;
+
+  typename Solver::CscMatrix P = { 2, 2, P_p, P_i, P_x };
+  typename Solver::CscMatrix A = { 3, 2, A_p, A_i, A_x };
+  typename Solver::Settings  settings = Solver::default_settings();
+
+  Solver solver;
+
+  settings.verbose   = 0;
+  settings.polishing = 1;
+
+  if (solver.setup(P, q, A, l, u, settings)) return 1;
+  if (solver.solve()) return 1;
+
+  std::printf("sizeof(Float) = %d, sizeof(Int) = %d: %s after %d iterations, x = (%f, %f)\n",
+              (int)sizeof(Float), (int)sizeof(Int), solver.status(), (int)solver.iter(),
+              (double)solver.x()[0], (double)solver.x()[1]);
+
+  *obj_val = (double)solver.obj_val();
+  return solver.status_val() != 1;
+}
+
+int main(void) {
+  double obj_f32, obj_f64;
+
+  if (solve_demo<float, std::int32_t>(&obj_f32)) return 1;
+  if (solve_demo<double, std::int64_t>(&obj_f64)) return 1;
+
+  // Both precisions solve the same problem
+  return std::fabs(obj_f32 - obj_f64) > 1e-3;
+}
@@ -18,7 +18,7 @@ TEST_CASE_METHOD(primal_infeasibility_test_fixture, "Primal infeasibility", "[so
   settings->warm_starting = 0;
 
   /* Test all possible linear system solvers in this test case */
-  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
+  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER, OSQP_HYBRID_SOLVER})));
 
   CAPTURE(settings->linsys_solver);
 
@@ -6,6 +6,12 @@
 
 #include "update_matrices_data.h"
 
+#ifdef OSQP_ALGEBRA_BUILTIN
+#include <vector>
+
+#include "qdldl_interface.h"
+#endif
+
 #ifndef OSQP_ALGEBRA_CUDA
 
 #include "kkt.h"
@@ -105,9 +111,12 @@ TEST_CASE_METHOD(OSQPTestFixture, "Test updating P and A", "[update]")
   settings->max_iter = 1000;
 
   /* Test all possible linear system solvers in this test case */
-  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER})));
+  settings->linsys_solver = GENERATE(filter(&isLinsysSupported, values({OSQP_DIRECT_SOLVER, OSQP_INDIRECT_SOLVER, OSQP_HYBRID_SOLVER})));
+
+  /* The updates must also work when the KKT matrix has been released after setup */
+  settings->lean_memory = GENERATE(0, 1);
 
-  CAPTURE(settings->linsys_solver);
+  CAPTURE(settings->linsys_solver, settings->lean_memory);
 
   // Setup solver
   exitflag = osqp_setup(&tmpSolver, data->test_solve_Pu, data->test_solve_q,
@@ -309,3 +318,413 @@ TEST_CASE_METHOD(OSQPTestFixture, "Test updating P and A", "[update]")
                         data->m) < TESTS_TOL);
   }
 }
+
+TEST_CASE_METHOD(OSQPTestFixture, "Test updating a few entries of P and A", "[update]")
+{
+  OSQPInt exitflag;
+  OSQPInt i;
+
+  // Separable problem: the KKT matrix is made of n independent 2x2 blocks,
+  // so an update touches only a couple of rows of L
+  const OSQPInt n = 20;
+  const OSQPInt m = n;
+
+  std::unique_ptr<OSQPInt[]>   Mp(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Mi(new OSQPInt[n]);
+  std::unique_ptr<OSQPFloat[]> Px(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> Ax(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> Px_ref(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> Ax_ref(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+
+  for (i = 0; i < n; i++) {
+    Mp[i] = i;
+    Mi[i] = i;
+    Px[i] = 1.0 + 0.1 * i;
+    Ax[i] = 1.0 - 0.02 * i;
+    q[i]  = (i % 2) ? 2.0 : -3.0;
+    l[i]  = -1.0;
+    u[i]  = 1.0;
+  }
+  Mp[n] = n;
+
+  // Without scaling the update indices reach the linear system solver,
+  // which only refactors the rows of L that depend on them
+  settings->scaling       = 0;
+  settings->polishing     = 0;
+  settings->linsys_solver = OSQP_DIRECT_SOLVER;
+  settings->lean_memory   = GENERATE(0, 1);
+
+  // Entries in early or late columns
+  OSQPInt late = GENERATE(0, 1);
+
+  CAPTURE(settings->lean_memory, late);
+
+  OSQPInt   Px_new_idx[1] = { late ? n - 1 : 0 };
+  OSQPInt   Ax_new_idx[2] = { late ? n - 2 : 0, late ? n - 1 : 1 };
+  OSQPFloat Px_new[1]     = { 2.0 * Px[Px_new_idx[0]] };
+  OSQPFloat Ax_new[2]     = { 1.5 * Ax[Ax_new_idx[0]], -0.5 * Ax[Ax_new_idx[1]] };
+
+  for (i = 0; i < n; i++) {
+    Px_ref[i] = Px[i];
+    Ax_ref[i] = Ax[i];
+  }
+  Px_ref[Px_new_idx[0]] = Px_new[0];
+  Ax_ref[Ax_new_idx[0]] = Ax_new[0];
+  Ax_ref[Ax_new_idx[1]] = Ax_new[1];
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+  OSQPCscMatrix P_ref;
+  OSQPCscMatrix A_ref;
+
+  csc_set_data(&P,     n, n, n, Px.get(),     Mi.get(), Mp.get());
+  csc_set_data(&A,     m, n, n, Ax.get(),     Mi.get(), Mp.get());
+  csc_set_data(&P_ref, n, n, n, Px_ref.get(), Mi.get(), Mp.get());
+  csc_set_data(&A_ref, m, n, n, Ax_ref.get(), Mi.get(), Mp.get());
+
+  // Reference: a solver set up with the updated matrices. The other solver is
+  // set up with the original matrices and then updated.
+  OSQPSolver_ptr refSolver{nullptr};
+
+  setup_with_reference(refSolver, OSQPTestProblem(&P_ref, q.get(), &A_ref, l.get(), u.get(), m, n),
+                       solver, OSQPTestProblem(&P, q.get(), &A, l.get(), u.get(), m, n),
+                       settings.get(), nullptr);
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  exitflag = osqp_update_data_mat(solver.get(),
+                                  Px_new, Px_new_idx, 1,
+                                  Ax_new, Ax_new_idx, 2);
+  mu_assert("Update matrices: few entries, update error!", exitflag == 0);
+
+  // Same starting point as the reference solver. The factorization matches
+  // the one computed from scratch, so the iterations do too.
+  osqp_cold_start(solver.get());
+  osqp_solve(solver.get());
+  compare_solutions(refSolver.get(), solver.get());
+}
+
+#ifdef OSQP_ALGEBRA_BUILTIN
+TEST_CASE_METHOD(OSQPTestFixture, "Test updating an entry of P far from the diagonal", "[update]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, k;
+
+  // Chain problem: P is tridiagonal with a coupling between the first and the
+  // last variable, so the elimination tree is deep and the two indices of an
+  // off-diagonal entry can be far apart on it
+  const OSQPInt n   = 40;
+  const OSQPInt m   = n;
+  const OSQPInt Pnz = 2 * n;
+
+  std::unique_ptr<OSQPInt[]>   Pp(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Pi(new OSQPInt[Pnz]);
+  std::unique_ptr<OSQPFloat[]> Px(new OSQPFloat[Pnz]);
+  std::unique_ptr<OSQPFloat[]> Px_ref(new OSQPFloat[Pnz]);
+  std::unique_ptr<OSQPInt[]>   Ap(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Ai(new OSQPInt[n]);
+  std::unique_ptr<OSQPFloat[]> Ax(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+
+  k = 0;
+  for (i = 0; i < n; i++) {
+    Pp[i] = k;
+    if (i == n - 1) {
+      Pi[k] = 0;
+      Px[k++] = -0.5;
+    }
+    if (i > 0) {
+      Pi[k] = i - 1;
+      Px[k++] = -1.0;
+    }
+    Pi[k] = i;
+    Px[k++] = 4.0 + 0.1 * i;
+
+    Ap[i] = i;
+    Ai[i] = i;
+    Ax[i] = 1.0;
+    q[i]  = (i % 2) ? 2.0 : -3.0;
+    l[i]  = -1.0;
+    u[i]  = 1.0;
+  }
+  Pp[n] = k;
+  Ap[n] = n;
+
+  // Same rho updates in both solvers
+  settings->scaling               = 0;
+  settings->polishing             = 0;
+  settings->linsys_solver         = OSQP_DIRECT_SOLVER;
+  settings->adaptive_rho_interval = TESTS_RHO_INTERVAL;
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+
+  csc_set_data(&P, n, n, Pnz, Px.get(), Pi.get(), Pp.get());
+  csc_set_data(&A, m, n, n,   Ax.get(), Ai.get(), Ap.get());
+
+  exitflag = osqp_setup(&tmpSolver, &P, q.get(), &A, l.get(), u.get(), m, n, settings.get());
+  solver.reset(tmpSolver);
+  mu_assert("Update matrices: far entry, setup error!", exitflag == 0);
+
+  std::string name = solver->work->linsys_solver->name(solver->work->linsys_solver);
+  // The partial refactorization is specific to QDLDL
+  if (name.rfind("QDLDL", 0) != 0)
+    return;
+
+  qdldl_solver*  s   = (qdldl_solver*) solver->work->linsys_solver;
+  OSQPCscMatrix* KKT = s->KKT;
+  OSQPInt        nKKT = KKT->n;
+
+  // Depth of each row of L in the elimination tree
+  std::vector<OSQPInt> depth(nKKT);
+  for (i = 0; i < nKKT; i++) {
+    depth[i] = 1;
+    for (k = s->etree[i]; k != -1; k = s->etree[k])
+      depth[i]++;
+  }
+
+  // Off-diagonal entry of P whose row lies deepest below its column in the
+  // elimination tree of the permuted KKT matrix
+  OSQPInt best = -1;
+  OSQPInt bestCol = 0;
+  OSQPInt bestGap = 0;
+
+  for (i = 0; i < Pnz; i++) {
+    OSQPInt pos = s->PtoKKT[i];
+    OSQPInt row = KKT->i[pos];
+    OSQPInt col = 0;
+
+    while (KKT->p[col + 1] <= pos)
+      col++;
+
+    if (row != col && depth[row] - depth[col] > bestGap) {
+      best    = i;
+      bestCol = col;
+      bestGap = depth[row] - depth[col];
+    }
+  }
+
+  CAPTURE(nKKT, best, bestGap, depth[bestCol]);
+
+  // Marking from the row would recompute many more rows
+  mu_assert("Update matrices: far entry, indices are close on the elimination tree!",
+            bestGap > nKKT / 4);
+
+  for (i = 0; i < Pnz; i++)
+    Px_ref[i] = Px[i];
+
+  OSQPInt   Px_new_idx[1] = { best };
+  OSQPFloat Px_new[1]     = { 0.5 * Px[best] };
+  Px_ref[best] = Px_new[0];
+
+  exitflag = osqp_update_data_mat(solver.get(), Px_new, Px_new_idx, 1, OSQP_NULL, OSQP_NULL, 0);
+  mu_assert("Update matrices: far entry, update error!", exitflag == 0);
+
+  // Only the path from the column of the entry to the root is recomputed
+  mu_assert("Update matrices: far entry, wrong rows refactored!",
+            s->rows_refactored == depth[bestCol]);
+
+  // Reference: a solver set up with the updated matrix
+  OSQPCscMatrix P_ref;
+  csc_set_data(&P_ref, n, n, Pnz, Px_ref.get(), Pi.get(), Pp.get());
+
+  OSQPSolver* tmpRef = nullptr;
+  exitflag = osqp_setup(&tmpRef, &P_ref, q.get(), &A, l.get(), u.get(), m, n, settings.get());
+  OSQPSolver_ptr refSolver{tmpRef};
+  mu_assert("Update matrices: far entry, reference setup error!", exitflag == 0);
+
+  solve_and_compare(refSolver.get(), solver.get());
+}
+#endif
+
+TEST_CASE_METHOD(OSQPTestFixture, "Test updating the vectors and matrices together", "[update]")
+{
+  OSQPInt exitflag;
+  OSQPInt i;
+
+  // Separable problem whose new bounds turn some constraints into equalities,
+  // so the constraint types change with the matrices
+  const OSQPInt n = 20;
+  const OSQPInt m = n;
+
+  std::unique_ptr<OSQPInt[]>   Mp(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Mi(new OSQPInt[n]);
+  std::unique_ptr<OSQPFloat[]> Px(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> Ax(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> Px_new(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> Ax_new(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> q_new(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l_new(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u_new(new OSQPFloat[m]);
+
+  for (i = 0; i < n; i++) {
+    Mp[i]     = i;
+    Mi[i]     = i;
+    Px[i]     = 1.0 + 0.1 * i;
+    Ax[i]     = 1.0 - 0.02 * i;
+    q[i]      = (i % 2) ? 2.0 : -3.0;
+    l[i]      = -1.0;
+    u[i]      = 1.0;
+    Px_new[i] = 2.0 - 0.05 * i;
+    Ax_new[i] = 0.5 + 0.03 * i;
+    q_new[i]  = (i % 3) ? -1.0 : 4.0;
+    l_new[i]  = (i % 4) ? -2.0 : 0.5;
+    u_new[i]  = 0.5;
+  }
+  Mp[n] = n;
+
+  settings->scaling       = GENERATE(0, 1);
+  settings->polishing     = 0;
+  settings->linsys_solver = OSQP_DIRECT_SOLVER;
+
+  CAPTURE(settings->scaling);
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+  OSQPCscMatrix P_new;
+  OSQPCscMatrix A_new;
+
+  csc_set_data(&P,     n, n, n, Px.get(),     Mi.get(), Mp.get());
+  csc_set_data(&A,     m, n, n, Ax.get(),     Mi.get(), Mp.get());
+  csc_set_data(&P_new, n, n, n, Px_new.get(), Mi.get(), Mp.get());
+  csc_set_data(&A_new, m, n, n, Ax_new.get(), Mi.get(), Mp.get());
+
+  // Reference: a solver set up with the new data
+  OSQPSolver_ptr refSolver{nullptr};
+
+  setup_with_reference(refSolver,
+                       OSQPTestProblem(&P_new, q_new.get(), &A_new, l_new.get(), u_new.get(), m, n),
+                       solver, OSQPTestProblem(&P, q.get(), &A, l.get(), u.get(), m, n),
+                       settings.get(), nullptr);
+
+  osqp_solve(refSolver.get());
+  osqp_solve(solver.get());
+
+  // Inconsistent bounds leave the problem as it was
+  OSQPInt   iter = solver->info->iter;
+  OSQPFloat l_bad[m];
+  for (i = 0; i < m; i++) l_bad[i] = 2.0;
+
+  exitflag = osqp_update_data(solver.get(), q_new.get(), l_bad, OSQP_NULL,
+                              Px_new.get(), OSQP_NULL, n, Ax_new.get(), OSQP_NULL, n);
+  mu_assert("Update data: inconsistent bounds not caught!",
+            exitflag == OSQP_DATA_VALIDATION_ERROR);
+
+  // Same rho and starting point as the first solve
+  osqp_update_rho(solver.get(), settings->rho);
+  osqp_cold_start(solver.get());
+  osqp_solve(solver.get());
+  mu_assert("Update data: problem changed by a rejected update!",
+            solver->info->iter == iter);
+
+  exitflag = osqp_update_data(solver.get(), q_new.get(), l_new.get(), u_new.get(),
+                              Px_new.get(), OSQP_NULL, n, Ax_new.get(), OSQP_NULL, n);
+  mu_assert("Update data: update error!", exitflag == 0);
+
+  // Same starting point as the reference solver
+  osqp_cold_start(solver.get());
+  osqp_solve(solver.get());
+  compare_solutions(refSolver.get(), solver.get());
+}
+
+TEST_CASE_METHOD(OSQPTestFixture, "Test updating P and A with the supernodal factorization", "[update]")
+{
+  OSQPInt exitflag;
+  OSQPInt i, j, k;
+
+  // Dense P and box constraints: the factor of the KKT matrix is one large
+  // supernode for the variables, which makes QDLDL use the dense kernels
+  const OSQPInt n   = 24;
+  const OSQPInt m   = n;
+  const OSQPInt Pnz = n * (n + 1) / 2;
+
+  std::unique_ptr<OSQPInt[]>   Pp(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Pi(new OSQPInt[Pnz]);
+  std::unique_ptr<OSQPFloat[]> Px(new OSQPFloat[Pnz]);
+  std::unique_ptr<OSQPInt[]>   Ap(new OSQPInt[n+1]);
+  std::unique_ptr<OSQPInt[]>   Ai(new OSQPInt[n]);
+  std::unique_ptr<OSQPFloat[]> Ax(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> q(new OSQPFloat[n]);
+  std::unique_ptr<OSQPFloat[]> l(new OSQPFloat[m]);
+  std::unique_ptr<OSQPFloat[]> u(new OSQPFloat[m]);
+
+  k = 0;
+  for (j = 0; j < n; j++) {
+    Pp[j] = k;
+    for (i = 0; i <= j; i++) {
+      Pi[k]   = i;
+      Px[k++] = (i == j) ? (OSQPFloat)n : 0.1 * (1 + (7*i + 3*j) % 5);
+    }
+    Ap[j] = j;
+    Ai[j] = j;
+    Ax[j] = 1.0 + 0.01 * j;
+    q[j]  = (j % 3) ? 10.0 : -25.0;
+    l[j]  = -1.0;
+    u[j]  = 1.0;
+  }
+  Pp[n] = Pnz;
+  Ap[n] = n;
+
+  OSQPCscMatrix P;
+  OSQPCscMatrix A;
+
+  csc_set_data(&P, n, n, Pnz, Px.get(), Pi.get(), Pp.get());
+  csc_set_data(&A, m, n, n,   Ax.get(), Ai.get(), Ap.get());
+
+  settings->scaling         = 0;
+  settings->linsys_solver   = OSQP_DIRECT_SOLVER;
+  settings->polishing       = 1;
+  settings->polish_in_place = GENERATE(0, 1);
+  settings->supernodal      = 0;
+
+  CAPTURE(settings->polish_in_place);
+
+  // Reference: the scalar QDLDL kernels
+  OSQPSolver_ptr refSolver{nullptr};
+
+  setup_with_reference(refSolver, solver,
+                       OSQPTestProblem(&P, q.get(), &A, l.get(), u.get(), m, n),
+                       settings.get(), [](OSQPSettings* s) { s->supernodal = 1; });
+
+  std::string refName = refSolver->work->linsys_solver->name(refSolver->work->linsys_solver);
+  std::string name    = solver->work->linsys_solver->name(solver->work->linsys_solver);
+  if (refName.rfind("QDLDL", 0) == 0) {
+    mu_assert("Update matrices: supernodal, dense kernels not used!",
+              name == refName + " (supernodal)");
+  }
+
+  // Only the rounding differs, so the iterations are the same
+  solve_and_compare(refSolver.get(), solver.get());
+
+  mu_assert("Update matrices: supernodal, error in solver status!",
+            solver->info->status_val == OSQP_SOLVED);
+  mu_assert("Update matrices: supernodal, error in polishing status!",
+            solver->info->status_polish == refSolver->info->status_polish);
+
+  // A few entries of P (partial refactorization) and all of A
+  OSQPInt   Px_new_idx[2] = { 0, Pnz - 1 };
+  OSQPFloat Px_new[2]     = { 2.0 * Px[0], 0.5 * Px[Pnz - 1] };
+
+  for (j = 0; j < n; j++) Ax[j] = 1.0 - 0.02 * j;
+
+  exitflag = osqp_update_data_mat(refSolver.get(), Px_new, Px_new_idx, 2, Ax.get(), OSQP_NULL, n);
+  mu_assert("Update matrices: supernodal, reference update error!", exitflag == 0);
+  exitflag = osqp_update_data_mat(solver.get(), Px_new, Px_new_idx, 2, Ax.get(), OSQP_NULL, n);
+  mu_assert("Update matrices: supernodal, update error!", exitflag == 0);
+
+  solve_and_compare(refSolver.get(), solver.get());
+
+  // A new rho refactors the whole KKT matrix
+  osqp_update_rho(refSolver.get(), 0.5);
+  osqp_update_rho(solver.get(), 0.5);
+  solve_and_compare(refSolver.get(), solver.get());
+}
@@ -1,5 +1,8 @@
+#include <catch2/catch.hpp>
+
 #include "osqp.h"
 #include "osqp_tester.h"
+#include "test_utils.h"
 
 // Needed for the c_absval define
 #include "glob_opts.h"
@@ -40,5 +43,86 @@ OSQPInt isLinsysSupported(enum osqp_linsys_solver_type solver) {
     return 1;
   }
 
+  if((caps & OSQP_CAPABILITY_HYBRID_SOLVER) && (solver == OSQP_HYBRID_SOLVER)) {
+    return 1;
+  }
+
   return 0;
 }
+
+void setup_with_reference(OSQPSolver_ptr&        refSolver,
+                          const OSQPTestProblem& refProb,
+                          OSQPSolver_ptr&        solver,
+                          const OSQPTestProblem& prob,
+                          OSQPSettings*          settings,
+                          const std::function<void(OSQPSettings*)>& settings_mod) {
+  OSQPInt     exitflag;
+  OSQPSolver* tmpSolver = nullptr;
+
+  if (settings->adaptive_rho_interval == 0) {
+    settings->adaptive_rho_interval = TESTS_RHO_INTERVAL;
+  }
+
+  exitflag = osqp_setup(&tmpSolver, refProb.P, refProb.q,
+                        refProb.A, refProb.l, refProb.u,
+                        refProb.m, refProb.n, settings);
+  refSolver.reset(tmpSolver);
+  mu_assert("Comparison with a reference: Reference setup error!", exitflag == 0);
+
+  if (settings_mod) settings_mod(settings);
+
+  tmpSolver = nullptr;
+  exitflag = osqp_setup(&tmpSolver, prob.P, prob.q,
+                        prob.A, prob.l, prob.u,
+                        prob.m, prob.n, settings);
+  solver.reset(tmpSolver);
+  mu_assert("Comparison with a reference: Setup error!", exitflag == 0);
+}
+
+void setup_with_reference(OSQPSolver_ptr&        refSolver,
+                          OSQPSolver_ptr&        solver,
+                          const OSQPTestProblem& prob,
+                          OSQPSettings*          settings,
+                          const std::function<void(OSQPSettings*)>& settings_mod) {
+  setup_with_reference(refSolver, prob, solver, prob, settings, settings_mod);
+}
+
+void compare_solutions(OSQPSolver* refSolver, OSQPSolver* solver) {
+  OSQPInt m, n;
+
+  osqp_get_dimensions(solver, &m, &n);
+
+  mu_assert("Comparison with a reference: Error in solver status!",
+            solver->info->status_val == refSolver->info->status_val);
+  mu_assert("Comparison with a reference: Error in number of iterations!",
+            solver->info->iter == refSolver->info->iter);
+  mu_assert("Comparison with a reference: Error in objective value!",
+            c_absval(solver->info->obj_val - refSolver->info->obj_val) < TESTS_TOL);
+
+  if (solver->info->status_val == OSQP_PRIMAL_INFEASIBLE) {
+    mu_assert("Comparison with a reference: Error in primal infeasibility certificate!",
+              vec_norm_inf_diff(solver->solution->prim_inf_cert,
+                                refSolver->solution->prim_inf_cert, m) < TESTS_TOL);
+  }
+  else {
+    mu_assert("Comparison with a reference: Error in primal solution!",
+              vec_norm_inf_diff(solver->solution->x, refSolver->solution->x, n) < TESTS_TOL);
+    mu_assert("Comparison with a reference: Error in dual solution!",
+              vec_norm_inf_diff(solver->solution->y, refSolver->solution->y, m) < TESTS_TOL);
+  }
+}
+
+void solve_and_compare(OSQPSolver* refSolver, OSQPSolver* solver) {
+  osqp_solve(refSolver);
+  osqp_solve(solver);
+  compare_solutions(refSolver, solver);
+}
+
+void compare_with_reference(OSQPSolver_ptr&        refSolver,
+                            OSQPSolver_ptr&        solver,
+                            const OSQPTestProblem& prob,
+                            OSQPSettings*          settings,
+                            const std::function<void(OSQPSettings*)>& settings_mod) {
+  setup_with_reference(refSolver, solver, prob, settings, settings_mod);
+  solve_and_compare(refSolver.get(), solver.get());
+}
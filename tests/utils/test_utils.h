@@ -1,10 +1,71 @@
 #ifndef TEST_UTILS_H_
 #define TEST_UTILS_H_
 
+#include <functional>
+
 #include "osqp.h"
+#include "osqp_tester.h"
 
 OSQPFloat vec_norm_inf(const OSQPFloat* v, OSQPInt l);
 OSQPFloat vec_norm_inf_diff(const OSQPFloat* a, const OSQPFloat* b, OSQPInt l);
 OSQPInt isLinsysSupported(enum osqp_linsys_solver_type solver);
 
+/* Interval of the rho adaptation in the comparisons with a reference solver */
+#define TESTS_RHO_INTERVAL 25
+
+/* Problem data passed to osqp_setup */
+struct OSQPTestProblem {
+    OSQPTestProblem(const OSQPCscMatrix* P, const OSQPFloat* q,
+                    const OSQPCscMatrix* A, const OSQPFloat* l, const OSQPFloat* u,
+                    OSQPInt m, OSQPInt n)
+        : P(P), q(q), A(A), l(l), u(u), m(m), n(n) {}
+
+    OSQPTestProblem(const OSQPTestData& data)
+        : OSQPTestProblem(data.P, data.q, data.A, data.l, data.u, data.m, data.n) {}
+
+    const OSQPCscMatrix* P;
+    const OSQPFloat*     q;
+    const OSQPCscMatrix* A;
+    const OSQPFloat*     l;
+    const OSQPFloat*     u;
+    OSQPInt              m;
+    OSQPInt              n;
+};
+
+/*
+ * Set up refSolver on refProb with the settings, then apply settings_mod (if any)
+ * to the settings and set up solver on prob. Timing-based rho adaptation would
+ * differ between the two solvers, so settings without an adaptation interval
+ * get TESTS_RHO_INTERVAL.
+ */
+void setup_with_reference(OSQPSolver_ptr&        refSolver,
+                          const OSQPTestProblem& refProb,
+                          OSQPSolver_ptr&        solver,
+                          const OSQPTestProblem& prob,
+                          OSQPSettings*          settings,
+                          const std::function<void(OSQPSettings*)>& settings_mod);
+
+/* Same problem for both solvers */
+void setup_with_reference(OSQPSolver_ptr&        refSolver,
+                          OSQPSolver_ptr&        solver,
+                          const OSQPTestProblem& prob,
+                          OSQPSettings*          settings,
+                          const std::function<void(OSQPSettings*)>& settings_mod);
+
+/*
+ * Check that solver found the same status, iterations, objective value and
+ * solution (or primal infeasibility certificate) as refSolver
+ */
+void compare_solutions(OSQPSolver* refSolver, OSQPSolver* solver);
+
+/* Solve with both solvers and compare the results */
+void solve_and_compare(OSQPSolver* refSolver, OSQPSolver* solver);
+
+/* Set up both solvers as setup_with_reference does, solve and compare */
+void compare_with_reference(OSQPSolver_ptr&        refSolver,
+                            OSQPSolver_ptr&        solver,
+                            const OSQPTestProblem& prob,
+                            OSQPSettings*          settings,
+                            const std::function<void(OSQPSettings*)>& settings_mod);
+
 #endif